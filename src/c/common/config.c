@@ -12,6 +12,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include <json-c/json.h>
 
 // Default configuration options
@@ -47,6 +49,9 @@ void sgnl_config_set_defaults(sgnl_config_t *config, const char *module_name) {
     // Set default HTTP settings
     config->http.timeout_seconds = 10;
     config->http.connect_timeout_seconds = 3;
+    config->http.timeout_ms = 0;
+    config->http.connect_timeout_ms = 0;
+    config->http.deadline_ms = 0;
     config->http.ssl_verify_peer = true;
     config->http.ssl_verify_host = true;
     
@@ -54,22 +59,187 @@ void sgnl_config_set_defaults(sgnl_config_t *config, const char *module_name) {
     strncpy(config->http.user_agent, "SGNL-Client/1.0", sizeof(config->http.user_agent) - 1);
     config->http.user_agent[sizeof(config->http.user_agent) - 1] = '\0';
     
+    // Set default retry policy
+    config->http.retry.max_retries = 2;
+    config->http.retry.base_delay_ms = 100;
+    config->http.retry.max_delay_ms = 2000;
+    config->http.retry.budget_ms = 0;
+    
+    // Set default hedging policy (disabled unless configured)
+    config->http.hedging.enabled = false;
+    config->http.hedging.percentile = 95;
+    config->http.hedging.initial_delay_ms = 250;
+    config->http.hedging.min_delay_ms = 20;
+    
+    // Set default batch splitting
+    config->http.batch.max_queries = 100;
+    config->http.batch.max_concurrency = 4;
+    
+    // Set default compression (decode responses, send requests as is)
+    config->http.compression.response = true;
+    config->http.compression.request = false;
+    config->http.compression.request_min_bytes = 4096;
+    
+    // Set default name resolution (libcurl's cache lifetime, either family)
+    config->http.dns.cache_ttl_seconds = 60;
+    config->http.dns.resolve_count = 0;
+    strncpy(config->http.dns.ip_version, "any", sizeof(config->http.dns.ip_version) - 1);
+    config->http.dns.happy_eyeballs_timeout_ms = 0;
+    
+    // Set default TLS sessions (shared in process, not persisted, no 0-RTT)
+    config->http.tls.session_cache = true;
+    config->http.tls.persist_sessions = false;
+    strncpy(config->http.tls.session_file, SGNL_DEFAULT_TLS_SESSION_FILE, sizeof(config->http.tls.session_file) - 1);
+    config->http.tls.session_file[sizeof(config->http.tls.session_file) - 1] = '\0';
+    config->http.tls.early_data = false;
+    
     // Set default logging
     config->logging.debug_mode = false;
     strncpy(config->logging.log_level, "info", sizeof(config->logging.log_level) - 1);
     config->logging.log_level[sizeof(config->logging.log_level) - 1] = '\0';
+    strcpy(config->logging.destination, "stdout");
+    strcpy(config->logging.format, "text");
+    config->logging.timestamp = false;
+    config->logging.pid = false;
+    strcpy(config->logging.facility, "local0");
+    config->logging.async = false;
+    config->logging.async_buffer_kb = 256;
+    strcpy(config->logging.audit, "syslog");
     
     // Set default sudo settings
     config->sudo.access_msg = true;
     strcpy(config->sudo.command_attribute, "id");  // Default to using asset ID
     config->sudo.batch_evaluation = false;  // Default to single query evaluation
+    
+    // Set default cache settings (disabled unless configured)
+    config->cache.enabled = false;
+    config->cache.positive_ttl_seconds = 30;
+    config->cache.negative_ttl_seconds = 5;
+    config->cache.max_entries = 1024;
+    
+    // Set default broker settings (disabled unless configured)
+    config->broker.enabled = false;
+    strncpy(config->broker.socket_path, SGNL_DEFAULT_BROKER_SOCKET, sizeof(config->broker.socket_path) - 1);
+    config->broker.socket_path[sizeof(config->broker.socket_path) - 1] = '\0';
+    config->broker.timeout_ms = 250;
+    
+    // Set default offline store settings (disabled unless configured)
+    config->offline_mode.enabled = false;
+    strncpy(config->offline_mode.store_path, SGNL_DEFAULT_OFFLINE_STORE, sizeof(config->offline_mode.store_path) - 1);
+    config->offline_mode.store_path[sizeof(config->offline_mode.store_path) - 1] = '\0';
+    config->offline_mode.grace_period_seconds = 14400;
+    config->offline_mode.max_entries = 4096;
+    
+    // Set default prefetch settings (disabled unless configured)
+    config->prefetch.enabled = false;
+    config->prefetch.interval_seconds = 300;
+    strcpy(config->prefetch.action, "sudo");
+    config->prefetch.group[0] = '\0';
+    config->prefetch.logged_in_users = true;
+    config->prefetch.max_principals = 256;
+    
+    // Set default metrics settings (no export unless configured)
+    config->metrics.textfile_path[0] = '\0';
+    config->metrics.interval_seconds = 15;
 }
 
 // Forward declaration
 static void apply_config_values(sgnl_config_t *config, json_object *root);
 
+// Identity of a config file's contents as seen by stat()
+typedef struct {
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec mtime;
+    struct timespec ctime;
+} config_file_key_t;
+
+// The most recently parsed config file (defaults plus file values, before
+// validation). Modules that load the same file twice per process, such as
+// the sudo plugin and the client it creates, parse it only once. The values
+// include the API token, so an entry serves a single later load and is
+// wiped as soon as that caller has its copy.
+static struct {
+    pthread_mutex_t lock;
+    bool valid;
+    char path[4096];
+    config_file_key_t key;
+    sgnl_config_t values;
+} config_cache = {
+    .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+static void config_file_key_from_stat(config_file_key_t *key, const struct stat *st) {
+    memset(key, 0, sizeof(*key));
+    key->device = st->st_dev;
+    key->inode = st->st_ino;
+    key->size = st->st_size;
+#ifdef __APPLE__
+    key->mtime = st->st_mtimespec;
+    key->ctime = st->st_ctimespec;
+#else
+    key->mtime = st->st_mtim;
+    key->ctime = st->st_ctim;
+#endif
+}
+
+static bool config_file_key_equal(const config_file_key_t *a, const config_file_key_t *b) {
+    return a->device == b->device && a->inode == b->inode && a->size == b->size &&
+           a->mtime.tv_sec == b->mtime.tv_sec && a->mtime.tv_nsec == b->mtime.tv_nsec &&
+           a->ctime.tv_sec == b->ctime.tv_sec && a->ctime.tv_nsec == b->ctime.tv_nsec;
+}
+
+// Called with config_cache.lock held
+static void config_cache_wipe(void) {
+    memset(&config_cache.values, 0, sizeof(config_cache.values));
+    config_cache.path[0] = '\0';
+    config_cache.valid = false;
+}
+
+// Move the cached values for config_path out of the cache if the file is
+// unchanged since it was parsed
+static bool config_cache_lookup(const char *config_path, sgnl_config_t *config) {
+    struct stat st;
+    if (stat(config_path, &st) != 0) {
+        return false;
+    }
+    config_file_key_t key;
+    config_file_key_from_stat(&key, &st);
+    
+    pthread_mutex_lock(&config_cache.lock);
+    bool hit = config_cache.valid && strcmp(config_cache.path, config_path) == 0 &&
+               config_file_key_equal(&config_cache.key, &key);
+    if (hit) {
+        *config = config_cache.values;
+        config_cache_wipe();
+    }
+    pthread_mutex_unlock(&config_cache.lock);
+    return hit;
+}
+
+static void config_cache_store(const char *config_path, const config_file_key_t *key, const sgnl_config_t *config) {
+    if (strlen(config_path) >= sizeof(config_cache.path)) {
+        return;
+    }
+    
+    pthread_mutex_lock(&config_cache.lock);
+    strcpy(config_cache.path, config_path);
+    config_cache.key = *key;
+    config_cache.values = *config;
+    config_cache.valid = true;
+    pthread_mutex_unlock(&config_cache.lock);
+}
+
+void sgnl_config_cache_clear(void) {
+    pthread_mutex_lock(&config_cache.lock);
+    config_cache_wipe();
+    pthread_mutex_unlock(&config_cache.lock);
+}
+
 // Helper to load and parse a single JSON config file
-static sgnl_config_result_t load_config_file(const char *config_path, json_object **root_out, char *error_buffer, size_t error_size) {
+static sgnl_config_result_t load_config_file(const char *config_path, json_object **root_out,
+                                             config_file_key_t *key_out, char *error_buffer, size_t error_size) {
     SGNL_RETURN_IF_NULL(config_path, SGNL_CONFIG_MEMORY_ERROR);
     SGNL_RETURN_IF_NULL(root_out, SGNL_CONFIG_MEMORY_ERROR);
     
@@ -83,6 +253,14 @@ static sgnl_config_result_t load_config_file(const char *config_path, json_objec
         return SGNL_CONFIG_FILE_NOT_FOUND;
     }
     
+    // Key the parse on the file that was actually opened
+    struct stat st;
+    if (key_out && fstat(fileno(fp), &st) == 0) {
+        config_file_key_from_stat(key_out, &st);
+    } else if (key_out) {
+        memset(key_out, 0, sizeof(*key_out));
+    }
+    
     // Read file content with automatic cleanup
     fseek(fp, 0, SEEK_END);
     long file_size = ftell(fp);
@@ -140,18 +318,25 @@ sgnl_config_result_t sgnl_config_load(sgnl_config_t *config, const sgnl_config_o
     
     SGNL_LOG_DEBUG(&log_ctx, "Loading configuration from: %s", config_path);
     
-    // Load configuration file
-    SGNL_AUTO_JSON json_object *config_json = NULL;
-    sgnl_config_result_t result = load_config_file(config_path, &config_json, config->last_error, sizeof(config->last_error));
-    
-    if (result != SGNL_CONFIG_OK) {
-        SGNL_LOG_ERROR(&log_ctx, "Failed to load configuration file: %s", config->last_error);
-        return result;
+    if (config_cache_lookup(config_path, config)) {
+        SGNL_LOG_DEBUG(&log_ctx, "Configuration unchanged since last load, reusing parsed values");
+    } else {
+        // Load configuration file
+        SGNL_AUTO_JSON json_object *config_json = NULL;
+        config_file_key_t key;
+        sgnl_config_result_t result = load_config_file(config_path, &config_json, &key,
+                                                       config->last_error, sizeof(config->last_error));
+        
+        if (result != SGNL_CONFIG_OK) {
+            SGNL_LOG_ERROR(&log_ctx, "Failed to load configuration file: %s", config->last_error);
+            return result;
+        }
+        
+        // Apply configuration values
+        apply_config_values(config, config_json);
+        config_cache_store(config_path, &key, config);
     }
     
-    // Apply configuration values
-    apply_config_values(config, config_json);
-    
     // Validate final configuration
     sgnl_config_result_t validation_result = sgnl_config_validate(config);
     if (validation_result != SGNL_CONFIG_OK && opts->strict_validation) {
@@ -217,6 +402,88 @@ static void apply_config_values(sgnl_config_t *config, json_object *root) {
         }
     }
     
+    // Decision cache settings (optional)
+    json_object *cache_obj;
+    if (json_object_object_get_ex(root, "cache", &cache_obj)) {
+        if (json_object_object_get_ex(cache_obj, "enabled", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->cache.enabled = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(cache_obj, "positive_ttl", &value) && json_object_is_type(value, json_type_int)) {
+            config->cache.positive_ttl_seconds = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(cache_obj, "negative_ttl", &value) && json_object_is_type(value, json_type_int)) {
+            config->cache.negative_ttl_seconds = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(cache_obj, "max_entries", &value) && json_object_is_type(value, json_type_int)) {
+            config->cache.max_entries = json_object_get_int(value);
+        }
+    }
+    
+    // Broker settings (optional)
+    json_object *broker_obj;
+    if (json_object_object_get_ex(root, "broker", &broker_obj)) {
+        if (json_object_object_get_ex(broker_obj, "enabled", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->broker.enabled = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(broker_obj, "socket_path", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->broker.socket_path, json_object_get_string(value), sizeof(config->broker.socket_path));
+        }
+        if (json_object_object_get_ex(broker_obj, "timeout_ms", &value) && json_object_is_type(value, json_type_int)) {
+            config->broker.timeout_ms = json_object_get_int(value);
+        }
+    }
+    
+    // Offline fail-safe settings (optional)
+    json_object *offline_obj;
+    if (json_object_object_get_ex(root, "offline_mode", &offline_obj)) {
+        if (json_object_object_get_ex(offline_obj, "enabled", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->offline_mode.enabled = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(offline_obj, "store_path", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->offline_mode.store_path, json_object_get_string(value), sizeof(config->offline_mode.store_path));
+        }
+        if (json_object_object_get_ex(offline_obj, "grace_period_seconds", &value) && json_object_is_type(value, json_type_int)) {
+            config->offline_mode.grace_period_seconds = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(offline_obj, "max_entries", &value) && json_object_is_type(value, json_type_int)) {
+            config->offline_mode.max_entries = json_object_get_int(value);
+        }
+    }
+    
+    // Entitlement prefetch settings (optional)
+    json_object *prefetch_obj;
+    if (json_object_object_get_ex(root, "prefetch", &prefetch_obj)) {
+        if (json_object_object_get_ex(prefetch_obj, "enabled", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->prefetch.enabled = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(prefetch_obj, "interval_seconds", &value) && json_object_is_type(value, json_type_int)) {
+            config->prefetch.interval_seconds = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(prefetch_obj, "action", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->prefetch.action, json_object_get_string(value), sizeof(config->prefetch.action));
+        }
+        if (json_object_object_get_ex(prefetch_obj, "group", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->prefetch.group, json_object_get_string(value), sizeof(config->prefetch.group));
+        }
+        if (json_object_object_get_ex(prefetch_obj, "logged_in_users", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->prefetch.logged_in_users = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(prefetch_obj, "max_principals", &value) && json_object_is_type(value, json_type_int)) {
+            config->prefetch.max_principals = json_object_get_int(value);
+        }
+    }
+    
+    // Metrics export settings (optional)
+    json_object *metrics_obj;
+    if (json_object_object_get_ex(root, "metrics", &metrics_obj)) {
+        if (json_object_object_get_ex(metrics_obj, "textfile_path", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->metrics.textfile_path, json_object_get_string(value), sizeof(config->metrics.textfile_path));
+        }
+        if (json_object_object_get_ex(metrics_obj, "interval_seconds", &value) && json_object_is_type(value, json_type_int)) {
+            config->metrics.interval_seconds = json_object_get_int(value);
+        }
+    }
+    
     // HTTP settings (optional)
     json_object *http_obj;
     if (json_object_object_get_ex(root, "http", &http_obj)) {
@@ -226,6 +493,15 @@ static void apply_config_values(sgnl_config_t *config, json_object *root) {
         if (json_object_object_get_ex(http_obj, "connect_timeout", &value) && json_object_is_type(value, json_type_int)) {
             config->http.connect_timeout_seconds = json_object_get_int(value);
         }
+        if (json_object_object_get_ex(http_obj, "timeout_ms", &value) && json_object_is_type(value, json_type_int)) {
+            config->http.timeout_ms = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(http_obj, "connect_timeout_ms", &value) && json_object_is_type(value, json_type_int)) {
+            config->http.connect_timeout_ms = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(http_obj, "deadline_ms", &value) && json_object_is_type(value, json_type_int)) {
+            config->http.deadline_ms = json_object_get_int(value);
+        }
         if (json_object_object_get_ex(http_obj, "ssl_verify_peer", &value) && json_object_is_type(value, json_type_boolean)) {
             config->http.ssl_verify_peer = json_object_get_boolean(value);
         }
@@ -235,6 +511,104 @@ static void apply_config_values(sgnl_config_t *config, json_object *root) {
         if (json_object_object_get_ex(http_obj, "user_agent", &value) && json_object_is_type(value, json_type_string)) {
             SGNL_SAFE_STRNCPY(config->http.user_agent, json_object_get_string(value), sizeof(config->http.user_agent));
         }
+        
+        json_object *retry_obj;
+        if (json_object_object_get_ex(http_obj, "retry", &retry_obj)) {
+            if (json_object_object_get_ex(retry_obj, "max_retries", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.retry.max_retries = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(retry_obj, "base_delay_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.retry.base_delay_ms = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(retry_obj, "max_delay_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.retry.max_delay_ms = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(retry_obj, "budget_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.retry.budget_ms = json_object_get_int(value);
+            }
+        }
+        
+        json_object *hedging_obj;
+        if (json_object_object_get_ex(http_obj, "hedging", &hedging_obj)) {
+            if (json_object_object_get_ex(hedging_obj, "enabled", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.hedging.enabled = json_object_get_boolean(value);
+            }
+            if (json_object_object_get_ex(hedging_obj, "percentile", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.hedging.percentile = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(hedging_obj, "initial_delay_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.hedging.initial_delay_ms = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(hedging_obj, "min_delay_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.hedging.min_delay_ms = json_object_get_int(value);
+            }
+        }
+        
+        json_object *batch_obj;
+        if (json_object_object_get_ex(http_obj, "batch", &batch_obj)) {
+            if (json_object_object_get_ex(batch_obj, "max_queries", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.batch.max_queries = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(batch_obj, "max_concurrency", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.batch.max_concurrency = json_object_get_int(value);
+            }
+        }
+        
+        json_object *compression_obj;
+        if (json_object_object_get_ex(http_obj, "compression", &compression_obj)) {
+            if (json_object_object_get_ex(compression_obj, "response", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.compression.response = json_object_get_boolean(value);
+            }
+            if (json_object_object_get_ex(compression_obj, "request", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.compression.request = json_object_get_boolean(value);
+            }
+            if (json_object_object_get_ex(compression_obj, "request_min_bytes", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.compression.request_min_bytes = json_object_get_int(value);
+            }
+        }
+        
+        json_object *dns_obj;
+        if (json_object_object_get_ex(http_obj, "dns", &dns_obj)) {
+            if (json_object_object_get_ex(dns_obj, "cache_ttl_seconds", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.dns.cache_ttl_seconds = json_object_get_int(value);
+            }
+            if (json_object_object_get_ex(dns_obj, "resolve", &value) && json_object_is_type(value, json_type_array)) {
+                // An entry that does not fit is kept empty so validation rejects it
+                size_t count = json_object_array_length(value);
+                config->http.dns.resolve_count = 0;
+                for (size_t i = 0; i < count && config->http.dns.resolve_count < SGNL_CONFIG_MAX_RESOLVE; i++) {
+                    json_object *entry = json_object_array_get_idx(value, i);
+                    char *slot = config->http.dns.resolve[config->http.dns.resolve_count++];
+                    slot[0] = '\0';
+                    if (json_object_is_type(entry, json_type_string) &&
+                        strlen(json_object_get_string(entry)) < sizeof(config->http.dns.resolve[0])) {
+                        strcpy(slot, json_object_get_string(entry));
+                    }
+                }
+            }
+            if (json_object_object_get_ex(dns_obj, "ip_version", &value) && json_object_is_type(value, json_type_string)) {
+                SGNL_SAFE_STRNCPY(config->http.dns.ip_version, json_object_get_string(value), sizeof(config->http.dns.ip_version));
+            }
+            if (json_object_object_get_ex(dns_obj, "happy_eyeballs_timeout_ms", &value) && json_object_is_type(value, json_type_int)) {
+                config->http.dns.happy_eyeballs_timeout_ms = json_object_get_int(value);
+            }
+        }
+        
+        json_object *tls_obj;
+        if (json_object_object_get_ex(http_obj, "tls", &tls_obj)) {
+            if (json_object_object_get_ex(tls_obj, "session_cache", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.tls.session_cache = json_object_get_boolean(value);
+            }
+            if (json_object_object_get_ex(tls_obj, "persist_sessions", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.tls.persist_sessions = json_object_get_boolean(value);
+            }
+            if (json_object_object_get_ex(tls_obj, "session_file", &value) && json_object_is_type(value, json_type_string)) {
+                SGNL_SAFE_STRNCPY(config->http.tls.session_file, json_object_get_string(value), sizeof(config->http.tls.session_file));
+            }
+            if (json_object_object_get_ex(tls_obj, "early_data", &value) && json_object_is_type(value, json_type_boolean)) {
+                config->http.tls.early_data = json_object_get_boolean(value);
+            }
+        }
     }
     
     // Debug logging
@@ -256,6 +630,35 @@ static void apply_config_values(sgnl_config_t *config, json_object *root) {
     if (json_object_object_get_ex(root, "log_level", &value) && json_object_is_type(value, json_type_string)) {
         SGNL_SAFE_STRNCPY(config->logging.log_level, json_object_get_string(value), sizeof(config->logging.log_level));
     }
+    
+    // Log output
+    json_object *logging_obj;
+    if (json_object_object_get_ex(root, "logging", &logging_obj)) {
+        if (json_object_object_get_ex(logging_obj, "destination", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->logging.destination, json_object_get_string(value), sizeof(config->logging.destination));
+        }
+        if (json_object_object_get_ex(logging_obj, "format", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->logging.format, json_object_get_string(value), sizeof(config->logging.format));
+        }
+        if (json_object_object_get_ex(logging_obj, "timestamp", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->logging.timestamp = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(logging_obj, "pid", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->logging.pid = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(logging_obj, "facility", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->logging.facility, json_object_get_string(value), sizeof(config->logging.facility));
+        }
+        if (json_object_object_get_ex(logging_obj, "async", &value) && json_object_is_type(value, json_type_boolean)) {
+            config->logging.async = json_object_get_boolean(value);
+        }
+        if (json_object_object_get_ex(logging_obj, "async_buffer_kb", &value) && json_object_is_type(value, json_type_int)) {
+            config->logging.async_buffer_kb = json_object_get_int(value);
+        }
+        if (json_object_object_get_ex(logging_obj, "audit", &value) && json_object_is_type(value, json_type_string)) {
+            SGNL_SAFE_STRNCPY(config->logging.audit, json_object_get_string(value), sizeof(config->logging.audit));
+        }
+    }
 
 }
 
@@ -282,6 +685,153 @@ sgnl_config_result_t sgnl_config_validate(const sgnl_config_t *config) {
         return SGNL_CONFIG_INVALID_VALUE;
     }
     
+    // Millisecond overrides share the ranges above; 0 leaves them unset
+    if (config->http.timeout_ms < 0 || config->http.timeout_ms > 300000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (config->http.connect_timeout_ms < 0 || config->http.connect_timeout_ms > 60000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (config->http.deadline_ms < 0 || config->http.deadline_ms > 300000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate retry policy
+    if (config->http.retry.max_retries < 0 || config->http.retry.max_retries > 10) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (config->http.retry.base_delay_ms < 1 ||
+        config->http.retry.max_delay_ms < config->http.retry.base_delay_ms ||
+        config->http.retry.max_delay_ms > 60000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (config->http.retry.budget_ms < 0 || config->http.retry.budget_ms > 300000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate hedging policy; below the median every other request would be duplicated
+    if (config->http.hedging.enabled) {
+        if (config->http.hedging.percentile < 50 || config->http.hedging.percentile > 99) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->http.hedging.initial_delay_ms < 1 || config->http.hedging.initial_delay_ms > 60000 ||
+            config->http.hedging.min_delay_ms < 1 || config->http.hedging.min_delay_ms > 60000) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate batch splitting
+    if (config->http.batch.max_queries < 1 || config->http.batch.max_queries > 10000 ||
+        config->http.batch.max_concurrency < 1 || config->http.batch.max_concurrency > 16) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate compression
+    if (config->http.compression.request_min_bytes < 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate name resolution
+    if (config->http.dns.cache_ttl_seconds < -1 ||
+        config->http.dns.happy_eyeballs_timeout_ms < 0 || config->http.dns.happy_eyeballs_timeout_ms > 60000) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (strcmp(config->http.dns.ip_version, "any") != 0 && strcmp(config->http.dns.ip_version, "ipv4") != 0 &&
+        strcmp(config->http.dns.ip_version, "ipv6") != 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    for (int i = 0; i < config->http.dns.resolve_count; i++) {
+        // host:port:address; addresses may contain colons themselves
+        const char *port = strchr(config->http.dns.resolve[i], ':');
+        if (!port || port == config->http.dns.resolve[i] || !strchr(port + 1, ':')) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate TLS sessions; the file is only opened when persisting
+    if (config->http.tls.persist_sessions &&
+        (strlen(config->http.tls.session_file) == 0 || config->http.tls.session_file[0] != '/')) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate cache settings
+    if (config->cache.enabled) {
+        if (config->cache.positive_ttl_seconds < 0 || config->cache.positive_ttl_seconds > 3600 ||
+            config->cache.negative_ttl_seconds < 0 || config->cache.negative_ttl_seconds > 3600) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->cache.max_entries < 1 || config->cache.max_entries > 1000000) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate broker settings
+    if (config->broker.enabled) {
+        if (strlen(config->broker.socket_path) == 0) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->broker.timeout_ms < 1 || config->broker.timeout_ms > 10000) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate offline store settings; the grace period is capped at a week
+    // so a forgotten outage cannot keep stale grants alive indefinitely
+    if (config->offline_mode.enabled) {
+        if (strlen(config->offline_mode.store_path) == 0 || config->offline_mode.store_path[0] != '/') {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->offline_mode.grace_period_seconds < 1 || config->offline_mode.grace_period_seconds > 604800) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->offline_mode.max_entries < 16 || config->offline_mode.max_entries > 1000000) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate prefetch settings; a snapshot is trusted for two intervals, so
+    // the interval bounds how long a revoked grant can still be served
+    if (config->prefetch.enabled) {
+        if (config->prefetch.interval_seconds < 10 || config->prefetch.interval_seconds > 3600) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (strlen(config->prefetch.action) == 0) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->prefetch.max_principals < 1 || config->prefetch.max_principals > 10000) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
+    // Validate log output settings
+    if (strcmp(config->logging.destination, "stdout") != 0 &&
+        strcmp(config->logging.destination, "syslog") != 0 &&
+        strcmp(config->logging.destination, "journald") != 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (strcmp(config->logging.format, "text") != 0 && strcmp(config->logging.format, "json") != 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (sgnl_log_facility_from_string(config->logging.facility) < 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (config->logging.async_buffer_kb < 16 || config->logging.async_buffer_kb > 65536) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    if (sgnl_audit_destination_from_string(config->logging.audit) < 0) {
+        return SGNL_CONFIG_INVALID_VALUE;
+    }
+    
+    // Validate metrics settings
+    if (config->metrics.textfile_path[0] != '\0') {
+        if (config->metrics.textfile_path[0] != '/') {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+        if (config->metrics.interval_seconds < 1 || config->metrics.interval_seconds > 3600) {
+            return SGNL_CONFIG_INVALID_VALUE;
+        }
+    }
+    
     return SGNL_CONFIG_OK;
 }
 
@@ -322,6 +872,224 @@ int sgnl_config_get_connect_timeout(const sgnl_config_t *config) {
     return config ? config->http.connect_timeout_seconds : 10;
 }
 
+int sgnl_config_get_timeout_ms(const sgnl_config_t *config) {
+    if (!config) return 30000;
+    return config->http.timeout_ms > 0 ? config->http.timeout_ms : config->http.timeout_seconds * 1000;
+}
+
+int sgnl_config_get_connect_timeout_ms(const sgnl_config_t *config) {
+    if (!config) return 10000;
+    return config->http.connect_timeout_ms > 0 ? config->http.connect_timeout_ms :
+                                                 config->http.connect_timeout_seconds * 1000;
+}
+
+int sgnl_config_get_deadline_ms(const sgnl_config_t *config) {
+    return config ? config->http.deadline_ms : 0;
+}
+
+int sgnl_config_get_retry_max_retries(const sgnl_config_t *config) {
+    return config ? config->http.retry.max_retries : 0;
+}
+
+int sgnl_config_get_retry_base_delay_ms(const sgnl_config_t *config) {
+    return config ? config->http.retry.base_delay_ms : 0;
+}
+
+int sgnl_config_get_retry_max_delay_ms(const sgnl_config_t *config) {
+    return config ? config->http.retry.max_delay_ms : 0;
+}
+
+int sgnl_config_get_retry_budget_ms(const sgnl_config_t *config) {
+    return config ? config->http.retry.budget_ms : 0;
+}
+
+bool sgnl_config_get_hedging_enabled(const sgnl_config_t *config) {
+    return config ? config->http.hedging.enabled : false;
+}
+
+int sgnl_config_get_hedging_percentile(const sgnl_config_t *config) {
+    return config ? config->http.hedging.percentile : 0;
+}
+
+int sgnl_config_get_hedging_initial_delay_ms(const sgnl_config_t *config) {
+    return config ? config->http.hedging.initial_delay_ms : 0;
+}
+
+int sgnl_config_get_hedging_min_delay_ms(const sgnl_config_t *config) {
+    return config ? config->http.hedging.min_delay_ms : 0;
+}
+
+int sgnl_config_get_batch_max_queries(const sgnl_config_t *config) {
+    return config ? config->http.batch.max_queries : 100;
+}
+
+int sgnl_config_get_batch_max_concurrency(const sgnl_config_t *config) {
+    return config ? config->http.batch.max_concurrency : 1;
+}
+
+bool sgnl_config_get_compression_response(const sgnl_config_t *config) {
+    return config ? config->http.compression.response : true;
+}
+
+bool sgnl_config_get_compression_request(const sgnl_config_t *config) {
+    return config ? config->http.compression.request : false;
+}
+
+int sgnl_config_get_compression_request_min_bytes(const sgnl_config_t *config) {
+    return config ? config->http.compression.request_min_bytes : 4096;
+}
+
+int sgnl_config_get_dns_cache_ttl(const sgnl_config_t *config) {
+    return config ? config->http.dns.cache_ttl_seconds : 60;
+}
+
+int sgnl_config_get_dns_resolve_count(const sgnl_config_t *config) {
+    return config ? config->http.dns.resolve_count : 0;
+}
+
+const char* sgnl_config_get_dns_resolve(const sgnl_config_t *config, int index) {
+    if (!config || index < 0 || index >= config->http.dns.resolve_count) {
+        return NULL;
+    }
+    return config->http.dns.resolve[index];
+}
+
+const char* sgnl_config_get_ip_version(const sgnl_config_t *config) {
+    return config ? config->http.dns.ip_version : "any";
+}
+
+int sgnl_config_get_happy_eyeballs_timeout_ms(const sgnl_config_t *config) {
+    return config ? config->http.dns.happy_eyeballs_timeout_ms : 0;
+}
+
+bool sgnl_config_get_tls_session_cache(const sgnl_config_t *config) {
+    return config ? config->http.tls.session_cache : true;
+}
+
+bool sgnl_config_get_tls_persist_sessions(const sgnl_config_t *config) {
+    return config ? config->http.tls.persist_sessions : false;
+}
+
+const char* sgnl_config_get_tls_session_file(const sgnl_config_t *config) {
+    return config ? config->http.tls.session_file : SGNL_DEFAULT_TLS_SESSION_FILE;
+}
+
+bool sgnl_config_get_tls_early_data(const sgnl_config_t *config) {
+    return config ? config->http.tls.early_data : false;
+}
+
+bool sgnl_config_get_cache_enabled(const sgnl_config_t *config) {
+    return config ? config->cache.enabled : false;
+}
+
+int sgnl_config_get_cache_positive_ttl(const sgnl_config_t *config) {
+    return config ? config->cache.positive_ttl_seconds : 0;
+}
+
+int sgnl_config_get_cache_negative_ttl(const sgnl_config_t *config) {
+    return config ? config->cache.negative_ttl_seconds : 0;
+}
+
+int sgnl_config_get_cache_max_entries(const sgnl_config_t *config) {
+    return config ? config->cache.max_entries : 0;
+}
+
+bool sgnl_config_get_broker_enabled(const sgnl_config_t *config) {
+    return config ? config->broker.enabled : false;
+}
+
+const char* sgnl_config_get_broker_socket_path(const sgnl_config_t *config) {
+    return config ? config->broker.socket_path : NULL;
+}
+
+int sgnl_config_get_broker_timeout_ms(const sgnl_config_t *config) {
+    return config ? config->broker.timeout_ms : 0;
+}
+
+bool sgnl_config_get_offline_enabled(const sgnl_config_t *config) {
+    return config ? config->offline_mode.enabled : false;
+}
+
+const char* sgnl_config_get_offline_store_path(const sgnl_config_t *config) {
+    return config ? config->offline_mode.store_path : NULL;
+}
+
+int sgnl_config_get_offline_grace_period(const sgnl_config_t *config) {
+    return config ? config->offline_mode.grace_period_seconds : 0;
+}
+
+int sgnl_config_get_offline_max_entries(const sgnl_config_t *config) {
+    return config ? config->offline_mode.max_entries : 0;
+}
+
+bool sgnl_config_get_prefetch_enabled(const sgnl_config_t *config) {
+    return config ? config->prefetch.enabled : false;
+}
+
+int sgnl_config_get_prefetch_interval(const sgnl_config_t *config) {
+    return config ? config->prefetch.interval_seconds : 0;
+}
+
+const char* sgnl_config_get_prefetch_action(const sgnl_config_t *config) {
+    return config ? config->prefetch.action : NULL;
+}
+
+const char* sgnl_config_get_prefetch_group(const sgnl_config_t *config) {
+    return config ? config->prefetch.group : NULL;
+}
+
+bool sgnl_config_get_prefetch_logged_in_users(const sgnl_config_t *config) {
+    return config ? config->prefetch.logged_in_users : false;
+}
+
+int sgnl_config_get_prefetch_max_principals(const sgnl_config_t *config) {
+    return config ? config->prefetch.max_principals : 0;
+}
+
+const char* sgnl_config_get_metrics_textfile_path(const sgnl_config_t *config) {
+    return config ? config->metrics.textfile_path : "";
+}
+
+int sgnl_config_get_metrics_interval(const sgnl_config_t *config) {
+    return config ? config->metrics.interval_seconds : 15;
+}
+
+const char* sgnl_config_get_log_level(const sgnl_config_t *config) {
+    return config ? config->logging.log_level : "info";
+}
+
+const char* sgnl_config_get_log_destination(const sgnl_config_t *config) {
+    return config ? config->logging.destination : "stdout";
+}
+
+const char* sgnl_config_get_log_format(const sgnl_config_t *config) {
+    return config ? config->logging.format : "text";
+}
+
+bool sgnl_config_get_log_timestamp(const sgnl_config_t *config) {
+    return config ? config->logging.timestamp : false;
+}
+
+bool sgnl_config_get_log_pid(const sgnl_config_t *config) {
+    return config ? config->logging.pid : false;
+}
+
+const char* sgnl_config_get_log_facility(const sgnl_config_t *config) {
+    return config ? config->logging.facility : "local0";
+}
+
+bool sgnl_config_get_log_async(const sgnl_config_t *config) {
+    return config ? config->logging.async : false;
+}
+
+int sgnl_config_get_log_async_buffer_kb(const sgnl_config_t *config) {
+    return config ? config->logging.async_buffer_kb : 256;
+}
+
+const char* sgnl_config_get_log_audit(const sgnl_config_t *config) {
+    return config ? config->logging.audit : "syslog";
+}
+
 // Convenience functions
 bool sgnl_config_is_valid(const sgnl_config_t *config) {
     return config && config->initialized && (sgnl_config_validate(config) == SGNL_CONFIG_OK);
@@ -11,6 +11,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+// Static host:port:address entries accepted under http.dns.resolve
+#define SGNL_CONFIG_MAX_RESOLVE 8
+
 // Configuration structure - unified for all modules
 typedef struct {
     // Core SGNL API settings
@@ -22,15 +25,75 @@ typedef struct {
     struct {
         int timeout_seconds;
         int connect_timeout_seconds;
+        int timeout_ms;              // Per-attempt timeout in ms (0 = timeout_seconds)
+        int connect_timeout_ms;      // Connect timeout in ms (0 = connect_timeout_seconds)
+        int deadline_ms;             // End-to-end bound on one call, broker and retries included (0 = none)
         bool ssl_verify_peer;
         bool ssl_verify_host;
         char user_agent[128];
+        
+        // Retry policy for transient failures (5xx, 429, connect errors)
+        struct {
+            int max_retries;         // Retries after the first attempt (0 = never retry)
+            int base_delay_ms;       // Backoff base; attempt n waits up to base * 2^n
+            int max_delay_ms;        // Cap on a single backoff delay
+            int budget_ms;           // Total time across all attempts (0 = http.timeout)
+        } retry;
+        
+        // Hedging: an evaluation that is slower than usual is duplicated on a
+        // second connection and the first answer wins
+        struct {
+            bool enabled;            // Default: false
+            int percentile;          // Hedge once an attempt outlasts this percentile of recent ones
+            int initial_delay_ms;    // Hedge delay until enough latencies have been observed
+            int min_delay_ms;        // Floor on the hedge delay
+        } hedging;
+        
+        // Large batch evaluations are split into several requests
+        struct {
+            int max_queries;         // Queries per evaluation request (the server's limit)
+            int max_concurrency;     // Requests of one batch in flight at once
+        } batch;
+        
+        // Bytes on the wire: compressed responses are decoded transparently,
+        // and large batch bodies may be sent gzip-encoded
+        struct {
+            bool response;           // Advertise Accept-Encoding (default: true)
+            bool request;            // gzip large batch request bodies (default: false)
+            int request_min_bytes;   // Smallest body worth compressing
+        } compression;
+        
+        // Resolving the API host
+        struct {
+            int cache_ttl_seconds;   // How long resolved addresses are reused (-1 = forever, 0 = never)
+            char resolve[SGNL_CONFIG_MAX_RESOLVE][256]; // "host:port:address[,address]", bypasses DNS
+            int resolve_count;
+            char ip_version[8];      // "any", "ipv4" or "ipv6"
+            int happy_eyeballs_timeout_ms; // Head start for the preferred family (0 = libcurl default)
+        } dns;
+        
+        // TLS session resumption: tickets are shared by every handle of a
+        // client and may be kept on disk for the next process
+        struct {
+            bool session_cache;      // Share sessions between connections (default: true)
+            bool persist_sessions;   // Save sessions across processes (default: false)
+            char session_file[256];  // Root-only file holding saved sessions
+            bool early_data;         // Send TLS 1.3 0-RTT data on resumption (default: false)
+        } tls;
     } http;
     
     // Global logging settings
     struct {
         bool debug_mode;
         char log_level[16];          // "debug", "info", "warn", "error"
+        char destination[16];        // "stdout", "syslog" or "journald"
+        char format[8];              // "text" or "json"
+        bool timestamp;              // Prefix records with the time (stdout, json)
+        bool pid;                    // Include the process ID
+        char facility[16];           // Syslog facility ("local0", "authpriv", ...)
+        bool async;                  // Write records from a background thread (default: false)
+        int async_buffer_kb;         // Queued records beyond this are dropped
+        char audit[16];              // Audit records: "syslog", "journald", "stderr", "stdout" or "none"
     } logging;
     
     // Sudo plugin specific settings
@@ -40,6 +103,46 @@ typedef struct {
         bool batch_evaluation;       // Use batch evaluation for command + arguments (default: false)
     } sudo;
     
+    // In-process decision cache settings
+    struct {
+        bool enabled;                // Serve repeated decisions from memory (default: false)
+        int positive_ttl_seconds;    // Lifetime of cached Allow decisions (0 = never cache)
+        int negative_ttl_seconds;    // Lifetime of cached Deny decisions (0 = never cache)
+        int max_entries;             // Upper bound on cached decisions
+    } cache;
+    
+    // Local decision broker (sgnld) settings
+    struct {
+        bool enabled;                // Route evaluations through sgnld when it is running (default: false)
+        char socket_path[108];       // Unix domain socket of the broker
+        int timeout_ms;              // IPC timeout before falling back to direct evaluation
+    } broker;
+    
+    // Offline fail-safe: recent Allow decisions persisted for API outages
+    struct {
+        bool enabled;                // Serve stored Allows while the API is unreachable (default: false)
+        char store_path[256];        // Memory-mapped store, HMAC-protected with the API token
+        int grace_period_seconds;    // How long after it was recorded an Allow may be served
+        int max_entries;             // Slots allocated when the store is created
+    } offline_mode;
+    
+    // Entitlement prefetch: sgnld keeps each active principal's allowed
+    // assets warm via /access/v2/search so evaluations are answered locally
+    struct {
+        bool enabled;                // Run the background refresher in sgnld (default: false)
+        int interval_seconds;        // Every active principal is refreshed once per interval
+        char action[64];             // Action whose allowed assets are prefetched
+        char group[64];              // Also prefetch members of this group ("" = none)
+        bool logged_in_users;        // Prefetch users with a login session
+        int max_principals;          // Upper bound on prefetched principals
+    } prefetch;
+    
+    // Metrics: sgnld exports its client's statistics for Prometheus
+    struct {
+        char textfile_path[256];     // Written for the node_exporter textfile collector ("" = off)
+        int interval_seconds;        // How often the file is rewritten
+    } metrics;
+    
     // Internal state
     bool initialized;
     char last_error[256];
@@ -58,6 +161,15 @@ typedef struct {
 // Default configuration path
 #define SGNL_DEFAULT_CONFIG     "/etc/sgnl/config.json"
 
+// Default broker socket path
+#define SGNL_DEFAULT_BROKER_SOCKET "/run/sgnl/sgnld.sock"
+
+// Default offline decision store path
+#define SGNL_DEFAULT_OFFLINE_STORE "/var/lib/sgnl/offline.db"
+
+// Default TLS session file path
+#define SGNL_DEFAULT_TLS_SESSION_FILE "/var/lib/sgnl/tls_sessions"
+
 // Configuration validation result
 typedef enum {
     SGNL_CONFIG_OK = 0,
@@ -74,7 +186,12 @@ typedef enum {
 sgnl_config_t* sgnl_config_create(void);
 void sgnl_config_destroy(sgnl_config_t *config);
 
+// The last parsed file is cached per process and reused by the next load
+// if its path, inode, size and timestamps are unchanged. The cached copy
+// (API token included) is wiped once that load has taken it, or by
+// sgnl_config_cache_clear.
 sgnl_config_result_t sgnl_config_load(sgnl_config_t *config, const sgnl_config_options_t *options);
+void sgnl_config_cache_clear(void);
 sgnl_config_result_t sgnl_config_validate(const sgnl_config_t *config);
 void sgnl_config_set_defaults(sgnl_config_t *config, const char *module_name);
 
@@ -88,6 +205,59 @@ bool sgnl_config_get_sudo_batch_evaluation(const sgnl_config_t *config);
 const char* sgnl_config_get_user_agent(const sgnl_config_t *config);
 int sgnl_config_get_timeout(const sgnl_config_t *config);
 int sgnl_config_get_connect_timeout(const sgnl_config_t *config);
+int sgnl_config_get_timeout_ms(const sgnl_config_t *config);
+int sgnl_config_get_connect_timeout_ms(const sgnl_config_t *config);
+int sgnl_config_get_deadline_ms(const sgnl_config_t *config);
+int sgnl_config_get_retry_max_retries(const sgnl_config_t *config);
+int sgnl_config_get_retry_base_delay_ms(const sgnl_config_t *config);
+int sgnl_config_get_retry_max_delay_ms(const sgnl_config_t *config);
+int sgnl_config_get_retry_budget_ms(const sgnl_config_t *config);
+bool sgnl_config_get_hedging_enabled(const sgnl_config_t *config);
+int sgnl_config_get_hedging_percentile(const sgnl_config_t *config);
+int sgnl_config_get_hedging_initial_delay_ms(const sgnl_config_t *config);
+int sgnl_config_get_hedging_min_delay_ms(const sgnl_config_t *config);
+int sgnl_config_get_batch_max_queries(const sgnl_config_t *config);
+int sgnl_config_get_batch_max_concurrency(const sgnl_config_t *config);
+bool sgnl_config_get_compression_response(const sgnl_config_t *config);
+bool sgnl_config_get_compression_request(const sgnl_config_t *config);
+int sgnl_config_get_compression_request_min_bytes(const sgnl_config_t *config);
+int sgnl_config_get_dns_cache_ttl(const sgnl_config_t *config);
+int sgnl_config_get_dns_resolve_count(const sgnl_config_t *config);
+const char* sgnl_config_get_dns_resolve(const sgnl_config_t *config, int index);
+const char* sgnl_config_get_ip_version(const sgnl_config_t *config);
+int sgnl_config_get_happy_eyeballs_timeout_ms(const sgnl_config_t *config);
+bool sgnl_config_get_tls_session_cache(const sgnl_config_t *config);
+bool sgnl_config_get_tls_persist_sessions(const sgnl_config_t *config);
+const char* sgnl_config_get_tls_session_file(const sgnl_config_t *config);
+bool sgnl_config_get_tls_early_data(const sgnl_config_t *config);
+bool sgnl_config_get_cache_enabled(const sgnl_config_t *config);
+int sgnl_config_get_cache_positive_ttl(const sgnl_config_t *config);
+int sgnl_config_get_cache_negative_ttl(const sgnl_config_t *config);
+int sgnl_config_get_cache_max_entries(const sgnl_config_t *config);
+bool sgnl_config_get_broker_enabled(const sgnl_config_t *config);
+const char* sgnl_config_get_broker_socket_path(const sgnl_config_t *config);
+int sgnl_config_get_broker_timeout_ms(const sgnl_config_t *config);
+bool sgnl_config_get_offline_enabled(const sgnl_config_t *config);
+const char* sgnl_config_get_offline_store_path(const sgnl_config_t *config);
+int sgnl_config_get_offline_grace_period(const sgnl_config_t *config);
+int sgnl_config_get_offline_max_entries(const sgnl_config_t *config);
+bool sgnl_config_get_prefetch_enabled(const sgnl_config_t *config);
+int sgnl_config_get_prefetch_interval(const sgnl_config_t *config);
+const char* sgnl_config_get_prefetch_action(const sgnl_config_t *config);
+const char* sgnl_config_get_prefetch_group(const sgnl_config_t *config);
+bool sgnl_config_get_prefetch_logged_in_users(const sgnl_config_t *config);
+int sgnl_config_get_prefetch_max_principals(const sgnl_config_t *config);
+const char* sgnl_config_get_metrics_textfile_path(const sgnl_config_t *config);
+int sgnl_config_get_metrics_interval(const sgnl_config_t *config);
+const char* sgnl_config_get_log_level(const sgnl_config_t *config);
+const char* sgnl_config_get_log_destination(const sgnl_config_t *config);
+const char* sgnl_config_get_log_format(const sgnl_config_t *config);
+bool sgnl_config_get_log_timestamp(const sgnl_config_t *config);
+bool sgnl_config_get_log_pid(const sgnl_config_t *config);
+const char* sgnl_config_get_log_facility(const sgnl_config_t *config);
+bool sgnl_config_get_log_async(const sgnl_config_t *config);
+int sgnl_config_get_log_async_buffer_kb(const sgnl_config_t *config);
+const char* sgnl_config_get_log_audit(const sgnl_config_t *config);
 
 // Convenience functions for common operations
 bool sgnl_config_is_valid(const sgnl_config_t *config);
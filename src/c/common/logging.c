@@ -1,13 +1,39 @@
 /*
- * SGNL Minimal Logging Implementation
+ * SGNL Logging Implementation
  *
- * Simple logging for the configuration system
+ * A record is formatted into one buffer for its destination: a text or
+ * JSON line for stdout, a message for syslog(3), or a datagram of
+ * KEY=VALUE fields for the journal. The async writer queues those buffers
+ * unchanged, so it never formats anything itself.
  */
 
 #include "logging.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <signal.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+// Longest message kept; the formatted record adds context and escaping
+#define RECORD_MESSAGE_MAX 4096
+#define RECORD_MAX 8192
+#define ASYNC_DEFAULT_SIZE (256 * 1024)
+#define JOURNAL_SOCKET "/run/systemd/journal/socket"
+
+typedef enum {
+    SINK_STDOUT,
+    SINK_STDERR,
+    SINK_SYSLOG,
+    SINK_JOURNALD
+} log_sink_t;
 
 // Global logger config with defaults
 sgnl_logger_config_t sgnl_logger_config = {
@@ -16,44 +42,584 @@ sgnl_logger_config_t sgnl_logger_config = {
     .structured_format = false,
     .include_timestamp = false,
     .include_pid = false,
-    .facility = "local0"
+    .facility = "local0",
+    .use_journald = false,
+    .async = false,
+    .async_buffer_size = 0,
+    .audit_destination = SGNL_AUDIT_SYSLOG
 };
 
-void sgnl_log_init(const sgnl_logger_config_t *config) {
-    if (config) {
-        sgnl_logger_config = *config;
+// sgnl_log_init copies the facility so callers may pass a temporary string
+static char logger_facility[16] = "local0";
+static int journal_fd = -1;
+static uint64_t dropped_records = 0;   // Queue overflows and refused journal sends
+
+// Users counted by sgnl_log_acquire; the last release tears logging down
+static pthread_mutex_t users_lock = PTHREAD_MUTEX_INITIALIZER;
+static int users = 0;
+
+// Records waiting for the background writer; each is a header and its bytes
+typedef struct {
+    int level;
+    int sink;
+    size_t length;
+} queued_record_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t idle;            // Signalled when the queue has been written out
+    char *buffer;
+    size_t size;
+    size_t tail;                    // Oldest queued byte
+    size_t used;
+    uint64_t dropped;               // Records that did not fit
+    uint64_t dropped_reported;
+    pthread_t thread;
+    pid_t owner;                    // Process running the thread (0 = none)
+    bool writing;                   // A dequeued record is being written
+    bool stopping;
+} writer = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .idle = PTHREAD_COND_INITIALIZER
+};
+
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+// ============================================================================
+// Record Formatting
+// ============================================================================
+
+typedef struct {
+    char *data;
+    size_t length;
+    size_t limit;                   // Appends stop here, leaving room to close the record
+} log_buffer_t;
+
+// Extra structured field of a record (audit records carry these)
+typedef struct {
+    const char *key;
+    const char *value;
+    bool number;                    // Emit unquoted in JSON
+} log_field_t;
+
+static void buffer_append(log_buffer_t *buffer, const char *text, size_t length) {
+    if (buffer->length + length > buffer->limit) {
+        length = buffer->limit - buffer->length;
     }
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
 }
 
-void sgnl_log_cleanup(void) {
-    // Nothing to cleanup in this minimal implementation
+static void buffer_append_string(log_buffer_t *buffer, const char *text) {
+    buffer_append(buffer, text, strlen(text));
 }
 
-void sgnl_log_with_context(sgnl_log_level_t level, 
-                          const sgnl_log_context_t *context,
-                          const char *format, ...) {
-    if (level > sgnl_logger_config.min_level) {
-        return;  // Log level too low
-    }
-    
+static void buffer_printf(log_buffer_t *buffer, const char *format, ...) {
+    char text[256];
     va_list args;
     va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length > 0) {
+        buffer_append(buffer, text, (size_t)length < sizeof(text) ? (size_t)length : sizeof(text) - 1);
+    }
+}
+
+// Quoted JSON string; an escape is never split by truncation
+static void buffer_append_json_string(log_buffer_t *buffer, const char *text) {
+    buffer_append(buffer, "\"", 1);
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++) {
+        char escaped[8];
+        size_t length;
+        switch (*c) {
+            case '"': memcpy(escaped, "\\\"", 2); length = 2; break;
+            case '\\': memcpy(escaped, "\\\\", 2); length = 2; break;
+            case '\n': memcpy(escaped, "\\n", 2); length = 2; break;
+            case '\r': memcpy(escaped, "\\r", 2); length = 2; break;
+            case '\t': memcpy(escaped, "\\t", 2); length = 2; break;
+            default:
+                if (*c < 0x20) {
+                    length = (size_t)snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                } else {
+                    escaped[0] = (char)*c;
+                    length = 1;
+                }
+        }
+        if (buffer->length + length + 1 > buffer->limit) {
+            break;
+        }
+        buffer_append(buffer, escaped, length);
+    }
+    buffer_append(buffer, "\"", 1);
+}
+
+static void buffer_append_timestamp(log_buffer_t *buffer) {
+    struct timeval now;
+    struct tm tm;
+    char text[32];
+    gettimeofday(&now, NULL);
+    gmtime_r(&now.tv_sec, &tm);
+    size_t length = strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(text + length, sizeof(text) - length, ".%03ldZ", (long)now.tv_usec / 1000);
+    buffer_append_string(buffer, text);
+}
+
+static void format_json(log_buffer_t *buffer, sgnl_log_level_t level, const sgnl_log_context_t *context,
+                        const log_field_t *extra, size_t extra_count, const char *message) {
+    const struct {
+        const char *key;
+        const char *value;
+    } fields[] = {
+        {"component", context && context->component ? context->component : "SGNL"},
+        {"function", context ? context->function : NULL},
+        {"request_id", context ? context->request_id : NULL},
+        {"principal_id", context ? context->principal_id : NULL},
+        {"asset_id", context ? context->asset_id : NULL},
+        {"action", context ? context->action : NULL}
+    };
     
-    // Simple output format: [COMPONENT] MESSAGE
-    if (context && context->component) {
-        printf("[%s] ", context->component);
+    buffer_append_string(buffer, "{");
+    if (sgnl_logger_config.include_timestamp) {
+        buffer_append_string(buffer, "\"timestamp\":\"");
+        buffer_append_timestamp(buffer);
+        buffer_append_string(buffer, "\",");
+    }
+    buffer_printf(buffer, "\"level\":\"%s\"", sgnl_log_level_to_string(level));
+    if (sgnl_logger_config.include_pid) {
+        buffer_printf(buffer, ",\"pid\":%ld", (long)getpid());
+    }
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        if (fields[i].value) {
+            buffer_printf(buffer, ",\"%s\":", fields[i].key);
+            buffer_append_json_string(buffer, fields[i].value);
+        }
+    }
+    for (size_t i = 0; i < extra_count; i++) {
+        buffer_printf(buffer, ",\"%s\":", extra[i].key);
+        if (extra[i].number) {
+            buffer_append_string(buffer, extra[i].value);
+        } else {
+            buffer_append_json_string(buffer, extra[i].value);
+        }
+    }
+    buffer_append_string(buffer, ",\"message\":");
+    buffer_append_json_string(buffer, message);
+    buffer->limit = RECORD_MAX - 2;
+    buffer_append_string(buffer, "}");
+}
+
+static void format_text(log_buffer_t *buffer, const sgnl_log_context_t *context, const char *message) {
+    buffer_printf(buffer, "[%s] ", context && context->component ? context->component : "SGNL");
+    buffer_append_string(buffer, message);
+}
+
+// One journal field; values holding a newline use the length-prefixed form
+static void journal_append_field(log_buffer_t *buffer, const char *key, const char *value) {
+    if (!value) {
+        return;
+    }
+    size_t key_length = strlen(key);
+    size_t length = strlen(value);
+    if (!strchr(value, '\n')) {
+        if (buffer->length + key_length + length + 2 <= buffer->limit) {
+            buffer_append(buffer, key, key_length);
+            buffer_append(buffer, "=", 1);
+            buffer_append(buffer, value, length);
+            buffer_append(buffer, "\n", 1);
+        }
+        return;
+    }
+    if (buffer->length + key_length + length + 10 <= buffer->limit) {
+        unsigned char size[8];
+        for (int i = 0; i < 8; i++) {
+            size[i] = (unsigned char)((uint64_t)length >> (8 * i));
+        }
+        buffer_append(buffer, key, key_length);
+        buffer_append(buffer, "\n", 1);
+        buffer_append(buffer, (const char *)size, sizeof(size));
+        buffer_append(buffer, value, length);
+        buffer_append(buffer, "\n", 1);
+    }
+}
+
+static void format_journal(log_buffer_t *buffer, sgnl_log_level_t level, const sgnl_log_context_t *context,
+                           const log_field_t *extra, size_t extra_count, const char *message) {
+    char number[16];
+    snprintf(number, sizeof(number), "%d", (int)level);
+    journal_append_field(buffer, "PRIORITY", number);
+    int facility = sgnl_log_facility_from_string(logger_facility);
+    snprintf(number, sizeof(number), "%d", (facility < 0 ? LOG_LOCAL0 : facility) >> 3);
+    journal_append_field(buffer, "SYSLOG_FACILITY", number);
+    journal_append_field(buffer, "SYSLOG_IDENTIFIER", "sgnl");
+    if (context) {
+        journal_append_field(buffer, "SGNL_COMPONENT", context->component);
+        journal_append_field(buffer, "CODE_FUNC", context->function);
+        journal_append_field(buffer, "SGNL_REQUEST_ID", context->request_id);
+        journal_append_field(buffer, "SGNL_PRINCIPAL_ID", context->principal_id);
+        journal_append_field(buffer, "SGNL_ASSET_ID", context->asset_id);
+        journal_append_field(buffer, "SGNL_ACTION", context->action);
+    }
+    for (size_t i = 0; i < extra_count; i++) {
+        char key[64] = "SGNL_";
+        for (size_t k = 0; extra[i].key[k] && k + 6 < sizeof(key); k++) {
+            key[k + 5] = (char)toupper((unsigned char)extra[i].key[k]);
+            key[k + 6] = '\0';
+        }
+        journal_append_field(buffer, key, extra[i].value);
+    }
+    
+    // The message goes last and is cut to what is left
+    char text[RECORD_MESSAGE_MAX + 64];
+    snprintf(text, sizeof(text), "[%s] %s", context && context->component ? context->component : "SGNL", message);
+    size_t room = buffer->limit - buffer->length;
+    size_t overhead = sizeof("MESSAGE") + 9;
+    if (room > overhead) {
+        if (strlen(text) > room - overhead) {
+            text[room - overhead] = '\0';
+        }
+        journal_append_field(buffer, "MESSAGE", text);
+    }
+}
+
+/**
+ * Format a record for sink into out (RECORD_MAX bytes)
+ *
+ * @return Length of the record; text and JSON records are also NUL-terminated
+ */
+static size_t format_record(log_sink_t sink, sgnl_log_level_t level, const sgnl_log_context_t *context,
+                            const log_field_t *extra, size_t extra_count, const char *message, char *out) {
+    // Room is kept for the closing brace, newline and NUL
+    log_buffer_t buffer = {.data = out, .length = 0, .limit = RECORD_MAX - 3};
+    
+    if (sink == SINK_JOURNALD) {
+        format_journal(&buffer, level, context, extra, extra_count, message);
+        return buffer.length;
+    }
+    
+    // syslog(3) is never opened, so the host program keeps its ident and the
+    // tag it would have added is part of the record
+    if (sink == SINK_SYSLOG) {
+        if (sgnl_logger_config.include_pid) {
+            buffer_printf(&buffer, "sgnl[%ld]: ", (long)getpid());
+        } else {
+            buffer_append_string(&buffer, "sgnl: ");
+        }
+    }
+    
+    if (sgnl_logger_config.structured_format) {
+        format_json(&buffer, level, context, extra, extra_count, message);
     } else {
-        printf("[SGNL] ");
+        // syslog(3) adds its own timestamp and the tag above carries the pid
+        if (sink != SINK_SYSLOG && sgnl_logger_config.include_timestamp) {
+            buffer_append_timestamp(&buffer);
+            buffer_append_string(&buffer, " ");
+        }
+        if (sink != SINK_SYSLOG && sgnl_logger_config.include_pid) {
+            buffer_printf(&buffer, "[%ld] ", (long)getpid());
+        }
+        format_text(&buffer, context, message);
     }
     
-    // Use default message if format is NULL or empty
-    if (!format || strlen(format) == 0) {
-        printf("Log message");
+    if (sink != SINK_SYSLOG) {
+        out[buffer.length++] = '\n';
+    }
+    out[buffer.length] = '\0';
+    return buffer.length;
+}
+
+// ============================================================================
+// Delivery
+// ============================================================================
+
+static log_sink_t current_sink(void) {
+    if (sgnl_logger_config.use_journald && journal_fd >= 0) {
+        return SINK_JOURNALD;
+    }
+    if (sgnl_logger_config.use_syslog || sgnl_logger_config.use_journald) {
+        return SINK_SYSLOG;
+    }
+    return SINK_STDOUT;
+}
+
+static log_sink_t audit_sink(void) {
+    switch (sgnl_logger_config.audit_destination) {
+        case SGNL_AUDIT_JOURNALD:
+            return journal_fd >= 0 ? SINK_JOURNALD : SINK_SYSLOG;
+        case SGNL_AUDIT_STDERR:
+            return SINK_STDERR;
+        case SGNL_AUDIT_STDOUT:
+            return SINK_STDOUT;
+        default:
+            return SINK_SYSLOG;
+    }
+}
+
+static void deliver(log_sink_t sink, int level, const char *record, size_t length) {
+    switch (sink) {
+        case SINK_JOURNALD: {
+            struct sockaddr_un address;
+            memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            memcpy(address.sun_path, JOURNAL_SOCKET, sizeof(JOURNAL_SOCKET));
+            if (sendto(journal_fd, record, length, MSG_NOSIGNAL,
+                       (const struct sockaddr *)&address, sizeof(address)) < 0) {
+                __atomic_fetch_add(&dropped_records, 1, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+        case SINK_SYSLOG: {
+            // The facility travels with the priority, so syslog(3) need not
+            // be opened and the host program's openlog() is left alone
+            int facility = sgnl_log_facility_from_string(logger_facility);
+            syslog((facility < 0 ? LOG_LOCAL0 : facility) | level, "%s", record);
+            break;
+        }
+        case SINK_STDOUT:
+            // stdio locks the stream for the call, so this is one uninterrupted line
+            fwrite(record, 1, length, stdout);
+            break;
+        case SINK_STDERR:
+            fwrite(record, 1, length, stderr);
+            break;
+    }
+}
+
+static void writer_report_dropped(uint64_t count) {
+    char message[64];
+    char record[RECORD_MAX];
+    sgnl_log_context_t context = {.component = "logging"};
+    snprintf(message, sizeof(message), "%llu log records dropped", (unsigned long long)count);
+    log_sink_t sink = current_sink();
+    size_t length = format_record(sink, SGNL_LOG_WARNING, &context, NULL, 0, message, record);
+    deliver(sink, SGNL_LOG_WARNING, record, length);
+}
+
+static void ring_copy_in(const void *data, size_t length) {
+    size_t start = (writer.tail + writer.used) % writer.size;
+    size_t first = writer.size - start < length ? writer.size - start : length;
+    memcpy(writer.buffer + start, data, first);
+    memcpy(writer.buffer, (const char *)data + first, length - first);
+    writer.used += length;
+}
+
+static void ring_copy_out(void *data, size_t length) {
+    size_t first = writer.size - writer.tail < length ? writer.size - writer.tail : length;
+    memcpy(data, writer.buffer + writer.tail, first);
+    memcpy((char *)data + first, writer.buffer, length - first);
+    writer.tail = (writer.tail + length) % writer.size;
+    writer.used -= length;
+}
+
+static void* writer_thread(void *arg) {
+    (void)arg;
+    char record[RECORD_MAX];
+    
+    pthread_mutex_lock(&writer.lock);
+    while (true) {
+        if (writer.used == 0 && writer.dropped == writer.dropped_reported) {
+            writer.writing = false;
+            pthread_cond_broadcast(&writer.idle);
+            if (writer.stopping) {
+                break;
+            }
+            pthread_cond_wait(&writer.wake, &writer.lock);
+            continue;
+        }
+    
+        queued_record_t header = {0};
+        if (writer.used > 0) {
+            ring_copy_out(&header, sizeof(header));
+            ring_copy_out(record, header.length);
+            record[header.length] = '\0';
+        }
+        writer.writing = true;
+        uint64_t unreported = writer.dropped - writer.dropped_reported;
+        writer.dropped_reported = writer.dropped;
+        pthread_mutex_unlock(&writer.lock);
+    
+        if (header.length > 0) {
+            deliver((log_sink_t)header.sink, header.level, record, header.length);
+        }
+        if (unreported > 0) {
+            writer_report_dropped(unreported);
+        }
+        pthread_mutex_lock(&writer.lock);
+    }
+    pthread_mutex_unlock(&writer.lock);
+    return NULL;
+}
+
+// The thread does not survive fork(); the child starts its own on demand
+static void writer_atfork_child(void) {
+    pthread_mutex_init(&writer.lock, NULL);
+    pthread_cond_init(&writer.wake, NULL);
+    pthread_cond_init(&writer.idle, NULL);
+    writer.tail = 0;
+    writer.used = 0;
+    writer.owner = 0;
+    writer.writing = false;
+    writer.stopping = false;
+}
+
+static void writer_register_atfork(void) {
+    pthread_atfork(NULL, NULL, writer_atfork_child);
+}
+
+// Called with writer.lock held
+static bool writer_start(void) {
+    if (!writer.buffer) {
+        size_t size = sgnl_logger_config.async_buffer_size ? sgnl_logger_config.async_buffer_size : ASYNC_DEFAULT_SIZE;
+        writer.buffer = malloc(size);
+        if (!writer.buffer) {
+            return false;
+        }
+        writer.size = size;
+        writer.tail = 0;
+        writer.used = 0;
+    }
+    
+    // Signals belong to the application's threads
+    sigset_t blocked, previous;
+    sigfillset(&blocked);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    int rc = pthread_create(&writer.thread, NULL, writer_thread, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (rc != 0) {
+        return false;
+    }
+    writer.owner = getpid();
+    return true;
+}
+
+/**
+ * Queue a record for the writer thread, starting it if this process has none
+ *
+ * @return false if there is no writer and the caller must write the record
+ */
+static bool writer_enqueue(log_sink_t sink, int level, const char *record, size_t length) {
+    queued_record_t header = {.level = level, .sink = (int)sink, .length = length};
+    
+    pthread_mutex_lock(&writer.lock);
+    if (writer.owner != getpid() && (writer.stopping || !writer_start())) {
+        pthread_mutex_unlock(&writer.lock);
+        return false;
+    }
+    if (writer.used + sizeof(header) + length <= writer.size) {
+        ring_copy_in(&header, sizeof(header));
+        ring_copy_in(record, length);
     } else {
-        vprintf(format, args);
+        writer.dropped++;
+        __atomic_fetch_add(&dropped_records, 1, __ATOMIC_RELAXED);
+    }
+    pthread_cond_signal(&writer.wake);
+    pthread_mutex_unlock(&writer.lock);
+    return true;
+}
+
+void sgnl_log_flush(void) {
+    pthread_mutex_lock(&writer.lock);
+    if (writer.owner == getpid()) {
+        while (writer.used > 0 || writer.writing) {
+            pthread_cond_wait(&writer.idle, &writer.lock);
+        }
+    }
+    pthread_mutex_unlock(&writer.lock);
+    fflush(stdout);
+}
+
+// Write out everything queued and stop the writer thread
+static void writer_stop(void) {
+    pthread_mutex_lock(&writer.lock);
+    if (writer.owner != getpid()) {
+        pthread_mutex_unlock(&writer.lock);
+        return;
+    }
+    writer.stopping = true;
+    pthread_cond_signal(&writer.wake);
+    pthread_mutex_unlock(&writer.lock);
+    
+    pthread_join(writer.thread, NULL);
+    
+    pthread_mutex_lock(&writer.lock);
+    writer.owner = 0;
+    writer.stopping = false;
+    free(writer.buffer);
+    writer.buffer = NULL;
+    writer.size = 0;
+    pthread_mutex_unlock(&writer.lock);
+}
+
+// ============================================================================
+// Public Interface
+// ============================================================================
+
+void sgnl_log_init(const sgnl_logger_config_t *config) {
+    if (config) {
+        sgnl_logger_config = *config;
+    }
+    if (sgnl_logger_config.facility && sgnl_logger_config.facility != logger_facility) {
+        snprintf(logger_facility, sizeof(logger_facility), "%s", sgnl_logger_config.facility);
     }
-    printf("\n");
+    sgnl_logger_config.facility = logger_facility;
     
+    if (sgnl_logger_config.async) {
+        pthread_once(&atfork_once, writer_register_atfork);
+    }
+    
+    // Without a journal (not systemd, or a container) records go to syslog
+    struct stat st;
+    bool journal_wanted = sgnl_logger_config.use_journald ||
+                          sgnl_logger_config.audit_destination == SGNL_AUDIT_JOURNALD;
+    if (journal_wanted && journal_fd < 0 &&
+        stat(JOURNAL_SOCKET, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        journal_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    }
+}
+
+void sgnl_log_cleanup(void) {
+    writer_stop();
+    fflush(stdout);
+    if (journal_fd >= 0) {
+        close(journal_fd);
+        journal_fd = -1;
+    }
+}
+
+void sgnl_log_acquire(const sgnl_logger_config_t *config) {
+    pthread_mutex_lock(&users_lock);
+    users++;
+    sgnl_log_init(config);
+    pthread_mutex_unlock(&users_lock);
+}
+
+bool sgnl_log_release(void) {
+    pthread_mutex_lock(&users_lock);
+    bool last = users > 0 && --users == 0;
+    if (last) {
+        sgnl_log_cleanup();
+    }
+    pthread_mutex_unlock(&users_lock);
+    return last;
+}
+
+static void log_emit(log_sink_t sink, sgnl_log_level_t level, const sgnl_log_context_t *context,
+                     const log_field_t *extra, size_t extra_count, const char *message) {
+    char record[RECORD_MAX];
+    size_t length = format_record(sink, level, context, extra, extra_count, message, record);
+    if (sgnl_logger_config.async && writer_enqueue(sink, (int)level, record, length)) {
+        return;
+    }
+    deliver(sink, (int)level, record, length);
+}
+
+void sgnl_log_with_context(sgnl_log_level_t level,
+                          const sgnl_log_context_t *context,
+                          const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    sgnl_log_with_context_v(level, context, format, args);
     va_end(args);
 }
 
@@ -61,22 +627,56 @@ void sgnl_log_with_context_v(sgnl_log_level_t level,
                             const sgnl_log_context_t *context,
                             const char *format, va_list args) {
     if (level > sgnl_logger_config.min_level) {
-        return;
+        return;  // Log level too low
     }
     
-    if (context && context->component) {
-        printf("[%s] ", context->component);
+    // Use default message if format is NULL or empty
+    char message[RECORD_MESSAGE_MAX];
+    if (!format || format[0] == '\0') {
+        strcpy(message, "Log message");
     } else {
-        printf("[SGNL] ");
+        vsnprintf(message, sizeof(message), format, args);
     }
     
-    // Use default message if format is NULL or empty
-    if (!format || strlen(format) == 0) {
-        printf("Log message");
-    } else {
-        vprintf(format, args);
+    log_emit(current_sink(), level, context, NULL, 0, message);
+}
+
+uint64_t sgnl_log_dropped_count(void) {
+    return __atomic_load_n(&dropped_records, __ATOMIC_RELAXED);
+}
+
+int sgnl_log_facility_from_string(const char *name) {
+    static const struct {
+        const char *name;
+        int facility;
+    } facilities[] = {
+        {"auth", LOG_AUTH}, {"authpriv", LOG_AUTHPRIV}, {"daemon", LOG_DAEMON}, {"user", LOG_USER},
+        {"local0", LOG_LOCAL0}, {"local1", LOG_LOCAL1}, {"local2", LOG_LOCAL2}, {"local3", LOG_LOCAL3},
+        {"local4", LOG_LOCAL4}, {"local5", LOG_LOCAL5}, {"local6", LOG_LOCAL6}, {"local7", LOG_LOCAL7}
+    };
+    if (!name) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(facilities) / sizeof(facilities[0]); i++) {
+        if (strcmp(name, facilities[i].name) == 0) {
+            return facilities[i].facility;
+        }
+    }
+    return -1;
+}
+
+int sgnl_audit_destination_from_string(const char *name) {
+    // In sgnl_audit_destination_t order
+    static const char *names[] = {"syslog", "journald", "stderr", "stdout", "none"};
+    if (!name) {
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return (int)i;
+        }
     }
-    printf("\n");
+    return -1;
 }
 
 const char* sgnl_log_level_to_string(sgnl_log_level_t level) {
@@ -112,17 +712,158 @@ bool sgnl_log_level_enabled(sgnl_log_level_t level) {
     return level <= sgnl_logger_config.min_level;
 }
 
-// Request tracking stubs (not implemented)
+// ============================================================================
+// Request Tracking
+// ============================================================================
+
+// Innermost open tracker of this thread
+static __thread sgnl_request_tracker_t *current_tracker = NULL;
+static uint32_t tracker_sequence = 0;
+
+static int64_t monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
 sgnl_request_tracker_t* sgnl_request_start(const char *principal_id,
                                           const char *asset_id,
                                           const char *action) {
-    (void)principal_id;
-    (void)asset_id;
-    (void)action;
-    return NULL;
+    sgnl_request_tracker_t *tracker = calloc(1, sizeof(*tracker));
+    if (!tracker) {
+        return NULL;
+    }
+    
+    snprintf(tracker->principal_id, sizeof(tracker->principal_id), "%s", principal_id ? principal_id : "");
+    snprintf(tracker->asset_id, sizeof(tracker->asset_id), "%s", asset_id ? asset_id : "");
+    snprintf(tracker->action, sizeof(tracker->action), "%s", action ? action : "");
+    tracker->start_time = time(NULL);
+    tracker->start_us = monotonic_us();
+    snprintf(tracker->request_id, sizeof(tracker->request_id), "%08lx-%05x-%04x",
+             (unsigned long)tracker->start_time, (unsigned)getpid() & 0xfffff,
+             __atomic_add_fetch(&tracker_sequence, 1, __ATOMIC_RELAXED) & 0xffff);
+    strcpy(tracker->source, "none");
+    tracker->queries = 1;
+    
+    tracker->outer = current_tracker;
+    current_tracker = tracker;
+    return tracker;
+}
+
+void sgnl_request_set_source(sgnl_request_tracker_t *tracker, const char *source) {
+    if (tracker && source) {
+        snprintf(tracker->source, sizeof(tracker->source), "%s", source);
+    }
+}
+
+void sgnl_request_set_id(sgnl_request_tracker_t *tracker, const char *request_id) {
+    if (tracker && request_id && request_id[0] != '\0') {
+        snprintf(tracker->request_id, sizeof(tracker->request_id), "%s", request_id);
+    }
+}
+
+// Outcome of a nested tracker, as seen by the caller that opened the outer one
+static void request_hand_to_outer(const sgnl_request_tracker_t *tracker, sgnl_request_tracker_t *outer) {
+    strcpy(outer->request_id, tracker->request_id);
+    if (strcmp(tracker->source, "none") != 0) {
+        strcpy(outer->source, tracker->source);
+    }
+    if (tracker->result[0] != '\0') {
+        strcpy(outer->result, tracker->result);
+    }
+    if (outer->asset_id[0] == '\0') {
+        strcpy(outer->asset_id, tracker->asset_id);
+    }
+    if (outer->action[0] == '\0') {
+        strcpy(outer->action, tracker->action);
+    }
+    outer->queries = tracker->queries;
+}
+
+// A logfmt value: bare when it is one plain token, otherwise a quoted JSON
+// string, so no value can end its field early or start another record
+static const char* logfmt_value(const char *value, char *quoted, size_t size) {
+    bool plain = value[0] != '\0';
+    for (const unsigned char *c = (const unsigned char *)value; plain && *c; c++) {
+        plain = *c > ' ' && *c != '"' && *c != '=' && *c != '\\' && *c != 0x7f;
+    }
+    if (plain) {
+        return value;
+    }
+    log_buffer_t buffer = {.data = quoted, .length = 0, .limit = size - 1};
+    buffer_append_json_string(&buffer, value);
+    quoted[buffer.length] = '\0';
+    return quoted;
 }
 
 void sgnl_request_end(sgnl_request_tracker_t *tracker, const char *result) {
-    (void)tracker;
-    (void)result;
-} 
\ No newline at end of file
+    if (!tracker) {
+        return;
+    }
+    if (result) {
+        snprintf(tracker->result, sizeof(tracker->result), "%s", result);
+    }
+    if (current_tracker == tracker) {
+        current_tracker = tracker->outer;
+    }
+    
+    if (tracker->outer) {
+        request_hand_to_outer(tracker, tracker->outer);
+        free(tracker);
+        return;
+    }
+    
+    // The audit trail has its own destination and ignores the log level
+    if (sgnl_logger_config.audit_destination != SGNL_AUDIT_NONE) {
+        int64_t duration_us = monotonic_us() - tracker->start_us;
+        char duration[24];
+        char queries[16];
+        snprintf(duration, sizeof(duration), "%lld", (long long)duration_us);
+        snprintf(queries, sizeof(queries), "%d", tracker->queries);
+        const char *outcome = tracker->result[0] != '\0' ? tracker->result : "Unknown";
+        
+        sgnl_log_context_t context = {
+            .component = "audit",
+            .request_id = tracker->request_id,
+            .principal_id = tracker->principal_id,
+            .asset_id = tracker->asset_id[0] != '\0' ? tracker->asset_id : NULL,
+            .action = tracker->action[0] != '\0' ? tracker->action : NULL
+        };
+        const log_field_t fields[] = {
+            {"result", outcome, false},
+            {"source", tracker->source, false},
+            {"duration_us", duration, true},
+            {"queries", queries, true}
+        };
+        
+        // JSON records carry every value as a field; text gets them in the message
+        char message[2048];
+        if (sgnl_logger_config.structured_format) {
+            strcpy(message, "Access decision");
+        } else {
+            char principal[600];
+            char asset[600];
+            char action[160];
+            char outcome_quoted[80];
+            char request_id[160];
+            int length = snprintf(message, sizeof(message),
+                                  "principal=%s asset=%s action=%s result=%s source=%s duration_ms=%.3f",
+                                  logfmt_value(tracker->principal_id, principal, sizeof(principal)),
+                                  logfmt_value(tracker->asset_id, asset, sizeof(asset)),
+                                  logfmt_value(tracker->action, action, sizeof(action)),
+                                  logfmt_value(outcome, outcome_quoted, sizeof(outcome_quoted)),
+                                  tracker->source, (double)duration_us / 1000.0);
+            if (length > 0 && (size_t)length < sizeof(message)) {
+                if (tracker->queries > 1) {
+                    length += snprintf(message + length, sizeof(message) - (size_t)length, " queries=%d", tracker->queries);
+                }
+                if ((size_t)length < sizeof(message)) {
+                    snprintf(message + length, sizeof(message) - (size_t)length, " request_id=%s",
+                             logfmt_value(tracker->request_id, request_id, sizeof(request_id)));
+                }
+            }
+        }
+        log_emit(audit_sink(), SGNL_LOG_INFO, &context, fields, sizeof(fields) / sizeof(fields[0]), message);
+    }
+    free(tracker);
+}
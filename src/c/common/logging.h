@@ -2,6 +2,13 @@
  * SGNL Unified Logging System
  *
  * Structured logging with levels, contexts, and consistent formatting
+ *
+ * Records go to stdout, syslog or the systemd journal, as plain text or one
+ * JSON object per line. Each record is formatted once and written with a
+ * single call, so records from concurrent threads never interleave. With
+ * async enabled the caller only copies the record into a ring buffer and a
+ * background thread writes it; a full buffer drops records (counted, and
+ * reported once there is room) rather than blocking the caller.
  */
 
 #ifndef SGNL_LOGGING_H
@@ -9,6 +16,8 @@
 
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 // Log levels (matching syslog levels)
@@ -33,14 +42,27 @@ typedef struct {
     const char *action;         // Action being performed
 } sgnl_log_context_t;
 
+// Where audit records go, independent of the other log output
+typedef enum {
+    SGNL_AUDIT_SYSLOG = 0,          // syslog(3) with the configured facility (default)
+    SGNL_AUDIT_JOURNALD,            // Native journal protocol; syslog when no journal runs
+    SGNL_AUDIT_STDERR,
+    SGNL_AUDIT_STDOUT,              // Mixes with the output of the calling program
+    SGNL_AUDIT_NONE
+} sgnl_audit_destination_t;
+
 // Logger configuration
 typedef struct {
     sgnl_log_level_t min_level;     // Minimum level to log
-    bool use_syslog;                // Use syslog vs stderr
+    bool use_syslog;                // Use syslog vs stdout
     bool structured_format;         // JSON vs plain text
     bool include_timestamp;         // Include timestamp in output
     bool include_pid;               // Include process ID
-    const char *facility;           // Syslog facility name
+    const char *facility;           // Syslog facility name (copied by sgnl_log_init)
+    bool use_journald;              // Native journal protocol; syslog when no journal runs
+    bool async;                     // Write records from a background thread
+    size_t async_buffer_size;       // Bytes queued before records are dropped (0 = 256 KiB)
+    sgnl_audit_destination_t audit_destination;
 } sgnl_logger_config_t;
 
 // Global logger instance
@@ -50,6 +72,20 @@ extern sgnl_logger_config_t sgnl_logger_config;
 void sgnl_log_init(const sgnl_logger_config_t *config);
 void sgnl_log_cleanup(void);
 
+/**
+ * Configure logging for one of several users in the process (each libsgnl
+ * client) and count it. The latest configuration applies to all of them.
+ */
+void sgnl_log_acquire(const sgnl_logger_config_t *config);
+
+/**
+ * Drop a reference taken by sgnl_log_acquire. The last user out runs
+ * sgnl_log_cleanup; until then the writer thread and journal socket stay.
+ *
+ * @return true if this was the last user and logging was shut down
+ */
+bool sgnl_log_release(void);
+
 void sgnl_log_with_context(sgnl_log_level_t level, 
                           const sgnl_log_context_t *context,
                           const char *format, ...);
@@ -80,20 +116,88 @@ void sgnl_log_with_context_v(sgnl_log_level_t level,
         sgnl_log_with_context(SGNL_LOG_DEBUG, (ctx), fmt, ##__VA_ARGS__); } while(0)
 
 // Request tracking helpers
-typedef struct {
+//
+// A tracker times one access decision on the monotonic clock and, when it
+// ends, emits a single INFO audit record from component "audit" to the
+// audit destination (syslog unless configured otherwise, so the output of
+// sudo'ed commands is never mixed with it), whatever the log level:
+//   principal=alice asset=host1 action=sudo result="Access Allowed" source=cache duration_ms=0.214
+// Values that are not a plain token are quoted and escaped as JSON strings.
+// A tracker started while another is open on the same thread (libsgnl
+// inside the PAM module or sudo plugin) is nested: ending it hands its
+// request ID, source and result to the outer tracker instead of logging, so
+// each decision yields one record timed end to end.
+typedef struct sgnl_request_tracker {
     char request_id[64];
     char principal_id[256];
     char asset_id[256];
     char action[64];
     time_t start_time;
+    int64_t start_us;               // Monotonic clock
+    char source[16];                // Where the decision came from ("cache", "network", ...)
+    char result[32];
+    int queries;                    // Decisions covered; batch checks cover several
+    struct sgnl_request_tracker *outer;
 } sgnl_request_tracker_t;
 
+/**
+ * Start timing a decision
+ *
+ * @return The tracker, NULL if out of memory (the other tracker functions accept NULL)
+ */
 sgnl_request_tracker_t* sgnl_request_start(const char *principal_id,
                                           const char *asset_id,
                                           const char *action);
+
+/**
+ * Record where the decision came from: "cache", "snapshot", "broker",
+ * "network" or "offline"
+ */
+void sgnl_request_set_source(sgnl_request_tracker_t *tracker, const char *source);
+
+/**
+ * Replace the generated request ID, e.g. with the one sent to the API
+ */
+void sgnl_request_set_id(sgnl_request_tracker_t *tracker, const char *request_id);
+
+/**
+ * Emit the audit record (or hand the outcome to the outer tracker) and
+ * free the tracker
+ *
+ * @param result Outcome to report; NULL keeps the one a nested tracker reported
+ */
 void sgnl_request_end(sgnl_request_tracker_t *tracker, 
                      const char *result);
 
+/**
+ * Wait until the async writer has written every queued record. Call before
+ * fork() when the parent is about to exit: the child does not inherit the
+ * queue.
+ */
+void sgnl_log_flush(void);
+
+/**
+ * Number of records dropped so far because the async buffer was full or
+ * the journal refused them
+ */
+uint64_t sgnl_log_dropped_count(void);
+
+/**
+ * Syslog facility code for a name ("auth", "authpriv", "daemon", "user",
+ * "local0" to "local7")
+ *
+ * @return The LOG_* facility value, -1 if the name is unknown
+ */
+int sgnl_log_facility_from_string(const char *name);
+
+/**
+ * Audit destination for a name ("syslog", "journald", "stderr", "stdout",
+ * "none")
+ *
+ * @return The destination, -1 if the name is unknown
+ */
+int sgnl_audit_destination_from_string(const char *name);
+
 // Level utilities
 const char* sgnl_log_level_to_string(sgnl_log_level_t level);
 sgnl_log_level_t sgnl_log_level_from_string(const char *level_str);
@@ -0,0 +1,694 @@
+/**
+ * SGNL Decision Broker Daemon (sgnld)
+ *
+ * Long-running process that owns the HTTP connections to SGNL and the
+ * decision cache, and answers access evaluations from the PAM module and
+ * sudo plugin over a root-only Unix domain socket (see lib/broker.h).
+ * Clients fall back to calling SGNL directly when the broker is absent.
+ *
+ * With the "prefetch" config block enabled, a background thread keeps the
+ * allowed assets of active principals (logged-in users, members of a
+ * configured group) warm via /access/v2/search, so their evaluations are
+ * answered from memory.
+ *
+ * With "metrics.textfile_path" set, the client's counters and per-phase
+ * latency percentiles are written there every interval in the Prometheus
+ * text format, for node_exporter's textfile collector.
+ *
+ * Usage: sgnld [-c config_path] [-s socket_path] [-d]
+ *
+ * Signals: SIGTERM/SIGINT stop the broker, SIGHUP flushes the decision cache
+ * and prefetched snapshots.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <utmpx.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+// SGNL library and common modules
+#include "../lib/libsgnl.h"
+#include "../lib/broker.h"
+#include "../common/config.h"
+#include "../common/logging.h"
+
+// Upper bound on connections being served at once; extra clients are
+// turned away and evaluate directly
+#define SGNLD_MAX_CONNECTIONS   64
+
+// How long a connected client may take to send its request
+#define SGNLD_CLIENT_TIMEOUT_MS 2000
+
+// Broker state
+static struct {
+    sgnl_client_t *client;          // Shared by all connection threads
+    pthread_mutex_t count_lock;
+    int active_connections;
+    int listen_fd;
+} broker = {
+    .count_lock = PTHREAD_MUTEX_INITIALIZER,
+    .listen_fd = -1
+};
+
+// Background entitlement prefetch
+static struct {
+    bool enabled;
+    int interval_seconds;
+    char group[64];
+    bool logged_in_users;
+    int max_principals;
+    pthread_t thread;
+    bool running;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;                  // Guarded by lock
+} prefetch = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER
+};
+
+// Periodic Prometheus textfile export of the client's statistics
+static struct {
+    char textfile_path[256];        // "" = disabled
+    int interval_seconds;
+    pthread_t thread;
+    bool running;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;                  // Guarded by lock
+} metrics = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+static volatile sig_atomic_t flush_requested = 0;
+
+static void handle_stop(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static void handle_flush(int sig) {
+    (void)sig;
+    flush_requested = 1;
+}
+
+static void install_signal_handlers(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+
+    // No SA_RESTART: accept() must return EINTR so the loop sees the flags
+    sa.sa_handler = handle_stop;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    sa.sa_handler = handle_flush;
+    sigaction(SIGHUP, &sa, NULL);
+
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+}
+
+/**
+ * Evaluate one decoded request and send the response
+ */
+static void serve_request(int fd, const sgnl_broker_request_t *req) {
+    sgnl_result_t status = SGNL_OK;
+    sgnl_access_result_t *single = NULL;
+    sgnl_access_result_t **results = NULL;
+
+    if (req->count == 1) {
+        single = sgnl_evaluate_access(broker.client, req->principal_id,
+                                      req->asset_ids[0], req->actions[0]);
+        results = single ? &single : NULL;
+    } else {
+        results = sgnl_evaluate_access_batch(broker.client, req->principal_id,
+                                             (const char **)req->asset_ids,
+                                             (const char **)req->actions, req->count);
+    }
+
+    if (!results) {
+        status = SGNL_ERROR;
+    }
+
+    sgnl_broker_write_response(fd, status, results, req->count);
+
+    if (single) {
+        sgnl_access_result_free(single);
+    } else if (results) {
+        sgnl_access_result_array_free(results, req->count);
+    }
+}
+
+static void* connection_thread(void *arg) {
+    int fd = (int)(intptr_t)arg;
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+
+    // Only root may ask for decisions: both the PAM module (sshd, login) and
+    // the sudo plugin run with an effective UID of 0
+    if (!sgnl_broker_peer_is_root(fd)) {
+        SGNL_LOG_WARNING(&log_ctx, "Rejected connection from non-root peer");
+    } else {
+        sgnl_broker_request_t req;
+        if (sgnl_broker_read_request(fd, &req)) {
+            SGNL_LOG_DEBUG(&log_ctx, "Evaluating %d quer%s for principal=%s",
+                           req.count, req.count == 1 ? "y" : "ies", req.principal_id);
+            serve_request(fd, &req);
+            sgnl_broker_request_free(&req);
+        } else {
+            SGNL_LOG_WARNING(&log_ctx, "Discarding malformed broker request");
+        }
+    }
+
+    close(fd);
+
+    pthread_mutex_lock(&broker.count_lock);
+    broker.active_connections--;
+    pthread_mutex_unlock(&broker.count_lock);
+    return NULL;
+}
+
+static void dispatch_connection(int fd) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+
+    pthread_mutex_lock(&broker.count_lock);
+    bool accepted = broker.active_connections < SGNLD_MAX_CONNECTIONS;
+    if (accepted) {
+        broker.active_connections++;
+    }
+    pthread_mutex_unlock(&broker.count_lock);
+
+    if (!accepted) {
+        SGNL_LOG_WARNING(&log_ctx, "Connection limit reached, client will evaluate directly");
+        close(fd);
+        return;
+    }
+
+    struct timeval tv = {
+        .tv_sec = SGNLD_CLIENT_TIMEOUT_MS / 1000,
+        .tv_usec = (SGNLD_CLIENT_TIMEOUT_MS % 1000) * 1000
+    };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, connection_thread, (void *)(intptr_t)fd) != 0) {
+        // Serve inline rather than drop the client
+        connection_thread((void *)(intptr_t)fd);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+typedef struct {
+    char **names;
+    int count;
+    int capacity;
+} principal_list_t;
+
+static void principal_list_add(principal_list_t *list, const char *name) {
+    if (!name || !*name || list->count >= list->capacity) {
+        return;
+    }
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->names[i], name) == 0) {
+            return;
+        }
+    }
+    char *copy = strdup(name);
+    if (copy) {
+        list->names[list->count++] = copy;
+    }
+}
+
+static void principal_list_free(principal_list_t *list) {
+    for (int i = 0; i < list->count; i++) {
+        free(list->names[i]);
+    }
+    free(list->names);
+    list->names = NULL;
+    list->count = 0;
+}
+
+static void add_group_members(principal_list_t *list, const char *group_name) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    struct group grp;
+    struct group *found = NULL;
+    size_t size = 16384;
+    char *buf = NULL;
+    int rc;
+
+    // Large groups need a larger buffer than sysconf suggests
+    do {
+        char *grown = realloc(buf, size);
+        if (!grown) {
+            free(buf);
+            return;
+        }
+        buf = grown;
+        rc = getgrnam_r(group_name, &grp, buf, size, &found);
+        size *= 2;
+    } while (rc == ERANGE && size <= 1024 * 1024);
+
+    if (rc != 0 || !found) {
+        SGNL_LOG_WARNING(&log_ctx, "Prefetch group %s not found", group_name);
+    } else {
+        for (char **member = grp.gr_mem; *member; member++) {
+            principal_list_add(list, *member);
+        }
+    }
+    free(buf);
+}
+
+/**
+ * Principals worth keeping warm: users with a login session and members of
+ * the configured group, capped at max_principals
+ */
+static bool collect_active_principals(principal_list_t *list) {
+    list->names = calloc((size_t)prefetch.max_principals, sizeof(char *));
+    list->count = 0;
+    list->capacity = prefetch.max_principals;
+    if (!list->names) {
+        return false;
+    }
+
+    if (prefetch.logged_in_users) {
+        setutxent();
+        struct utmpx *entry;
+        while ((entry = getutxent()) != NULL) {
+            if (entry->ut_type != USER_PROCESS) {
+                continue;
+            }
+            char user[sizeof(entry->ut_user) + 1];
+            memcpy(user, entry->ut_user, sizeof(entry->ut_user));
+            user[sizeof(entry->ut_user)] = '\0';
+            principal_list_add(list, user);
+        }
+        endutxent();
+    }
+
+    if (prefetch.group[0]) {
+        add_group_members(list, prefetch.group);
+    }
+    return true;
+}
+
+/**
+ * Sleep up to ms, returning early (true) once *stopping is set under lock
+ */
+static bool background_wait(pthread_mutex_t *lock, pthread_cond_t *wake, const bool *stopping, int64_t ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(ms / 1000);
+    deadline.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(lock);
+    while (!*stopping) {
+        if (pthread_cond_timedwait(wake, lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool stopped = *stopping;
+    pthread_mutex_unlock(lock);
+    return stopped;
+}
+
+static bool prefetch_wait(int64_t ms) {
+    return background_wait(&prefetch.lock, &prefetch.wake, &prefetch.stopping, ms);
+}
+
+/**
+ * Start a long-lived helper thread. The main thread must keep receiving the
+ * stop and flush signals so accept() is interrupted; helpers block them.
+ */
+static int background_start(pthread_t *thread, void *(*run)(void *)) {
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGTERM);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+    int rc = pthread_create(thread, NULL, run, NULL);
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    return rc;
+}
+
+/**
+ * Refresh one principal at a time, spread evenly over the interval, so the
+ * snapshot is renewed incrementally rather than in bursts against SGNL
+ */
+static void* prefetch_thread(void *arg) {
+    (void)arg;
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    int64_t interval_ms = (int64_t)prefetch.interval_seconds * 1000;
+    bool stopping = false;
+
+    while (!stopping) {
+        principal_list_t list = {0};
+        if (!collect_active_principals(&list)) {
+            stopping = prefetch_wait(interval_ms);
+            continue;
+        }
+
+        // Users who logged out since the last pass no longer need a snapshot
+        sgnl_client_snapshot_retain(broker.client, (const char **)list.names, list.count);
+
+        int refreshed = 0;
+        int64_t step_ms = list.count > 0 ? interval_ms / list.count : interval_ms;
+        for (int i = 0; i < list.count && !stopping; i++) {
+            if (sgnl_client_snapshot_refresh(broker.client, list.names[i]) == SGNL_OK) {
+                refreshed++;
+            }
+            stopping = prefetch_wait(step_ms);
+        }
+        if (list.count == 0) {
+            stopping = prefetch_wait(interval_ms);
+        }
+
+        if (refreshed < list.count && !stopping) {
+            SGNL_LOG_WARNING(&log_ctx, "Prefetch pass refreshed %d of %d principals", refreshed, list.count);
+        } else {
+            SGNL_LOG_DEBUG(&log_ctx, "Prefetch pass refreshed %d principal(s)", refreshed);
+        }
+        principal_list_free(&list);
+    }
+    return NULL;
+}
+
+static void prefetch_start(void) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    if (!prefetch.enabled) {
+        return;
+    }
+    if (background_start(&prefetch.thread, prefetch_thread) != 0) {
+        SGNL_LOG_WARNING(&log_ctx, "Failed to start entitlement prefetch; evaluating on demand");
+        return;
+    }
+    prefetch.running = true;
+    SGNL_LOG_INFO(&log_ctx, "Entitlement prefetch every %d seconds", prefetch.interval_seconds);
+}
+
+static void prefetch_stop(void) {
+    if (!prefetch.running) {
+        return;
+    }
+    pthread_mutex_lock(&prefetch.lock);
+    prefetch.stopping = true;
+    pthread_cond_broadcast(&prefetch.wake);
+    pthread_mutex_unlock(&prefetch.lock);
+    pthread_join(prefetch.thread, NULL);
+    prefetch.running = false;
+}
+
+/**
+ * Rewrite the metrics file every interval, and once more when stopping so
+ * the last counts of this run are not lost
+ */
+static void* metrics_thread(void *arg) {
+    (void)arg;
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    bool failing = false;
+    bool stopping = false;
+
+    while (true) {
+        bool ok = sgnl_client_write_metrics(broker.client, metrics.textfile_path) == SGNL_OK;
+        if (!ok && !failing) {
+            SGNL_LOG_WARNING(&log_ctx, "Failed to write metrics to %s", metrics.textfile_path);
+        }
+        failing = !ok;
+        if (stopping) {
+            break;
+        }
+        stopping = background_wait(&metrics.lock, &metrics.wake, &metrics.stopping,
+                                   (int64_t)metrics.interval_seconds * 1000);
+    }
+    return NULL;
+}
+
+static void metrics_start(void) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    if (metrics.textfile_path[0] == '\0') {
+        return;
+    }
+    if (background_start(&metrics.thread, metrics_thread) != 0) {
+        SGNL_LOG_WARNING(&log_ctx, "Failed to start metrics export");
+        return;
+    }
+    metrics.running = true;
+    SGNL_LOG_INFO(&log_ctx, "Writing metrics to %s every %d seconds", metrics.textfile_path, metrics.interval_seconds);
+}
+
+static void metrics_stop(void) {
+    if (!metrics.running) {
+        return;
+    }
+    pthread_mutex_lock(&metrics.lock);
+    metrics.stopping = true;
+    pthread_cond_broadcast(&metrics.wake);
+    pthread_mutex_unlock(&metrics.lock);
+    pthread_join(metrics.thread, NULL);
+    metrics.running = false;
+}
+
+/**
+ * Create the listening socket, replacing a stale one left by a previous run
+ */
+static int open_listen_socket(const char *socket_path) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+    struct sockaddr_un addr;
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        SGNL_LOG_ERROR(&log_ctx, "Socket path too long: %s", socket_path);
+        return -1;
+    }
+
+    // Create the parent directory (e.g. /run/sgnl) if needed
+    char dir[sizeof(addr.sun_path)];
+    strncpy(dir, socket_path, sizeof(dir) - 1);
+    dir[sizeof(dir) - 1] = '\0';
+    char *slash = strrchr(dir, '/');
+    if (slash && slash != dir) {
+        *slash = '\0';
+        if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+            SGNL_LOG_ERROR(&log_ctx, "Cannot create %s: %s", dir, strerror(errno));
+            return -1;
+        }
+
+        // Clients ignore a broker whose socket others could replace
+        struct stat dir_st;
+        if (stat(dir, &dir_st) == 0 && (dir_st.st_uid != 0 || (dir_st.st_mode & (S_IWGRP | S_IWOTH)))) {
+            SGNL_LOG_WARNING(&log_ctx, "%s is not writable by root alone; clients will not use this broker", dir);
+        }
+    }
+
+    struct stat st;
+    if (lstat(socket_path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            SGNL_LOG_ERROR(&log_ctx, "Refusing to replace non-socket %s", socket_path);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        SGNL_LOG_ERROR(&log_ctx, "socket() failed: %s", strerror(errno));
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, socket_path, strlen(socket_path) + 1);
+
+    // Create the socket node root-only from the start
+    mode_t old_umask = umask(077);
+    int rc = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old_umask);
+
+    if (rc != 0 || listen(fd, SGNLD_MAX_CONNECTIONS) != 0) {
+        SGNL_LOG_ERROR(&log_ctx, "Cannot listen on %s: %s", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-c config_path] [-s socket_path] [-d]\n", prog);
+    fprintf(stderr, "  -c  Configuration file (default: %s)\n", SGNL_DEFAULT_CONFIG);
+    fprintf(stderr, "  -s  Socket path (default: broker.socket_path from config)\n");
+    fprintf(stderr, "  -d  Detach and run in the background\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *config_path = NULL;
+    const char *socket_override = NULL;
+    bool detach = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:s:dh")) != -1) {
+        switch (opt) {
+            case 'c':
+                config_path = optarg;
+                break;
+            case 's':
+                socket_override = optarg;
+                break;
+            case 'd':
+                detach = true;
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("sgnld");
+
+    // Read the broker section for the socket path
+    sgnl_config_t *config = sgnl_config_create();
+    if (!config) {
+        fprintf(stderr, "sgnld: out of memory\n");
+        return 1;
+    }
+
+    sgnl_config_options_t options = SGNL_CONFIG_DEFAULT_OPTIONS;
+    options.config_path = config_path;
+    options.module_name = "sgnld";
+
+    sgnl_config_result_t config_result = sgnl_config_load(config, &options);
+    if (config_result != SGNL_CONFIG_OK) {
+        fprintf(stderr, "sgnld: failed to load config: %s\n", sgnl_config_result_to_string(config_result));
+        sgnl_config_destroy(config);
+        return 1;
+    }
+
+    char socket_path[108];
+    snprintf(socket_path, sizeof(socket_path), "%s",
+             socket_override ? socket_override : sgnl_config_get_broker_socket_path(config));
+
+    prefetch.enabled = sgnl_config_get_prefetch_enabled(config);
+    prefetch.interval_seconds = sgnl_config_get_prefetch_interval(config);
+    snprintf(prefetch.group, sizeof(prefetch.group), "%s", sgnl_config_get_prefetch_group(config));
+    prefetch.logged_in_users = sgnl_config_get_prefetch_logged_in_users(config);
+    prefetch.max_principals = sgnl_config_get_prefetch_max_principals(config);
+    snprintf(metrics.textfile_path, sizeof(metrics.textfile_path), "%s", sgnl_config_get_metrics_textfile_path(config));
+    metrics.interval_seconds = sgnl_config_get_metrics_interval(config);
+    sgnl_config_destroy(config);
+
+    // Create the client that owns connections and the cache for all callers
+    sgnl_client_config_t client_config = {
+        .config_path = config_path,
+        .timeout_seconds = 0,
+        .retry_count = 0,     // Use http.retry from config
+        .retry_delay_ms = 0,  // Use http.retry from config
+        .enable_debug_logging = false,  // Will be overridden by config file
+        .validate_ssl = true,
+        .user_agent = "SGNL-Broker/1.0",
+        .bypass_broker = true
+    };
+
+    broker.client = sgnl_client_create(&client_config);
+    if (!broker.client || sgnl_client_validate(broker.client) != SGNL_OK) {
+        fprintf(stderr, "sgnld: failed to initialize SGNL client: %s\n",
+                sgnl_client_get_last_error(broker.client));
+        sgnl_client_destroy(broker.client);
+        return 1;
+    }
+
+    broker.listen_fd = open_listen_socket(socket_path);
+    if (broker.listen_fd < 0) {
+        sgnl_client_destroy(broker.client);
+        return 1;
+    }
+
+    // Queued log records would be lost with the exiting parent
+    sgnl_log_flush();
+    if (detach && daemon(0, 0) != 0) {
+        fprintf(stderr, "sgnld: failed to detach: %s\n", strerror(errno));
+        close(broker.listen_fd);
+        unlink(socket_path);
+        sgnl_client_destroy(broker.client);
+        return 1;
+    }
+
+    install_signal_handlers();
+    SGNL_LOG_INFO(&log_ctx, "SGNL broker listening on %s", socket_path);
+
+    // Resolve the API host before the first caller waits on it
+    if (sgnl_client_warm_up(broker.client) != SGNL_OK) {
+        SGNL_LOG_WARNING(&log_ctx, "SGNL API not reachable yet; continuing");
+    }
+
+    // Started after daemon(): threads do not survive the fork
+    prefetch_start();
+    metrics_start();
+
+    while (!stop_requested) {
+        if (flush_requested) {
+            flush_requested = 0;
+            sgnl_client_cache_flush(broker.client);
+            SGNL_LOG_INFO(&log_ctx, "Decision cache and prefetched snapshots flushed");
+        }
+
+        int fd = accept(broker.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EINTR) {
+                SGNL_LOG_ERROR(&log_ctx, "accept() failed: %s", strerror(errno));
+            }
+            continue;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        dispatch_connection(fd);
+    }
+
+    SGNL_LOG_INFO(&log_ctx, "SGNL broker shutting down");
+    close(broker.listen_fd);
+    unlink(socket_path);
+    prefetch_stop();
+    metrics_stop();
+
+    // Let in-flight connections finish before tearing down the client
+    int active = 0;
+    for (int i = 0; i < 50; i++) {
+        pthread_mutex_lock(&broker.count_lock);
+        active = broker.active_connections;
+        pthread_mutex_unlock(&broker.count_lock);
+        if (active == 0) {
+            break;
+        }
+        usleep(100 * 1000);
+    }
+
+    // A connection still evaluating would use the client after it is freed;
+    // leave it to process exit instead
+    if (active == 0) {
+        sgnl_client_destroy(broker.client);
+        broker.client = NULL;
+    } else {
+        SGNL_LOG_WARNING(&log_ctx, "%d connections still active at shutdown", active);
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * SGNL Request Arena Implementation
+ *
+ * A block that fills up is kept, not reallocated, so earlier allocations
+ * never move. Heap blocks double in size, which keeps their number
+ * logarithmic in the total requested.
+ */
+
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN 16
+#define ARENA_MIN_BLOCK 4096
+
+struct sgnl_arena_block {
+    sgnl_arena_block_t *next;
+    size_t size;                    // Usable bytes from the aligned start of data
+    char data[];
+};
+
+static size_t align_up(size_t value) {
+    return (value + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static char* align_ptr(char *ptr) {
+    return (char *)(((uintptr_t)ptr + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1));
+}
+
+void sgnl_arena_init(sgnl_arena_t *arena, void *storage, size_t size) {
+    arena->blocks = NULL;
+    arena->storage = NULL;
+    arena->storage_size = 0;
+
+    // Round the caller's storage to the arena alignment
+    if (storage) {
+        char *aligned = align_ptr(storage);
+        size_t skipped = (size_t)(aligned - (char *)storage);
+        if (size > skipped) {
+            arena->storage = aligned;
+            arena->storage_size = size - skipped;
+        }
+    }
+    arena->base = arena->storage;
+    arena->size = arena->storage_size;
+    arena->used = 0;
+}
+
+void* sgnl_arena_alloc(sgnl_arena_t *arena, size_t size) {
+    size = align_up(size ? size : 1);
+    if (arena->base && size <= arena->size - arena->used) {
+        void *ptr = arena->base + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    size_t block_size = arena->blocks ? arena->blocks->size * 2 : ARENA_MIN_BLOCK;
+    while (block_size < size) {
+        block_size *= 2;
+    }
+    sgnl_arena_block_t *block = malloc(sizeof(sgnl_arena_block_t) + block_size + ARENA_ALIGN);
+    if (!block) {
+        return NULL;
+    }
+    block->next = arena->blocks;
+    block->size = block_size;
+    arena->blocks = block;
+    arena->base = align_ptr(block->data);
+    arena->size = block_size;
+    arena->used = size;
+    return arena->base;
+}
+
+char* sgnl_arena_strdup(sgnl_arena_t *arena, const char *text) {
+    size_t len = strlen(text) + 1;
+    char *copy = sgnl_arena_alloc(arena, len);
+    if (copy) {
+        memcpy(copy, text, len);
+    }
+    return copy;
+}
+
+bool sgnl_arena_extend(sgnl_arena_t *arena, void *ptr, size_t old_size, size_t new_size) {
+    old_size = align_up(old_size ? old_size : 1);
+    new_size = align_up(new_size);
+    if (!arena->base || (char *)ptr + old_size != arena->base + arena->used) {
+        return false;
+    }
+    if (new_size > old_size && new_size - old_size > arena->size - arena->used) {
+        return false;
+    }
+    arena->used = arena->used - old_size + new_size;
+    return true;
+}
+
+void sgnl_arena_release(sgnl_arena_t *arena) {
+    sgnl_arena_block_t *block = arena->blocks;
+    while (block) {
+        sgnl_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->base = arena->storage;
+    arena->size = arena->storage_size;
+    arena->used = 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * SGNL Request Arena
+ *
+ * Bump allocator for memory that lives exactly as long as one call: the
+ * request body, the response parser and scratch arrays. The first block is
+ * usually caller storage on the stack, so a typical evaluation allocates
+ * nothing; larger requests spill into heap blocks. Everything is released
+ * at once by sgnl_arena_release. Internal to libsgnl.
+ */
+
+#ifndef SGNL_ARENA_H
+#define SGNL_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Inline storage that covers a single evaluation (parser state and body)
+#define SGNL_ARENA_INLINE_SIZE 4096
+
+typedef struct sgnl_arena_block sgnl_arena_block_t;
+
+typedef struct {
+    char *base;                     // Current block
+    size_t size;
+    size_t used;
+    sgnl_arena_block_t *blocks;     // Heap blocks, most recent first
+    char *storage;                  // Caller's block, aligned
+    size_t storage_size;
+} sgnl_arena_t;
+
+/**
+ * Initialize an arena
+ *
+ * @param storage Initial block owned by the caller (may be NULL)
+ * @param size Size of storage
+ */
+void sgnl_arena_init(sgnl_arena_t *arena, void *storage, size_t size);
+
+/**
+ * Allocate size bytes, aligned for any type
+ *
+ * @return Memory valid until sgnl_arena_release, or NULL on allocation failure
+ */
+void* sgnl_arena_alloc(sgnl_arena_t *arena, size_t size);
+
+/**
+ * Copy a string into the arena
+ *
+ * @return Copy or NULL on allocation failure
+ */
+char* sgnl_arena_strdup(sgnl_arena_t *arena, const char *text);
+
+/**
+ * Resize the most recent allocation in place when it has room to grow
+ *
+ * @return true if ptr now holds new_size bytes; otherwise it is unchanged
+ */
+bool sgnl_arena_extend(sgnl_arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * Free every heap block; the arena is empty and reusable afterwards,
+ * starting again from the caller's storage
+ */
+void sgnl_arena_release(sgnl_arena_t *arena);
+
+#endif /* SGNL_ARENA_H */
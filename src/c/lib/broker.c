@@ -0,0 +1,485 @@
+/*
+ * SGNL Decision Broker Protocol Implementation
+ *
+ * Framing, encoding and the client-side exchange with sgnld.
+ */
+
+#include "broker.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+#define BROKER_NULL_STRING 0xFFFFu
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS/BSD: SO_NOSIGPIPE is set on the socket instead
+#endif
+
+// Growable byte buffer used to build frames
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+} frame_buffer_t;
+
+// Bounded reader over a received payload
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+} frame_reader_t;
+
+static void buffer_reserve(frame_buffer_t *buf, size_t extra) {
+    if (buf->failed || buf->size + extra <= buf->capacity) {
+        return;
+    }
+    size_t capacity = buf->capacity ? buf->capacity : 256;
+    while (capacity < buf->size + extra) {
+        capacity *= 2;
+    }
+    unsigned char *data = realloc(buf->data, capacity);
+    if (!data) {
+        buf->failed = true;
+        return;
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+}
+
+static void buffer_put(frame_buffer_t *buf, const void *bytes, size_t len) {
+    buffer_reserve(buf, len);
+    if (!buf->failed) {
+        memcpy(buf->data + buf->size, bytes, len);
+        buf->size += len;
+    }
+}
+
+static void buffer_put_u8(frame_buffer_t *buf, uint8_t value) {
+    buffer_put(buf, &value, 1);
+}
+
+static void buffer_put_u16(frame_buffer_t *buf, uint16_t value) {
+    uint16_t net = htons(value);
+    buffer_put(buf, &net, 2);
+}
+
+static void buffer_put_u32(frame_buffer_t *buf, uint32_t value) {
+    uint32_t net = htonl(value);
+    buffer_put(buf, &net, 4);
+}
+
+static void buffer_put_str(frame_buffer_t *buf, const char *str) {
+    if (!str) {
+        buffer_put_u16(buf, BROKER_NULL_STRING);
+        return;
+    }
+    size_t len = strlen(str);
+    if (len >= BROKER_NULL_STRING) {
+        buf->failed = true;
+        return;
+    }
+    buffer_put_u16(buf, (uint16_t)len);
+    buffer_put(buf, str, len);
+}
+
+// Reserve the header; the payload length is patched in by buffer_finish_frame
+static void buffer_begin_frame(frame_buffer_t *buf, uint8_t code) {
+    buffer_put_u32(buf, SGNL_BROKER_MAGIC);
+    buffer_put_u8(buf, SGNL_BROKER_VERSION);
+    buffer_put_u8(buf, code);
+    buffer_put_u16(buf, 0);
+    buffer_put_u32(buf, 0);
+}
+
+static void buffer_finish_frame(frame_buffer_t *buf) {
+    if (buf->failed) {
+        return;
+    }
+    size_t payload = buf->size - SGNL_BROKER_HEADER_SIZE;
+    if (payload > SGNL_BROKER_MAX_PAYLOAD) {
+        buf->failed = true;
+        return;
+    }
+    uint32_t net = htonl((uint32_t)payload);
+    memcpy(buf->data + 8, &net, 4);
+}
+
+static bool reader_get_u8(frame_reader_t *reader, uint8_t *value) {
+    if (reader->size - reader->pos < 1) {
+        return false;
+    }
+    *value = reader->data[reader->pos++];
+    return true;
+}
+
+static bool reader_get_u16(frame_reader_t *reader, uint16_t *value) {
+    uint16_t net;
+    if (reader->size - reader->pos < 2) {
+        return false;
+    }
+    memcpy(&net, reader->data + reader->pos, 2);
+    reader->pos += 2;
+    *value = ntohs(net);
+    return true;
+}
+
+// Returns a view into the payload, or sets *is_null for an encoded NULL
+static bool reader_get_str(frame_reader_t *reader, const char **start, size_t *len, bool *is_null) {
+    uint16_t str_len;
+    if (!reader_get_u16(reader, &str_len)) {
+        return false;
+    }
+    if (str_len == BROKER_NULL_STRING) {
+        *is_null = true;
+        *start = NULL;
+        *len = 0;
+        return true;
+    }
+    if (reader->size - reader->pos < str_len) {
+        return false;
+    }
+    *is_null = false;
+    *start = (const char *)reader->data + reader->pos;
+    *len = str_len;
+    reader->pos += str_len;
+    return true;
+}
+
+static char* reader_dup_str(frame_reader_t *reader, bool *ok) {
+    const char *start;
+    size_t len;
+    bool is_null;
+    if (!reader_get_str(reader, &start, &len, &is_null)) {
+        *ok = false;
+        return NULL;
+    }
+    if (is_null) {
+        return NULL;
+    }
+    char *copy = malloc(len + 1);
+    if (!copy) {
+        *ok = false;
+        return NULL;
+    }
+    memcpy(copy, start, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+static bool write_all(int fd, const unsigned char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = send(fd, data, len, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+static bool read_all(int fd, unsigned char *data, size_t len) {
+    while (len > 0) {
+        ssize_t got = recv(fd, data, len, 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (got == 0) {
+            return false;
+        }
+        data += got;
+        len -= (size_t)got;
+    }
+    return true;
+}
+
+// Read one frame; the caller frees *payload_out
+static bool read_frame(int fd, uint8_t *code_out, unsigned char **payload_out, size_t *payload_len_out) {
+    unsigned char header[SGNL_BROKER_HEADER_SIZE];
+    if (!read_all(fd, header, sizeof(header))) {
+        return false;
+    }
+
+    uint32_t magic, length;
+    memcpy(&magic, header, 4);
+    memcpy(&length, header + 8, 4);
+    magic = ntohl(magic);
+    length = ntohl(length);
+
+    if (magic != SGNL_BROKER_MAGIC || header[4] != SGNL_BROKER_VERSION ||
+        length > SGNL_BROKER_MAX_PAYLOAD) {
+        return false;
+    }
+
+    unsigned char *payload = malloc(length ? length : 1);
+    if (!payload) {
+        return false;
+    }
+    if (length > 0 && !read_all(fd, payload, length)) {
+        free(payload);
+        return false;
+    }
+
+    *code_out = header[5];
+    *payload_out = payload;
+    *payload_len_out = length;
+    return true;
+}
+
+static void set_socket_timeout(int fd, int timeout_ms) {
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+bool sgnl_broker_peer_is_root(int fd) {
+#ifdef SO_PEERCRED
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        return false;
+    }
+    return cred.uid == 0;
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(fd, &uid, &gid) != 0) {
+        return false;
+    }
+    return uid == 0;
+#endif
+}
+
+// Anyone who can bind or replace the socket decides access, so only a
+// root-owned socket in a directory no one else can write to is used
+static bool socket_path_trusted(const char *socket_path) {
+    struct stat st;
+    if (lstat(socket_path, &st) != 0 || !S_ISSOCK(st.st_mode) || st.st_uid != 0) {
+        return false;
+    }
+    
+    char dir[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    const char *slash = strrchr(socket_path, '/');
+    if (!slash) {
+        strcpy(dir, ".");
+    } else if (slash == socket_path) {
+        strcpy(dir, "/");
+    } else {
+        memcpy(dir, socket_path, (size_t)(slash - socket_path));
+        dir[slash - socket_path] = '\0';
+    }
+    return stat(dir, &st) == 0 && S_ISDIR(st.st_mode) && st.st_uid == 0 &&
+           (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+static int connect_broker(const char *socket_path, int timeout_ms) {
+    struct sockaddr_un addr;
+    if (strlen(socket_path) >= sizeof(addr.sun_path) || !socket_path_trusted(socket_path)) {
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    set_socket_timeout(fd, timeout_ms);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    // The path may have been replaced since it was checked; the peer cannot lie
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || !sgnl_broker_peer_is_root(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sgnl_broker_evaluate(const char *socket_path, int timeout_ms,
+                          const char *principal_id,
+                          const char **asset_ids,
+                          const char **actions,
+                          int count,
+                          sgnl_access_result_t **results) {
+    if (!socket_path || !principal_id || !asset_ids || !actions || !results ||
+        count <= 0 || count > SGNL_BROKER_MAX_QUERIES) {
+        return false;
+    }
+
+    frame_buffer_t request = {0};
+    buffer_begin_frame(&request, SGNL_BROKER_OP_EVALUATE);
+    buffer_put_str(&request, principal_id);
+    buffer_put_u16(&request, (uint16_t)count);
+    for (int i = 0; i < count; i++) {
+        buffer_put_str(&request, asset_ids[i]);
+        buffer_put_str(&request, actions[i]);
+    }
+    buffer_finish_frame(&request);
+    if (request.failed) {
+        free(request.data);
+        return false;
+    }
+
+    int fd = connect_broker(socket_path, timeout_ms);
+    if (fd < 0) {
+        free(request.data);
+        return false;
+    }
+
+    bool sent = write_all(fd, request.data, request.size);
+    free(request.data);
+
+    uint8_t status = SGNL_ERROR;
+    unsigned char *payload = NULL;
+    size_t payload_len = 0;
+    bool received = sent && read_frame(fd, &status, &payload, &payload_len);
+    close(fd);
+
+    if (!received) {
+        return false;
+    }
+
+    // The broker could not evaluate at all (e.g. its own config is broken);
+    // let the caller try directly rather than trusting a partial answer
+    if (status != SGNL_OK) {
+        free(payload);
+        return false;
+    }
+
+    frame_reader_t reader = {payload, payload_len, 0};
+    uint16_t result_count;
+    bool ok = reader_get_u16(&reader, &result_count) && result_count == count;
+
+    for (int i = 0; ok && i < count; i++) {
+        uint8_t result;
+        const char *reason;
+        size_t reason_len;
+        bool is_null;
+        ok = reader_get_u8(&reader, &result) &&
+             reader_get_str(&reader, &reason, &reason_len, &is_null);
+        if (!ok) {
+            break;
+        }
+
+        sgnl_access_result_t *entry = results[i];
+        entry->result = (sgnl_result_t)result;
+        if (entry->result == SGNL_ALLOWED) {
+            strcpy(entry->decision, "Allow");
+        } else if (entry->result == SGNL_DENIED) {
+            strcpy(entry->decision, "Deny");
+        }
+        if (!is_null) {
+            size_t copy_len = reason_len < sizeof(entry->reason) - 1 ? reason_len : sizeof(entry->reason) - 1;
+            memcpy(entry->reason, reason, copy_len);
+            entry->reason[copy_len] = '\0';
+        }
+    }
+
+    free(payload);
+    return ok;
+}
+
+bool sgnl_broker_read_request(int fd, sgnl_broker_request_t *req) {
+    if (!req) {
+        return false;
+    }
+    memset(req, 0, sizeof(*req));
+
+    uint8_t opcode;
+    unsigned char *payload = NULL;
+    size_t payload_len = 0;
+    if (!read_frame(fd, &opcode, &payload, &payload_len)) {
+        return false;
+    }
+    if (opcode != SGNL_BROKER_OP_EVALUATE) {
+        free(payload);
+        return false;
+    }
+
+    frame_reader_t reader = {payload, payload_len, 0};
+    bool ok = true;
+    uint16_t count = 0;
+
+    req->principal_id = reader_dup_str(&reader, &ok);
+    ok = ok && req->principal_id && reader_get_u16(&reader, &count) &&
+         count > 0 && count <= SGNL_BROKER_MAX_QUERIES;
+
+    if (ok) {
+        req->asset_ids = calloc(count, sizeof(char *));
+        req->actions = calloc(count, sizeof(char *));
+        ok = req->asset_ids && req->actions;
+        req->count = ok ? count : 0;
+    }
+
+    for (int i = 0; ok && i < req->count; i++) {
+        req->asset_ids[i] = reader_dup_str(&reader, &ok);
+        if (ok) {
+            req->actions[i] = reader_dup_str(&reader, &ok);
+        }
+        ok = ok && req->actions[i];
+    }
+
+    free(payload);
+    if (!ok || reader.pos != reader.size) {
+        sgnl_broker_request_free(req);
+        return false;
+    }
+    return true;
+}
+
+void sgnl_broker_request_free(sgnl_broker_request_t *req) {
+    if (!req) {
+        return;
+    }
+    for (int i = 0; i < req->count; i++) {
+        if (req->asset_ids) free(req->asset_ids[i]);
+        if (req->actions) free(req->actions[i]);
+    }
+    free(req->asset_ids);
+    free(req->actions);
+    free(req->principal_id);
+    memset(req, 0, sizeof(*req));
+}
+
+bool sgnl_broker_write_response(int fd, sgnl_result_t status,
+                                sgnl_access_result_t **results, int count) {
+    frame_buffer_t response = {0};
+    buffer_begin_frame(&response, (uint8_t)status);
+
+    if (status == SGNL_OK) {
+        buffer_put_u16(&response, (uint16_t)count);
+        for (int i = 0; i < count; i++) {
+            sgnl_access_result_t *entry = results ? results[i] : NULL;
+            buffer_put_u8(&response, (uint8_t)(entry ? entry->result : SGNL_ERROR));
+            buffer_put_str(&response, entry && entry->reason[0] ? entry->reason : NULL);
+        }
+    }
+    buffer_finish_frame(&response);
+
+    bool ok = !response.failed && write_all(fd, response.data, response.size);
+    free(response.data);
+    return ok;
+}
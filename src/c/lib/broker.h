@@ -0,0 +1,91 @@
+/*
+ * SGNL Decision Broker Protocol
+ *
+ * Compact binary protocol spoken over a Unix domain socket between
+ * libsgnl clients (PAM module, sudo plugin) and the sgnld broker, which
+ * owns the long-lived HTTP connections and decision cache.
+ *
+ * Frame layout (integers in network byte order):
+ *
+ *   u32 magic | u8 version | u8 code | u16 reserved | u32 payload_length | payload
+ *
+ * Request payload (code = SGNL_BROKER_OP_EVALUATE):
+ *   str principal | u16 count | count x (str asset | str action)
+ *
+ * Response payload (code = sgnl_result_t of the call as a whole):
+ *   u16 count | count x (u8 result | str reason)
+ *
+ * A str is a u16 length followed by that many bytes; length 0xFFFF encodes NULL.
+ */
+
+#ifndef SGNL_BROKER_H
+#define SGNL_BROKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "libsgnl.h"
+
+#define SGNL_BROKER_DEFAULT_SOCKET  "/run/sgnl/sgnld.sock"
+#define SGNL_BROKER_MAGIC           0x53474e42u   /* "SGNB" */
+#define SGNL_BROKER_VERSION         1
+#define SGNL_BROKER_HEADER_SIZE     12
+#define SGNL_BROKER_MAX_PAYLOAD     (256 * 1024)
+#define SGNL_BROKER_MAX_QUERIES     1024
+
+// Request opcodes
+#define SGNL_BROKER_OP_EVALUATE     1
+
+// Decoded request (server side)
+typedef struct {
+    char *principal_id;
+    int count;
+    char **asset_ids;               // Entries may be NULL
+    char **actions;
+} sgnl_broker_request_t;
+
+/**
+ * Evaluate queries through the broker (client side)
+ *
+ * Fills result, decision and reason of each preallocated entry in results.
+ * The broker is only asked when socket_path is a root-owned socket in a
+ * directory writable by root alone, and the process answering on it runs
+ * as root.
+ *
+ * @param socket_path Broker socket path
+ * @param timeout_ms Send/receive timeout for the whole exchange
+ * @return true if the broker answered, false if the caller should fall back
+ *         to evaluating directly (broker absent, untrusted, busy, or protocol error)
+ */
+bool sgnl_broker_evaluate(const char *socket_path, int timeout_ms,
+                          const char *principal_id,
+                          const char **asset_ids,
+                          const char **actions,
+                          int count,
+                          sgnl_access_result_t **results);
+
+/**
+ * Whether the process at the other end of a connected Unix socket runs as
+ * root (SO_PEERCRED, or getpeereid on the BSDs)
+ */
+bool sgnl_broker_peer_is_root(int fd);
+
+/**
+ * Read and decode one request from a connected socket (server side)
+ *
+ * @return true on success; req must then be released with sgnl_broker_request_free
+ */
+bool sgnl_broker_read_request(int fd, sgnl_broker_request_t *req);
+
+void sgnl_broker_request_free(sgnl_broker_request_t *req);
+
+/**
+ * Encode and send a response (server side)
+ *
+ * @param status Overall status (SGNL_OK when results holds count entries)
+ * @param results Per-query results, NULL entries are reported as SGNL_ERROR
+ */
+bool sgnl_broker_write_response(int fd, sgnl_result_t status,
+                                sgnl_access_result_t **results, int count);
+
+#endif /* SGNL_BROKER_H */
@@ -0,0 +1,59 @@
+/*
+ * SGNL Request Compression Implementation
+ */
+
+#include "compress.h"
+#include <stdint.h>
+#include <string.h>
+#include <zlib.h>
+
+// zlib's working memory comes from the request arena and goes with it
+static voidpf gzip_arena_alloc(voidpf opaque, uInt items, uInt size) {
+    return sgnl_arena_alloc((sgnl_arena_t *)opaque, (size_t)items * size);
+}
+
+static void gzip_arena_free(voidpf opaque, voidpf address) {
+    (void)opaque;
+    (void)address;
+}
+
+size_t sgnl_gzip_encode(sgnl_arena_t *arena, const char *data, size_t length, size_t min_bytes,
+                        int level, const char **out) {
+    if (length == 0 || length < min_bytes || length > UINT32_MAX) {
+        return 0;
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    zs.zalloc = gzip_arena_alloc;
+    zs.zfree = gzip_arena_free;
+    zs.opaque = arena;
+
+    // 15 + 16 window bits selects the gzip wrapper
+    if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+
+    // An encoding that does not fit in fewer bytes than the body is useless,
+    // so deflate gets no more room than that
+    uLong bound = deflateBound(&zs, (uLong)length);
+    if (bound > length - 1) {
+        bound = (uLong)(length - 1);
+    }
+    Bytef *encoded = bound > 0 ? sgnl_arena_alloc(arena, bound) : NULL;
+    int status = Z_BUF_ERROR;
+    if (encoded) {
+        zs.next_in = (Bytef *)data;
+        zs.avail_in = (uInt)length;
+        zs.next_out = encoded;
+        zs.avail_out = (uInt)bound;
+        status = deflate(&zs, Z_FINISH);
+    }
+    deflateEnd(&zs);
+
+    if (status != Z_STREAM_END) {
+        return 0;
+    }
+    *out = (const char *)encoded;
+    return zs.total_out;
+}
@@ -0,0 +1,28 @@
+/*
+ * SGNL Request Compression
+ *
+ * gzip encoding of request bodies for http.compression.request. The
+ * encoding and zlib's working memory come from the request arena, so
+ * nothing outlives the call. Response decoding is left to libcurl.
+ * Internal to libsgnl.
+ */
+
+#ifndef SGNL_COMPRESS_H
+#define SGNL_COMPRESS_H
+
+#include <stddef.h>
+#include "arena.h"
+
+/**
+ * gzip-encode a request body into the arena
+ *
+ * @param min_bytes Bodies shorter than this are not worth encoding
+ * @param level zlib compression level (-1 for zlib's default)
+ * @param out Set to the encoding when one is returned
+ * @return Length of the encoding, or 0 when the body should be sent as is:
+ *         it is short, the encoding would not be smaller, or zlib failed
+ */
+size_t sgnl_gzip_encode(sgnl_arena_t *arena, const char *data, size_t length, size_t min_bytes,
+                        int level, const char **out);
+
+#endif /* SGNL_COMPRESS_H */
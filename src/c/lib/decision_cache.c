@@ -0,0 +1,356 @@
+/*
+ * SGNL Decision Cache Implementation
+ *
+ * Chained hash table plus an insertion-ordered list used for eviction.
+ * Each entry is a single allocation holding its key and reason strings.
+ * All public functions take the cache lock, so one cache can serve
+ * concurrent evaluations on a shared client.
+ */
+
+#include "decision_cache.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct cache_entry {
+    struct cache_entry *next;       // Bucket chain
+    struct cache_entry *older;      // Insertion order (eviction list)
+    struct cache_entry *newer;
+    uint64_t hash;
+    int64_t expires_at;             // Monotonic seconds
+    sgnl_result_t result;
+    size_t principal_len;
+    size_t asset_len;
+    size_t action_len;
+    char strings[];                 // principal\0asset\0action\0reason\0
+} cache_entry_t;
+
+struct sgnl_decision_cache {
+    cache_entry_t **buckets;
+    size_t bucket_count;            // Power of two
+    size_t count;
+    size_t max_entries;
+    int positive_ttl_seconds;
+    int negative_ttl_seconds;
+    cache_entry_t *oldest;
+    cache_entry_t *newest;
+    pthread_mutex_t lock;           // Guards everything above except the settings
+};
+
+static int64_t monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec;
+}
+
+// FNV-1a over principal\0asset\0action
+static uint64_t hash_key(const char *principal_id, const char *asset_id, const char *action) {
+    const char *parts[3] = {principal_id, asset_id, action};
+    uint64_t hash = 1469598103934665603ULL;
+
+    for (int i = 0; i < 3; i++) {
+        for (const unsigned char *p = (const unsigned char *)parts[i]; *p; p++) {
+            hash ^= *p;
+            hash *= 1099511628211ULL;
+        }
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const char* entry_principal(const cache_entry_t *entry) {
+    return entry->strings;
+}
+
+static const char* entry_asset(const cache_entry_t *entry) {
+    return entry->strings + entry->principal_len + 1;
+}
+
+static const char* entry_action(const cache_entry_t *entry) {
+    return entry_asset(entry) + entry->asset_len + 1;
+}
+
+static const char* entry_reason(const cache_entry_t *entry) {
+    return entry_action(entry) + entry->action_len + 1;
+}
+
+static bool entry_matches(const cache_entry_t *entry, uint64_t hash,
+                          const char *principal_id, const char *asset_id, const char *action) {
+    return entry->hash == hash &&
+           strcmp(entry_principal(entry), principal_id) == 0 &&
+           strcmp(entry_asset(entry), asset_id) == 0 &&
+           strcmp(entry_action(entry), action) == 0;
+}
+
+// Unlink from both the bucket chain and the eviction list, then free
+static void entry_remove(sgnl_decision_cache_t *cache, cache_entry_t *entry) {
+    cache_entry_t **slot = &cache->buckets[entry->hash & (cache->bucket_count - 1)];
+    while (*slot && *slot != entry) {
+        slot = &(*slot)->next;
+    }
+    if (*slot) {
+        *slot = entry->next;
+    }
+
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        cache->oldest = entry->newer;
+    }
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        cache->newest = entry->older;
+    }
+
+    cache->count--;
+    free(entry);
+}
+
+static cache_entry_t* entry_find(sgnl_decision_cache_t *cache, uint64_t hash,
+                                 const char *principal_id, const char *asset_id, const char *action) {
+    cache_entry_t *entry = cache->buckets[hash & (cache->bucket_count - 1)];
+    while (entry && !entry_matches(entry, hash, principal_id, asset_id, action)) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+sgnl_decision_cache_t* sgnl_decision_cache_create(size_t max_entries,
+                                                  int positive_ttl_seconds,
+                                                  int negative_ttl_seconds) {
+    if (max_entries == 0) {
+        return NULL;
+    }
+
+    sgnl_decision_cache_t *cache = calloc(1, sizeof(sgnl_decision_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+
+    // Keep the load factor at or below 0.5
+    cache->bucket_count = 16;
+    while (cache->bucket_count < max_entries * 2) {
+        cache->bucket_count <<= 1;
+    }
+
+    cache->buckets = calloc(cache->bucket_count, sizeof(cache_entry_t *));
+    if (!cache->buckets) {
+        free(cache);
+        return NULL;
+    }
+
+    cache->max_entries = max_entries;
+    cache->positive_ttl_seconds = positive_ttl_seconds;
+    cache->negative_ttl_seconds = negative_ttl_seconds;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+void sgnl_decision_cache_destroy(sgnl_decision_cache_t *cache) {
+    if (cache) {
+        sgnl_decision_cache_flush(cache);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache->buckets);
+        free(cache);
+    }
+}
+
+bool sgnl_decision_cache_lookup(sgnl_decision_cache_t *cache,
+                                const char *principal_id,
+                                const char *asset_id,
+                                const char *action,
+                                sgnl_result_t *result,
+                                char *reason, size_t reason_size) {
+    if (!cache || !principal_id || !action || !result) {
+        return false;
+    }
+    if (!asset_id) {
+        asset_id = "";
+    }
+
+    uint64_t hash = hash_key(principal_id, asset_id, action);
+    int64_t now = monotonic_seconds();
+    bool hit = false;
+
+    pthread_mutex_lock(&cache->lock);
+    cache_entry_t *entry = entry_find(cache, hash, principal_id, asset_id, action);
+    if (entry && entry->expires_at <= now) {
+        entry_remove(cache, entry);
+    } else if (entry) {
+        *result = entry->result;
+        if (reason && reason_size > 0) {
+            strncpy(reason, entry_reason(entry), reason_size - 1);
+            reason[reason_size - 1] = '\0';
+        }
+        hit = true;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return hit;
+}
+
+void sgnl_decision_cache_store(sgnl_decision_cache_t *cache,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               sgnl_result_t result,
+                               const char *reason) {
+    if (!cache || !principal_id || !action) {
+        return;
+    }
+
+    int ttl;
+    if (result == SGNL_ALLOWED) {
+        ttl = cache->positive_ttl_seconds;
+    } else if (result == SGNL_DENIED) {
+        ttl = cache->negative_ttl_seconds;
+    } else {
+        return;  // Errors are never cached
+    }
+    if (ttl <= 0) {
+        return;
+    }
+
+    if (!asset_id) {
+        asset_id = "";
+    }
+    if (!reason) {
+        reason = "";
+    }
+
+    uint64_t hash = hash_key(principal_id, asset_id, action);
+
+    // Build the entry before taking the lock
+    size_t principal_len = strlen(principal_id);
+    size_t asset_len = strlen(asset_id);
+    size_t action_len = strlen(action);
+    size_t reason_len = strlen(reason);
+
+    cache_entry_t *entry = malloc(sizeof(cache_entry_t) +
+                                  principal_len + asset_len + action_len + reason_len + 4);
+    if (!entry) {
+        return;
+    }
+
+    entry->hash = hash;
+    entry->expires_at = monotonic_seconds() + ttl;
+    entry->result = result;
+    entry->principal_len = principal_len;
+    entry->asset_len = asset_len;
+    entry->action_len = action_len;
+
+    char *p = entry->strings;
+    memcpy(p, principal_id, principal_len + 1);
+    p += principal_len + 1;
+    memcpy(p, asset_id, asset_len + 1);
+    p += asset_len + 1;
+    memcpy(p, action, action_len + 1);
+    p += action_len + 1;
+    memcpy(p, reason, reason_len + 1);
+
+    pthread_mutex_lock(&cache->lock);
+
+    cache_entry_t *existing = entry_find(cache, hash, principal_id, asset_id, action);
+    if (existing) {
+        entry_remove(cache, existing);
+    }
+
+    // Evict oldest entries to stay within bounds
+    while (cache->count >= cache->max_entries && cache->oldest) {
+        entry_remove(cache, cache->oldest);
+    }
+
+    size_t bucket = hash & (cache->bucket_count - 1);
+    entry->next = cache->buckets[bucket];
+    cache->buckets[bucket] = entry;
+
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest) {
+        cache->newest->newer = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+    cache->count++;
+
+    pthread_mutex_unlock(&cache->lock);
+}
+
+size_t sgnl_decision_cache_invalidate(sgnl_decision_cache_t *cache,
+                                      const char *principal_id,
+                                      const char *asset_id,
+                                      const char *action) {
+    if (!cache || !principal_id) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    pthread_mutex_lock(&cache->lock);
+
+    // Exact key: single bucket probe
+    if (asset_id && action) {
+        uint64_t hash = hash_key(principal_id, asset_id, action);
+        cache_entry_t *entry = entry_find(cache, hash, principal_id, asset_id, action);
+        if (entry) {
+            entry_remove(cache, entry);
+            removed = 1;
+        }
+        pthread_mutex_unlock(&cache->lock);
+        return removed;
+    }
+
+    // Wildcard: walk the eviction list
+    cache_entry_t *entry = cache->oldest;
+    while (entry) {
+        cache_entry_t *newer = entry->newer;
+        if (strcmp(entry_principal(entry), principal_id) == 0 &&
+            (!asset_id || strcmp(entry_asset(entry), asset_id) == 0) &&
+            (!action || strcmp(entry_action(entry), action) == 0)) {
+            entry_remove(cache, entry);
+            removed++;
+        }
+        entry = newer;
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+    return removed;
+}
+
+void sgnl_decision_cache_flush(sgnl_decision_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+
+    cache_entry_t *entry = cache->oldest;
+    while (entry) {
+        cache_entry_t *newer = entry->newer;
+        free(entry);
+        entry = newer;
+    }
+
+    memset(cache->buckets, 0, cache->bucket_count * sizeof(cache_entry_t *));
+    cache->oldest = NULL;
+    cache->newest = NULL;
+    cache->count = 0;
+
+    pthread_mutex_unlock(&cache->lock);
+}
+
+size_t sgnl_decision_cache_count(const sgnl_decision_cache_t *cache) {
+    if (!cache) {
+        return 0;
+    }
+
+    pthread_mutex_t *lock = (pthread_mutex_t *)&cache->lock;
+    pthread_mutex_lock(lock);
+    size_t count = cache->count;
+    pthread_mutex_unlock(lock);
+    return count;
+}
@@ -0,0 +1,69 @@
+/*
+ * SGNL Decision Cache
+ *
+ * Bounded in-process cache of access decisions keyed by
+ * (principal, asset, action), with separate TTLs for Allow and Deny.
+ * Internal to libsgnl; applications use the sgnl_client_cache_* API.
+ */
+
+#ifndef SGNL_DECISION_CACHE_H
+#define SGNL_DECISION_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "libsgnl.h"
+
+typedef struct sgnl_decision_cache sgnl_decision_cache_t;
+
+/**
+ * Create a decision cache
+ *
+ * @param max_entries Maximum number of cached decisions (oldest evicted first)
+ * @param positive_ttl_seconds Lifetime of Allow decisions (0 = do not cache)
+ * @param negative_ttl_seconds Lifetime of Deny decisions (0 = do not cache)
+ * @return Cache instance or NULL on allocation failure
+ */
+sgnl_decision_cache_t* sgnl_decision_cache_create(size_t max_entries,
+                                                  int positive_ttl_seconds,
+                                                  int negative_ttl_seconds);
+
+void sgnl_decision_cache_destroy(sgnl_decision_cache_t *cache);
+
+/**
+ * Look up a cached decision
+ *
+ * @param reason Optional output buffer for the cached reason
+ * @return true and sets *result (SGNL_ALLOWED or SGNL_DENIED) on a live hit
+ */
+bool sgnl_decision_cache_lookup(sgnl_decision_cache_t *cache,
+                                const char *principal_id,
+                                const char *asset_id,
+                                const char *action,
+                                sgnl_result_t *result,
+                                char *reason, size_t reason_size);
+
+/**
+ * Store a decision; results other than SGNL_ALLOWED/SGNL_DENIED are ignored
+ */
+void sgnl_decision_cache_store(sgnl_decision_cache_t *cache,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               sgnl_result_t result,
+                               const char *reason);
+
+/**
+ * Remove matching entries; NULL asset_id or action matches any value
+ *
+ * @return Number of entries removed
+ */
+size_t sgnl_decision_cache_invalidate(sgnl_decision_cache_t *cache,
+                                      const char *principal_id,
+                                      const char *asset_id,
+                                      const char *action);
+
+void sgnl_decision_cache_flush(sgnl_decision_cache_t *cache);
+
+size_t sgnl_decision_cache_count(const sgnl_decision_cache_t *cache);
+
+#endif /* SGNL_DECISION_CACHE_H */
@@ -0,0 +1,61 @@
+/*
+ * SGNL Request Hedging Implementation
+ */
+
+#include "hedge.h"
+#include <stdlib.h>
+#include <string.h>
+
+void sgnl_latency_window_record(sgnl_latency_window_t *window, int64_t elapsed_ms) {
+    if (elapsed_ms < 0) {
+        elapsed_ms = 0;
+    }
+    window->samples[window->next] = (int32_t)(elapsed_ms > INT32_MAX ? INT32_MAX : elapsed_ms);
+    window->next = (window->next + 1) % SGNL_HEDGE_LATENCY_SAMPLES;
+    if (window->count < SGNL_HEDGE_LATENCY_SAMPLES) {
+        window->count++;
+    }
+}
+
+static int compare_latency(const void *a, const void *b) {
+    int32_t x = *(const int32_t *)a;
+    int32_t y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int64_t sgnl_hedge_delay_ms(const sgnl_latency_window_t *window, int percentile,
+                            int initial_delay_ms, int min_delay_ms) {
+    int64_t delay = initial_delay_ms;
+    int count = window->count;
+    if (count >= SGNL_HEDGE_MIN_SAMPLES) {
+        int32_t samples[SGNL_HEDGE_LATENCY_SAMPLES];
+        memcpy(samples, window->samples, (size_t)count * sizeof(int32_t));
+        qsort(samples, (size_t)count, sizeof(int32_t), compare_latency);
+        int index = count * percentile / 100;
+        delay = samples[index < count ? index : count - 1];
+    }
+    return delay < min_delay_ms ? min_delay_ms : delay;
+}
+
+void sgnl_hedge_race_init(sgnl_hedge_race_t *race) {
+    race->started = 1;
+    race->finished = 0;
+    race->winner = -1;
+}
+
+bool sgnl_hedge_race_finish(sgnl_hedge_race_t *race, int leg, bool answered) {
+    if (race->winner >= 0) {
+        return false;
+    }
+    race->finished++;
+    if (answered || race->finished == race->started) {
+        race->winner = leg;
+        return true;
+    }
+    return false;
+}
+
+sgnl_json_stream_status_t sgnl_hedge_replay(sgnl_json_stream_t *stream, const char *body, size_t length) {
+    sgnl_json_stream_reset(stream);
+    return sgnl_json_stream_feed(stream, body, length);
+}
@@ -0,0 +1,69 @@
+/*
+ * SGNL Request Hedging
+ *
+ * Bookkeeping behind hedged evaluations: a window of recent latencies whose
+ * percentile decides when a slow attempt gets a duplicate, and the race
+ * between the two legs that decides which one answers. Transfers and
+ * locking stay with the caller. Internal to libsgnl.
+ */
+
+#ifndef SGNL_HEDGE_H
+#define SGNL_HEDGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "json_stream.h"
+
+// Recent latencies kept for the percentile, and how many must be seen
+// before it replaces the configured initial delay
+#define SGNL_HEDGE_LATENCY_SAMPLES 128
+#define SGNL_HEDGE_MIN_SAMPLES 20
+
+// Ring of the most recent latencies, in milliseconds
+typedef struct {
+    int32_t samples[SGNL_HEDGE_LATENCY_SAMPLES];
+    int count;
+    int next;
+} sgnl_latency_window_t;
+
+// Legs of one hedged attempt: the primary and, once started, the hedge
+typedef struct {
+    int started;
+    int finished;
+    int winner;                     // Index of the winning leg (-1 = undecided)
+} sgnl_hedge_race_t;
+
+void sgnl_latency_window_record(sgnl_latency_window_t *window, int64_t elapsed_ms);
+
+/**
+ * How long an attempt may run before it is hedged: the given percentile of
+ * the window, or the initial delay while it holds fewer than
+ * SGNL_HEDGE_MIN_SAMPLES, never below the floor
+ *
+ * @param percentile 0 to 100
+ */
+int64_t sgnl_hedge_delay_ms(const sgnl_latency_window_t *window, int percentile,
+                            int initial_delay_ms, int min_delay_ms);
+
+/**
+ * Start a race with its primary leg running
+ */
+void sgnl_hedge_race_init(sgnl_hedge_race_t *race);
+
+/**
+ * Record that a leg finished. A definitive answer wins at once; a failure
+ * only wins once no other leg is still running, so a retry policy sees the
+ * same outcomes as with a single transfer.
+ *
+ * @param answered Whether the leg produced a non-transient response
+ * @return true if the leg won the race
+ */
+bool sgnl_hedge_race_finish(sgnl_hedge_race_t *race, int leg, bool answered);
+
+/**
+ * Parse the winning leg's buffered body as if it had streamed in
+ */
+sgnl_json_stream_status_t sgnl_hedge_replay(sgnl_json_stream_t *stream, const char *body, size_t length);
+
+#endif /* SGNL_HEDGE_H */
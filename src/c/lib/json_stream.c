@@ -0,0 +1,675 @@
+/*
+ * SGNL Streaming Response Parser Implementation
+ *
+ * A byte-at-a-time lexer drives a validating push parser. Only the string
+ * values the caller cares about are copied, each into a fixed buffer
+ * (longer values are truncated); everything else is checked and dropped.
+ */
+
+#include "json_stream.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_STREAM_MAX_DEPTH   32
+#define JSON_STREAM_KEY_MAX     32
+#define JSON_STREAM_LITERAL_MAX 64
+
+// Where a container sits in the SGNL response shape
+typedef enum {
+    CTX_OTHER = 0,
+    CTX_ROOT,                       // Top-level object
+    CTX_DECISIONS,                  // Top-level "decisions" array
+    CTX_DECISION,                   // One element of "decisions"
+    CTX_ERROR                       // Top-level "error" object
+} context_t;
+
+// String values that are captured
+typedef enum {
+    FIELD_NONE = 0,
+    FIELD_DECISION,
+    FIELD_ASSET_ID,
+    FIELD_ACTION,
+    FIELD_REASON,
+    FIELD_NEXT_PAGE_TOKEN,
+    FIELD_ERROR_MESSAGE
+} field_t;
+
+// What the grammar allows next
+typedef enum {
+    EXPECT_VALUE,                   // Any value (root, after ':' or ',' in an array)
+    EXPECT_VALUE_OR_END,            // After '['
+    EXPECT_KEY_OR_END,              // After '{'
+    EXPECT_KEY,                     // After ',' in an object
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_END,
+    EXPECT_DONE                     // Root value complete
+} expect_t;
+
+typedef enum {
+    LEX_DEFAULT,
+    LEX_STRING,
+    LEX_ESCAPE,
+    LEX_UNICODE,
+    LEX_LITERAL
+} lex_t;
+
+typedef struct {
+    char type;                      // '{' or '['
+    context_t context;
+} frame_t;
+
+// Fixed-size destination for a captured string
+typedef struct {
+    char *data;
+    size_t capacity;
+    size_t length;
+    bool present;
+} capture_t;
+
+struct sgnl_json_stream {
+    sgnl_json_decision_cb callback;
+    void *user_data;
+    bool in_arena;                  // Memory belongs to an arena; destroy does not free it
+    sgnl_json_stream_status_t status;
+
+    // Grammar
+    frame_t stack[JSON_STREAM_MAX_DEPTH];
+    int depth;
+    expect_t expect;
+
+    // Lexer
+    lex_t lex;
+    bool string_is_key;
+    capture_t *target;              // Capture for the current string (NULL = discard)
+    uint32_t unicode;               // \uXXXX accumulator
+    int unicode_digits;
+    uint32_t high_surrogate;        // Pending first half of a surrogate pair
+    char literal[JSON_STREAM_LITERAL_MAX];
+    size_t literal_length;
+
+    // Key of the member whose value comes next
+    char key[JSON_STREAM_KEY_MAX];
+    size_t key_length;
+    bool key_truncated;
+    field_t pending_field;
+    context_t pending_context;
+
+    // Current decision element
+    char decision[16];
+    char asset_id[256];
+    char action[64];
+    char reason[512];
+    capture_t decision_capture;
+    capture_t asset_id_capture;
+    capture_t action_capture;
+    capture_t reason_capture;
+    int decision_count;
+
+    // Top-level members
+    char next_page_token[1024];
+    char error_message[512];
+    capture_t next_page_token_capture;
+    capture_t error_message_capture;
+    bool has_decisions;
+    bool has_error;
+};
+
+static void capture_init(capture_t *capture, char *data, size_t capacity) {
+    capture->data = data;
+    capture->capacity = capacity;
+    capture->length = 0;
+    capture->present = false;
+    data[0] = '\0';
+}
+
+static void capture_begin(capture_t *capture) {
+    capture->length = 0;
+    capture->present = true;
+    capture->data[0] = '\0';
+}
+
+static void capture_put(capture_t *capture, const char *bytes, size_t len) {
+    if (capture->length + len < capture->capacity) {
+        memcpy(capture->data + capture->length, bytes, len);
+        capture->length += len;
+        capture->data[capture->length] = '\0';
+    } else {
+        capture->length = capture->capacity;  // Truncated; drop the rest of the value
+    }
+}
+
+static void decision_clear(sgnl_json_stream_t *stream) {
+    capture_init(&stream->decision_capture, stream->decision, sizeof(stream->decision));
+    capture_init(&stream->asset_id_capture, stream->asset_id, sizeof(stream->asset_id));
+    capture_init(&stream->action_capture, stream->action, sizeof(stream->action));
+    capture_init(&stream->reason_capture, stream->reason, sizeof(stream->reason));
+}
+
+static capture_t* field_capture(sgnl_json_stream_t *stream, field_t field) {
+    switch (field) {
+        case FIELD_DECISION:        return &stream->decision_capture;
+        case FIELD_ASSET_ID:        return &stream->asset_id_capture;
+        case FIELD_ACTION:          return &stream->action_capture;
+        case FIELD_REASON:          return &stream->reason_capture;
+        case FIELD_NEXT_PAGE_TOKEN: return &stream->next_page_token_capture;
+        case FIELD_ERROR_MESSAGE:   return &stream->error_message_capture;
+        default:                    return NULL;
+    }
+}
+
+static context_t current_context(const sgnl_json_stream_t *stream) {
+    return stream->depth > 0 ? stream->stack[stream->depth - 1].context : CTX_OTHER;
+}
+
+// Map a completed key to the field or child context its value feeds
+static void key_complete(sgnl_json_stream_t *stream) {
+    stream->pending_field = FIELD_NONE;
+    stream->pending_context = CTX_OTHER;
+    if (stream->key_truncated) {
+        return;
+    }
+
+    const char *key = stream->key;
+    switch (current_context(stream)) {
+        case CTX_ROOT:
+            if (strcmp(key, "decisions") == 0) {
+                stream->pending_context = CTX_DECISIONS;
+            } else if (strcmp(key, "nextPageToken") == 0) {
+                stream->pending_field = FIELD_NEXT_PAGE_TOKEN;
+            } else if (strcmp(key, "error") == 0) {
+                stream->has_error = true;
+                stream->pending_context = CTX_ERROR;
+            }
+            break;
+        case CTX_DECISION:
+            if (strcmp(key, "decision") == 0) {
+                stream->pending_field = FIELD_DECISION;
+            } else if (strcmp(key, "assetId") == 0) {
+                stream->pending_field = FIELD_ASSET_ID;
+            } else if (strcmp(key, "action") == 0) {
+                stream->pending_field = FIELD_ACTION;
+            } else if (strcmp(key, "reason") == 0) {
+                stream->pending_field = FIELD_REASON;
+            }
+            break;
+        case CTX_ERROR:
+            if (strcmp(key, "message") == 0) {
+                stream->pending_field = FIELD_ERROR_MESSAGE;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// A complete value was read; advance the grammar of the enclosing container
+static void value_complete(sgnl_json_stream_t *stream) {
+    stream->pending_field = FIELD_NONE;
+    stream->pending_context = CTX_OTHER;
+    stream->expect = stream->depth == 0 ? EXPECT_DONE : EXPECT_COMMA_OR_END;
+}
+
+static bool value_allowed(const sgnl_json_stream_t *stream) {
+    return stream->expect == EXPECT_VALUE || stream->expect == EXPECT_VALUE_OR_END;
+}
+
+static void fail(sgnl_json_stream_t *stream) {
+    stream->status = SGNL_JSON_STREAM_ERROR;
+}
+
+static void container_begin(sgnl_json_stream_t *stream, char type) {
+    if (!value_allowed(stream) || stream->depth >= JSON_STREAM_MAX_DEPTH) {
+        fail(stream);
+        return;
+    }
+
+    context_t context = CTX_OTHER;
+    context_t parent = current_context(stream);
+    if (stream->depth == 0) {
+        context = type == '{' ? CTX_ROOT : CTX_OTHER;
+    } else if (parent == CTX_DECISIONS) {
+        context = type == '{' ? CTX_DECISION : CTX_OTHER;
+    } else if (stream->pending_context == CTX_DECISIONS && type == '[') {
+        context = CTX_DECISIONS;
+        stream->has_decisions = true;
+    } else if (stream->pending_context == CTX_ERROR && type == '{') {
+        context = CTX_ERROR;
+    }
+
+    if (context == CTX_DECISION) {
+        decision_clear(stream);
+    }
+
+    stream->stack[stream->depth].type = type;
+    stream->stack[stream->depth].context = context;
+    stream->depth++;
+    stream->pending_field = FIELD_NONE;
+    stream->pending_context = CTX_OTHER;
+    stream->expect = type == '{' ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+}
+
+static void decision_emit(sgnl_json_stream_t *stream) {
+    int index = stream->decision_count++;
+    if (!stream->callback) {
+        return;
+    }
+
+    sgnl_json_decision_t decision = {
+        .decision = stream->decision_capture.present ? stream->decision : NULL,
+        .asset_id = stream->asset_id_capture.present ? stream->asset_id : NULL,
+        .action = stream->action_capture.present ? stream->action : NULL,
+        .reason = stream->reason_capture.present ? stream->reason : NULL
+    };
+    if (!stream->callback(&decision, index, stream->user_data)) {
+        stream->status = SGNL_JSON_STREAM_STOPPED;
+    }
+}
+
+static void container_end(sgnl_json_stream_t *stream, char type) {
+    if (stream->depth == 0 || stream->stack[stream->depth - 1].type != type) {
+        fail(stream);
+        return;
+    }
+
+    bool allowed = stream->expect == EXPECT_COMMA_OR_END ||
+                   (type == '{' && stream->expect == EXPECT_KEY_OR_END) ||
+                   (type == '[' && stream->expect == EXPECT_VALUE_OR_END);
+    if (!allowed) {
+        fail(stream);
+        return;
+    }
+
+    context_t context = stream->stack[stream->depth - 1].context;
+    stream->depth--;
+    value_complete(stream);
+
+    if (context == CTX_DECISION) {
+        decision_emit(stream);
+    }
+}
+
+static void string_begin(sgnl_json_stream_t *stream) {
+    stream->lex = LEX_STRING;
+    stream->high_surrogate = 0;
+    stream->target = NULL;
+
+    if (stream->expect == EXPECT_KEY_OR_END || stream->expect == EXPECT_KEY) {
+        stream->string_is_key = true;
+        stream->key_length = 0;
+        stream->key_truncated = false;
+        stream->key[0] = '\0';
+    } else if (value_allowed(stream)) {
+        stream->string_is_key = false;
+        stream->target = field_capture(stream, stream->pending_field);
+        if (stream->target) {
+            capture_begin(stream->target);
+        }
+    } else {
+        fail(stream);
+    }
+}
+
+static void string_put(sgnl_json_stream_t *stream, const char *bytes, size_t len) {
+    if (stream->string_is_key) {
+        if (stream->key_length + len < sizeof(stream->key)) {
+            memcpy(stream->key + stream->key_length, bytes, len);
+            stream->key_length += len;
+            stream->key[stream->key_length] = '\0';
+        } else {
+            stream->key_truncated = true;
+        }
+    } else if (stream->target) {
+        capture_put(stream->target, bytes, len);
+    }
+}
+
+static void string_put_codepoint(sgnl_json_stream_t *stream, uint32_t cp) {
+    char utf8[4];
+    size_t len;
+
+    if (cp < 0x80) {
+        utf8[0] = (char)cp;
+        len = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F));
+        len = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F));
+        len = 3;
+    } else {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F));
+        len = 4;
+    }
+    string_put(stream, utf8, len);
+}
+
+// A lone surrogate half becomes U+FFFD rather than invalid UTF-8
+static void flush_high_surrogate(sgnl_json_stream_t *stream) {
+    if (stream->high_surrogate) {
+        stream->high_surrogate = 0;
+        string_put_codepoint(stream, 0xFFFD);
+    }
+}
+
+static void unicode_complete(sgnl_json_stream_t *stream) {
+    uint32_t cp = stream->unicode;
+
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        flush_high_surrogate(stream);
+        stream->high_surrogate = cp;
+        return;
+    }
+    if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        if (stream->high_surrogate) {
+            cp = 0x10000 + ((stream->high_surrogate - 0xD800) << 10) + (cp - 0xDC00);
+            stream->high_surrogate = 0;
+        } else {
+            cp = 0xFFFD;
+        }
+        string_put_codepoint(stream, cp);
+        return;
+    }
+
+    flush_high_surrogate(stream);
+    string_put_codepoint(stream, cp);
+}
+
+static void string_end(sgnl_json_stream_t *stream) {
+    flush_high_surrogate(stream);
+    stream->lex = LEX_DEFAULT;
+
+    if (stream->string_is_key) {
+        key_complete(stream);
+        stream->expect = EXPECT_COLON;
+    } else {
+        stream->target = NULL;
+        value_complete(stream);
+    }
+}
+
+static bool literal_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '-' || c == '+' || c == '.';
+}
+
+// RFC 8259 number: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+static bool valid_number(const char *s) {
+    if (*s == '-') s++;
+    if (*s == '0') {
+        s++;
+    } else if (*s >= '1' && *s <= '9') {
+        while (*s >= '0' && *s <= '9') s++;
+    } else {
+        return false;
+    }
+    if (*s == '.') {
+        s++;
+        if (!(*s >= '0' && *s <= '9')) return false;
+        while (*s >= '0' && *s <= '9') s++;
+    }
+    if (*s == 'e' || *s == 'E') {
+        s++;
+        if (*s == '+' || *s == '-') s++;
+        if (!(*s >= '0' && *s <= '9')) return false;
+        while (*s >= '0' && *s <= '9') s++;
+    }
+    return *s == '\0';
+}
+
+static void literal_end(sgnl_json_stream_t *stream) {
+    stream->lex = LEX_DEFAULT;
+    stream->literal[stream->literal_length] = '\0';
+
+    const char *lit = stream->literal;
+    if (strcmp(lit, "true") != 0 && strcmp(lit, "false") != 0 &&
+        strcmp(lit, "null") != 0 && !valid_number(lit)) {
+        fail(stream);
+        return;
+    }
+    value_complete(stream);
+}
+
+static void lex_default(sgnl_json_stream_t *stream, char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r':
+            return;
+        case '{': case '[':
+            container_begin(stream, c);
+            return;
+        case '}':
+            container_end(stream, '{');
+            return;
+        case ']':
+            container_end(stream, '[');
+            return;
+        case ':':
+            if (stream->expect != EXPECT_COLON) {
+                fail(stream);
+                return;
+            }
+            stream->expect = EXPECT_VALUE;
+            return;
+        case ',':
+            if (stream->expect != EXPECT_COMMA_OR_END || stream->depth == 0) {
+                fail(stream);
+                return;
+            }
+            stream->expect = stream->stack[stream->depth - 1].type == '{' ? EXPECT_KEY : EXPECT_VALUE;
+            return;
+        case '"':
+            string_begin(stream);
+            return;
+        default:
+            if (!value_allowed(stream) || !literal_char(c)) {
+                fail(stream);
+                return;
+            }
+            stream->lex = LEX_LITERAL;
+            stream->literal[0] = c;
+            stream->literal_length = 1;
+            return;
+    }
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void lex_char(sgnl_json_stream_t *stream, char c) {
+    switch (stream->lex) {
+        case LEX_DEFAULT:
+            lex_default(stream, c);
+            return;
+
+        case LEX_STRING:
+            if (c == '"') {
+                string_end(stream);
+            } else if (c == '\\') {
+                stream->lex = LEX_ESCAPE;
+            } else if ((unsigned char)c < 0x20) {
+                fail(stream);
+            } else {
+                flush_high_surrogate(stream);
+                string_put(stream, &c, 1);
+            }
+            return;
+
+        case LEX_ESCAPE: {
+            char out;
+            stream->lex = LEX_STRING;
+            switch (c) {
+                case '"':  out = '"';  break;
+                case '\\': out = '\\'; break;
+                case '/':  out = '/';  break;
+                case 'b':  out = '\b'; break;
+                case 'f':  out = '\f'; break;
+                case 'n':  out = '\n'; break;
+                case 'r':  out = '\r'; break;
+                case 't':  out = '\t'; break;
+                case 'u':
+                    stream->lex = LEX_UNICODE;
+                    stream->unicode = 0;
+                    stream->unicode_digits = 0;
+                    return;
+                default:
+                    fail(stream);
+                    return;
+            }
+            flush_high_surrogate(stream);
+            string_put(stream, &out, 1);
+            return;
+        }
+
+        case LEX_UNICODE: {
+            int digit = hex_value(c);
+            if (digit < 0) {
+                fail(stream);
+                return;
+            }
+            stream->unicode = (stream->unicode << 4) | (uint32_t)digit;
+            if (++stream->unicode_digits == 4) {
+                stream->lex = LEX_STRING;
+                unicode_complete(stream);
+            }
+            return;
+        }
+
+        case LEX_LITERAL:
+            if (literal_char(c)) {
+                if (stream->literal_length + 1 >= sizeof(stream->literal)) {
+                    fail(stream);
+                    return;
+                }
+                stream->literal[stream->literal_length++] = c;
+                return;
+            }
+            literal_end(stream);
+            if (stream->status == SGNL_JSON_STREAM_OK) {
+                lex_default(stream, c);
+            }
+            return;
+    }
+}
+
+sgnl_json_stream_t* sgnl_json_stream_create(sgnl_json_decision_cb callback, void *user_data) {
+    sgnl_json_stream_t *stream = malloc(sizeof(sgnl_json_stream_t));
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->callback = callback;
+    stream->user_data = user_data;
+    stream->in_arena = false;
+    sgnl_json_stream_reset(stream);
+    return stream;
+}
+
+sgnl_json_stream_t* sgnl_json_stream_create_in(sgnl_arena_t *arena, sgnl_json_decision_cb callback, void *user_data) {
+    sgnl_json_stream_t *stream = sgnl_arena_alloc(arena, sizeof(sgnl_json_stream_t));
+    if (!stream) {
+        return NULL;
+    }
+
+    stream->callback = callback;
+    stream->user_data = user_data;
+    stream->in_arena = true;
+    sgnl_json_stream_reset(stream);
+    return stream;
+}
+
+void sgnl_json_stream_destroy(sgnl_json_stream_t *stream) {
+    if (stream && !stream->in_arena) {
+        free(stream);
+    }
+}
+
+void sgnl_json_stream_reset(sgnl_json_stream_t *stream) {
+    if (!stream) {
+        return;
+    }
+
+    sgnl_json_decision_cb callback = stream->callback;
+    void *user_data = stream->user_data;
+    bool in_arena = stream->in_arena;
+    memset(stream, 0, sizeof(*stream));
+    stream->callback = callback;
+    stream->user_data = user_data;
+    stream->in_arena = in_arena;
+
+    stream->status = SGNL_JSON_STREAM_OK;
+    stream->expect = EXPECT_VALUE;
+    stream->lex = LEX_DEFAULT;
+    decision_clear(stream);
+    capture_init(&stream->next_page_token_capture, stream->next_page_token, sizeof(stream->next_page_token));
+    capture_init(&stream->error_message_capture, stream->error_message, sizeof(stream->error_message));
+}
+
+sgnl_json_stream_status_t sgnl_json_stream_feed(sgnl_json_stream_t *stream, const char *data, size_t len) {
+    if (!stream) {
+        return SGNL_JSON_STREAM_ERROR;
+    }
+
+    for (size_t i = 0; i < len && stream->status == SGNL_JSON_STREAM_OK; i++) {
+        if (stream->expect == EXPECT_DONE && stream->lex == LEX_DEFAULT) {
+            char c = data[i];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                fail(stream);  // Trailing garbage after the document
+            }
+            continue;
+        }
+        lex_char(stream, data[i]);
+    }
+    return stream->status;
+}
+
+sgnl_json_stream_status_t sgnl_json_stream_finish(sgnl_json_stream_t *stream) {
+    if (!stream) {
+        return SGNL_JSON_STREAM_ERROR;
+    }
+
+    if (stream->status == SGNL_JSON_STREAM_OK && stream->lex == LEX_LITERAL) {
+        literal_end(stream);
+    }
+    if (stream->status == SGNL_JSON_STREAM_OK &&
+        (stream->expect != EXPECT_DONE || stream->lex != LEX_DEFAULT)) {
+        fail(stream);  // Truncated
+    }
+    return stream->status;
+}
+
+sgnl_json_stream_status_t sgnl_json_stream_status(const sgnl_json_stream_t *stream) {
+    return stream ? stream->status : SGNL_JSON_STREAM_ERROR;
+}
+
+int sgnl_json_stream_decision_count(const sgnl_json_stream_t *stream) {
+    return stream ? stream->decision_count : 0;
+}
+
+bool sgnl_json_stream_has_decisions(const sgnl_json_stream_t *stream) {
+    return stream ? stream->has_decisions : false;
+}
+
+bool sgnl_json_stream_has_error(const sgnl_json_stream_t *stream) {
+    return stream ? stream->has_error : false;
+}
+
+const char* sgnl_json_stream_error_message(const sgnl_json_stream_t *stream) {
+    return stream ? stream->error_message : "";
+}
+
+const char* sgnl_json_stream_next_page_token(const sgnl_json_stream_t *stream) {
+    if (!stream || !stream->next_page_token_capture.present || stream->next_page_token[0] == '\0') {
+        return NULL;
+    }
+    return stream->next_page_token;
+}
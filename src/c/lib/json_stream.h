@@ -0,0 +1,105 @@
+/*
+ * SGNL Streaming Response Parser
+ *
+ * Incremental scanner for SGNL access API responses. Bytes are fed as they
+ * arrive from the network; each element of the top-level "decisions" array
+ * is reported through a callback as soon as it is complete, so memory use is
+ * bounded by one decision rather than the size of the response.
+ *
+ * Recognised shape (everything else is validated and skipped):
+ *
+ *   { "decisions": [ { "decision", "assetId", "action", "reason" }, ... ],
+ *     "nextPageToken": "...",
+ *     "error": { "message": "..." } }
+ *
+ * Internal to libsgnl.
+ */
+
+#ifndef SGNL_JSON_STREAM_H
+#define SGNL_JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "arena.h"
+
+typedef struct sgnl_json_stream sgnl_json_stream_t;
+
+typedef enum {
+    SGNL_JSON_STREAM_OK = 0,        // Well-formed so far (or complete, after finish)
+    SGNL_JSON_STREAM_STOPPED,       // The decision callback asked to stop
+    SGNL_JSON_STREAM_ERROR          // Malformed or truncated document
+} sgnl_json_stream_status_t;
+
+// One element of the decisions array; absent fields are NULL
+typedef struct {
+    const char *decision;
+    const char *asset_id;
+    const char *action;
+    const char *reason;
+} sgnl_json_decision_t;
+
+/**
+ * Decision callback
+ *
+ * @param decision Fields of the element (only valid for the duration of the call)
+ * @param index Position of the element in the decisions array
+ * @param user_data Context passed to sgnl_json_stream_create
+ * @return true to continue, false to stop parsing
+ */
+typedef bool (*sgnl_json_decision_cb)(const sgnl_json_decision_t *decision, int index, void *user_data);
+
+/**
+ * Create a parser
+ *
+ * @param callback Called for each decision (may be NULL to only count them)
+ * @return Parser or NULL on allocation failure
+ */
+sgnl_json_stream_t* sgnl_json_stream_create(sgnl_json_decision_cb callback, void *user_data);
+
+/**
+ * Create a parser in arena memory
+ *
+ * The parser lives until the arena is released; sgnl_json_stream_destroy
+ * may still be called on it and does nothing.
+ *
+ * @return Parser or NULL on allocation failure
+ */
+sgnl_json_stream_t* sgnl_json_stream_create_in(sgnl_arena_t *arena, sgnl_json_decision_cb callback, void *user_data);
+
+void sgnl_json_stream_destroy(sgnl_json_stream_t *stream);
+
+/**
+ * Discard all state so the parser can read a new document
+ */
+void sgnl_json_stream_reset(sgnl_json_stream_t *stream);
+
+/**
+ * Feed the next chunk of the document
+ *
+ * @return SGNL_JSON_STREAM_OK to keep feeding; any other status is final
+ */
+sgnl_json_stream_status_t sgnl_json_stream_feed(sgnl_json_stream_t *stream, const char *data, size_t len);
+
+/**
+ * Signal end of input
+ *
+ * @return SGNL_JSON_STREAM_OK only if exactly one complete document was read
+ */
+sgnl_json_stream_status_t sgnl_json_stream_finish(sgnl_json_stream_t *stream);
+
+sgnl_json_stream_status_t sgnl_json_stream_status(const sgnl_json_stream_t *stream);
+
+// Number of decisions reported so far
+int sgnl_json_stream_decision_count(const sgnl_json_stream_t *stream);
+
+// Whether the document had a top-level "decisions" array
+bool sgnl_json_stream_has_decisions(const sgnl_json_stream_t *stream);
+
+// Top-level "error" member, if any; message is "" when it had none
+bool sgnl_json_stream_has_error(const sgnl_json_stream_t *stream);
+const char* sgnl_json_stream_error_message(const sgnl_json_stream_t *stream);
+
+// Top-level "nextPageToken", or NULL when absent or empty
+const char* sgnl_json_stream_next_page_token(const sgnl_json_stream_t *stream);
+
+#endif /* SGNL_JSON_STREAM_H */
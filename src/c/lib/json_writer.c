@@ -0,0 +1,203 @@
+/*
+ * SGNL JSON Writer Implementation
+ *
+ * In an arena the buffer is the newest allocation while a document is
+ * written, so it usually grows in place; otherwise it moves to a block
+ * twice the size. A heap buffer is reallocated and keeps the larger size
+ * for the next document. Strings are escaped as RFC 8259 requires: quote, backslash and
+ * control characters. Other bytes, UTF-8 included, are copied unchanged.
+ */
+
+#include "json_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_WRITER_MIN_CAPACITY 256
+
+// Make room for len more bytes plus the terminator
+static bool reserve(sgnl_json_writer_t *writer, size_t len) {
+    if (writer->failed) {
+        return false;
+    }
+    size_t needed = writer->length + len + 1;
+    if (needed <= writer->capacity) {
+        return true;
+    }
+
+    size_t capacity = writer->capacity ? writer->capacity * 2 : JSON_WRITER_MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    if (writer->buffer) {
+        char *data = realloc(writer->buffer->data, capacity);
+        if (!data) {
+            writer->failed = true;
+            return false;
+        }
+        writer->buffer->data = data;
+        writer->buffer->capacity = capacity;
+        writer->data = data;
+        writer->capacity = capacity;
+        return true;
+    }
+    if (writer->data && sgnl_arena_extend(writer->arena, writer->data, writer->capacity, capacity)) {
+        writer->capacity = capacity;
+        return true;
+    }
+
+    char *data = sgnl_arena_alloc(writer->arena, capacity);
+    if (!data) {
+        writer->failed = true;
+        return false;
+    }
+    if (writer->length) {
+        memcpy(data, writer->data, writer->length);
+    }
+    writer->data = data;
+    writer->capacity = capacity;
+    return true;
+}
+
+static void append(sgnl_json_writer_t *writer, const char *text, size_t len) {
+    if (reserve(writer, len)) {
+        memcpy(writer->data + writer->length, text, len);
+        writer->length += len;
+    }
+}
+
+// Separator owed before a value or key at the current depth
+static void begin_item(sgnl_json_writer_t *writer) {
+    if (writer->after_key) {
+        writer->after_key = false;
+        return;
+    }
+    uint32_t bit = (uint32_t)1 << writer->depth;
+    if (writer->has_items & bit) {
+        append(writer, ",", 1);
+    }
+    writer->has_items |= bit;
+}
+
+static void write_escaped(sgnl_json_writer_t *writer, const char *value) {
+    append(writer, "\"", 1);
+    const char *run = value;
+    for (const char *p = value; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        append(writer, run, (size_t)(p - run));
+        run = p + 1;
+        switch (c) {
+            case '"':  append(writer, "\\\"", 2); break;
+            case '\\': append(writer, "\\\\", 2); break;
+            case '\b': append(writer, "\\b", 2); break;
+            case '\f': append(writer, "\\f", 2); break;
+            case '\n': append(writer, "\\n", 2); break;
+            case '\r': append(writer, "\\r", 2); break;
+            case '\t': append(writer, "\\t", 2); break;
+            default: {
+                char escape[7];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                append(writer, escape, 6);
+                break;
+            }
+        }
+    }
+    append(writer, run, strlen(run));
+    append(writer, "\"", 1);
+}
+
+void sgnl_json_writer_init(sgnl_json_writer_t *writer, sgnl_arena_t *arena, size_t initial_capacity) {
+    memset(writer, 0, sizeof(*writer));
+    writer->arena = arena;
+    reserve(writer, initial_capacity);
+}
+
+void sgnl_json_writer_init_buffer(sgnl_json_writer_t *writer, sgnl_json_buffer_t *buffer, size_t initial_capacity) {
+    memset(writer, 0, sizeof(*writer));
+    writer->buffer = buffer;
+    writer->data = buffer->data;
+    writer->capacity = buffer->capacity;
+    reserve(writer, initial_capacity);
+}
+
+static void begin_container(sgnl_json_writer_t *writer, char open) {
+    begin_item(writer);
+    if (writer->depth + 1 >= SGNL_JSON_WRITER_MAX_DEPTH) {
+        writer->failed = true;
+        return;
+    }
+    append(writer, &open, 1);
+    writer->depth++;
+    writer->has_items &= ~((uint32_t)1 << writer->depth);
+}
+
+static void end_container(sgnl_json_writer_t *writer, char close) {
+    if (writer->depth == 0 || writer->after_key) {
+        writer->failed = true;
+        return;
+    }
+    writer->depth--;
+    append(writer, &close, 1);
+}
+
+void sgnl_json_writer_begin_object(sgnl_json_writer_t *writer) {
+    begin_container(writer, '{');
+}
+
+void sgnl_json_writer_end_object(sgnl_json_writer_t *writer) {
+    end_container(writer, '}');
+}
+
+void sgnl_json_writer_begin_array(sgnl_json_writer_t *writer) {
+    begin_container(writer, '[');
+}
+
+void sgnl_json_writer_end_array(sgnl_json_writer_t *writer) {
+    end_container(writer, ']');
+}
+
+void sgnl_json_writer_key(sgnl_json_writer_t *writer, const char *key) {
+    begin_item(writer);
+    write_escaped(writer, key);
+    append(writer, ":", 1);
+    writer->after_key = true;
+}
+
+void sgnl_json_writer_string(sgnl_json_writer_t *writer, const char *value) {
+    begin_item(writer);
+    if (value) {
+        write_escaped(writer, value);
+    } else {
+        append(writer, "null", 4);
+    }
+}
+
+void sgnl_json_writer_int(sgnl_json_writer_t *writer, long long value) {
+    char number[24];
+    int len = snprintf(number, sizeof(number), "%lld", value);
+    begin_item(writer);
+    append(writer, number, (size_t)len);
+}
+
+void sgnl_json_writer_raw(sgnl_json_writer_t *writer, const char *json) {
+    begin_item(writer);
+    append(writer, json, strlen(json));
+}
+
+const char* sgnl_json_writer_finish(sgnl_json_writer_t *writer) {
+    if (writer->depth != 0 || writer->after_key || !reserve(writer, 0)) {
+        return NULL;
+    }
+    writer->data[writer->length] = '\0';
+    return writer->data;
+}
+
+void sgnl_json_buffer_free(sgnl_json_buffer_t *buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->capacity = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * SGNL JSON Writer
+ *
+ * Writes a JSON document directly into arena memory or a reusable heap
+ * buffer, escaping strings as they are copied, so building a request costs
+ * no per-value allocations.
+ * Commas are inserted automatically; the caller only opens and closes
+ * containers and names members. Internal to libsgnl.
+ */
+
+#ifndef SGNL_JSON_WRITER_H
+#define SGNL_JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+#define SGNL_JSON_WRITER_MAX_DEPTH 32
+
+// Heap buffer that keeps its capacity between documents
+typedef struct {
+    char *data;
+    size_t capacity;
+} sgnl_json_buffer_t;
+
+typedef struct {
+    sgnl_arena_t *arena;            // Exactly one of arena and buffer is set
+    sgnl_json_buffer_t *buffer;
+    char *data;
+    size_t length;
+    size_t capacity;
+    bool failed;                    // Allocation failed or nesting was unbalanced
+    int depth;
+    uint32_t has_items;             // Bit per depth: container already has a value
+    bool after_key;                 // Next value completes a member
+} sgnl_json_writer_t;
+
+/**
+ * Start an empty document in arena memory
+ *
+ * @param initial_capacity Expected output size (grown as needed)
+ */
+void sgnl_json_writer_init(sgnl_json_writer_t *writer, sgnl_arena_t *arena, size_t initial_capacity);
+
+/**
+ * Start an empty document at the beginning of buffer, overwriting what it
+ * held; the buffer is grown as needed and keeps its capacity afterwards
+ *
+ * @param initial_capacity Expected output size (grown as needed)
+ */
+void sgnl_json_writer_init_buffer(sgnl_json_writer_t *writer, sgnl_json_buffer_t *buffer, size_t initial_capacity);
+
+void sgnl_json_writer_begin_object(sgnl_json_writer_t *writer);
+void sgnl_json_writer_end_object(sgnl_json_writer_t *writer);
+void sgnl_json_writer_begin_array(sgnl_json_writer_t *writer);
+void sgnl_json_writer_end_array(sgnl_json_writer_t *writer);
+
+/**
+ * Name the next member of the current object
+ */
+void sgnl_json_writer_key(sgnl_json_writer_t *writer, const char *key);
+
+/**
+ * Write a string value, escaped (NULL writes null)
+ */
+void sgnl_json_writer_string(sgnl_json_writer_t *writer, const char *value);
+
+void sgnl_json_writer_int(sgnl_json_writer_t *writer, long long value);
+
+/**
+ * Write an already serialized JSON value as is
+ */
+void sgnl_json_writer_raw(sgnl_json_writer_t *writer, const char *json);
+
+/**
+ * Finish the document
+ *
+ * @return NUL-terminated document in the writer's memory, or NULL if any
+ *         write failed or containers are still open
+ */
+const char* sgnl_json_writer_finish(sgnl_json_writer_t *writer);
+
+/**
+ * Free a buffer's memory and reset it to empty
+ */
+void sgnl_json_buffer_free(sgnl_json_buffer_t *buffer);
+
+#endif /* SGNL_JSON_WRITER_H */
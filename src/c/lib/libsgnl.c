@@ -6,6 +6,19 @@
  */
 
 #include "libsgnl.h"
+#include "decision_cache.h"
+#include "broker.h"
+#include "json_stream.h"
+#include "offline_store.h"
+#include "snapshot.h"
+#include "query_set.h"
+#include "result_set.h"
+#include "arena.h"
+#include "json_writer.h"
+#include "tls_session_store.h"
+#include "stats.h"
+#include "hedge.h"
+#include "compress.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,8 +27,9 @@
 #include <unistd.h>
 #include <stdarg.h>
 #include <dirent.h>
+#include <pthread.h>
 #include <curl/curl.h>
-#include <json-c/json.h>
+#include <zlib.h>
 
 // Add common config and logging systems
 #include "../common/config.h"
@@ -25,6 +39,27 @@
 // Internal Data Structures
 // ============================================================================
 
+// Idle curl handles kept per client; concurrent requests beyond this create
+// short-lived handles that still share the pooled connections
+#define SGNL_HANDLE_POOL_SIZE 8
+
+// Idle request body buffers kept per client, and the largest one kept after
+// use; a bigger batch body is freed rather than held for the next call
+#define SGNL_BODY_POOL_SIZE 8
+#define SGNL_BODY_BUFFER_MAX_RETAINED (1024 * 1024)
+
+// Upper bound on http.batch.max_concurrency
+#define SGNL_MAX_BATCH_CONCURRENCY 16
+
+// Longest the async worker sleeps without checking for new work when
+// libcurl cannot be woken up (curl_multi_wakeup needs 7.68.0)
+#define SGNL_ASYNC_POLL_MS 50
+
+typedef struct async_request async_request_t;
+
+// A client may be shared by any number of threads between sgnl_client_create
+// and sgnl_client_destroy. Everything below is either immutable after
+// creation or guarded as noted; per-request state lives on the caller's stack.
 struct sgnl_client {
     // Configuration
     char api_url[256];
@@ -32,29 +67,147 @@ struct sgnl_client {
     char tenant[128];
     
     // HTTP settings
-    int timeout_seconds;
-    int connect_timeout_seconds;
+    int timeout_ms;                 // Per attempt
+    int connect_timeout_ms;
+    int deadline_ms;                // End-to-end per call, 0 = retry budget only
     bool ssl_verify_peer;
     bool ssl_verify_host;
     char user_agent[128];
     
+    // Retry policy (see make_http_request)
+    int retry_max_retries;
+    int retry_base_delay_ms;
+    int retry_max_delay_ms;
+    int retry_budget_ms;
+    uint64_t retry_rng;             // Jitter state, seeded per client (updated atomically)
+    
+    // Hedging policy (see http_request_hedged)
+    bool hedging_enabled;
+    int hedging_percentile;
+    int hedging_initial_delay_ms;
+    int hedging_min_delay_ms;
+    pthread_mutex_t latency_lock;   // Guards the latency window below
+    sgnl_latency_window_t latency;
+    
+    // Batch splitting (see batch_evaluate_chunked)
+    int batch_max_queries;
+    int batch_max_concurrency;
+    
+    // Compression: decode compressed responses, gzip large batch bodies
+    bool compression_response;
+    bool compression_request;
+    int compression_request_min_bytes;
+    
+    // Name resolution, applied to every handle (see http_handle_create)
+    int dns_cache_ttl_seconds;
+    long ip_resolve;                // CURL_IPRESOLVE_*
+    int happy_eyeballs_timeout_ms;  // 0 = libcurl default
+    struct curl_slist *resolve;     // Static host:port:address entries (NULL = none)
+    
+    // TLS session resumption (see process_share_acquire)
+    bool tls_session_cache;
+    bool tls_persist_sessions;
+    char tls_session_file[256];
+    bool tls_early_data;
+    
     // Logging settings  
     bool debug_enabled;
+    sgnl_logger_config_t logger_config;  // From the config file; applied in sgnl_client_create
+    char log_facility[16];
+    
+    // Decision cache settings and state (cache is NULL when disabled)
+    bool cache_enabled;
+    int cache_positive_ttl_seconds;
+    int cache_negative_ttl_seconds;
+    int cache_max_entries;
+    sgnl_decision_cache_t *cache;   // Internally locked
+    
+    // Local broker (sgnld) settings
+    bool broker_enabled;
+    char broker_socket_path[108];
+    int broker_timeout_ms;
+    
+    // Offline fail-safe store (NULL when disabled or unavailable)
+    bool offline_enabled;
+    char offline_store_path[256];
+    int offline_grace_period_seconds;
+    int offline_max_entries;
+    sgnl_offline_store_t *offline;  // Internally locked
+    
+    // Prefetched entitlement snapshot (NULL when prefetch is disabled)
+    bool prefetch_enabled;
+    int prefetch_interval_seconds;
+    char prefetch_action[64];
+    int prefetch_max_principals;
+    sgnl_snapshot_t *snapshot;      // Internally locked
+    
+    // Persistent transport (reused across requests so the TCP/TLS
+    // connection to the tenant stays open between evaluations). Each
+    // request borrows an easy handle; the share keeps one connection cache.
+    pthread_mutex_t pool_lock;      // Guards the idle handles and bodies and share creation
+    CURL *idle_handles[SGNL_HANDLE_POOL_SIZE];
+    int idle_count;
+    sgnl_json_buffer_t idle_bodies[SGNL_BODY_POOL_SIZE];
+    int idle_body_count;
+    CURLSH *share;                  // Connections, resolved addresses and TLS sessions;
+                                    // the process share when tls_session_cache is set
+    pthread_mutex_t share_locks[CURL_LOCK_DATA_LAST]; // Locks of a client-owned share
+    char base_url[448];
+    char auth_header[768];
+    
+    // Request-invariant identity, resolved once at creation
+    char device_id[256];
+    pthread_mutex_t principal_lock; // Guards principal_json and principal_json_id
+    char *principal_json;           // Serialized principal member for principal_json_id
+    char principal_json_id[256];
+    
+    // Asynchronous evaluations, driven by a worker thread that is started
+    // by the first sgnl_evaluate_access_async
+    pthread_mutex_t async_lock;     // Guards the fields below
+    bool async_started;
+    bool async_stopping;
+    pthread_t async_thread;
+    CURLM *multi;
+    async_request_t *async_submitted;
+    
+    // Counters and latency histograms (see sgnl_client_get_stats), updated
+    // without locks
+    sgnl_stats_t stats;
     
     // Runtime state
     bool initialized;
-    char last_error[512];
-    char last_request_id[64];
 };
 
+static void async_worker_stop(sgnl_client_t *client);
+
+// Last error reported on this thread (see sgnl_client_get_last_error)
+static __thread char last_error[512];
+
+// Sequence mixed into request IDs so concurrent requests never collide
+static unsigned int request_sequence;
+
 // HTTP response structure for internal use
 typedef struct {
     char *data;
     size_t size;
     long status_code;
     char *error_message;
+    sgnl_json_stream_t *stream;     // Parser fed directly by 200 responses (NULL = buffer body)
+    CURL *curl;
+    CURLcode curl_result;           // Transport outcome of the final attempt
+    bool connected;                 // Whether the final attempt reached the server
+    long retry_after_seconds;       // Retry-After from the server (-1 = absent)
+    const int *cancel;              // Transfer is aborted once *cancel is set (NULL = never)
+    int64_t parse_us;               // Time spent in the parser while the body streamed in
 } http_response_t;
 
+// Request body as sent: JSON, or its gzip encoding (see http_body_compress)
+typedef struct {
+    const char *data;
+    size_t length;
+    bool gzip;
+} http_body_t;
+
 
 
 // ============================================================================
@@ -81,7 +234,7 @@ static void sgnl_log_error(sgnl_client_t *client, const char *format, ...) {
     if (client) {
         va_list args_copy;
         va_copy(args_copy, args);
-        vsnprintf(client->last_error, sizeof(client->last_error), format, args_copy);
+        vsnprintf(last_error, sizeof(last_error), format, args_copy);
         va_end(args_copy);
     }
     
@@ -89,11 +242,31 @@ static void sgnl_log_error(sgnl_client_t *client, const char *format, ...) {
     va_end(args);
 }
 
+static int64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 // HTTP response callback
 static size_t http_write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
     size_t realsize = size * nmemb;
     http_response_t *response = (http_response_t *)userp;
     
+    // Successful responses go straight to the parser; error bodies are
+    // buffered for the log. Returning 0 aborts the transfer once the parser
+    // has failed or the consumer has what it needs.
+    if (response->stream) {
+        long status_code = 0;
+        curl_easy_getinfo(response->curl, CURLINFO_RESPONSE_CODE, &status_code);
+        if (status_code == 200) {
+            int64_t start = monotonic_us();
+            sgnl_json_stream_status_t status = sgnl_json_stream_feed(response->stream, contents, realsize);
+            response->parse_us += monotonic_us() - start;
+            return status == SGNL_JSON_STREAM_OK ? realsize : 0;
+        }
+    }
+    
     char *temp = realloc(response->data, response->size + realsize + 1);
     if (temp == NULL) {
         free(response->data);
@@ -109,6 +282,17 @@ static size_t http_write_callback(void *contents, size_t size, size_t nmemb, voi
     return realsize;
 }
 
+// Progress callback: abort a transfer whose answer is no longer needed
+static int http_progress_callback(void *clientp, curl_off_t dltotal, curl_off_t dlnow,
+                                  curl_off_t ultotal, curl_off_t ulnow) {
+    (void)dltotal;
+    (void)dlnow;
+    (void)ultotal;
+    (void)ulnow;
+    const http_response_t *response = (const http_response_t *)clientp;
+    return response->cancel && __atomic_load_n(response->cancel, __ATOMIC_RELAXED) ? 1 : 0;
+}
+
 // Free HTTP response
 static void http_response_free(http_response_t *response) {
     if (response) {
@@ -122,44 +306,42 @@ static void http_response_free(http_response_t *response) {
     }
 }
 
-// Generate request ID
-static char* generate_request_id_internal(void) {
-    static char request_id[64];
+// Generate request ID into the caller's buffer
+static void generate_request_id_internal(char *request_id, size_t size) {
     time_t now = time(NULL);
     unsigned int pid = getpid();
-    unsigned int random_val = (unsigned int)(now ^ pid);
+    unsigned int sequence = __atomic_add_fetch(&request_sequence, 1, __ATOMIC_RELAXED);
+    unsigned int random_val = (unsigned int)(now ^ pid) + sequence;
     
-    snprintf(request_id, sizeof(request_id), 
+    snprintf(request_id, size, 
              "sgnl-%08x-%04x-%04x",
              (unsigned int)now,
              (unsigned int)(pid & 0xFFFF),
              (unsigned int)(random_val & 0xFFFF));
-    
-    return request_id;
 }
 
-// Get system device ID with fallback chain: machine-id -> hostname -> MAC address
-static char* get_device_id(void) {
-    static char device_id[256];
+// Resolve system device ID with fallback chain: machine-id -> hostname -> MAC address.
+// Called once per client; the result is kept in client->device_id.
+static void resolve_device_id(char *device_id, size_t size) {
     
     // First try: /etc/machine-id
     FILE *machine_id_file = fopen("/etc/machine-id", "r");
     if (machine_id_file) {
-        if (fgets(device_id, sizeof(device_id), machine_id_file)) {
+        if (fgets(device_id, size, machine_id_file)) {
             // Remove newline if present
             size_t len = strlen(device_id);
             if (len > 0 && device_id[len-1] == '\n') {
                 device_id[len-1] = '\0';
             }
             fclose(machine_id_file);
-            return device_id;
+            return;
         }
         fclose(machine_id_file);
     }
     
     // Second try: hostname
-    if (gethostname(device_id, sizeof(device_id)) == 0) {
-        return device_id;
+    if (gethostname(device_id, size) == 0) {
+        return;
     }
     
     // Third try: MAC address of first network interface
@@ -185,21 +367,20 @@ static char* get_device_id(void) {
     }
     
     if (net_dev_file) {
-        if (fgets(device_id, sizeof(device_id), net_dev_file)) {
+        if (fgets(device_id, size, net_dev_file)) {
             // Remove newline if present
             size_t len = strlen(device_id);
             if (len > 0 && device_id[len-1] == '\n') {
                 device_id[len-1] = '\0';
             }
             fclose(net_dev_file);
-            return device_id;
+            return;
         }
         fclose(net_dev_file);
     }
     
     // Final fallback
-    strcpy(device_id, "unknown-device");
-    return device_id;
+    snprintf(device_id, size, "unknown-device");
 }
 
 // Load configuration using common config system
@@ -220,6 +401,10 @@ static sgnl_result_t load_config_from_common_system(sgnl_client_t *client, const
     }
     
     sgnl_config_result_t result = sgnl_config_load(common_config, &options);
+    
+    // The client is the last reader of the file; leave no copy of the token
+    // in the config cache
+    sgnl_config_cache_clear();
     if (result != SGNL_CONFIG_OK) {
         sgnl_log_error(client, "Failed to load config: %s", 
                       sgnl_config_result_to_string(result));
@@ -236,95 +421,581 @@ static sgnl_result_t load_config_from_common_system(sgnl_client_t *client, const
     client->tenant[sizeof(client->tenant) - 1] = '\0';
     
     // HTTP settings
-    client->timeout_seconds = sgnl_config_get_timeout(common_config);
-    client->connect_timeout_seconds = sgnl_config_get_connect_timeout(common_config);
+    client->timeout_ms = sgnl_config_get_timeout_ms(common_config);
+    client->connect_timeout_ms = sgnl_config_get_connect_timeout_ms(common_config);
+    client->deadline_ms = sgnl_config_get_deadline_ms(common_config);
     strncpy(client->user_agent, sgnl_config_get_user_agent(common_config), sizeof(client->user_agent) - 1);
     client->user_agent[sizeof(client->user_agent) - 1] = '\0';
     
     // Logging settings
     client->debug_enabled = sgnl_config_is_debug_enabled(common_config);
+    const char *log_destination = sgnl_config_get_log_destination(common_config);
+    client->logger_config.min_level = sgnl_log_level_from_string(sgnl_config_get_log_level(common_config));
+    client->logger_config.use_syslog = strcmp(log_destination, "syslog") == 0;
+    client->logger_config.use_journald = strcmp(log_destination, "journald") == 0;
+    client->logger_config.structured_format = strcmp(sgnl_config_get_log_format(common_config), "json") == 0;
+    client->logger_config.include_timestamp = sgnl_config_get_log_timestamp(common_config);
+    client->logger_config.include_pid = sgnl_config_get_log_pid(common_config);
+    strncpy(client->log_facility, sgnl_config_get_log_facility(common_config), sizeof(client->log_facility) - 1);
+    client->log_facility[sizeof(client->log_facility) - 1] = '\0';
+    client->logger_config.facility = client->log_facility;
+    client->logger_config.async = sgnl_config_get_log_async(common_config);
+    client->logger_config.async_buffer_size = (size_t)sgnl_config_get_log_async_buffer_kb(common_config) * 1024;
+    int audit_destination = sgnl_audit_destination_from_string(sgnl_config_get_log_audit(common_config));
+    client->logger_config.audit_destination = audit_destination < 0 ? SGNL_AUDIT_SYSLOG :
+                                              (sgnl_audit_destination_t)audit_destination;
+    
+    // Decision cache settings
+    client->cache_enabled = sgnl_config_get_cache_enabled(common_config);
+    client->cache_positive_ttl_seconds = sgnl_config_get_cache_positive_ttl(common_config);
+    client->cache_negative_ttl_seconds = sgnl_config_get_cache_negative_ttl(common_config);
+    client->cache_max_entries = sgnl_config_get_cache_max_entries(common_config);
+    
+    // Broker settings
+    client->broker_enabled = sgnl_config_get_broker_enabled(common_config);
+    strncpy(client->broker_socket_path, sgnl_config_get_broker_socket_path(common_config),
+            sizeof(client->broker_socket_path) - 1);
+    client->broker_socket_path[sizeof(client->broker_socket_path) - 1] = '\0';
+    client->broker_timeout_ms = sgnl_config_get_broker_timeout_ms(common_config);
+    
+    // Offline store settings
+    client->offline_enabled = sgnl_config_get_offline_enabled(common_config);
+    strncpy(client->offline_store_path, sgnl_config_get_offline_store_path(common_config),
+            sizeof(client->offline_store_path) - 1);
+    client->offline_store_path[sizeof(client->offline_store_path) - 1] = '\0';
+    client->offline_grace_period_seconds = sgnl_config_get_offline_grace_period(common_config);
+    client->offline_max_entries = sgnl_config_get_offline_max_entries(common_config);
+    
+    // Prefetch settings
+    client->prefetch_enabled = sgnl_config_get_prefetch_enabled(common_config);
+    client->prefetch_interval_seconds = sgnl_config_get_prefetch_interval(common_config);
+    strncpy(client->prefetch_action, sgnl_config_get_prefetch_action(common_config),
+            sizeof(client->prefetch_action) - 1);
+    client->prefetch_action[sizeof(client->prefetch_action) - 1] = '\0';
+    client->prefetch_max_principals = sgnl_config_get_prefetch_max_principals(common_config);
+    
+    // Retry policy
+    client->retry_max_retries = sgnl_config_get_retry_max_retries(common_config);
+    client->retry_base_delay_ms = sgnl_config_get_retry_base_delay_ms(common_config);
+    client->retry_max_delay_ms = sgnl_config_get_retry_max_delay_ms(common_config);
+    client->retry_budget_ms = sgnl_config_get_retry_budget_ms(common_config);
+    
+    // Hedging policy
+    client->hedging_enabled = sgnl_config_get_hedging_enabled(common_config);
+    client->hedging_percentile = sgnl_config_get_hedging_percentile(common_config);
+    client->hedging_initial_delay_ms = sgnl_config_get_hedging_initial_delay_ms(common_config);
+    client->hedging_min_delay_ms = sgnl_config_get_hedging_min_delay_ms(common_config);
+    
+    // Batch splitting
+    client->batch_max_queries = sgnl_config_get_batch_max_queries(common_config);
+    client->batch_max_concurrency = sgnl_config_get_batch_max_concurrency(common_config);
+    if (client->batch_max_concurrency > SGNL_MAX_BATCH_CONCURRENCY) {
+        client->batch_max_concurrency = SGNL_MAX_BATCH_CONCURRENCY;
+    }
+    
+    // Compression
+    client->compression_response = sgnl_config_get_compression_response(common_config);
+    client->compression_request = sgnl_config_get_compression_request(common_config);
+    client->compression_request_min_bytes = sgnl_config_get_compression_request_min_bytes(common_config);
+    
+    // Name resolution
+    client->dns_cache_ttl_seconds = sgnl_config_get_dns_cache_ttl(common_config);
+    const char *ip_version = sgnl_config_get_ip_version(common_config);
+    client->ip_resolve = strcmp(ip_version, "ipv4") == 0 ? CURL_IPRESOLVE_V4 :
+                         strcmp(ip_version, "ipv6") == 0 ? CURL_IPRESOLVE_V6 : CURL_IPRESOLVE_WHATEVER;
+    client->happy_eyeballs_timeout_ms = sgnl_config_get_happy_eyeballs_timeout_ms(common_config);
+    for (int i = 0; i < sgnl_config_get_dns_resolve_count(common_config); i++) {
+        struct curl_slist *resolve = curl_slist_append(client->resolve, sgnl_config_get_dns_resolve(common_config, i));
+        if (!resolve) {
+            curl_slist_free_all(client->resolve);
+            client->resolve = NULL;
+            sgnl_config_destroy(common_config);
+            return SGNL_MEMORY_ERROR;
+        }
+        client->resolve = resolve;
+    }
+    
+    // TLS sessions
+    client->tls_session_cache = sgnl_config_get_tls_session_cache(common_config);
+    client->tls_persist_sessions = sgnl_config_get_tls_persist_sessions(common_config);
+    strncpy(client->tls_session_file, sgnl_config_get_tls_session_file(common_config),
+            sizeof(client->tls_session_file) - 1);
+    client->tls_session_file[sizeof(client->tls_session_file) - 1] = '\0';
+    client->tls_early_data = sgnl_config_get_tls_early_data(common_config);
     
     sgnl_config_destroy(common_config);
     return SGNL_OK;
 }
 
-// Make HTTP request to SGNL API
-static http_response_t* make_http_request(sgnl_client_t *client, const char *endpoint, const char *json_body) {
-    CURL *curl;
-    CURLcode res;
-    http_response_t *response = NULL;
+// Initialize libcurl once per process (curl_global_init is not thread-safe
+// to call from every client, and curl_easy_init would otherwise do it lazily)
+static pthread_once_t http_global_once = PTHREAD_ONCE_INIT;
+
+static void http_global_init_once(void) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+static void http_global_init(void) {
+    pthread_once(&http_global_once, http_global_init_once);
+}
+
+// One lock per kind of shared data: libcurl may take the DNS lock while
+// it holds the connection lock. userptr is the share's lock array.
+static void http_share_lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr) {
+    (void)handle;
+    (void)access;
+    pthread_mutex_lock(&((pthread_mutex_t *)userptr)[data]);
+}
+
+static void http_share_unlock(CURL *handle, curl_lock_data data, void *userptr) {
+    (void)handle;
+    pthread_mutex_unlock(&((pthread_mutex_t *)userptr)[data]);
+}
+
+// Share state between handles so a connection opened by one request is
+// reused by the next, whichever handle it borrows
+static CURLSH* http_share_create(pthread_mutex_t *locks, bool ssl_sessions) {
+    CURLSH *share = curl_share_init();
+    if (!share) {
+        return NULL;
+    }
+    
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, http_share_lock);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, http_share_unlock);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, locks);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+    if (ssl_sessions) {
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    return share;
+}
+
+// Clients with http.tls.session_cache use one process-wide share instead of
+// their own, so a TLS session (or connection) negotiated by one client is
+// resumed by every other client in the process. It lives while any such
+// client does. Sessions also outlive it when libcurl can export them
+// (curl_easy_ssls_export, 8.12.0 built with SSLS-EXPORT): they are kept in
+// tls_sessions for the next share and, with http.tls.persist_sessions, in a
+// file for the next process.
+static pthread_mutex_t process_share_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t process_share_locks[CURL_LOCK_DATA_LAST];
+static CURLSH *process_share;                   // Guarded by process_share_lock
+static int process_share_clients;
+#if LIBCURL_VERSION_NUM >= 0x080c00
+static sgnl_tls_session_store_t *tls_sessions;  // Guarded by process_share_lock
+static bool tls_sessions_loaded;                // Session file read into tls_sessions
+
+static CURLcode tls_session_export_callback(CURL *handle, void *userptr, const char *session_key,
+                                            const unsigned char *shmac, size_t shmac_len,
+                                            const unsigned char *sdata, size_t sdata_len,
+                                            curl_off_t valid_until, int ietf_tls_id,
+                                            const char *alpn, size_t earlydata_max) {
+    (void)handle;
+    (void)session_key;
+    (void)ietf_tls_id;
+    (void)alpn;
+    (void)earlydata_max;
+    sgnl_tls_session_store_add((sgnl_tls_session_store_t *)userptr, shmac, shmac_len,
+                               sdata, sdata_len, (int64_t)valid_until);
+    return CURLE_OK;
+}
+#endif
+
+// Seed a new process share with the sessions kept from earlier ones.
+// Called with process_share_lock held.
+static void tls_sessions_import(sgnl_client_t *client, CURLSH *share) {
+#if LIBCURL_VERSION_NUM >= 0x080c00
+    if (!tls_sessions) {
+        tls_sessions = sgnl_tls_session_store_create();
+    }
+    if (tls_sessions && client->tls_persist_sessions && !tls_sessions_loaded) {
+        size_t loaded = sgnl_tls_session_store_load(tls_sessions, client->tls_session_file);
+        tls_sessions_loaded = true;
+        sgnl_log_debug(client, "Loaded %zu TLS sessions from %s", loaded, client->tls_session_file);
+    }
+    size_t count = sgnl_tls_session_store_count(tls_sessions);
+    CURL *curl = count > 0 ? curl_easy_init() : NULL;
+    if (!curl) {
+        return;
+    }
     
-    curl = curl_easy_init();
+    // Sessions go into whatever cache the handle uses: the share's
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char *shmac;
+        const unsigned char *data;
+        size_t shmac_len;
+        size_t data_len;
+        if (sgnl_tls_session_store_get(tls_sessions, i, &shmac, &shmac_len, &data, &data_len)) {
+            curl_easy_ssls_import(curl, NULL, shmac, shmac_len, data, data_len);
+        }
+    }
+    curl_easy_cleanup(curl);
+#else
+    (void)client;
+    (void)share;
+#endif
+}
+
+// Keep the sessions of a process share that is going away (and save them).
+// Called with process_share_lock held.
+static void tls_sessions_export(sgnl_client_t *client, CURLSH *share) {
+#if LIBCURL_VERSION_NUM >= 0x080c00
+    sgnl_tls_session_store_t *exported = sgnl_tls_session_store_create();
+    CURL *curl = exported ? curl_easy_init() : NULL;
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share);
+        CURLcode rc = curl_easy_ssls_export(curl, tls_session_export_callback, exported);
+        if (rc != CURLE_OK) {
+            sgnl_log_debug(client, "TLS sessions not exported: %s", curl_easy_strerror(rc));
+        } else if (sgnl_tls_session_store_count(exported) > 0 && tls_sessions) {
+            sgnl_tls_session_store_copy(tls_sessions, exported);
+            if (client->tls_persist_sessions && !sgnl_tls_session_store_save(tls_sessions, client->tls_session_file)) {
+                sgnl_log_debug(client, "Could not save TLS sessions to %s", client->tls_session_file);
+            }
+        }
+        curl_easy_cleanup(curl);
+    }
+    sgnl_tls_session_store_free(exported);
+#else
+    (void)client;
+    (void)share;
+#endif
+}
+
+static CURLSH* process_share_acquire(sgnl_client_t *client) {
+    pthread_mutex_lock(&process_share_lock);
+    if (!process_share) {
+        for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+            pthread_mutex_init(&process_share_locks[i], NULL);
+        }
+        process_share = http_share_create(process_share_locks, true);
+        if (process_share) {
+            tls_sessions_import(client, process_share);
+        } else {
+            for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+                pthread_mutex_destroy(&process_share_locks[i]);
+            }
+        }
+    }
+    CURLSH *share = process_share;
+    if (share) {
+        process_share_clients++;
+    }
+    pthread_mutex_unlock(&process_share_lock);
+    return share;
+}
+
+// Called once the client's handles are gone; the last client closes the share
+static void process_share_release(sgnl_client_t *client) {
+    pthread_mutex_lock(&process_share_lock);
+    if (--process_share_clients == 0) {
+        tls_sessions_export(client, process_share);
+        // A share still in use (a leaked handle) is left alone, locks and all
+        if (curl_share_cleanup(process_share) == CURLSHE_OK) {
+            for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+                pthread_mutex_destroy(&process_share_locks[i]);
+            }
+        }
+        process_share = NULL;
+    }
+    pthread_mutex_unlock(&process_share_lock);
+}
+
+// Create the client's persistent curl handle with all per-client options set.
+// Per-request options (URL, body, headers, sink) are applied in make_http_request.
+static CURL* http_handle_create(sgnl_client_t *client) {
+    CURL *curl = curl_easy_init();
     if (!curl) {
         return NULL;
     }
     
-    response = calloc(1, sizeof(http_response_t));
-    if (!response) {
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, http_write_callback);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, client->user_agent);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)client->connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, client->ssl_verify_peer ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, client->ssl_verify_host ? 2L : 0L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    
+    // A resumed TLS 1.3 session may carry the request in its first flight
+#ifdef CURLSSLOPT_EARLYDATA
+    if (client->tls_early_data) {
+        curl_easy_setopt(curl, CURLOPT_SSL_OPTIONS, (long)CURLSSLOPT_EARLYDATA);
+    }
+#endif
+    
+    // Offer every encoding libcurl can decode (gzip, deflate, and br or
+    // zstd when built with them); bodies reach the parser decoded
+    if (client->compression_response) {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
+    
+    // Resolved addresses are shared by all of the client's handles and
+    // reused for dns.cache_ttl_seconds; static entries bypass DNS entirely
+    curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, (long)client->dns_cache_ttl_seconds);
+    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, client->ip_resolve);
+    if (client->resolve) {
+        curl_easy_setopt(curl, CURLOPT_RESOLVE, client->resolve);
+    }
+#if LIBCURL_VERSION_NUM >= 0x073b00
+    if (client->happy_eyeballs_timeout_ms > 0) {
+        curl_easy_setopt(curl, CURLOPT_HAPPY_EYEBALLS_TIMEOUT_MS, (long)client->happy_eyeballs_timeout_ms);
+    }
+#endif
+    
+    // Keep the connection alive between evaluations
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 60L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 30L);
+    
+    // Prefer HTTP/2 over TLS when libcurl was built with it
+    curl_version_info_data *info = curl_version_info(CURLVERSION_NOW);
+    if (info && (info->features & CURL_VERSION_HTTP2)) {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    }
+    
+    if (client->share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, client->share);
+    }
+    
+    return curl;
+}
+
+// Borrow an easy handle for one request; handles are never used by two
+// threads at once
+static CURL* http_handle_acquire(sgnl_client_t *client) {
+    http_global_init();
+    
+    pthread_mutex_lock(&client->pool_lock);
+    if (!client->share) {
+        client->share = client->tls_session_cache ? process_share_acquire(client) :
+                                                    http_share_create(client->share_locks, false);
+    }
+    CURL *curl = client->idle_count > 0 ? client->idle_handles[--client->idle_count] : NULL;
+    pthread_mutex_unlock(&client->pool_lock);
+    
+    return curl ? curl : http_handle_create(client);
+}
+
+static void http_handle_release(sgnl_client_t *client, CURL *curl) {
+    pthread_mutex_lock(&client->pool_lock);
+    if (client->idle_count < SGNL_HANDLE_POOL_SIZE) {
+        client->idle_handles[client->idle_count++] = curl;
+        curl = NULL;
+    }
+    pthread_mutex_unlock(&client->pool_lock);
+    
+    if (curl) {
         curl_easy_cleanup(curl);
+    }
+}
+
+// Borrow a buffer for writing one request body. Buffers keep their
+// capacity, so a steady stream of similar requests allocates nothing.
+static sgnl_json_buffer_t body_buffer_acquire(sgnl_client_t *client) {
+    sgnl_json_buffer_t buffer = {0};
+    pthread_mutex_lock(&client->pool_lock);
+    if (client->idle_body_count > 0) {
+        buffer = client->idle_bodies[--client->idle_body_count];
+    }
+    pthread_mutex_unlock(&client->pool_lock);
+    return buffer;
+}
+
+static void body_buffer_release(sgnl_client_t *client, sgnl_json_buffer_t *buffer) {
+    if (buffer->data && buffer->capacity <= SGNL_BODY_BUFFER_MAX_RETAINED) {
+        pthread_mutex_lock(&client->pool_lock);
+        if (client->idle_body_count < SGNL_BODY_POOL_SIZE) {
+            client->idle_bodies[client->idle_body_count++] = *buffer;
+            buffer->data = NULL;
+            buffer->capacity = 0;
+        }
+        pthread_mutex_unlock(&client->pool_lock);
+    }
+    sgnl_json_buffer_free(buffer);
+}
+
+// Replace a large JSON body with its gzip encoding, in arena, when request
+// compression is enabled. On any failure, or if the encoding is not
+// smaller, the body is sent as JSON.
+static void http_body_compress(sgnl_client_t *client, sgnl_arena_t *arena, http_body_t *body) {
+    if (!client->compression_request || body->gzip) {
+        return;
+    }
+    
+    const char *encoded = NULL;
+    size_t length = sgnl_gzip_encode(arena, body->data, body->length,
+                                     (size_t)client->compression_request_min_bytes,
+                                     Z_DEFAULT_COMPRESSION, &encoded);
+    if (length == 0) {
+        return;
+    }
+    sgnl_log_debug(client, "Request body compressed from %zu to %zu bytes", body->length, length);
+    body->data = encoded;
+    body->length = length;
+    body->gzip = true;
+}
+
+// Allocate a response for one attempt on curl. With a stream, a 200 body
+// is parsed as it arrives instead of being buffered.
+static http_response_t* http_response_create(CURL *curl, sgnl_json_stream_t *stream) {
+    http_response_t *response = calloc(1, sizeof(http_response_t));
+    if (!response) {
         return NULL;
     }
     
     response->data = calloc(1, sizeof(char));
     if (!response->data) {
         free(response);
-        curl_easy_cleanup(curl);
         return NULL;
     }
     response->size = 0;
-    
+    response->retry_after_seconds = -1;
+    response->stream = stream;
+    response->curl = curl;
+    sgnl_json_stream_reset(stream);
+    return response;
+}
+
+// Apply the per-request options for one attempt; everything else was set
+// once in http_handle_create. Returns the header list to pass to
+// http_request_complete.
+static struct curl_slist* http_request_setup(sgnl_client_t *client, CURL *curl, http_response_t *response,
+                                             const char *endpoint, const http_body_t *body,
+                                             long timeout_ms, const char *request_id) {
     // Build full URL
     char url[512];
-    snprintf(url, sizeof(url), "https://%s.%s%s", client->tenant, client->api_url, endpoint);
+    snprintf(url, sizeof(url), "%s%s", client->base_url, endpoint);
     
     sgnl_log_debug(client, "Making HTTP request to: %s", url);
-    sgnl_log_debug(client, "Request body: %s", json_body ? json_body : "NULL");
+    if (!body) {
+        sgnl_log_debug(client, "Request body: NULL");
+    } else if (body->gzip) {
+        sgnl_log_debug(client, "Request body: %zu bytes, gzip", body->length);
+    } else {
+        sgnl_log_debug(client, "Request body: %s", body->data);
+    }
     
-    // Set curl options
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, http_write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, client->user_agent);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long)client->timeout_seconds);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, (long)client->connect_timeout_seconds);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, client->ssl_verify_peer ? 1L : 0L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, client->ssl_verify_host ? 2L : 0L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    
+    // Only cancellable requests pay for progress callbacks
+    if (response->cancel) {
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, http_progress_callback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, response);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
+    }
     
     // Set POST data
-    if (json_body) {
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_body);
+    if (body) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)body->length);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body->data);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
     }
     
     // Set headers
     struct curl_slist *headers = NULL;
     headers = curl_slist_append(headers, "Accept: application/json");
     headers = curl_slist_append(headers, "Content-Type: application/json");
-    
-    // Authorization header
-    char auth_header[768];
-    snprintf(auth_header, sizeof(auth_header), "Authorization: Bearer %s", client->api_token);
-    headers = curl_slist_append(headers, auth_header);
+    if (body && body->gzip) {
+        headers = curl_slist_append(headers, "Content-Encoding: gzip");
+    }
+    headers = curl_slist_append(headers, client->auth_header);
     
     // Request ID header
     char req_id_header[128];
-    snprintf(req_id_header, sizeof(req_id_header), "X-Request-Id: %s", client->last_request_id);
+    snprintf(req_id_header, sizeof(req_id_header), "X-Request-Id: %s", request_id);
     headers = curl_slist_append(headers, req_id_header);
     
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    return headers;
+}
+
+static uint64_t elapsed_us(double from_seconds, double to_seconds) {
+    return to_seconds > from_seconds ? (uint64_t)((to_seconds - from_seconds) * 1e6) : 0;
+}
+
+// Count a finished attempt and time its phases. libcurl's times are
+// cumulative from the start of the attempt; each phase is the difference.
+static void stats_record_attempt(sgnl_client_t *client, CURL *curl, const http_response_t *response,
+                                 long new_connections) {
+    sgnl_stats_t *stats = &client->stats;
+    sgnl_stats_add(&stats->requests, 1);
+    sgnl_stats_add(&stats->connections, (uint64_t)(new_connections > 0 ? new_connections : 0));
+    if (response->status_code != 200) {
+        sgnl_stats_add(&stats->request_errors, 1);
+    }
+    if (response->status_code == 0) {
+        return;
+    }
     
-    // Perform request
-    res = curl_easy_perform(curl);
+    double namelookup = 0, connect = 0, appconnect = 0, pretransfer = 0, starttransfer = 0, total = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &pretransfer);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+    
+    if (new_connections > 0) {
+        sgnl_histogram_record(&stats->phases[SGNL_PHASE_DNS], elapsed_us(0, namelookup));
+        sgnl_histogram_record(&stats->phases[SGNL_PHASE_CONNECT], elapsed_us(namelookup, connect));
+        if (appconnect > 0) {
+            sgnl_histogram_record(&stats->phases[SGNL_PHASE_TLS], elapsed_us(connect, appconnect));
+        }
+    }
+    sgnl_histogram_record(&stats->phases[SGNL_PHASE_FIRST_BYTE], elapsed_us(pretransfer, starttransfer));
+    sgnl_histogram_record(&stats->phases[SGNL_PHASE_TOTAL], elapsed_us(0, total));
+    if (response->parse_us > 0) {
+        sgnl_histogram_record(&stats->phases[SGNL_PHASE_PARSE], (uint64_t)response->parse_us);
+    }
+}
+
+// Record the outcome of a finished attempt and drop references to
+// request-scoped memory before it goes away
+static void http_request_complete(sgnl_client_t *client, CURL *curl, http_response_t *response,
+                                  CURLcode res, struct curl_slist *headers) {
+    sgnl_json_stream_t *stream = response->stream;
     
     // Get response code
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response->status_code);
-    
-    sgnl_log_debug(client, "HTTP response: status=%ld, curl_result=%d", response->status_code, res);
+    response->curl_result = res;
+    
+    // A connect timeout reports CURLE_OPERATION_TIMEDOUT like a slow server
+    // does; the connect time tells them apart
+    double connect_time = 0;
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect_time);
+    response->connected = connect_time > 0;
+    
+#if LIBCURL_VERSION_NUM >= 0x074200
+    curl_off_t retry_after = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retry_after) == CURLE_OK && retry_after > 0) {
+        response->retry_after_seconds = (long)retry_after;
+    }
+#endif
+    
+    long new_connections = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &new_connections);
+    sgnl_log_debug(client, "HTTP response: status=%ld, curl_result=%d, connection=%s",
+                   response->status_code, res, new_connections > 0 ? "new" : "reused");
+    stats_record_attempt(client, curl, response, new_connections);
     if (response->data && response->size > 0) {
         sgnl_log_debug(client, "Response body: %.*s", (int)response->size, response->data);
     }
     
-    // Handle curl errors
-    if (res != CURLE_OK) {
+    // The write callback stopped the transfer because the parser was done
+    // with it; the HTTP exchange itself succeeded
+    if (res == CURLE_WRITE_ERROR && stream && sgnl_json_stream_status(stream) != SGNL_JSON_STREAM_OK) {
+        sgnl_log_debug(client, "Response stream ended early: %s",
+                       sgnl_json_stream_status(stream) == SGNL_JSON_STREAM_STOPPED ? "consumer stopped" : "malformed JSON");
+    } else if (res != CURLE_OK) {
         size_t error_len = strlen(curl_easy_strerror(res)) + 1;
         response->error_message = malloc(error_len);
         if (response->error_message) {
@@ -333,227 +1004,493 @@ static http_response_t* make_http_request(sgnl_client_t *client, const char *end
         response->status_code = 0;
     }
     
-    // Cleanup
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, NULL);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, NULL);
     curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
-    return response;
+    response->curl = NULL;
 }
 
-// Parse SGNL API response and extract decision
-static sgnl_result_t parse_api_response(const char *json_data, sgnl_access_result_t *result) {
-    if (!json_data || !result) {
-        return SGNL_ERROR;
+// Perform a single HTTP attempt, bounded by timeout_ms
+static http_response_t* http_request_once(sgnl_client_t *client, const char *endpoint,
+                                          const http_body_t *body, long timeout_ms,
+                                          sgnl_json_stream_t *stream, const char *request_id,
+                                          const int *cancel) {
+    CURL *curl = http_handle_acquire(client);
+    if (!curl) {
+        sgnl_log_error(client, "Failed to initialize HTTP transport");
+        return NULL;
     }
     
-    json_object *root = json_tokener_parse(json_data);
-    if (!root) {
-        strncpy(result->error_message, "Failed to parse JSON response", sizeof(result->error_message) - 1);
-        result->error_message[sizeof(result->error_message) - 1] = '\0';
-        return SGNL_ERROR;
+    http_response_t *response = http_response_create(curl, stream);
+    if (!response) {
+        http_handle_release(client, curl);
+        return NULL;
     }
+    response->cancel = cancel;
     
-    // Check for API errors
-    json_object *error_obj;
-    if (json_object_object_get_ex(root, "error", &error_obj)) {
-        json_object *error_msg;
-        if (json_object_object_get_ex(error_obj, "message", &error_msg)) {
-            strncpy(result->error_message, json_object_get_string(error_msg), sizeof(result->error_message) - 1);
-            result->error_message[sizeof(result->error_message) - 1] = '\0';
-        }
-        json_object_put(root);
-        return SGNL_ERROR;
-    }
+    struct curl_slist *headers = http_request_setup(client, curl, response, endpoint, body,
+                                                    timeout_ms, request_id);
     
-    // Get decisions array
-    json_object *decisions;
-    if (!json_object_object_get_ex(root, "decisions", &decisions) ||
-        !json_object_is_type(decisions, json_type_array)) {
-        json_object_put(root);
-        strncpy(result->error_message, "No decisions in response", sizeof(result->error_message) - 1);
-        result->error_message[sizeof(result->error_message) - 1] = '\0';
-        return SGNL_ERROR;
-    }
+    // Perform request
+    CURLcode res = curl_easy_perform(curl);
     
-    int decision_count = json_object_array_length(decisions);
-    if (decision_count == 0) {
-        json_object_put(root);
-        strncpy(result->decision, "Deny", sizeof(result->decision) - 1);
-        result->decision[sizeof(result->decision) - 1] = '\0';
-        return SGNL_DENIED;
+    http_request_complete(client, curl, response, res, headers);
+    http_handle_release(client, curl);
+    
+    return response;
+}
+
+static int64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void sleep_ms(int64_t ms) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(ms / 1000),
+        .tv_nsec = (long)(ms % 1000) * 1000000L
+    };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+// xorshift64: cheap, per-client, good enough for spreading retries
+static uint64_t retry_random(sgnl_client_t *client) {
+    uint64_t current = __atomic_load_n(&client->retry_rng, __ATOMIC_RELAXED);
+    uint64_t x;
+    do {
+        x = current;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    } while (!__atomic_compare_exchange_n(&client->retry_rng, &current, x, false,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    return x;
+}
+
+// Transient failures worth another attempt: overload/unavailable responses
+// and failures to reach the server at all. Anything else (4xx, TLS
+// verification, a timeout after the request was sent) is returned as is.
+static bool http_response_is_retryable(const http_response_t *response) {
+    if (response->curl_result == CURLE_OK) {
+        return response->status_code == 429 || response->status_code >= 500;
+    }
+    
+    switch (response->curl_result) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_SSL_CONNECT_ERROR:
+            return true;
+        case CURLE_OPERATION_TIMEDOUT:
+            return !response->connected;
+        default:
+            return false;
+    }
+}
+
+// Full jitter: uniform in [0, min(max_delay, base * 2^retry)]
+static int64_t retry_backoff_ms(sgnl_client_t *client, int retry) {
+    int64_t ceiling = client->retry_base_delay_ms;
+    for (int i = 0; i < retry && ceiling < client->retry_max_delay_ms; i++) {
+        ceiling *= 2;
+    }
+    if (ceiling > client->retry_max_delay_ms) {
+        ceiling = client->retry_max_delay_ms;
+    }
+    return (int64_t)(retry_random(client) % (uint64_t)(ceiling + 1));
+}
+
+// Deadline for one call, in monotonic_ms() time: the retry budget, cut
+// short by the end-to-end deadline. Taken when the call starts so that the
+// broker round trip counts against it too.
+static int64_t http_retry_deadline(sgnl_client_t *client) {
+    int64_t budget_ms = client->retry_budget_ms > 0 ? client->retry_budget_ms : client->timeout_ms;
+    if (client->deadline_ms > 0 && client->deadline_ms < budget_ms) {
+        budget_ms = client->deadline_ms;
+    }
+    return monotonic_ms() + budget_ms;
+}
+
+// Broker round-trip timeout, cut short by the deadline
+static int broker_call_timeout_ms(sgnl_client_t *client, int64_t deadline) {
+    int64_t remaining = deadline - monotonic_ms();
+    if (remaining >= client->broker_timeout_ms) {
+        return client->broker_timeout_ms;
+    }
+    return remaining < 1 ? 1 : (int)remaining;
+}
+
+// Timeout for the next attempt: the request timeout, cut short by the deadline
+static long http_attempt_timeout_ms(sgnl_client_t *client, int64_t deadline) {
+    int64_t timeout_ms = client->timeout_ms;
+    int64_t remaining = deadline - monotonic_ms();
+    int64_t attempt_timeout = remaining < timeout_ms ? remaining : timeout_ms;
+    return attempt_timeout < 1 ? 1 : (long)attempt_timeout;
+}
+
+// Decide whether a finished attempt should be retried. Returns the backoff
+// before the next attempt, or -1 to keep this response.
+static int64_t http_retry_delay_ms(sgnl_client_t *client, const http_response_t *response,
+                                   sgnl_json_stream_t *stream, int attempt, int64_t deadline) {
+    if (attempt >= client->retry_max_retries || !http_response_is_retryable(response)) {
+        return -1;
     }
     
-    // Get first decision
-    json_object *decision_obj = json_object_array_get_idx(decisions, 0);
-    if (!decision_obj) {
-        json_object_put(root);
-        return SGNL_ERROR;
+    // Decisions already handed to the consumer cannot be taken back
+    if (sgnl_json_stream_decision_count(stream) > 0) {
+        return -1;
     }
     
-    json_object *decision_value;
-    if (json_object_object_get_ex(decision_obj, "decision", &decision_value)) {
-        const char *decision_str = json_object_get_string(decision_value);
-        if (decision_str) {
-            strncpy(result->decision, decision_str, sizeof(result->decision) - 1);
-            result->decision[sizeof(result->decision) - 1] = '\0';
-            
-            if (strcmp(decision_str, "Allow") == 0) {
-                json_object_put(root);
-                return SGNL_ALLOWED;
-            }
+    int64_t delay = retry_backoff_ms(client, attempt);
+    if (response->retry_after_seconds >= 0) {
+        // The server knows when it will be back; waiting less only adds load
+        int64_t retry_after = (int64_t)response->retry_after_seconds * 1000;
+        if (retry_after > delay) {
+            delay = retry_after;
         }
     }
     
-    // Extract reason if available
-    json_object *reason_value;
-    if (json_object_object_get_ex(decision_obj, "reason", &reason_value)) {
-        const char *reason_str = json_object_get_string(reason_value);
-        if (reason_str) {
-            strncpy(result->reason, reason_str, sizeof(result->reason) - 1);
-            result->reason[sizeof(result->reason) - 1] = '\0';
-        }
+    int64_t remaining = deadline - monotonic_ms();
+    if (delay >= remaining) {
+        sgnl_log_debug(client, "Not retrying: %lld ms backoff exceeds remaining budget of %lld ms",
+                       (long long)delay, (long long)remaining);
+        return -1;
     }
     
-    json_object_put(root);
-    return SGNL_DENIED;
+    sgnl_stats_add(&client->stats.retries, 1);
+    sgnl_log_debug(client, "Transient failure (status=%ld, curl=%d), retry %d/%d in %lld ms",
+                   response->status_code, response->curl_result, attempt + 1,
+                   client->retry_max_retries, (long long)delay);
+    return delay;
 }
 
-// ============================================================================
-// Public API Implementation
-// ============================================================================
+// Remember how long an evaluation attempt took to answer
+static void latency_record(sgnl_client_t *client, int64_t elapsed_ms) {
+    pthread_mutex_lock(&client->latency_lock);
+    sgnl_latency_window_record(&client->latency, elapsed_ms);
+    pthread_mutex_unlock(&client->latency_lock);
+}
 
-sgnl_client_t* sgnl_client_create(const sgnl_client_config_t *config) {
-    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
-    
-    SGNL_LOG_DEBUG(&log_ctx, "Creating SGNL client");
+// How long an attempt may run before it is hedged (see sgnl_hedge_delay_ms)
+static int64_t hedge_delay_ms(sgnl_client_t *client) {
+    pthread_mutex_lock(&client->latency_lock);
+    sgnl_latency_window_t window = client->latency;
+    pthread_mutex_unlock(&client->latency_lock);
+    
+    return sgnl_hedge_delay_ms(&window, client->hedging_percentile, client->hedging_initial_delay_ms,
+                               client->hedging_min_delay_ms);
+}
+
+typedef struct {
+    CURL *curl;
+    http_response_t *response;
+    struct curl_slist *headers;
+    bool done;
+} hedge_transfer_t;
+
+// Start one leg of a hedged attempt. The hedge insists on a new connection:
+// with HTTP/2 it would otherwise be multiplexed onto the slow one.
+static bool hedge_transfer_start(sgnl_client_t *client, CURLM *multi, hedge_transfer_t *transfer,
+                                 const char *endpoint, const http_body_t *body, long timeout_ms,
+                                 const char *request_id, bool fresh_connection, const int *cancel) {
+    transfer->curl = http_handle_acquire(client);
+    if (!transfer->curl) {
+        return false;
+    }
     
-    sgnl_client_t *client = calloc(1, sizeof(sgnl_client_t));
-    if (!client) {
-        SGNL_LOG_ERROR(&log_ctx, "Failed to allocate memory for client");
+    // Bodies are buffered; only the winner is handed to the parser
+    transfer->response = http_response_create(transfer->curl, NULL);
+    if (!transfer->response) {
+        http_handle_release(client, transfer->curl);
+        transfer->curl = NULL;
+        return false;
+    }
+    transfer->response->cancel = cancel;
+    
+    transfer->headers = http_request_setup(client, transfer->curl, transfer->response, endpoint,
+                                           body, timeout_ms, request_id);
+    curl_easy_setopt(transfer->curl, CURLOPT_FRESH_CONNECT, fresh_connection ? 1L : 0L);
+    if (curl_multi_add_handle(multi, transfer->curl) != CURLM_OK) {
+        curl_easy_setopt(transfer->curl, CURLOPT_HTTPHEADER, NULL);
+        curl_easy_setopt(transfer->curl, CURLOPT_WRITEDATA, NULL);
+        curl_easy_setopt(transfer->curl, CURLOPT_FRESH_CONNECT, 0L);
+        curl_slist_free_all(transfer->headers);
+        http_response_free(transfer->response);
+        http_handle_release(client, transfer->curl);
+        transfer->curl = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Release a leg; one that is still running is abandoned, which closes its connection
+static void hedge_transfer_finish(sgnl_client_t *client, CURLM *multi, hedge_transfer_t *transfer,
+                                  bool keep_response) {
+    if (!transfer->curl) {
+        return;
+    }
+    if (!transfer->done) {
+        curl_multi_remove_handle(multi, transfer->curl);
+        curl_easy_setopt(transfer->curl, CURLOPT_HTTPHEADER, NULL);
+        curl_easy_setopt(transfer->curl, CURLOPT_WRITEDATA, NULL);
+        curl_slist_free_all(transfer->headers);
+    }
+    if (!keep_response) {
+        http_response_free(transfer->response);
+    }
+    curl_easy_setopt(transfer->curl, CURLOPT_FRESH_CONNECT, 0L);
+    http_handle_release(client, transfer->curl);
+}
+
+// A single attempt raced across two connections: if the primary transfer has
+// not answered within the hedge delay, a duplicate is started on a fresh
+// connection and the first definitive answer wins. A transient failure only
+// wins once no other leg is still running, so the retry policy above sees
+// the same outcomes as with a single transfer.
+static http_response_t* http_request_hedged(sgnl_client_t *client, const char *endpoint,
+                                            const http_body_t *body, long timeout_ms,
+                                            sgnl_json_stream_t *stream, const char *request_id,
+                                            const int *cancel) {
+    CURLM *multi = curl_multi_init();
+    if (!multi) {
+        return http_request_once(client, endpoint, body, timeout_ms, stream, request_id, cancel);
+    }
+    
+    hedge_transfer_t transfers[2];
+    memset(transfers, 0, sizeof(transfers));
+    int64_t start = monotonic_ms();
+    int64_t hedge_at = start + hedge_delay_ms(client);
+    if (!hedge_transfer_start(client, multi, &transfers[0], endpoint, body, timeout_ms, request_id,
+                              false, cancel)) {
+        curl_multi_cleanup(multi);
+        sgnl_log_error(client, "Failed to initialize HTTP transport");
         return NULL;
     }
+    sgnl_hedge_race_t race;
+    sgnl_hedge_race_init(&race);
     
-    // Set defaults
-    client->timeout_seconds = 30;
-    client->connect_timeout_seconds = 10;
-    client->ssl_verify_peer = true;
-    client->ssl_verify_host = true;
-    strcpy(client->user_agent, "SGNL-Client/1.0");
-    client->debug_enabled = false;
-    
-    // Apply configuration
-    if (config) {
-        if (config->timeout_seconds > 0) {
-            client->timeout_seconds = config->timeout_seconds;
+    while (race.winner < 0) {
+        int running = 0;
+        curl_multi_perform(multi, &running);
+        
+        CURLMsg *msg;
+        int queued;
+        while (race.winner < 0 && (msg = curl_multi_info_read(multi, &queued)) != NULL) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            int i = msg->easy_handle == transfers[0].curl ? 0 : 1;
+            CURLcode res = msg->data.result;
+            curl_multi_remove_handle(multi, transfers[i].curl);
+            http_request_complete(client, transfers[i].curl, transfers[i].response, res, transfers[i].headers);
+            transfers[i].headers = NULL;
+            transfers[i].done = true;
+            
+            bool answered = res == CURLE_OK && !http_response_is_retryable(transfers[i].response);
+            sgnl_hedge_race_finish(&race, i, answered);
         }
-        if (config->retry_count >= 0) {
-            // Note: retry logic not implemented in this simplified version
+        if (race.winner >= 0) {
+            break;
         }
-        client->debug_enabled = config->enable_debug_logging;
-        client->ssl_verify_peer = config->validate_ssl;
-        client->ssl_verify_host = config->validate_ssl;
         
-        if (config->user_agent) {
-            strncpy(client->user_agent, config->user_agent, sizeof(client->user_agent) - 1);
-            client->user_agent[sizeof(client->user_agent) - 1] = '\0';
+        int64_t now = monotonic_ms();
+        if (race.started == 1 && now >= hedge_at) {
+            long remaining = timeout_ms - (long)(now - start);
+            if (remaining > 0 && hedge_transfer_start(client, multi, &transfers[1], endpoint, body,
+                                                      remaining, request_id, true, cancel)) {
+                race.started = 2;
+                sgnl_stats_add(&client->stats.hedges, 1);
+                sgnl_log_debug(client, "No answer after %lld ms, hedging request on a second connection",
+                               (long long)(now - start));
+            }
+            hedge_at = INT64_MAX;
+        }
+        
+        int64_t wait_ms = 1000;
+        if (hedge_at != INT64_MAX && hedge_at - now < wait_ms) {
+            wait_ms = hedge_at - now > 0 ? hedge_at - now : 0;
         }
+        curl_multi_wait(multi, NULL, 0, (int)wait_ms, NULL);
     }
     
-    // Load configuration from common config system
-    const char *config_path = config ? config->config_path : NULL;
-    if (load_config_from_common_system(client, config_path) != SGNL_OK) {
-        SGNL_LOG_ERROR(&log_ctx, "Failed to load configuration from common system");
-        free(client);
-        return NULL;
-    }
-    
-    // Validate required fields
-    if (strlen(client->api_url) == 0 || strlen(client->api_token) == 0) {
-        sgnl_log_error(client, "Missing required configuration: api_url or api_token");
-        free(client);
-        return NULL;
+    int winner = race.winner;
+    http_response_t *response = transfers[winner].response;
+    if (response->curl_result == CURLE_OK && response->status_code == 200) {
+        latency_record(client, monotonic_ms() - start);
+        if (winner == 1) {
+            sgnl_log_debug(client, "Hedged request answered first");
+        }
+        
+        // Hand the winning body to the parser as if it had streamed in
+        if (stream) {
+            int64_t parse_start = monotonic_us();
+            sgnl_hedge_replay(stream, response->data, response->size);
+            sgnl_histogram_record(&client->stats.phases[SGNL_PHASE_PARSE], (uint64_t)(monotonic_us() - parse_start));
+            response->stream = stream;
+            response->size = 0;
+            response->data[0] = '\0';
+        }
     }
     
-    // Initialize common logging system with client's debug setting
-    sgnl_logger_config_t logging_config = sgnl_logger_config;
-    if (client->debug_enabled) {
-        logging_config.min_level = SGNL_LOG_DEBUG;
+    for (int i = 0; i < race.started; i++) {
+        hedge_transfer_finish(client, multi, &transfers[i], i == winner);
     }
-    sgnl_log_init(&logging_config);
-    
-    client->initialized = true;
-    sgnl_log_debug(client, "SGNL client initialized successfully");
-    sgnl_log_debug(client, "Config: tenant=%s, api_url=%s", 
-                   client->tenant, client->api_url);
-    
-    SGNL_LOG_DEBUG(&log_ctx, "SGNL client created and initialized successfully");
-    
-    return client;
+    curl_multi_cleanup(multi);
+    return response;
 }
 
-void sgnl_client_destroy(sgnl_client_t *client) {
-    if (client) {
-        sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
-        SGNL_LOG_DEBUG(&log_ctx, "Destroying SGNL client");
+// Make HTTP request to SGNL API, retrying transient failures until deadline
+// (from http_retry_deadline). Returns the last attempt's response. With a
+// stream, a 200 body is parsed as it arrives instead of being buffered.
+// Setting *cancel (when given) aborts the request and stops retrying.
+static http_response_t* make_http_request(sgnl_client_t *client, const char *endpoint,
+                                          const http_body_t *body, sgnl_json_stream_t *stream,
+                                          const char *request_id, int64_t deadline,
+                                          const int *cancel) {
+    // Evaluations are idempotent and latency-critical; searches are not hedged
+    bool hedge = client->hedging_enabled && strcmp(endpoint, "/access/v2/evaluations") == 0;
+    
+    for (int attempt = 0; ; attempt++) {
+        long timeout_ms = http_attempt_timeout_ms(client, deadline);
+        http_response_t *response = hedge ?
+            http_request_hedged(client, endpoint, body, timeout_ms, stream, request_id, cancel) :
+            http_request_once(client, endpoint, body, timeout_ms, stream, request_id, cancel);
+        if (!response) {
+            return NULL;
+        }
         
-        // Clear sensitive data
-        memset(client->api_token, 0, sizeof(client->api_token));
-        free(client);
+        int64_t delay = http_retry_delay_ms(client, response, stream, attempt, deadline);
+        if (delay < 0 || (cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED))) {
+            return response;
+        }
         
-        // Cleanup logging system (only if no other clients are using it)
-        sgnl_log_cleanup();
+        http_response_free(response);
+        sleep_ms(delay);
     }
 }
 
-sgnl_result_t sgnl_client_validate(sgnl_client_t *client) {
-    if (!client || !client->initialized) {
-        return SGNL_ERROR;
+// Serialized {"id":...,"deviceId":...} for a principal. PAM and sudo evaluate
+// one user per process, so the most recent principal is kept on the client.
+// Called with principal_lock held.
+static const char* principal_json(sgnl_client_t *client, const char *principal_id) {
+    if (client->principal_json && strcmp(client->principal_json_id, principal_id) == 0) {
+        return client->principal_json;
+    }
+    
+    char storage[512];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, storage, sizeof(storage));
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init(&writer, &arena, strlen(principal_id) + strlen(client->device_id) + 32);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "id");
+    sgnl_json_writer_string(&writer, principal_id);
+    sgnl_json_writer_key(&writer, "deviceId");
+    sgnl_json_writer_string(&writer, client->device_id);
+    sgnl_json_writer_end_object(&writer);
+    
+    const char *serialized = sgnl_json_writer_finish(&writer);
+    char *copy = serialized ? strdup(serialized) : NULL;
+    sgnl_arena_release(&arena);
+    if (!copy) {
+        return NULL;
     }
     
-    if (strlen(client->api_url) == 0) {
-        return SGNL_CONFIG_ERROR;
+    free(client->principal_json);
+    client->principal_json = copy;
+    if (strlen(principal_id) < sizeof(client->principal_json_id)) {
+        strcpy(client->principal_json_id, principal_id);
+    } else {
+        client->principal_json_id[0] = '\0';  // Too long to key on; rebuilt every call
     }
+    return copy;
+}
+
+// Open a request body with the cached principal member; the caller writes
+// the remaining members and closes the object
+static bool write_request_start(sgnl_client_t *client, sgnl_json_writer_t *writer, const char *principal_id) {
+    pthread_mutex_lock(&client->principal_lock);
     
-    if (strlen(client->api_token) == 0) {
-        return SGNL_CONFIG_ERROR;
+    const char *principal = principal_json(client, principal_id);
+    if (principal) {
+        sgnl_json_writer_begin_object(writer);
+        sgnl_json_writer_key(writer, "principal");
+        sgnl_json_writer_raw(writer, principal);
     }
     
-    return SGNL_OK;
+    pthread_mutex_unlock(&client->principal_lock);
+    return principal != NULL;
 }
 
-const char* sgnl_client_get_last_error(sgnl_client_t *client) {
-    return client ? client->last_error : "No client";
+// One element of "queries"
+static void write_query(sgnl_json_writer_t *writer, const char *asset_id, const char *action) {
+    sgnl_json_writer_begin_object(writer);
+    if (asset_id) {
+        sgnl_json_writer_key(writer, "assetId");
+        sgnl_json_writer_string(writer, asset_id);
+    }
+    sgnl_json_writer_key(writer, "action");
+    sgnl_json_writer_string(writer, action);
+    sgnl_json_writer_end_object(writer);
 }
 
-bool sgnl_client_is_debug_enabled(sgnl_client_t *client) {
-    return client ? client->debug_enabled : false;
+// Stream callback for single evaluations: the first decision is the answer.
+// Later elements are consumed (not aborted) so the connection stays reusable.
+static bool single_decision_callback(const sgnl_json_decision_t *decision, int index, void *user_data) {
+    sgnl_access_result_t *result = (sgnl_access_result_t *)user_data;
+    
+    if (index == 0) {
+        if (decision->decision) {
+            strncpy(result->decision, decision->decision, sizeof(result->decision) - 1);
+            result->decision[sizeof(result->decision) - 1] = '\0';
+        }
+        if (decision->reason) {
+            strncpy(result->reason, decision->reason, sizeof(result->reason) - 1);
+            result->reason[sizeof(result->reason) - 1] = '\0';
+        }
+    }
+    return true;
 }
 
-
-
-sgnl_result_t sgnl_check_access(sgnl_client_t *client,
-                               const char *principal_id,
-                               const char *asset_id,
-                               const char *action) {
-    sgnl_access_result_t *result = sgnl_evaluate_access(client, principal_id, asset_id, action);
-    if (!result) {
+// Derive the decision from a fully streamed SGNL API response
+static sgnl_result_t parse_api_response(sgnl_json_stream_t *stream, sgnl_access_result_t *result) {
+    if (!stream || !result) {
         return SGNL_ERROR;
     }
     
-    sgnl_result_t res = result->result;
-    sgnl_access_result_free(result);
+    if (sgnl_json_stream_finish(stream) != SGNL_JSON_STREAM_OK) {
+        strncpy(result->error_message, "Failed to parse JSON response", sizeof(result->error_message) - 1);
+        result->error_message[sizeof(result->error_message) - 1] = '\0';
+        return SGNL_ERROR;
+    }
     
-    return res;
-}
-
-sgnl_access_result_t* sgnl_evaluate_access(sgnl_client_t *client,
-                                           const char *principal_id,
-                                           const char *asset_id,
-                                           const char *action) {
-    if (!client || !client->initialized || !principal_id) {
-        return NULL;
+    // Check for API errors
+    if (sgnl_json_stream_has_error(stream)) {
+        strncpy(result->error_message, sgnl_json_stream_error_message(stream), sizeof(result->error_message) - 1);
+        result->error_message[sizeof(result->error_message) - 1] = '\0';
+        return SGNL_ERROR;
+    }
+    
+    if (!sgnl_json_stream_has_decisions(stream)) {
+        strncpy(result->error_message, "No decisions in response", sizeof(result->error_message) - 1);
+        result->error_message[sizeof(result->error_message) - 1] = '\0';
+        return SGNL_ERROR;
+    }
+    
+    if (sgnl_json_stream_decision_count(stream) == 0) {
+        strncpy(result->decision, "Deny", sizeof(result->decision) - 1);
+        result->decision[sizeof(result->decision) - 1] = '\0';
+        return SGNL_DENIED;
     }
     
+    return strcmp(result->decision, "Allow") == 0 ? SGNL_ALLOWED : SGNL_DENIED;
+}
+
+// Allocate a single evaluation result carrying its query and a fresh request ID
+static sgnl_access_result_t* access_result_create(const char *principal_id, const char *asset_id,
+                                                  const char *action) {
     sgnl_access_result_t *result = calloc(1, sizeof(sgnl_access_result_t));
     if (!result) {
         return NULL;
@@ -576,440 +1513,2186 @@ sgnl_access_result_t* sgnl_evaluate_access(sgnl_client_t *client,
     }
     
     // Generate request ID
-    strcpy(client->last_request_id, generate_request_id_internal());
-    strncpy(result->request_id, client->last_request_id, sizeof(result->request_id) - 1);
-    result->request_id[sizeof(result->request_id) - 1] = '\0';
-    
-    sgnl_log_debug(client, "Evaluating access: principal=%s, asset=%s, action=%s",
-                   principal_id, asset_id ? asset_id : "N/A", result->action);
-    
-    // Create JSON request
-    json_object *request = json_object_new_object();
-    json_object *principal = json_object_new_object();
-    json_object *queries = json_object_new_array();
-    json_object *query = json_object_new_object();
-    
-    if (!request || !principal || !queries || !query) {
-        if (request) json_object_put(request);
-        if (principal) json_object_put(principal);
-        if (queries) json_object_put(queries);
-        if (query) json_object_put(query);
-        strncpy(result->error_message, "Failed to create JSON request", sizeof(result->error_message) - 1);
-        result->error_message[sizeof(result->error_message) - 1] = '\0';
-        return result;
+    generate_request_id_internal(result->request_id, sizeof(result->request_id));
+    return result;
+}
+
+// Fill result from the decision cache; returns false on a miss
+static bool evaluation_from_cache(sgnl_client_t *client, sgnl_access_result_t *result,
+                                  const char *principal_id, const char *asset_id) {
+    sgnl_result_t cached_result;
+    if (!sgnl_decision_cache_lookup(client->cache, principal_id, asset_id, result->action,
+                                    &cached_result, result->reason, sizeof(result->reason))) {
+        if (client->cache) {
+            sgnl_stats_add(&client->stats.cache_misses, 1);
+        }
+        return false;
     }
+    sgnl_stats_add(&client->stats.cache_hits, 1);
     
-    // Build request
-    json_object_object_add(principal, "id", json_object_new_string(principal_id));
-    json_object_object_add(principal, "deviceId", json_object_new_string(get_device_id()));
-    json_object_object_add(request, "principal", principal);
+    result->result = cached_result;
+    strcpy(result->decision, cached_result == SGNL_ALLOWED ? "Allow" : "Deny");
+    sgnl_log_debug(client, "Access evaluation served from cache: decision=%s", result->decision);
+    return true;
+}
+
+// Answer from the prefetched snapshot; only hits are trusted, a miss says nothing
+static bool evaluation_from_snapshot(sgnl_client_t *client, sgnl_access_result_t *result,
+                                     const char *principal_id, const char *asset_id) {
+    if (!sgnl_snapshot_contains(client->snapshot, principal_id, asset_id, result->action)) {
+        return false;
+    }
+    sgnl_stats_add(&client->stats.snapshot_hits, 1);
     
-    if (asset_id) {
-        json_object_object_add(query, "assetId", json_object_new_string(asset_id));
+    result->result = SGNL_ALLOWED;
+    strcpy(result->decision, "Allow");
+    strcpy(result->reason, "Prefetched entitlement snapshot");
+    sgnl_log_debug(client, "Access evaluation served from prefetched snapshot");
+    return true;
+}
+
+// Request body for a single evaluation, in writer's memory
+static const char* build_evaluation_body(sgnl_client_t *client, sgnl_json_writer_t *writer, const char *principal_id,
+                                         const char *asset_id, const char *action) {
+    if (!write_request_start(client, writer, principal_id)) {
+        return NULL;
+    }
+    sgnl_json_writer_key(writer, "queries");
+    sgnl_json_writer_begin_array(writer);
+    write_query(writer, asset_id, action);
+    sgnl_json_writer_end_array(writer);
+    sgnl_json_writer_end_object(writer);
+    return sgnl_json_writer_finish(writer);
+}
+
+// The API could not be reached or could not answer: no response, a network
+// or timeout failure, or an overload/unavailable status. Only these outcomes
+// may be replaced by an offline decision; TLS verification failures,
+// misconfiguration and authoritative 4xx answers never are.
+static bool http_response_unavailable(const http_response_t *response) {
+    if (!response) {
+        return true;
+    }
+    if (response->curl_result == CURLE_OK) {
+        return response->status_code == 429 || response->status_code >= 500;
+    }
+    switch (response->curl_result) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Result for a request that did not end in a 200 response
+static sgnl_result_t http_failure_result(const http_response_t *response) {
+    if (!response) {
+        return SGNL_NETWORK_ERROR;
+    }
+    if (response->status_code == 401 || response->status_code == 403) {
+        return SGNL_AUTH_ERROR;
+    }
+    if (response->curl_result == CURLE_OPERATION_TIMEDOUT) {
+        return SGNL_TIMEOUT_ERROR;
+    }
+    return response->status_code >= 500 ? SGNL_NETWORK_ERROR : SGNL_ERROR;
+}
+
+// Look up a recently recorded Allow while the API is unreachable, writing
+// the reason to report for it
+static bool offline_allow(sgnl_client_t *client, const char *principal_id, const char *asset_id,
+                          const char *action, char *reason, size_t reason_size) {
+    int64_t age_seconds = 0;
+    if (!sgnl_offline_store_lookup(client->offline, principal_id, asset_id, action, &age_seconds)) {
+        return false;
     }
-    json_object_object_add(query, "action", json_object_new_string(result->action));
-    json_object_array_add(queries, query);
-    json_object_object_add(request, "queries", queries);
     
-    const char *json_payload = json_object_to_json_string(request);
+    snprintf(reason, reason_size, "Offline: SGNL API unreachable, Allow recorded %llds ago", (long long)age_seconds);
+    sgnl_stats_add(&client->stats.offline_hits, 1);
     
-    // Make HTTP request
-    http_response_t *response = make_http_request(client, "/access/v2/evaluations", json_payload);
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
+    SGNL_LOG_WARNING(&log_ctx, "SGNL API unreachable; allowing principal=%s asset=%s action=%s from offline store (recorded %llds ago)",
+                     principal_id, asset_id ? asset_id : "N/A", action, (long long)age_seconds);
+    return true;
+}
+
+// Serve a recently recorded Allow while the API is unreachable
+static bool evaluation_from_offline_store(sgnl_client_t *client, sgnl_access_result_t *result,
+                                          const char *principal_id, const char *asset_id) {
+    if (!offline_allow(client, principal_id, asset_id, result->action, result->reason, sizeof(result->reason))) {
+        return false;
+    }
     
-    json_object_put(request);
+    result->result = SGNL_ALLOWED;
+    strcpy(result->decision, "Allow");
+    result->error_code = 0;
+    result->error_message[0] = '\0';
+    return true;
+}
+
+// Turn the final response of a single evaluation into its result and cache it.
+// Returns where the decision came from: "offline" or "network".
+static const char* finish_evaluation(sgnl_client_t *client, sgnl_access_result_t *result,
+                              http_response_t *response, sgnl_json_stream_t *stream,
+                              const char *principal_id, const char *asset_id) {
+    if (client->offline && http_response_unavailable(response) &&
+        evaluation_from_offline_store(client, result, principal_id, asset_id)) {
+        return "offline";
+    }
     
     if (!response) {
         result->result = SGNL_NETWORK_ERROR;
         strncpy(result->error_message, "HTTP request failed", sizeof(result->error_message) - 1);
         result->error_message[sizeof(result->error_message) - 1] = '\0';
-        return result;
+        return "network";
     }
     
     // Handle HTTP errors
     if (response->status_code != 200) {
-        if (response->status_code == 401 || response->status_code == 403) {
-            result->result = SGNL_AUTH_ERROR;
-        } else if (response->status_code >= 500) {
-            result->result = SGNL_NETWORK_ERROR;
-        } else {
-            result->result = SGNL_ERROR;
-        }
+        result->result = http_failure_result(response);
         result->error_code = response->status_code;
         snprintf(result->error_message, sizeof(result->error_message), 
                 "HTTP %ld: %s", response->status_code, 
                 response->error_message ? response->error_message : "Unknown error");
-        http_response_free(response);
-        return result;
+        return "network";
     }
     
     // Parse response
-    result->result = parse_api_response(response->data, result);
+    result->result = parse_api_response(stream, result);
     
-    http_response_free(response);
+    sgnl_decision_cache_store(client->cache, principal_id, asset_id, result->action,
+                              result->result, result->reason);
+    sgnl_offline_store_record(client->offline, principal_id, asset_id, result->action, result->result);
     
     sgnl_log_debug(client, "Access evaluation completed: decision=%s, result=%s",
                    result->decision, sgnl_result_to_string(result->result));
+    return "network";
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+// Release what a client being created holds so far; every failed
+// sgnl_client_create ends here. Returns NULL for the caller to return.
+static sgnl_client_t* client_create_abort(sgnl_client_t *client) {
+    sgnl_decision_cache_destroy(client->cache);
+    sgnl_snapshot_destroy(client->snapshot);
+    curl_slist_free_all(client->resolve);
+    memset(client->api_token, 0, sizeof(client->api_token));
+    memset(client->auth_header, 0, sizeof(client->auth_header));
+    free(client);
+    return NULL;
+}
+
+sgnl_client_t* sgnl_client_create(const sgnl_client_config_t *config) {
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
+    
+    SGNL_LOG_DEBUG(&log_ctx, "Creating SGNL client");
+    
+    sgnl_client_t *client = calloc(1, sizeof(sgnl_client_t));
+    if (!client) {
+        SGNL_LOG_ERROR(&log_ctx, "Failed to allocate memory for client");
+        return NULL;
+    }
+    
+    // Set defaults
+    client->timeout_ms = 30000;
+    client->connect_timeout_ms = 10000;
+    client->ssl_verify_peer = true;
+    client->ssl_verify_host = true;
+    strcpy(client->user_agent, "SGNL-Client/1.0");
+    client->debug_enabled = false;
+    
+    // Apply configuration
+    if (config) {
+        client->debug_enabled = config->enable_debug_logging;
+        client->ssl_verify_peer = config->validate_ssl;
+        client->ssl_verify_host = config->validate_ssl;
+        
+        if (config->user_agent) {
+            strncpy(client->user_agent, config->user_agent, sizeof(client->user_agent) - 1);
+            client->user_agent[sizeof(client->user_agent) - 1] = '\0';
+        }
+    }
+    
+    // Load configuration from common config system
+    const char *config_path = config ? config->config_path : NULL;
+    if (load_config_from_common_system(client, config_path) != SGNL_OK) {
+        SGNL_LOG_ERROR(&log_ctx, "Failed to load configuration from common system");
+        return client_create_abort(client);
+    }
+    
+    // The broker itself must never route back to the broker. Its callers
+    // write the audit record for each decision it serves, so it writes none.
+    if (config && config->bypass_broker) {
+        client->broker_enabled = false;
+        client->logger_config.audit_destination = SGNL_AUDIT_NONE;
+    }
+    
+    // Explicit timeouts and retry settings from the caller override the config file
+    if (config && config->timeout_ms > 0) {
+        client->timeout_ms = config->timeout_ms;
+    } else if (config && config->timeout_seconds > 0) {
+        client->timeout_ms = config->timeout_seconds * 1000;
+    }
+    if (config && config->deadline_ms > 0) {
+        client->deadline_ms = config->deadline_ms;
+    }
+    if (config && config->retry_count > 0) {
+        client->retry_max_retries = config->retry_count;
+    }
+    if (config && config->retry_delay_ms > 0) {
+        client->retry_base_delay_ms = config->retry_delay_ms;
+        if (client->retry_max_delay_ms < client->retry_base_delay_ms) {
+            client->retry_max_delay_ms = client->retry_base_delay_ms;
+        }
+    }
+    
+    // Seed jitter per client so hosts that failed together do not retry together
+    struct timespec seed_ts;
+    clock_gettime(CLOCK_MONOTONIC, &seed_ts);
+    client->retry_rng = ((uint64_t)seed_ts.tv_nsec << 20) ^ (uint64_t)seed_ts.tv_sec ^
+                        ((uint64_t)getpid() << 40) ^ (uint64_t)(uintptr_t)client;
+    if (client->retry_rng == 0) {
+        client->retry_rng = 0x9e3779b97f4a7c15ULL;
+    }
+    
+    // Validate required fields
+    if (strlen(client->api_url) == 0 || strlen(client->api_token) == 0) {
+        sgnl_log_error(client, "Missing required configuration: api_url or api_token");
+        return client_create_abort(client);
+    }
+    
+    // Precompute request-invariant strings; the persistent transport itself is
+    // opened on first use so broker-routed and cache-served clients never pay
+    // for libcurl/TLS initialization
+    snprintf(client->base_url, sizeof(client->base_url), "https://%s.%s", client->tenant, client->api_url);
+    snprintf(client->auth_header, sizeof(client->auth_header), "Authorization: Bearer %s", client->api_token);
+    resolve_device_id(client->device_id, sizeof(client->device_id));
+    
+    if (client->cache_enabled) {
+        client->cache = sgnl_decision_cache_create((size_t)client->cache_max_entries,
+                                                   client->cache_positive_ttl_seconds,
+                                                   client->cache_negative_ttl_seconds);
+        if (!client->cache) {
+            sgnl_log_error(client, "Failed to allocate decision cache");
+            return client_create_abort(client);
+        }
+    }
+    
+    // A snapshot is trusted for two refresh intervals, so one failed refresh
+    // does not send every evaluation back to the network
+    if (client->prefetch_enabled) {
+        client->snapshot = sgnl_snapshot_create(client->prefetch_action,
+                                                (size_t)client->prefetch_max_principals,
+                                                client->prefetch_interval_seconds * 2);
+        if (!client->snapshot) {
+            sgnl_log_error(client, "Failed to allocate entitlement snapshot");
+            return client_create_abort(client);
+        }
+    }
+    
+    // A store that cannot be opened (e.g. an unprivileged caller) leaves the
+    // client working online-only
+    if (client->offline_enabled) {
+        client->offline = sgnl_offline_store_open(client->offline_store_path,
+                                                  (size_t)client->offline_max_entries,
+                                                  client->offline_grace_period_seconds,
+                                                  client->api_token);
+        if (!client->offline) {
+            SGNL_LOG_WARNING(&log_ctx, "Offline decision store %s unavailable; continuing without it",
+                             client->offline_store_path);
+        }
+    }
+    
+    // Initialize common logging system with the configured output and level
+    sgnl_logger_config_t logging_config = client->logger_config;
+    if (client->debug_enabled) {
+        logging_config.min_level = SGNL_LOG_DEBUG;
+    }
+    sgnl_log_acquire(&logging_config);
+    
+    pthread_mutex_init(&client->pool_lock, NULL);
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        pthread_mutex_init(&client->share_locks[i], NULL);
+    }
+    pthread_mutex_init(&client->principal_lock, NULL);
+    pthread_mutex_init(&client->async_lock, NULL);
+    pthread_mutex_init(&client->latency_lock, NULL);
+    
+    client->initialized = true;
+    sgnl_log_debug(client, "SGNL client initialized successfully");
+    sgnl_log_debug(client, "Config: tenant=%s, api_url=%s", 
+                   client->tenant, client->api_url);
+    
+    SGNL_LOG_DEBUG(&log_ctx, "SGNL client created and initialized successfully");
+    
+    return client;
+}
+
+void sgnl_client_destroy(sgnl_client_t *client) {
+    if (client) {
+        sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
+        SGNL_LOG_DEBUG(&log_ctx, "Destroying SGNL client");
+        
+        // Finish outstanding async evaluations before their handles, the
+        // cache and the offline store go away
+        async_worker_stop(client);
+        
+        sgnl_decision_cache_destroy(client->cache);
+        client->cache = NULL;
+        sgnl_offline_store_close(client->offline);
+        client->offline = NULL;
+        sgnl_snapshot_destroy(client->snapshot);
+        client->snapshot = NULL;
+        
+        // Close the persistent connections; handles go before the share they use
+        for (int i = 0; i < client->idle_count; i++) {
+            curl_easy_cleanup(client->idle_handles[i]);
+        }
+        client->idle_count = 0;
+        for (int i = 0; i < client->idle_body_count; i++) {
+            sgnl_json_buffer_free(&client->idle_bodies[i]);
+        }
+        client->idle_body_count = 0;
+        if (client->share && client->tls_session_cache) {
+            process_share_release(client);
+        } else if (client->share) {
+            curl_share_cleanup(client->share);
+        }
+        client->share = NULL;
+        curl_slist_free_all(client->resolve);
+        client->resolve = NULL;
+        
+        free(client->principal_json);
+        client->principal_json = NULL;
+        
+        pthread_mutex_destroy(&client->pool_lock);
+        for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+            pthread_mutex_destroy(&client->share_locks[i]);
+        }
+        pthread_mutex_destroy(&client->principal_lock);
+        pthread_mutex_destroy(&client->async_lock);
+        pthread_mutex_destroy(&client->latency_lock);
+        
+        // Clear sensitive data
+        memset(client->api_token, 0, sizeof(client->api_token));
+        memset(client->auth_header, 0, sizeof(client->auth_header));
+        free(client);
+        
+        // Logging is shared by every client; the last one shuts it down
+        sgnl_log_release();
+    }
+}
+
+sgnl_result_t sgnl_client_validate(sgnl_client_t *client) {
+    if (!client || !client->initialized) {
+        return SGNL_ERROR;
+    }
+    
+    if (strlen(client->api_url) == 0) {
+        return SGNL_CONFIG_ERROR;
+    }
+    
+    if (strlen(client->api_token) == 0) {
+        return SGNL_CONFIG_ERROR;
+    }
+    
+    return SGNL_OK;
+}
+
+const char* sgnl_client_get_last_error(sgnl_client_t *client) {
+    return client ? last_error : "No client";
+}
+
+bool sgnl_client_is_debug_enabled(sgnl_client_t *client) {
+    return client ? client->debug_enabled : false;
+}
+
+sgnl_result_t sgnl_client_cache_invalidate(sgnl_client_t *client,
+                                           const char *principal_id,
+                                           const char *asset_id,
+                                           const char *action) {
+    if (!client || !client->initialized || !principal_id) {
+        return SGNL_ERROR;
+    }
+    
+    size_t removed = sgnl_decision_cache_invalidate(client->cache, principal_id, asset_id, action);
+    sgnl_snapshot_invalidate(client->snapshot, principal_id);
+    sgnl_log_debug(client, "Invalidated %zu cached decision(s) for principal=%s", removed, principal_id);
+    return SGNL_OK;
+}
+
+sgnl_result_t sgnl_client_cache_flush(sgnl_client_t *client) {
+    if (!client || !client->initialized) {
+        return SGNL_ERROR;
+    }
+    
+    sgnl_decision_cache_flush(client->cache);
+    sgnl_snapshot_invalidate(client->snapshot, NULL);
+    return SGNL_OK;
+}
+
+sgnl_result_t sgnl_client_warm_up(sgnl_client_t *client) {
+    if (!client || !client->initialized) {
+        return SGNL_ERROR;
+    }
+    
+    // Borrowing a handle creates the share the lookup is cached in. The
+    // connect-only transfer runs on a handle of its own, since libcurl
+    // never reuses such a connection for requests.
+    CURL *pooled = http_handle_acquire(client);
+    if (!pooled) {
+        return SGNL_MEMORY_ERROR;
+    }
+    http_handle_release(client, pooled);
+    CURL *curl = http_handle_create(client);
+    if (!curl) {
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    curl_easy_setopt(curl, CURLOPT_URL, client->base_url);
+    curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)client->connect_timeout_ms);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    
+    sgnl_log_debug(client, "Warm-up of %s: %s", client->base_url, curl_easy_strerror(res));
+    if (res == CURLE_OK) {
+        return SGNL_OK;
+    }
+    return res == CURLE_OPERATION_TIMEDOUT ? SGNL_TIMEOUT_ERROR : SGNL_NETWORK_ERROR;
+}
+
+static bool snapshot_add_asset(const char *asset_id, void *user_data) {
+    return sgnl_asset_set_add((sgnl_asset_set_t *)user_data, asset_id);
+}
+
+sgnl_result_t sgnl_client_snapshot_refresh(sgnl_client_t *client, const char *principal_id) {
+    if (!client || !client->initialized || !client->snapshot || !principal_id) {
+        return SGNL_ERROR;
+    }
+    
+    sgnl_asset_set_t *set = sgnl_asset_set_create();
+    if (!set) {
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    // Even a set cut short by an allocation failure holds only granted
+    // assets, so whatever the search produced may replace the old set
+    sgnl_result_t status = sgnl_search_assets_foreach(client, principal_id, client->prefetch_action,
+                                                      SGNL_SEARCH_MAX_PAGE_SIZE, snapshot_add_asset, set);
+    if (status != SGNL_OK) {
+        sgnl_asset_set_destroy(set);
+        sgnl_log_debug(client, "Snapshot refresh failed for principal=%s: %s", principal_id,
+                       sgnl_result_to_string(status));
+        return status;
+    }
+    
+    size_t asset_count = sgnl_asset_set_count(set);
+    if (!sgnl_snapshot_replace(client->snapshot, principal_id, set)) {
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    sgnl_log_debug(client, "Snapshot refreshed for principal=%s: %zu asset(s)", principal_id, asset_count);
+    return SGNL_OK;
+}
+
+sgnl_result_t sgnl_client_snapshot_retain(sgnl_client_t *client, const char **principal_ids, int count) {
+    if (!client || !client->initialized || !client->snapshot || count < 0 || (count > 0 && !principal_ids)) {
+        return SGNL_ERROR;
+    }
+    
+    size_t removed = sgnl_snapshot_retain(client->snapshot, (const char *const *)principal_ids, (size_t)count);
+    if (removed > 0) {
+        sgnl_log_debug(client, "Dropped %zu inactive principal(s) from snapshot", removed);
+    }
+    return SGNL_OK;
+}
+
+sgnl_result_t sgnl_client_get_stats(sgnl_client_t *client, sgnl_client_stats_t *stats) {
+    if (!client || !client->initialized || !stats) {
+        return SGNL_ERROR;
+    }
+    
+    sgnl_stats_snapshot(&client->stats, stats);
+    return SGNL_OK;
+}
+
+sgnl_result_t sgnl_client_write_metrics(sgnl_client_t *client, const char *path) {
+    if (!client || !client->initialized || !path) {
+        return SGNL_ERROR;
+    }
+    
+    sgnl_client_stats_t stats;
+    sgnl_stats_snapshot(&client->stats, &stats);
+    char host[400];
+    snprintf(host, sizeof(host), "%s.%s", client->tenant, client->api_url);
+    if (!sgnl_stats_write_prometheus(&stats, host, path)) {
+        sgnl_log_debug(client, "Could not write metrics to %s", path);
+        return SGNL_ERROR;
+    }
+    return SGNL_OK;
+}
+
+
+
+sgnl_result_t sgnl_check_access(sgnl_client_t *client,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action) {
+    sgnl_access_result_t *result = sgnl_evaluate_access(client, principal_id, asset_id, action);
+    if (!result) {
+        return SGNL_ERROR;
+    }
+    
+    sgnl_result_t res = result->result;
+    sgnl_access_result_free(result);
+    
+    return res;
+}
+
+// Body of sgnl_evaluate_access; records on tracker where the decision came from
+static sgnl_access_result_t* evaluate_access(sgnl_client_t *client, sgnl_request_tracker_t *tracker,
+                                             const char *principal_id,
+                                             const char *asset_id,
+                                             const char *action) {
+    sgnl_access_result_t *result = access_result_create(principal_id, asset_id, action);
+    if (!result) {
+        return NULL;
+    }
+    
+    sgnl_log_debug(client, "Evaluating access: principal=%s, asset=%s, action=%s",
+                   principal_id, asset_id ? asset_id : "N/A", result->action);
+    
+    // Serve repeated decisions from the cache, then prefetched grants
+    if (evaluation_from_cache(client, result, principal_id, asset_id)) {
+        sgnl_request_set_source(tracker, "cache");
+        return result;
+    }
+    if (evaluation_from_snapshot(client, result, principal_id, asset_id)) {
+        sgnl_request_set_source(tracker, "snapshot");
+        return result;
+    }
+    
+    int64_t deadline = http_retry_deadline(client);
+    
+    // Ask the local broker, which keeps warm connections and a shared cache;
+    // fall through to a direct request if it is not running
+    if (client->broker_enabled) {
+        const char *broker_assets[1] = {asset_id};
+        const char *broker_actions[1] = {result->action};
+        if (sgnl_broker_evaluate(client->broker_socket_path, broker_call_timeout_ms(client, deadline),
+                                 principal_id, broker_assets, broker_actions, 1, &result)) {
+            sgnl_stats_add(&client->stats.broker_hits, 1);
+            sgnl_request_set_source(tracker, "broker");
+            sgnl_request_set_id(tracker, result->request_id);
+            sgnl_log_debug(client, "Access evaluation served by broker: result=%s",
+                           sgnl_result_to_string(result->result));
+            return result;
+        }
+        sgnl_log_debug(client, "Broker unavailable at %s, evaluating directly", client->broker_socket_path);
+    }
+    
+    // The body goes into a pooled client buffer; the parser lives in an
+    // arena released when the call ends
+    char arena_storage[SGNL_ARENA_INLINE_SIZE];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, arena_storage, sizeof(arena_storage));
+    sgnl_json_buffer_t body = body_buffer_acquire(client);
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init_buffer(&writer, &body, 256);
+    
+    const char *json_payload = build_evaluation_body(client, &writer, principal_id, asset_id, result->action);
+    if (!json_payload) {
+        body_buffer_release(client, &body);
+        sgnl_arena_release(&arena);
+        strncpy(result->error_message, "Failed to create JSON request", sizeof(result->error_message) - 1);
+        result->error_message[sizeof(result->error_message) - 1] = '\0';
+        return result;
+    }
+    
+    sgnl_json_stream_t *stream = sgnl_json_stream_create_in(&arena, single_decision_callback, result);
+    if (!stream) {
+        body_buffer_release(client, &body);
+        sgnl_arena_release(&arena);
+        result->result = SGNL_MEMORY_ERROR;
+        strncpy(result->error_message, "Failed to create response parser", sizeof(result->error_message) - 1);
+        result->error_message[sizeof(result->error_message) - 1] = '\0';
+        return result;
+    }
+    
+    // Make HTTP request
+    http_body_t payload = {json_payload, strlen(json_payload), false};
+    http_response_t *response = make_http_request(client, "/access/v2/evaluations", &payload, stream,
+                                                  result->request_id, deadline, NULL);
+    
+    sgnl_request_set_source(tracker, finish_evaluation(client, result, response, stream, principal_id, asset_id));
+    sgnl_request_set_id(tracker, result->request_id);
+    
+    http_response_free(response);
+    body_buffer_release(client, &body);
+    sgnl_arena_release(&arena);
+    
+    return result;
+}
+
+sgnl_access_result_t* sgnl_evaluate_access(sgnl_client_t *client,
+                                           const char *principal_id,
+                                           const char *asset_id,
+                                           const char *action) {
+    if (!client || !client->initialized || !principal_id) {
+        return NULL;
+    }
+    
+    // One audit record per decision; a caller's own tracker absorbs it
+    sgnl_request_tracker_t *tracker = sgnl_request_start(principal_id, asset_id, action ? action : "execute");
+    sgnl_access_result_t *result = evaluate_access(client, tracker, principal_id, asset_id, action);
+    sgnl_request_end(tracker, result ? sgnl_result_to_string(result->result) : "Error");
+    return result;
+}
+
+// ============================================================================
+// Asynchronous Evaluation
+// ============================================================================
+
+// One in-flight or backing-off async evaluation. Owned by the worker once
+// submitted.
+struct async_request {
+    async_request_t *next;
+    sgnl_access_result_t *result;
+    sgnl_access_callback_t callback;
+    void *user_data;
+    const char *principal_id;       // Strings, body and parser live in arena
+    const char *asset_id;           // NULL when the query has no asset
+    const char *body;
+    sgnl_json_stream_t *stream;
+    http_response_t *response;      // Current attempt (NULL between attempts)
+    CURL *curl;
+    struct curl_slist *headers;
+    int attempt;
+    int64_t deadline;               // Retry budget, monotonic ms
+    int64_t start_at;               // When the next attempt may start, monotonic ms
+    sgnl_arena_t arena;
+    char arena_storage[SGNL_ARENA_INLINE_SIZE];
+};
+
+static void async_request_free(async_request_t *req) {
+    sgnl_arena_release(&req->arena);
+    free(req);
+}
+
+// Hand the result to the caller and release the request
+static void async_request_complete(async_request_t *req) {
+    sgnl_access_result_t *result = req->result;
+    req->result = NULL;
+    req->callback(result, req->user_data);
+    async_request_free(req);
+}
+
+static void async_request_fail(async_request_t *req, sgnl_result_t code, const char *message) {
+    req->result->result = code;
+    snprintf(req->result->error_message, sizeof(req->result->error_message), "%s", message);
+    async_request_complete(req);
+}
+
+// Start the next attempt on the multi handle; false if it could not be started
+static bool async_attempt_start(sgnl_client_t *client, async_request_t *req) {
+    req->curl = http_handle_acquire(client);
+    if (!req->curl) {
+        return false;
+    }
+    
+    req->response = http_response_create(req->curl, req->stream);
+    if (!req->response) {
+        http_handle_release(client, req->curl);
+        req->curl = NULL;
+        return false;
+    }
+    
+    http_body_t payload = {req->body, strlen(req->body), false};
+    req->headers = http_request_setup(client, req->curl, req->response, "/access/v2/evaluations", &payload,
+                                      http_attempt_timeout_ms(client, req->deadline), req->result->request_id);
+    curl_easy_setopt(req->curl, CURLOPT_PRIVATE, req);
+    
+    if (curl_multi_add_handle(client->multi, req->curl) != CURLM_OK) {
+        http_request_complete(client, req->curl, req->response, CURLE_FAILED_INIT, req->headers);
+        http_handle_release(client, req->curl);
+        http_response_free(req->response);
+        req->curl = NULL;
+        req->response = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Detach a finished or abandoned attempt from the multi handle
+static void async_attempt_end(sgnl_client_t *client, async_request_t *req, CURLcode res) {
+    curl_multi_remove_handle(client->multi, req->curl);
+    curl_easy_setopt(req->curl, CURLOPT_PRIVATE, NULL);
+    http_request_complete(client, req->curl, req->response, res, req->headers);
+    http_handle_release(client, req->curl);
+    req->curl = NULL;
+    req->headers = NULL;
+}
+
+// An attempt finished: retry it later or complete the evaluation. Returns
+// true when the request went back to the waiting list.
+static bool async_attempt_done(sgnl_client_t *client, async_request_t *req, CURLcode res) {
+    async_attempt_end(client, req, res);
+    
+    http_response_t *response = req->response;
+    req->response = NULL;
+    
+    int64_t delay = http_retry_delay_ms(client, response, req->stream, req->attempt, req->deadline);
+    if (delay >= 0) {
+        http_response_free(response);
+        req->attempt++;
+        req->start_at = monotonic_ms() + delay;
+        return true;
+    }
+    
+    finish_evaluation(client, req->result, response, req->stream, req->principal_id, req->asset_id);
+    http_response_free(response);
+    async_request_complete(req);
+    return false;
+}
+
+// Worker loop: starts due requests, drives transfers and completes them.
+// Requests move submitted -> waiting -> in flight -> (waiting again on retry).
+static void* async_worker(void *arg) {
+    sgnl_client_t *client = (sgnl_client_t *)arg;
+    async_request_t *waiting = NULL;
+    async_request_t *in_flight = NULL;
+    
+    for (;;) {
+        pthread_mutex_lock(&client->async_lock);
+        async_request_t *submitted = client->async_submitted;
+        client->async_submitted = NULL;
+        bool stopping = client->async_stopping;
+        pthread_mutex_unlock(&client->async_lock);
+        
+        while (submitted) {
+            async_request_t *next = submitted->next;
+            submitted->next = waiting;
+            waiting = submitted;
+            submitted = next;
+        }
+        
+        if (stopping) {
+            break;
+        }
+        
+        // Start every request whose backoff has elapsed
+        int64_t now = monotonic_ms();
+        int64_t next_start = -1;
+        async_request_t **link = &waiting;
+        while (*link) {
+            async_request_t *req = *link;
+            if (req->start_at > now) {
+                if (next_start < 0 || req->start_at < next_start) {
+                    next_start = req->start_at;
+                }
+                link = &req->next;
+                continue;
+            }
+            
+            *link = req->next;
+            if (async_attempt_start(client, req)) {
+                req->next = in_flight;
+                in_flight = req;
+            } else {
+                async_request_fail(req, SGNL_NETWORK_ERROR, "Failed to start HTTP request");
+            }
+        }
+        
+        int running = 0;
+        curl_multi_perform(client->multi, &running);
+        
+        CURLMsg *msg;
+        int queued;
+        while ((msg = curl_multi_info_read(client->multi, &queued))) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            
+            async_request_t *req = NULL;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&req);
+            CURLcode res = msg->data.result;
+            if (!req) {
+                continue;
+            }
+            
+            for (link = &in_flight; *link && *link != req; link = &(*link)->next) {
+            }
+            if (*link) {
+                *link = req->next;
+            }
+            
+            if (async_attempt_done(client, req, res)) {
+                req->next = waiting;
+                waiting = req;
+                if (next_start < 0 || req->start_at < next_start) {
+                    next_start = req->start_at;
+                }
+            }
+        }
+        
+        // Sleep until there is socket activity, a backoff ends or new work
+        // is submitted
+        int timeout_ms = 1000;
+        if (next_start >= 0) {
+            int64_t until_start = next_start - monotonic_ms();
+            timeout_ms = until_start < 0 ? 0 : (until_start < timeout_ms ? (int)until_start : timeout_ms);
+        }
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_poll(client->multi, NULL, 0, timeout_ms, NULL);
+#else
+        // curl_multi_wait returns at once when there is nothing to wait on
+        int wait_ms = timeout_ms < SGNL_ASYNC_POLL_MS ? timeout_ms : SGNL_ASYNC_POLL_MS;
+        int numfds = 0;
+        curl_multi_wait(client->multi, NULL, 0, wait_ms, &numfds);
+        if (numfds == 0) {
+            sleep_ms(wait_ms);
+        }
+#endif
+    }
+    
+    // The client is being destroyed; every accepted request still gets its callback
+    while (in_flight) {
+        async_request_t *req = in_flight;
+        in_flight = req->next;
+        async_attempt_end(client, req, CURLE_ABORTED_BY_CALLBACK);
+        http_response_free(req->response);
+        req->response = NULL;
+        async_request_fail(req, SGNL_ERROR, "Client destroyed before the evaluation completed");
+    }
+    while (waiting) {
+        async_request_t *req = waiting;
+        waiting = req->next;
+        async_request_fail(req, SGNL_ERROR, "Client destroyed before the evaluation completed");
+    }
+    
+    return NULL;
+}
+
+static void async_worker_wakeup(sgnl_client_t *client) {
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(client->multi);
+#else
+    (void)client;
+#endif
+}
+
+// Start the worker on first use. Called with async_lock held.
+static bool async_worker_start(sgnl_client_t *client) {
+    if (client->async_started) {
+        return true;
+    }
+    
+    http_global_init();
+    client->multi = curl_multi_init();
+    if (!client->multi) {
+        return false;
+    }
+    
+    if (pthread_create(&client->async_thread, NULL, async_worker, client) != 0) {
+        curl_multi_cleanup(client->multi);
+        client->multi = NULL;
+        return false;
+    }
+    
+    client->async_started = true;
+    return true;
+}
+
+static void async_worker_stop(sgnl_client_t *client) {
+    pthread_mutex_lock(&client->async_lock);
+    bool started = client->async_started;
+    client->async_stopping = true;
+    pthread_mutex_unlock(&client->async_lock);
+    
+    if (!started) {
+        return;
+    }
+    
+    async_worker_wakeup(client);
+    pthread_join(client->async_thread, NULL);
+    curl_multi_cleanup(client->multi);
+    client->multi = NULL;
+    client->async_started = false;
+}
+
+sgnl_result_t sgnl_evaluate_access_async(sgnl_client_t *client,
+                                         const char *principal_id,
+                                         const char *asset_id,
+                                         const char *action,
+                                         sgnl_access_callback_t callback,
+                                         void *user_data) {
+    if (!client || !client->initialized || !principal_id || !callback) {
+        return SGNL_INVALID_REQUEST;
+    }
+    
+    sgnl_access_result_t *result = access_result_create(principal_id, asset_id, action);
+    if (!result) {
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    sgnl_log_debug(client, "Evaluating access asynchronously: principal=%s, asset=%s, action=%s",
+                   principal_id, asset_id ? asset_id : "N/A", result->action);
+    
+    // Cache and snapshot hits need no network round trip
+    if (evaluation_from_cache(client, result, principal_id, asset_id) ||
+        evaluation_from_snapshot(client, result, principal_id, asset_id)) {
+        callback(result, user_data);
+        return SGNL_OK;
+    }
+    
+    async_request_t *req = calloc(1, sizeof(async_request_t));
+    if (!req) {
+        sgnl_access_result_free(result);
+        return SGNL_MEMORY_ERROR;
+    }
+    req->result = result;
+    req->callback = callback;
+    req->user_data = user_data;
+    sgnl_arena_init(&req->arena, req->arena_storage, sizeof(req->arena_storage));
+    req->principal_id = sgnl_arena_strdup(&req->arena, principal_id);
+    req->asset_id = asset_id ? sgnl_arena_strdup(&req->arena, asset_id) : NULL;
+    
+    // The body outlives this call, so it stays in the request's arena
+    // rather than a pooled client buffer
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init(&writer, &req->arena, 256);
+    req->body = build_evaluation_body(client, &writer, principal_id, asset_id, result->action);
+    req->stream = sgnl_json_stream_create_in(&req->arena, single_decision_callback, result);
+    req->deadline = http_retry_deadline(client);
+    req->start_at = 0;
+    
+    if (!req->principal_id || (asset_id && !req->asset_id) || !req->body || !req->stream) {
+        async_request_free(req);
+        sgnl_access_result_free(result);
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    pthread_mutex_lock(&client->async_lock);
+    bool accepted = !client->async_stopping && async_worker_start(client);
+    if (accepted) {
+        req->next = client->async_submitted;
+        client->async_submitted = req;
+    }
+    pthread_mutex_unlock(&client->async_lock);
+    
+    if (!accepted) {
+        sgnl_log_error(client, "Failed to start asynchronous evaluation worker");
+        async_request_free(req);
+        sgnl_access_result_free(result);
+        return SGNL_ERROR;
+    }
+    
+    async_worker_wakeup(client);
+    return SGNL_OK;
+}
+
+// Allocate a batch result slot carrying the query it answers
+static sgnl_access_result_t* batch_result_create(const char *request_id, const char *principal_id,
+                                                 const char *asset_id, const char *action) {
+    sgnl_access_result_t *result = calloc(1, sizeof(sgnl_access_result_t));
+    if (!result) {
+        return NULL;
+    }
+    
+    result->result = SGNL_ERROR;
+    result->timestamp = time(NULL);
+    strncpy(result->principal_id, principal_id, sizeof(result->principal_id) - 1);
+    result->principal_id[sizeof(result->principal_id) - 1] = '\0';
+    strncpy(result->request_id, request_id, sizeof(result->request_id) - 1);
+    result->request_id[sizeof(result->request_id) - 1] = '\0';
+    
+    if (asset_id) {
+        strncpy(result->asset_id, asset_id, sizeof(result->asset_id) - 1);
+        result->asset_id[sizeof(result->asset_id) - 1] = '\0';
+    }
+    
+    strncpy(result->action, action, sizeof(result->action) - 1);
+    result->action[sizeof(result->action) - 1] = '\0';
+    return result;
+}
+
+// Evaluate a batch through the broker, filling results on success. On failure
+// results is left as all-NULL so the caller can evaluate directly.
+static bool batch_via_broker(sgnl_client_t *client,
+                             const char *principal_id,
+                             const char **asset_ids,
+                             const char **actions,
+                             int query_count,
+                             const char *request_id,
+                             int64_t deadline,
+                             sgnl_access_result_t **results) {
+    const char **broker_actions = calloc(query_count, sizeof(char *));
+    if (!broker_actions) {
+        return false;
+    }
+    
+    bool ok = true;
+    for (int i = 0; i < query_count && ok; i++) {
+        broker_actions[i] = actions ? actions[i] : "execute";
+        results[i] = batch_result_create(request_id, principal_id, asset_ids[i], broker_actions[i]);
+        ok = results[i] != NULL;
+    }
+    
+    ok = ok && sgnl_broker_evaluate(client->broker_socket_path, broker_call_timeout_ms(client, deadline),
+                                    principal_id, asset_ids, broker_actions, query_count, results);
+    free(broker_actions);
+    
+    if (!ok) {
+        for (int i = 0; i < query_count; i++) {
+            sgnl_access_result_free(results[i]);
+            results[i] = NULL;
+        }
+        sgnl_log_debug(client, "Broker unavailable at %s, evaluating batch directly", client->broker_socket_path);
+    } else {
+        sgnl_stats_add(&client->stats.broker_hits, 1);
+    }
+    return ok;
+}
+
+// Evaluate a batch through the broker into a result set. The broker protocol
+// answers with full results, which are copied over and released.
+static sgnl_result_set_t* batch_set_via_broker(sgnl_client_t *client,
+                                               const char *principal_id,
+                                               const char **asset_ids,
+                                               const char **actions,
+                                               int query_count,
+                                               const char *request_id,
+                                               int64_t deadline) {
+    sgnl_access_result_t **results = calloc(query_count, sizeof(sgnl_access_result_t *));
+    if (!results) {
+        return NULL;
+    }
+    if (!batch_via_broker(client, principal_id, asset_ids, actions, query_count, request_id, deadline, results)) {
+        free(results);
+        return NULL;
+    }
+    
+    sgnl_result_set_t *set = sgnl_result_set_create(principal_id, request_id, asset_ids, actions, query_count);
+    bool ok = set != NULL;
+    for (int i = 0; ok && i < query_count; i++) {
+        ok = sgnl_result_set_fill(set, i, results[i]->result, results[i]->reason);
+    }
+    sgnl_access_result_array_free(results, query_count);
+    if (!ok) {
+        sgnl_result_set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+// Batch evaluation state shared with the response stream. The queries of a
+// chunk fill the set from offset onwards.
+typedef struct {
+    sgnl_client_t *client;
+    const char *principal_id;
+    const char **asset_ids;
+    const char **actions;
+    int query_count;
+    sgnl_result_set_t *set;
+    int offset;
+} batch_stream_ctx_t;
+
+// Decisions arrive in query order; fill each result as its decision is parsed
+static bool batch_decision_callback(const sgnl_json_decision_t *decision, int index, void *user_data) {
+    batch_stream_ctx_t *ctx = (batch_stream_ctx_t *)user_data;
+    if (index >= ctx->query_count) {
+        return true;
+    }
+    
+    sgnl_result_t result = SGNL_ERROR;
+    if (decision->decision) {
+        result = strcmp(decision->decision, "Allow") == 0 ? SGNL_ALLOWED : SGNL_DENIED;
+    }
+    
+    // A result that cannot be stored is left unfilled and ends up denied
+    if (!sgnl_result_set_fill(ctx->set, ctx->offset + index, result, decision->reason)) {
+        return true;
+    }
+    sgnl_offline_store_record(ctx->client->offline, ctx->principal_id, ctx->asset_ids[index],
+                              ctx->actions ? ctx->actions[index] : "execute", result);
+    
+    sgnl_log_debug(ctx->client, "Batch result[%d]: %s -> %s", ctx->offset + index,
+                   ctx->asset_ids[index] ? ctx->asset_ids[index] : "N/A",
+                   sgnl_result_to_string(result));
+    return true;
+}
+
+// Complete a batch the API could not answer from the offline store. Decisions
+// that did stream in are kept; every other query needs a stored Allow, or the
+// batch fails as a whole.
+static bool batch_from_offline_store(batch_stream_ctx_t *ctx) {
+    char reason[128];
+    for (int i = 0; i < ctx->query_count; i++) {
+        if (sgnl_result_set_filled(ctx->set, ctx->offset + i)) {
+            continue;
+        }
+        if (!offline_allow(ctx->client, ctx->principal_id, ctx->asset_ids[i],
+                           ctx->actions ? ctx->actions[i] : "execute", reason, sizeof(reason)) ||
+            !sgnl_result_set_fill(ctx->set, ctx->offset + i, SGNL_ALLOWED, reason)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Answer a whole batch from the prefetched snapshot. Every query must hit;
+// otherwise NULL is returned and the batch goes to SGNL.
+static sgnl_result_set_t* batch_from_snapshot(sgnl_client_t *client,
+                                              const char *principal_id,
+                                              const char **asset_ids,
+                                              const char **actions,
+                                              int query_count,
+                                              const char *request_id) {
+    if (!client->snapshot) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < query_count; i++) {
+        if (!sgnl_snapshot_contains(client->snapshot, principal_id, asset_ids[i],
+                                    actions ? actions[i] : "execute")) {
+            return NULL;
+        }
+    }
+    
+    sgnl_result_set_t *set = sgnl_result_set_create(principal_id, request_id, asset_ids, actions, query_count);
+    bool ok = set != NULL;
+    for (int i = 0; ok && i < query_count; i++) {
+        ok = sgnl_result_set_fill(set, i, SGNL_ALLOWED, "Prefetched entitlement snapshot");
+    }
+    if (!ok) {
+        sgnl_result_set_free(set);
+        return NULL;
+    }
+    sgnl_stats_add(&client->stats.snapshot_hits, (uint64_t)query_count);
+    return set;
+}
+
+// Request body for a batch of queries, in a buffer borrowed from the
+// client (see body_buffer_acquire)
+static const char* build_batch_body(sgnl_client_t *client,
+                                    sgnl_json_buffer_t *buffer,
+                                    const char *principal_id,
+                                    const char **asset_ids,
+                                    const char **actions,
+                                    int query_count) {
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init_buffer(&writer, buffer, 256 + (size_t)query_count * 96);
+    if (!write_request_start(client, &writer, principal_id)) {
+        return NULL;
+    }
+    sgnl_json_writer_key(&writer, "queries");
+    sgnl_json_writer_begin_array(&writer);
+    for (int i = 0; i < query_count; i++) {
+        write_query(&writer, asset_ids[i], actions ? actions[i] : "execute");
+    }
+    sgnl_json_writer_end_array(&writer);
+    sgnl_json_writer_end_object(&writer);
+    
+    const char *json_payload = sgnl_json_writer_finish(&writer);
+    if (json_payload) {
+        sgnl_log_debug(client, "Batch request payload: %s", json_payload);
+    }
+    return json_payload;
+}
+
+// batch_evaluate_direct with the request body written to body and the
+// parser in arena
+static bool batch_evaluate_in_arena(sgnl_client_t *client,
+                                    sgnl_arena_t *arena,
+                                    sgnl_json_buffer_t *body,
+                                    const char *principal_id,
+                                    const char **asset_ids,
+                                    const char **actions,
+                                    int query_count,
+                                    const char *request_id,
+                                    int64_t deadline,
+                                    const int *cancel,
+                                    sgnl_result_set_t *set,
+                                    int offset) {
+    const char *json_payload = build_batch_body(client, body, principal_id, asset_ids, actions, query_count);
+    if (!json_payload) {
+        return false;
+    }
+    
+    batch_stream_ctx_t ctx = {
+        .client = client,
+        .principal_id = principal_id,
+        .asset_ids = asset_ids,
+        .actions = actions,
+        .query_count = query_count,
+        .set = set,
+        .offset = offset
+    };
+    sgnl_json_stream_t *stream = sgnl_json_stream_create_in(arena, batch_decision_callback, &ctx);
+    if (!stream) {
+        return false;
+    }
+    
+    // Make HTTP request; results fill in as decisions stream in
+    http_body_t payload = {json_payload, strlen(json_payload), false};
+    http_body_compress(client, arena, &payload);
+    http_response_t *response = make_http_request(client, "/access/v2/evaluations", &payload, stream,
+                                                  request_id, deadline, cancel);
+    
+    // Another chunk already failed the batch; nothing here is wanted
+    if (cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED)) {
+        http_response_free(response);
+        sgnl_result_set_clear(set, offset, query_count);
+        return false;
+    }
+    
+    if (!response || response->status_code != 200) {
+        if (!response) {
+            sgnl_log_error(client, "HTTP request failed for batch evaluation");
+        } else {
+            sgnl_log_error(client, "HTTP request failed with status %ld for batch evaluation", 
+                          response->status_code);
+        }
+        bool served_offline = client->offline && http_response_unavailable(response) &&
+                              batch_from_offline_store(&ctx);
+        http_response_free(response);
+        if (!served_offline) {
+            sgnl_result_set_clear(set, offset, query_count);
+        }
+        return served_offline;
+    }
+    http_response_free(response);
+    
+    sgnl_json_stream_status_t status = sgnl_json_stream_finish(stream);
+    bool has_decisions = sgnl_json_stream_has_decisions(stream);
+    int decision_count = sgnl_json_stream_decision_count(stream);
+    
+    if (status != SGNL_JSON_STREAM_OK || !has_decisions) {
+        sgnl_log_error(client, status != SGNL_JSON_STREAM_OK ?
+                       "Failed to parse JSON response for batch evaluation" :
+                       "No decisions array in batch response");
+        sgnl_result_set_clear(set, offset, query_count);
+        return false;
+    }
+    
+    sgnl_log_debug(client, "Batch response contains %d decisions", decision_count);
+    
+    // Queries the response did not answer are denied
+    for (int i = 0; i < query_count; i++) {
+        if (!sgnl_result_set_filled(set, offset + i)) {
+            sgnl_result_set_fill(set, offset + i, SGNL_DENIED, NULL);
+        }
+    }
+    return true;
+}
+
+// Evaluate one batch with a single request to SGNL, filling query_count
+// results of set from offset. Returns true with every one filled, or false
+// with all of them unfilled.
+static bool batch_evaluate_direct(sgnl_client_t *client,
+                                  const char *principal_id,
+                                  const char **asset_ids,
+                                  const char **actions,
+                                  int query_count,
+                                  const char *request_id,
+                                  int64_t deadline,
+                                  const int *cancel,
+                                  sgnl_result_set_t *set,
+                                  int offset) {
+    char arena_storage[SGNL_ARENA_INLINE_SIZE];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, arena_storage, sizeof(arena_storage));
+    sgnl_json_buffer_t body = body_buffer_acquire(client);
+    bool ok = batch_evaluate_in_arena(client, &arena, &body, principal_id, asset_ids, actions, query_count,
+                                      request_id, deadline, cancel, set, offset);
+    body_buffer_release(client, &body);
+    sgnl_arena_release(&arena);
+    return ok;
+}
+
+// All-must-allow batch state shared with the response stream. Only the
+// outcome is kept; no per-query results are built.
+typedef struct {
+    sgnl_client_t *client;
+    const char *principal_id;
+    const char **asset_ids;
+    const char **actions;
+    int query_count;
+    int allowed;                    // Leading queries answered Allow (decisions arrive in order)
+    int failed_index;               // First query not allowed, or -1
+    sgnl_result_t failed_result;
+} batch_check_ctx_t;
+
+// Count Allows; the first other decision ends the stream and the transfer
+static bool batch_check_callback(const sgnl_json_decision_t *decision, int index, void *user_data) {
+    batch_check_ctx_t *ctx = (batch_check_ctx_t *)user_data;
+    if (index >= ctx->query_count) {
+        return true;
+    }
+    
+    const char *action = ctx->actions ? ctx->actions[index] : "execute";
+    sgnl_result_t result = !decision->decision ? SGNL_ERROR :
+                           strcmp(decision->decision, "Allow") == 0 ? SGNL_ALLOWED : SGNL_DENIED;
+    sgnl_offline_store_record(ctx->client->offline, ctx->principal_id, ctx->asset_ids[index], action, result);
+    
+    if (result != SGNL_ALLOWED) {
+        sgnl_log_debug(ctx->client, "Batch query %d (%s) not allowed, stopping", index,
+                       ctx->asset_ids[index] ? ctx->asset_ids[index] : "N/A");
+        ctx->failed_index = index;
+        ctx->failed_result = result;
+        return false;
+    }
+    ctx->allowed++;
+    return true;
+}
+
+// Every query the API did not answer needs a recorded Allow
+static bool batch_check_from_offline_store(batch_check_ctx_t *ctx) {
+    for (int i = ctx->allowed; i < ctx->query_count; i++) {
+        if (!sgnl_offline_store_lookup(ctx->client->offline, ctx->principal_id, ctx->asset_ids[i],
+                                       ctx->actions ? ctx->actions[i] : "execute", NULL)) {
+            return false;
+        }
+    }
+    
+    sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("libsgnl");
+    SGNL_LOG_WARNING(&log_ctx, "SGNL API unreachable; allowing %d queries of principal=%s from offline store",
+                     ctx->query_count - ctx->allowed, ctx->principal_id);
+    return true;
+}
+
+// Check that every query of one batch is allowed, with a single request to
+// SGNL. On a non-Allow outcome, *failed_index is the first query known not
+// to be allowed (-1 for a failure that is not tied to a query).
+static sgnl_result_t batch_check_direct(sgnl_client_t *client,
+                                        const char *principal_id,
+                                        const char **asset_ids,
+                                        const char **actions,
+                                        int query_count,
+                                        const char *request_id,
+                                        int64_t deadline,
+                                        const int *cancel,
+                                        int *failed_index) {
+    *failed_index = -1;
+    batch_check_ctx_t ctx = {
+        .client = client,
+        .principal_id = principal_id,
+        .asset_ids = asset_ids,
+        .actions = actions,
+        .query_count = query_count,
+        .allowed = 0,
+        .failed_index = -1,
+        .failed_result = SGNL_ALLOWED
+    };
+    
+    char arena_storage[SGNL_ARENA_INLINE_SIZE];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, arena_storage, sizeof(arena_storage));
+    sgnl_json_buffer_t body = body_buffer_acquire(client);
+    const char *json_payload = build_batch_body(client, &body, principal_id, asset_ids, actions, query_count);
+    sgnl_json_stream_t *stream = json_payload ? sgnl_json_stream_create_in(&arena, batch_check_callback, &ctx) : NULL;
+    if (!stream) {
+        body_buffer_release(client, &body);
+        sgnl_arena_release(&arena);
+        return SGNL_MEMORY_ERROR;
+    }
+    
+    http_body_t payload = {json_payload, strlen(json_payload), false};
+    http_body_compress(client, &arena, &payload);
+    http_response_t *response = make_http_request(client, "/access/v2/evaluations", &payload, stream,
+                                                  request_id, deadline, cancel);
+    
+    sgnl_result_t outcome;
+    if (ctx.failed_index >= 0) {
+        *failed_index = ctx.failed_index;
+        outcome = ctx.failed_result;
+    } else if (cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED)) {
+        // The batch outcome is already known; this chunk does not count
+        outcome = SGNL_ERROR;
+    } else if (!response || response->status_code != 200) {
+        bool served_offline = client->offline && http_response_unavailable(response) &&
+                              batch_check_from_offline_store(&ctx);
+        outcome = served_offline ? SGNL_ALLOWED : http_failure_result(response);
+    } else if (sgnl_json_stream_finish(stream) != SGNL_JSON_STREAM_OK || !sgnl_json_stream_has_decisions(stream)) {
+        sgnl_log_error(client, "Failed to parse JSON response for batch evaluation");
+        outcome = SGNL_ERROR;
+    } else if (ctx.allowed < query_count) {
+        // A query without a decision is denied, as in sgnl_evaluate_access_batch
+        *failed_index = ctx.allowed;
+        outcome = SGNL_DENIED;
+    } else {
+        outcome = SGNL_ALLOWED;
+    }
+    
+    http_response_free(response);
+    body_buffer_release(client, &body);
+    sgnl_arena_release(&arena);
+    return outcome;
+}
+
+// A batch larger than the server accepts in one request, split into chunks
+// that worker threads (and the caller) claim in order. With a result set,
+// every chunk fills its part of it; without, only the aggregate outcome is
+// kept.
+typedef struct {
+    sgnl_client_t *client;
+    const char *principal_id;
+    const char **asset_ids;
+    const char **actions;
+    int query_count;
+    int chunk_size;
+    const char *request_id;
+    int64_t deadline;
+    sgnl_result_set_t *set;         // NULL for an all-must-allow check
+    int next_chunk;                 // Next chunk to claim (atomic)
+    int stop;                       // Outcome known; cancels chunks in flight (atomic)
+    pthread_mutex_t lock;           // Guards outcome and failed_index
+    sgnl_result_t outcome;
+    int failed_index;
+} batch_chunks_t;
+
+// Fold one chunk's outcome into the batch. A Deny is definitive and wins
+// over errors; any other failure already rules out an all-Allow outcome.
+static void batch_chunk_outcome(batch_chunks_t *chunks, sgnl_result_t outcome, int failed_index) {
+    if (outcome == SGNL_ALLOWED) {
+        return;
+    }
     
-    return result;
+    pthread_mutex_lock(&chunks->lock);
+    bool cancelled = __atomic_load_n(&chunks->stop, __ATOMIC_RELAXED);
+    if (outcome == SGNL_DENIED ? chunks->outcome != SGNL_DENIED : !cancelled) {
+        chunks->outcome = outcome;
+        chunks->failed_index = failed_index;
+    }
+    __atomic_store_n(&chunks->stop, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&chunks->lock);
 }
 
-sgnl_access_result_t** sgnl_evaluate_access_batch(sgnl_client_t *client,
-                                                  const char *principal_id,
-                                                  const char **asset_ids,
-                                                  const char **actions,
-                                                  int query_count) {
-    if (!client || !client->initialized || !principal_id || !asset_ids || query_count <= 0) {
+static void* batch_chunk_worker(void *arg) {
+    batch_chunks_t *chunks = (batch_chunks_t *)arg;
+    for (;;) {
+        int offset = __atomic_fetch_add(&chunks->next_chunk, 1, __ATOMIC_RELAXED) * chunks->chunk_size;
+        if (offset >= chunks->query_count || __atomic_load_n(&chunks->stop, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+        int count = chunks->query_count - offset;
+        if (count > chunks->chunk_size) {
+            count = chunks->chunk_size;
+        }
+        
+        const char **actions = chunks->actions ? chunks->actions + offset : NULL;
+        if (chunks->set) {
+            if (!batch_evaluate_direct(chunks->client, chunks->principal_id, chunks->asset_ids + offset,
+                                       actions, count, chunks->request_id, chunks->deadline,
+                                       &chunks->stop, chunks->set, offset)) {
+                batch_chunk_outcome(chunks, SGNL_ERROR, -1);
+            }
+        } else {
+            int failed_index = -1;
+            sgnl_result_t outcome = batch_check_direct(chunks->client, chunks->principal_id,
+                                                       chunks->asset_ids + offset, actions, count,
+                                                       chunks->request_id, chunks->deadline,
+                                                       &chunks->stop, &failed_index);
+            batch_chunk_outcome(chunks, outcome, failed_index < 0 ? -1 : offset + failed_index);
+        }
+    }
+}
+
+// Send a batch as chunks of at most batch_max_queries, up to
+// batch_max_concurrency at a time. The first failing chunk (or, without a
+// result set, the first Deny) cancels the rest.
+static sgnl_result_t batch_evaluate_chunked(sgnl_client_t *client,
+                                            const char *principal_id,
+                                            const char **asset_ids,
+                                            const char **actions,
+                                            int query_count,
+                                            const char *request_id,
+                                            int64_t deadline,
+                                            sgnl_result_set_t *set,
+                                            int *failed_index) {
+    batch_chunks_t chunks = {
+        .client = client,
+        .principal_id = principal_id,
+        .asset_ids = asset_ids,
+        .actions = actions,
+        .query_count = query_count,
+        .chunk_size = client->batch_max_queries,
+        .request_id = request_id,
+        .deadline = deadline,
+        .set = set,
+        .outcome = SGNL_ALLOWED,
+        .failed_index = -1
+    };
+    pthread_mutex_init(&chunks.lock, NULL);
+    int chunk_count = (query_count + chunks.chunk_size - 1) / chunks.chunk_size;
+    int helpers = (chunk_count < client->batch_max_concurrency ? chunk_count : client->batch_max_concurrency) - 1;
+    
+    sgnl_log_debug(client, "Splitting batch of %d queries into %d requests, %d at a time",
+                   query_count, chunk_count, helpers + 1);
+    
+    // A helper that cannot be started just leaves more chunks to the caller
+    pthread_t threads[SGNL_MAX_BATCH_CONCURRENCY];
+    int started = 0;
+    while (started < helpers && pthread_create(&threads[started], NULL, batch_chunk_worker, &chunks) == 0) {
+        started++;
+    }
+    batch_chunk_worker(&chunks);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&chunks.lock);
+    
+    if (set && chunks.outcome != SGNL_ALLOWED) {
+        sgnl_result_set_clear(set, 0, query_count);
+    }
+    if (failed_index) {
+        *failed_index = chunks.failed_index;
+    }
+    return chunks.outcome;
+}
+
+// Evaluate a batch with SGNL, in one request or in chunks
+static sgnl_result_set_t* batch_evaluate_remote(sgnl_client_t *client,
+                                                const char *principal_id,
+                                                const char **asset_ids,
+                                                const char **actions,
+                                                int query_count,
+                                                const char *request_id,
+                                                int64_t deadline) {
+    sgnl_result_set_t *set = sgnl_result_set_create(principal_id, request_id, asset_ids, actions, query_count);
+    if (!set) {
         return NULL;
     }
     
-    sgnl_access_result_t **results = calloc(query_count + 1, sizeof(sgnl_access_result_t*));
+    bool ok = query_count <= client->batch_max_queries ?
+        batch_evaluate_direct(client, principal_id, asset_ids, actions, query_count, request_id,
+                              deadline, NULL, set, 0) :
+        batch_evaluate_chunked(client, principal_id, asset_ids, actions, query_count, request_id,
+                               deadline, set, NULL) == SGNL_ALLOWED;
+    if (!ok) {
+        sgnl_result_set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+// Expand a result set into the full per-query results of the batch API
+static sgnl_access_result_t** batch_results_from_set(const sgnl_result_set_t *set) {
+    int count = sgnl_result_set_count(set);
+    sgnl_access_result_t **results = calloc(count + 1, sizeof(sgnl_access_result_t *));
     if (!results) {
         return NULL;
     }
     
-    // Initialize all results to NULL
-    for (int i = 0; i < query_count; i++) {
-        results[i] = NULL;
+    for (int i = 0; i < count; i++) {
+        sgnl_access_result_t *result = batch_result_create(sgnl_result_set_request_id(set),
+                                                           sgnl_result_set_principal_id(set),
+                                                           sgnl_result_set_asset_id(set, i),
+                                                           sgnl_result_set_action(set, i));
+        if (!result) {
+            sgnl_access_result_array_free(results, i);
+            return NULL;
+        }
+        result->result = sgnl_result_set_result(set, i);
+        result->timestamp = sgnl_result_set_timestamp(set);
+        strcpy(result->decision, sgnl_result_set_decision(set, i));
+        strncpy(result->reason, sgnl_result_set_reason(set, i), sizeof(result->reason) - 1);
+        result->reason[sizeof(result->reason) - 1] = '\0';
+        results[i] = result;
     }
-    
+    return results;
+}
+
+// Tracker for a batch evaluation; the first query names it in the audit record
+static sgnl_request_tracker_t* batch_tracker_start(const char *principal_id, const char **asset_ids,
+                                                   const char **actions, int query_count) {
+    sgnl_request_tracker_t *tracker = sgnl_request_start(principal_id, asset_ids[0],
+                                                         actions && actions[0] ? actions[0] : "execute");
+    if (tracker) {
+        tracker->queries = query_count;
+    }
+    return tracker;
+}
+
+// Audit result of a batch: the first query that was not allowed, if any
+static const char* batch_audit_result(const sgnl_result_set_t *set) {
+    if (!set) {
+        return sgnl_result_to_string(SGNL_ERROR);
+    }
+    sgnl_result_t outcome = SGNL_ALLOWED;
+    for (int i = 0; i < sgnl_result_set_count(set) && outcome == SGNL_ALLOWED; i++) {
+        outcome = sgnl_result_set_result(set, i);
+    }
+    return sgnl_result_to_string(outcome);
+}
+
+// Body of sgnl_evaluate_access_batch; records on tracker where the results came from
+static sgnl_access_result_t** evaluate_access_batch(sgnl_client_t *client, sgnl_request_tracker_t *tracker,
+                                                    const char *principal_id,
+                                                    const char **asset_ids,
+                                                    const char **actions,
+                                                    int query_count) {
     // Generate request ID
-    strcpy(client->last_request_id, generate_request_id_internal());
+    char request_id[64];
+    generate_request_id_internal(request_id, sizeof(request_id));
+    sgnl_request_set_id(tracker, request_id);
     
     sgnl_log_debug(client, "Batch evaluating access: principal=%s, queries=%d", 
                    principal_id, query_count);
     
-    // Create JSON request with multiple queries
-    json_object *request = json_object_new_object();
-    json_object *principal = json_object_new_object();
-    json_object *queries = json_object_new_array();
-    
-    if (!request || !principal || !queries) {
-        if (request) json_object_put(request);
-        if (principal) json_object_put(principal);
-        if (queries) json_object_put(queries);
-        for (int i = 0; i < query_count; i++) {
-            if (results[i]) sgnl_access_result_free(results[i]);
+    sgnl_result_set_t *set = batch_from_snapshot(client, principal_id, asset_ids, actions, query_count, request_id);
+    if (set) {
+        sgnl_request_set_source(tracker, "snapshot");
+        sgnl_log_debug(client, "Batch access evaluation served from prefetched snapshot");
+    }
+    
+    int64_t deadline = http_retry_deadline(client);
+    if (!set && client->broker_enabled) {
+        // The broker already answers with full results
+        sgnl_access_result_t **results = calloc(query_count + 1, sizeof(sgnl_access_result_t *));
+        if (results && batch_via_broker(client, principal_id, asset_ids, actions,
+                                        query_count, request_id, deadline, results)) {
+            sgnl_request_set_source(tracker, "broker");
+            sgnl_log_debug(client, "Batch access evaluation served by broker");
+            return results;
         }
         free(results);
-        return NULL;
     }
     
-    // Build request
-    json_object_object_add(principal, "id", json_object_new_string(principal_id));
-    json_object_object_add(principal, "deviceId", json_object_new_string(get_device_id()));
-    json_object_object_add(request, "principal", principal);
-    
-    // Add each query
-    for (int i = 0; i < query_count; i++) {
-        json_object *query = json_object_new_object();
-        if (!query) {
-            json_object_put(request);
-            for (int j = 0; j < query_count; j++) {
-                if (results[j]) sgnl_access_result_free(results[j]);
-            }
-            free(results);
+    if (!set) {
+        sgnl_request_set_source(tracker, "network");
+        set = batch_evaluate_remote(client, principal_id, asset_ids, actions, query_count, request_id, deadline);
+        if (!set) {
             return NULL;
         }
-        
-        if (asset_ids[i]) {
-            json_object_object_add(query, "assetId", json_object_new_string(asset_ids[i]));
-        }
-        
-        const char *action = actions ? actions[i] : "execute";
-        json_object_object_add(query, "action", json_object_new_string(action));
-        
-        json_object_array_add(queries, query);
+        sgnl_log_debug(client, "Batch access evaluation completed");
     }
     
-    json_object_object_add(request, "queries", queries);
-    
-    const char *json_payload = json_object_to_json_string(request);
-    
-    sgnl_log_debug(client, "Batch request payload: %s", json_payload);
-    
-    // Make HTTP request
-    http_response_t *response = make_http_request(client, "/access/v2/evaluations", json_payload);
-    
-    json_object_put(request);
-    
-    if (!response) {
-        sgnl_log_error(client, "HTTP request failed for batch evaluation");
-        for (int i = 0; i < query_count; i++) {
-            if (results[i]) sgnl_access_result_free(results[i]);
-        }
-        free(results);
+    sgnl_access_result_t **results = batch_results_from_set(set);
+    sgnl_result_set_free(set);
+    return results;
+}
+
+sgnl_access_result_t** sgnl_evaluate_access_batch(sgnl_client_t *client,
+                                                  const char *principal_id,
+                                                  const char **asset_ids,
+                                                  const char **actions,
+                                                  int query_count) {
+    if (!client || !client->initialized || !principal_id || !asset_ids || query_count <= 0) {
         return NULL;
     }
     
-    // Handle HTTP errors
-    if (response->status_code != 200) {
-        sgnl_log_error(client, "HTTP request failed with status %ld for batch evaluation", 
-                      response->status_code);
-        http_response_free(response);
-        for (int i = 0; i < query_count; i++) {
-            if (results[i]) sgnl_access_result_free(results[i]);
-        }
-        free(results);
-        return NULL;
+    sgnl_request_tracker_t *tracker = batch_tracker_start(principal_id, asset_ids, actions, query_count);
+    sgnl_access_result_t **results = evaluate_access_batch(client, tracker, principal_id, asset_ids, actions,
+                                                           query_count);
+    sgnl_result_t outcome = results ? SGNL_ALLOWED : SGNL_ERROR;
+    for (int i = 0; results && i < query_count && outcome == SGNL_ALLOWED; i++) {
+        outcome = results[i]->result;
     }
+    sgnl_request_end(tracker, sgnl_result_to_string(outcome));
+    return results;
+}
+
+// Body of sgnl_evaluate_access_batch_compact; records on tracker where the results came from
+static sgnl_result_set_t* evaluate_access_batch_compact(sgnl_client_t *client, sgnl_request_tracker_t *tracker,
+                                                        const char *principal_id,
+                                                        const char **asset_ids,
+                                                        const char **actions,
+                                                        int query_count) {
+    char request_id[64];
+    generate_request_id_internal(request_id, sizeof(request_id));
+    sgnl_request_set_id(tracker, request_id);
+    
+    sgnl_log_debug(client, "Batch evaluating access (compact): principal=%s, queries=%d",
+                   principal_id, query_count);
     
-    // Parse batch response
-    json_object *root = json_tokener_parse(response->data);
-    if (!root) {
-        sgnl_log_error(client, "Failed to parse JSON response for batch evaluation");
-        http_response_free(response);
-        for (int i = 0; i < query_count; i++) {
-            if (results[i]) sgnl_access_result_free(results[i]);
-        }
-        free(results);
-        return NULL;
+    sgnl_result_set_t *set = batch_from_snapshot(client, principal_id, asset_ids, actions, query_count, request_id);
+    if (set) {
+        sgnl_request_set_source(tracker, "snapshot");
+        sgnl_log_debug(client, "Batch access evaluation served from prefetched snapshot");
+        return set;
     }
     
-    // Get decisions array
-    json_object *decisions;
-    if (!json_object_object_get_ex(root, "decisions", &decisions) ||
-        !json_object_is_type(decisions, json_type_array)) {
-        sgnl_log_error(client, "No decisions array in batch response");
-        json_object_put(root);
-        http_response_free(response);
-        for (int i = 0; i < query_count; i++) {
-            if (results[i]) sgnl_access_result_free(results[i]);
+    int64_t deadline = http_retry_deadline(client);
+    if (client->broker_enabled) {
+        set = batch_set_via_broker(client, principal_id, asset_ids, actions, query_count, request_id, deadline);
+        if (set) {
+            sgnl_request_set_source(tracker, "broker");
+            sgnl_log_debug(client, "Batch access evaluation served by broker");
+            return set;
         }
-        free(results);
-        return NULL;
     }
     
-    int decision_count = json_object_array_length(decisions);
-    sgnl_log_debug(client, "Batch response contains %d decisions", decision_count);
+    sgnl_request_set_source(tracker, "network");
+    set = batch_evaluate_remote(client, principal_id, asset_ids, actions, query_count, request_id, deadline);
+    if (set) {
+        sgnl_log_debug(client, "Batch access evaluation completed");
+    }
+    return set;
+}
+
+sgnl_result_set_t* sgnl_evaluate_access_batch_compact(sgnl_client_t *client,
+                                                      const char *principal_id,
+                                                      const char **asset_ids,
+                                                      const char **actions,
+                                                      int query_count) {
+    if (!client || !client->initialized || !principal_id || !asset_ids || query_count <= 0) {
+        return NULL;
+    }
     
-    // Process each decision and create corresponding result
-    for (int i = 0; i < decision_count && i < query_count; i++) {
-        json_object *decision_obj = json_object_array_get_idx(decisions, i);
-        if (!decision_obj) continue;
-        
-        // Create result object
-        results[i] = calloc(1, sizeof(sgnl_access_result_t));
-        if (!results[i]) continue;
-        
-        // Initialize result
-        results[i]->result = SGNL_ERROR;
-        results[i]->timestamp = time(NULL);
-        strncpy(results[i]->principal_id, principal_id, sizeof(results[i]->principal_id) - 1);
-        results[i]->principal_id[sizeof(results[i]->principal_id) - 1] = '\0';
-        strncpy(results[i]->request_id, client->last_request_id, sizeof(results[i]->request_id) - 1);
-        results[i]->request_id[sizeof(results[i]->request_id) - 1] = '\0';
-        
-        if (asset_ids[i]) {
-            strncpy(results[i]->asset_id, asset_ids[i], sizeof(results[i]->asset_id) - 1);
-            results[i]->asset_id[sizeof(results[i]->asset_id) - 1] = '\0';
-        }
-        
-        const char *action = actions ? actions[i] : "execute";
-        strncpy(results[i]->action, action, sizeof(results[i]->action) - 1);
-        results[i]->action[sizeof(results[i]->action) - 1] = '\0';
-        
-        // Parse decision
-        json_object *decision_value;
-        if (json_object_object_get_ex(decision_obj, "decision", &decision_value)) {
-            const char *decision_str = json_object_get_string(decision_value);
-            if (decision_str) {
-                strncpy(results[i]->decision, decision_str, sizeof(results[i]->decision) - 1);
-                results[i]->decision[sizeof(results[i]->decision) - 1] = '\0';
-                
-                if (strcmp(decision_str, "Allow") == 0) {
-                    results[i]->result = SGNL_ALLOWED;
-                } else {
-                    results[i]->result = SGNL_DENIED;
+    sgnl_request_tracker_t *tracker = batch_tracker_start(principal_id, asset_ids, actions, query_count);
+    sgnl_result_set_t *set = evaluate_access_batch_compact(client, tracker, principal_id, asset_ids, actions,
+                                                           query_count);
+    sgnl_request_end(tracker, batch_audit_result(set));
+    return set;
+}
+
+// Body of sgnl_check_access_batch; records on tracker where the answer came from
+static sgnl_result_t check_access_batch(sgnl_client_t *client, sgnl_request_tracker_t *tracker,
+                                        const char *principal_id,
+                                        const char **asset_ids,
+                                        const char **actions,
+                                        int query_count,
+                                        int *failed_index) {
+    char request_id[64];
+    generate_request_id_internal(request_id, sizeof(request_id));
+    sgnl_request_set_id(tracker, request_id);
+    
+    sgnl_log_debug(client, "Checking that all %d queries are allowed: principal=%s", query_count, principal_id);
+    
+    bool all_prefetched = client->snapshot != NULL;
+    for (int i = 0; all_prefetched && i < query_count; i++) {
+        all_prefetched = sgnl_snapshot_contains(client->snapshot, principal_id, asset_ids[i],
+                                                actions ? actions[i] : "execute");
+    }
+    if (all_prefetched) {
+        sgnl_stats_add(&client->stats.snapshot_hits, (uint64_t)query_count);
+        sgnl_request_set_source(tracker, "snapshot");
+        sgnl_log_debug(client, "Batch check served from prefetched snapshot");
+        return SGNL_ALLOWED;
+    }
+    
+    int64_t deadline = http_retry_deadline(client);
+    if (client->broker_enabled) {
+        // The broker protocol returns per-query results; fold them here
+        sgnl_result_set_t *set = batch_set_via_broker(client, principal_id, asset_ids, actions,
+                                                      query_count, request_id, deadline);
+        if (set) {
+            sgnl_result_t outcome = SGNL_ALLOWED;
+            for (int i = 0; i < query_count && outcome == SGNL_ALLOWED; i++) {
+                outcome = sgnl_result_set_result(set, i);
+                if (outcome != SGNL_ALLOWED && failed_index) {
+                    *failed_index = i;
                 }
             }
-        }
-        
-        // Extract reason if available
-        json_object *reason_value;
-        if (json_object_object_get_ex(decision_obj, "reason", &reason_value)) {
-            const char *reason_str = json_object_get_string(reason_value);
-            if (reason_str) {
-                strncpy(results[i]->reason, reason_str, sizeof(results[i]->reason) - 1);
-                results[i]->reason[sizeof(results[i]->reason) - 1] = '\0';
-            }
-        }
-        
-        sgnl_log_debug(client, "Batch result[%d]: %s -> %s", i, 
-                      asset_ids[i] ? asset_ids[i] : "N/A", 
-                      sgnl_result_to_string(results[i]->result));
-    }
-    
-    // For any remaining slots, create default denied results
-    for (int i = decision_count; i < query_count; i++) {
-        results[i] = calloc(1, sizeof(sgnl_access_result_t));
-        if (results[i]) {
-            results[i]->result = SGNL_DENIED;
-            results[i]->timestamp = time(NULL);
-            strncpy(results[i]->principal_id, principal_id, sizeof(results[i]->principal_id) - 1);
-            results[i]->principal_id[sizeof(results[i]->principal_id) - 1] = '\0';
-            strncpy(results[i]->request_id, client->last_request_id, sizeof(results[i]->request_id) - 1);
-            results[i]->request_id[sizeof(results[i]->request_id) - 1] = '\0';
-            strcpy(results[i]->decision, "Deny");
-            
-            if (asset_ids[i]) {
-                strncpy(results[i]->asset_id, asset_ids[i], sizeof(results[i]->asset_id) - 1);
-                results[i]->asset_id[sizeof(results[i]->asset_id) - 1] = '\0';
-            }
-            
-            const char *action = actions ? actions[i] : "execute";
-            strncpy(results[i]->action, action, sizeof(results[i]->action) - 1);
-            results[i]->action[sizeof(results[i]->action) - 1] = '\0';
+            sgnl_result_set_free(set);
+            sgnl_request_set_source(tracker, "broker");
+            sgnl_log_debug(client, "Batch check served by broker");
+            return outcome;
         }
     }
     
-    json_object_put(root);
-    http_response_free(response);
+    int index = -1;
+    sgnl_request_set_source(tracker, "network");
+    sgnl_result_t outcome = query_count <= client->batch_max_queries ?
+        batch_check_direct(client, principal_id, asset_ids, actions, query_count, request_id,
+                           deadline, NULL, &index) :
+        batch_evaluate_chunked(client, principal_id, asset_ids, actions, query_count, request_id,
+                               deadline, NULL, &index);
+    if (failed_index) {
+        *failed_index = index;
+    }
+    
+    sgnl_log_debug(client, "Batch check completed: result=%s", sgnl_result_to_string(outcome));
+    return outcome;
+}
+
+sgnl_result_t sgnl_check_access_batch(sgnl_client_t *client,
+                                      const char *principal_id,
+                                      const char **asset_ids,
+                                      const char **actions,
+                                      int query_count,
+                                      int *failed_index) {
+    if (failed_index) {
+        *failed_index = -1;
+    }
+    if (!client || !client->initialized || !principal_id || !asset_ids || query_count <= 0) {
+        return SGNL_INVALID_REQUEST;
+    }
     
-    sgnl_log_debug(client, "Batch access evaluation completed");
+    // The whole batch is one decision
+    sgnl_request_tracker_t *tracker = batch_tracker_start(principal_id, asset_ids, actions, query_count);
+    sgnl_result_t outcome = check_access_batch(client, tracker, principal_id, asset_ids, actions,
+                                               query_count, failed_index);
+    sgnl_request_end(tracker, sgnl_result_to_string(outcome));
+    return outcome;
+}
+
+// Parallel arrays of the distinct queries of a set; free both with free()
+static bool query_set_arrays(const sgnl_query_set_t *set, const char ***asset_ids, const char ***actions) {
+    int unique_count = sgnl_query_set_unique_count(set);
+    *asset_ids = calloc(unique_count, sizeof(char *));
+    *actions = calloc(unique_count, sizeof(char *));
+    if (!*asset_ids || !*actions) {
+        free(*asset_ids);
+        free(*actions);
+        return false;
+    }
+    sgnl_query_set_unique_queries(set, *asset_ids, *actions);
+    return true;
+}
+
+sgnl_access_result_t** sgnl_evaluate_query_set(sgnl_client_t *client,
+                                               const char *principal_id,
+                                               const sgnl_query_set_t *set) {
+    int unique_count = sgnl_query_set_unique_count(set);
+    const char **asset_ids;
+    const char **actions;
+    if (!client || !principal_id || unique_count <= 0 || !query_set_arrays(set, &asset_ids, &actions)) {
+        return NULL;
+    }
     
+    sgnl_log_debug(client, "Evaluating %d distinct of %d queries", unique_count, sgnl_query_set_count(set));
+    sgnl_access_result_t **results = sgnl_evaluate_access_batch(client, principal_id, asset_ids, actions, unique_count);
+    free(asset_ids);
+    free(actions);
     return results;
 }
 
-char** sgnl_search_assets(sgnl_client_t *client,
-                          const char *principal_id,
-                          const char *action,
-                          int *asset_count) {
-    if (!client || !principal_id || !asset_count) {
-        if (asset_count) *asset_count = 0;
+sgnl_result_set_t* sgnl_evaluate_query_set_compact(sgnl_client_t *client,
+                                                   const char *principal_id,
+                                                   const sgnl_query_set_t *set) {
+    int unique_count = sgnl_query_set_unique_count(set);
+    const char **asset_ids;
+    const char **actions;
+    if (!client || !principal_id || unique_count <= 0 || !query_set_arrays(set, &asset_ids, &actions)) {
         return NULL;
     }
     
-    *asset_count = 0;
+    sgnl_log_debug(client, "Evaluating %d distinct of %d queries", unique_count, sgnl_query_set_count(set));
+    sgnl_result_set_t *results = sgnl_evaluate_access_batch_compact(client, principal_id, asset_ids, actions,
+                                                                    unique_count);
+    free(asset_ids);
+    free(actions);
+    return results;
+}
+
+sgnl_result_t sgnl_check_query_set(sgnl_client_t *client,
+                                   const char *principal_id,
+                                   const sgnl_query_set_t *set) {
+    int unique_count = sgnl_query_set_unique_count(set);
+    if (!client || !principal_id || unique_count <= 0) {
+        return SGNL_INVALID_REQUEST;
+    }
     
-    if (!client->initialized) {
-        sgnl_log_error(client, "Client not initialized");
+    const char **asset_ids;
+    const char **actions;
+    if (!query_set_arrays(set, &asset_ids, &actions)) {
+        return SGNL_MEMORY_ERROR;
+    }
+    sgnl_result_t outcome = sgnl_check_access_batch(client, principal_id, asset_ids, actions, unique_count, NULL);
+    free(asset_ids);
+    free(actions);
+    return outcome;
+}
+
+// SearchRequest body, in a buffer borrowed from the client
+static const char* build_search_body(sgnl_client_t *client, sgnl_json_buffer_t *buffer, const char *principal_id,
+                                     const char *action, const char *page_token, int page_size) {
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init_buffer(&writer, buffer, 256 + (page_token ? strlen(page_token) : 0));
+    if (!write_request_start(client, &writer, principal_id)) {
         return NULL;
     }
+    sgnl_json_writer_key(&writer, "queries");
+    sgnl_json_writer_begin_array(&writer);
+    write_query(&writer, NULL, action);
+    sgnl_json_writer_end_array(&writer);
+    sgnl_json_writer_key(&writer, "pageSize");
+    sgnl_json_writer_int(&writer, page_size);
+    if (page_token && page_token[0]) {
+        sgnl_json_writer_key(&writer, "pageToken");
+        sgnl_json_writer_string(&writer, page_token);
+    }
+    sgnl_json_writer_end_object(&writer);
+    return sgnl_json_writer_finish(&writer);
+}
+
+// Search state shared with the response stream
+typedef struct {
+    sgnl_asset_callback_t callback;
+    void *user_data;
+    bool stopped;
+} search_stream_ctx_t;
+
+// Hand allowed assets to the caller as each decision is parsed
+static bool search_decision_callback(const sgnl_json_decision_t *decision, int index, void *user_data) {
+    (void)index;
+    search_stream_ctx_t *ctx = (search_stream_ctx_t *)user_data;
+    
+    if (decision->decision && decision->asset_id && strcmp(decision->decision, "Allow") == 0) {
+        if (!ctx->callback(decision->asset_id, ctx->user_data)) {
+            ctx->stopped = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+// search_page with the request body written to body and the parser in arena
+static sgnl_result_t search_page_in_arena(sgnl_client_t *client,
+                                          sgnl_arena_t *arena,
+                                          sgnl_json_buffer_t *body,
+                                          const char *principal_id,
+                                          const char *action,
+                                          const char *page_token,
+                                          int page_size,
+                                          sgnl_asset_callback_t callback,
+                                          void *user_data,
+                                          const char *request_id,
+                                          char **next_page_token,
+                                          bool *stopped) {
+    *next_page_token = NULL;
+    *stopped = false;
+    
+    const char *json_body = build_search_body(client, body, principal_id, action, page_token, page_size);
+    if (!json_body) {
+        sgnl_log_error(client, "Failed to build search request");
+        return SGNL_MEMORY_ERROR;
+    }
     
-    // Build endpoint path (correct SGNL API v2 endpoint)
-    const char *endpoint = "/access/v2/search";
-    const char *search_action = action ? action : "list";
-    
-    // Build JSON request body according to SearchRequest schema
-    char json_body[1024];
-    snprintf(json_body, sizeof(json_body), 
-             "{"
-             "\"principal\":{\"id\":\"%s\",\"deviceId\":\"%s\"},"
-             "\"queries\":[{\"action\":\"%s\"}]"
-             "}", 
-             principal_id, get_device_id(), search_action);
+    search_stream_ctx_t ctx = {
+        .callback = callback,
+        .user_data = user_data,
+        .stopped = false
+    };
+    sgnl_json_stream_t *stream = sgnl_json_stream_create_in(arena, search_decision_callback, &ctx);
+    if (!stream) {
+        sgnl_log_error(client, "Failed to create response parser");
+        return SGNL_MEMORY_ERROR;
+    }
     
-    sgnl_log_debug(client, "Making asset search request to: %s.%s%s", client->tenant, client->api_url, endpoint);
-    sgnl_log_debug(client, "Request body: %s", json_body);
+    sgnl_log_debug(client, "Requesting search page (size=%d, token=%s)", page_size, page_token ? page_token : "none");
     
-    // Make HTTP request
-    http_response_t *response = make_http_request(client, endpoint, json_body);
+    http_body_t payload = {json_body, strlen(json_body), false};
+    http_response_t *response = make_http_request(client, "/access/v2/search", &payload, stream, request_id,
+                                                  http_retry_deadline(client), NULL);
     if (!response) {
         sgnl_log_error(client, "Failed to make HTTP request");
-        return NULL;
+        return SGNL_NETWORK_ERROR;
     }
     
     if (response->status_code != 200) {
         sgnl_log_error(client, "HTTP request failed with status %ld", response->status_code);
+        sgnl_result_t error = SGNL_ERROR;
+        if (response->status_code == 401 || response->status_code == 403) {
+            error = SGNL_AUTH_ERROR;
+        } else if (response->status_code == 0 || response->status_code >= 500) {
+            error = SGNL_NETWORK_ERROR;
+        }
         http_response_free(response);
-        return NULL;
+        return error;
     }
+    http_response_free(response);
     
-    sgnl_log_debug(client, "Received response: %s", response->data);
+    // The caller has what it wants; the rest of the page was never read
+    if (ctx.stopped) {
+        *stopped = true;
+        return SGNL_OK;
+    }
     
-    // Parse JSON response
-    json_object *root = json_tokener_parse(response->data);
-    if (!root) {
+    if (sgnl_json_stream_finish(stream) != SGNL_JSON_STREAM_OK) {
         sgnl_log_error(client, "Failed to parse JSON response");
-        http_response_free(response);
-        return NULL;
+        return SGNL_ERROR;
     }
     
-    // Extract decisions array
-    json_object *decisions_array;
-    if (!json_object_object_get_ex(root, "decisions", &decisions_array)) {
-        sgnl_log_error(client, "No 'decisions' field in response");
-        json_object_put(root);
-        http_response_free(response);
-        return NULL;
+    if (!sgnl_json_stream_has_decisions(stream)) {
+        sgnl_log_error(client, "No 'decisions' array in search response");
+        return SGNL_ERROR;
     }
     
-    if (!json_object_is_type(decisions_array, json_type_array)) {
-        sgnl_log_error(client, "'decisions' field is not an array");
-        json_object_put(root);
-        http_response_free(response);
-        return NULL;
+    const char *token = sgnl_json_stream_next_page_token(stream);
+    if (token) {
+        *next_page_token = strdup(token);
+        if (!*next_page_token) {
+            return SGNL_MEMORY_ERROR;
+        }
     }
     
-    int decisions_count = json_object_array_length(decisions_array);
-    sgnl_log_debug(client, "Found %d decisions in response", decisions_count);
+    sgnl_log_debug(client, "Search page had %d decisions, %s", sgnl_json_stream_decision_count(stream),
+                   *next_page_token ? "more pages follow" : "last page");
     
-    // First pass: count allowed assets
-    int allowed_count = 0;
-    for (int i = 0; i < decisions_count; i++) {
-        json_object *decision = json_object_array_get_idx(decisions_array, i);
-        if (!decision) continue;
-        
-        json_object *decision_field;
-        if (json_object_object_get_ex(decision, "decision", &decision_field)) {
-            const char *decision_value = json_object_get_string(decision_field);
-            if (decision_value && strcmp(decision_value, "Allow") == 0) {
-                allowed_count++;
-            }
+    return SGNL_OK;
+}
+
+/**
+ * Fetch one page of search results
+ *
+ * Calls callback for every allowed asset on the page, in response order,
+ * while the page is still downloading. On success *next_page_token is the
+ * token for the following page, or NULL when this was the last one;
+ * *stopped is set if the callback ended the walk.
+ */
+static sgnl_result_t search_page(sgnl_client_t *client,
+                                 const char *principal_id,
+                                 const char *action,
+                                 const char *page_token,
+                                 int page_size,
+                                 sgnl_asset_callback_t callback,
+                                 void *user_data,
+                                 const char *request_id,
+                                 char **next_page_token,
+                                 bool *stopped) {
+    char arena_storage[SGNL_ARENA_INLINE_SIZE];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, arena_storage, sizeof(arena_storage));
+    sgnl_json_buffer_t body = body_buffer_acquire(client);
+    sgnl_result_t result = search_page_in_arena(client, &arena, &body, principal_id, action, page_token, page_size,
+                                                callback, user_data, request_id, next_page_token, stopped);
+    body_buffer_release(client, &body);
+    sgnl_arena_release(&arena);
+    return result;
+}
+
+// Growable NULL-terminated array of asset IDs filled from search callbacks
+typedef struct {
+    char **asset_ids;
+    int count;
+    int capacity;
+    bool failed;
+} asset_collector_t;
+
+static bool collect_asset(const char *asset_id, void *user_data) {
+    asset_collector_t *collector = (asset_collector_t *)user_data;
+    
+    if (collector->count + 1 >= collector->capacity) {
+        int new_capacity = collector->capacity ? collector->capacity * 2 : 16;
+        char **grown = realloc(collector->asset_ids, new_capacity * sizeof(char *));
+        if (!grown) {
+            collector->failed = true;
+            return false;
         }
+        collector->asset_ids = grown;
+        collector->capacity = new_capacity;
     }
     
-    sgnl_log_debug(client, "Found %d allowed assets", allowed_count);
-    
-    if (allowed_count == 0) {
-        json_object_put(root);
-        http_response_free(response);
-        *asset_count = 0;
-        return calloc(1, sizeof(char*)); // Empty NULL-terminated array
+    char *copy = strdup(asset_id);
+    if (!copy) {
+        collector->failed = true;
+        return false;
+    }
+    collector->asset_ids[collector->count++] = copy;
+    collector->asset_ids[collector->count] = NULL;
+    return true;
+}
+
+// Hand back the collected array, always non-NULL and NULL-terminated
+static char** collector_finish(asset_collector_t *collector) {
+    if (!collector->asset_ids) {
+        collector->asset_ids = calloc(1, sizeof(char *));
+    }
+    return collector->asset_ids;
+}
+
+static int normalize_page_size(int page_size) {
+    if (page_size <= 0) {
+        return SGNL_SEARCH_DEFAULT_PAGE_SIZE;
+    }
+    return page_size > SGNL_SEARCH_MAX_PAGE_SIZE ? SGNL_SEARCH_MAX_PAGE_SIZE : page_size;
+}
+
+sgnl_result_t sgnl_search_assets_foreach(sgnl_client_t *client,
+                                         const char *principal_id,
+                                         const char *action,
+                                         int page_size,
+                                         sgnl_asset_callback_t callback,
+                                         void *user_data) {
+    if (!client || !principal_id || !callback) {
+        return SGNL_INVALID_REQUEST;
     }
     
-    // Allocate array for asset IDs (+ 1 for NULL terminator)
-    char **asset_ids = calloc(allowed_count + 1, sizeof(char*));
-    if (!asset_ids) {
-        sgnl_log_error(client, "Failed to allocate memory for asset IDs");
-        json_object_put(root);
-        http_response_free(response);
-        return NULL;
+    if (!client->initialized) {
+        sgnl_log_error(client, "Client not initialized");
+        return SGNL_CONFIG_ERROR;
     }
     
-    // Second pass: extract asset IDs from allowed decisions
-    int asset_index = 0;
-    for (int i = 0; i < decisions_count && asset_index < allowed_count; i++) {
-        json_object *decision = json_object_array_get_idx(decisions_array, i);
-        if (!decision) continue;
+    const char *search_action = action ? action : "list";
+    page_size = normalize_page_size(page_size);
+    
+    char request_id[64];
+    generate_request_id_internal(request_id, sizeof(request_id));
+    
+    char *page_token = NULL;
+    int pages = 0;
+    sgnl_result_t result;
+    
+    do {
+        char *next_page_token = NULL;
+        bool stopped = false;
         
-        json_object *decision_field;
-        if (json_object_object_get_ex(decision, "decision", &decision_field)) {
-            const char *decision_value = json_object_get_string(decision_field);
-            if (decision_value && strcmp(decision_value, "Allow") == 0) {
-                // Extract assetId
-                json_object *asset_id_field;
-                if (json_object_object_get_ex(decision, "assetId", &asset_id_field)) {
-                    const char *asset_id = json_object_get_string(asset_id_field);
-                    if (asset_id) {
-                        asset_ids[asset_index] = strdup(asset_id);
-                        if (asset_ids[asset_index]) {
-                            sgnl_log_debug(client, "Added allowed asset: %s", asset_id);
-                            asset_index++;
-                        }
-                    }
-                }
-            }
+        result = search_page(client, principal_id, search_action, page_token, page_size,
+                             callback, user_data, request_id, &next_page_token, &stopped);
+        pages++;
+        
+        // A server echoing the same token back would otherwise loop forever
+        if (result == SGNL_OK && next_page_token && page_token &&
+            strcmp(next_page_token, page_token) == 0) {
+            sgnl_log_error(client, "Search pagination did not advance");
+            result = SGNL_ERROR;
         }
+        
+        free(page_token);
+        page_token = stopped ? NULL : next_page_token;
+        if (stopped) {
+            free(next_page_token);
+        }
+    } while (result == SGNL_OK && page_token);
+    
+    free(page_token);
+    sgnl_log_debug(client, "Asset search finished after %d page%s: %s",
+                   pages, pages == 1 ? "" : "s", sgnl_result_to_string(result));
+    return result;
+}
+
+char** sgnl_search_assets(sgnl_client_t *client,
+                          const char *principal_id,
+                          const char *action,
+                          int *asset_count) {
+    if (!client || !principal_id || !asset_count) {
+        if (asset_count) *asset_count = 0;
+        return NULL;
     }
     
-    json_object_put(root);
-    http_response_free(response);
+    *asset_count = 0;
+    
+    asset_collector_t collector = {0};
+    sgnl_result_t result = sgnl_search_assets_foreach(client, principal_id, action, 0,
+                                                      collect_asset, &collector);
+    if (collector.failed) {
+        sgnl_log_error(client, "Failed to allocate memory for asset IDs");
+        result = SGNL_MEMORY_ERROR;
+    }
+    if (result != SGNL_OK) {
+        sgnl_asset_ids_free(collector.asset_ids, collector.count);
+        return NULL;
+    }
     
-    *asset_count = asset_index;
-    sgnl_log_debug(client, "Asset search completed: %d assets found", asset_index);
+    *asset_count = collector.count;
+    sgnl_log_debug(client, "Asset search completed: %d assets found", collector.count);
     
-    return asset_ids;
+    return collector_finish(&collector);
 }
 
 sgnl_search_result_t* sgnl_search_assets_detailed(sgnl_client_t *client,
@@ -1017,25 +3700,47 @@ sgnl_search_result_t* sgnl_search_assets_detailed(sgnl_client_t *client,
                                                   const char *action,
                                                   const char *page_token,
                                                   int page_size) {
-    // Simplified implementation
-    (void)client;     // Suppress unused parameter warning
-    (void)page_token; // Suppress unused parameter warning
-    (void)page_size;  // Suppress unused parameter warning
+    if (!client || !principal_id) {
+        return NULL;
+    }
     
     sgnl_search_result_t *result = calloc(1, sizeof(sgnl_search_result_t));
-    if (result) {
-        result->result = SGNL_OK;
-        result->asset_count = 0;
-        result->asset_ids = calloc(1, sizeof(char*)); // NULL-terminated empty array
-        if (principal_id) {
-            strncpy(result->principal_id, principal_id, sizeof(result->principal_id) - 1);
-            result->principal_id[sizeof(result->principal_id) - 1] = '\0';
-        }
-        if (action) {
-            strncpy(result->action, action, sizeof(result->action) - 1);
-            result->action[sizeof(result->action) - 1] = '\0';
-        }
+    if (!result) {
+        return NULL;
+    }
+    
+    const char *search_action = action ? action : "list";
+    snprintf(result->principal_id, sizeof(result->principal_id), "%s", principal_id);
+    snprintf(result->action, sizeof(result->action), "%s", search_action);
+    
+    generate_request_id_internal(result->request_id, sizeof(result->request_id));
+    
+    if (!client->initialized) {
+        result->result = SGNL_CONFIG_ERROR;
+        snprintf(result->error_message, sizeof(result->error_message), "Client not initialized");
+        return result;
+    }
+    
+    asset_collector_t collector = {0};
+    bool stopped = false;
+    result->result = search_page(client, principal_id, search_action, page_token,
+                                 normalize_page_size(page_size), collect_asset, &collector,
+                                 result->request_id, &result->next_page_token, &stopped);
+    if (collector.failed) {
+        result->result = SGNL_MEMORY_ERROR;
     }
+    
+    if (result->result != SGNL_OK) {
+        snprintf(result->error_message, sizeof(result->error_message), "%s", last_error);
+        free(result->next_page_token);
+        result->next_page_token = NULL;
+        sgnl_asset_ids_free(collector.asset_ids, collector.count);
+        return result;
+    }
+    
+    result->asset_ids = collector_finish(&collector);
+    result->asset_count = collector.count;
+    result->has_more_pages = result->next_page_token != NULL;
     return result;
 }
 
@@ -1102,10 +3807,29 @@ const char* sgnl_result_to_string(sgnl_result_t result) {
     }
 }
 
+const char* sgnl_phase_to_string(sgnl_phase_t phase) {
+    switch (phase) {
+        case SGNL_PHASE_DNS:
+            return "dns";
+        case SGNL_PHASE_CONNECT:
+            return "connect";
+        case SGNL_PHASE_TLS:
+            return "tls";
+        case SGNL_PHASE_FIRST_BYTE:
+            return "first_byte";
+        case SGNL_PHASE_TOTAL:
+            return "total";
+        case SGNL_PHASE_PARSE:
+            return "parse";
+        default:
+            return "unknown";
+    }
+}
+
 char* sgnl_generate_request_id(void) {
     char *request_id = malloc(64);
     if (request_id) {
-        strcpy(request_id, generate_request_id_internal());
+        generate_request_id_internal(request_id, 64);
     }
     return request_id;
 }
@@ -1132,4 +3856,4 @@ const char* sgnl_get_version(void) {
     return "1.0.0";
 }
 
- 
\ No newline at end of file
+ 
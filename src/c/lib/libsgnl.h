@@ -49,16 +49,21 @@ typedef enum {
 typedef struct sgnl_client sgnl_client_t;
 typedef struct sgnl_access_result sgnl_access_result_t;
 typedef struct sgnl_search_result sgnl_search_result_t;
+typedef struct sgnl_query_set sgnl_query_set_t;
+typedef struct sgnl_result_set sgnl_result_set_t;
 
 // Client configuration options  
 typedef struct {
     const char *config_path;        // Path to config file (NULL = auto-detect)
     int timeout_seconds;            // Request timeout (0 = default: 30s)
-    int retry_count;                // Number of retries (0 = default: 2)
-    int retry_delay_ms;             // Delay between retries (0 = default: 1000ms)
+    int retry_count;                // Retries on transient failure (0 = http.retry from config, default: 2)
+    int retry_delay_ms;             // Backoff base delay (0 = http.retry from config, default: 100ms)
     bool enable_debug_logging;      // Enable debug output
     bool validate_ssl;              // Validate SSL certificates
     const char *user_agent;         // Custom user agent (NULL = default)
+    bool bypass_broker;             // Never route through sgnld, and write no audit records (set by the broker itself)
+    int timeout_ms;                 // Request timeout in ms, takes precedence over timeout_seconds (0 = unset)
+    int deadline_ms;                // End-to-end bound on each call, retries included (0 = http.deadline_ms from config)
 } sgnl_client_config_t;
 
 // Access evaluation result (detailed)
@@ -97,6 +102,10 @@ struct sgnl_search_result {
 /**
  * Create SGNL client with configuration from file
  * 
+ * The client may be shared by any number of threads: evaluations and
+ * searches on one client run concurrently and share its connections and
+ * decision cache.
+ * 
  * @param config Configuration options (NULL = use defaults)
  * @return Client instance or NULL on error
  */
@@ -105,6 +114,8 @@ sgnl_client_t* sgnl_client_create(const sgnl_client_config_t *config);
 /**
  * Destroy client and cleanup resources
  * 
+ * No other thread may be using the client.
+ * 
  * @param client Client to destroy
  */
 void sgnl_client_destroy(sgnl_client_t *client);
@@ -120,6 +131,9 @@ sgnl_result_t sgnl_client_validate(sgnl_client_t *client);
 /**
  * Get last error message from client
  * 
+ * Errors are recorded per thread, so this reports the last failure seen by
+ * the calling thread.
+ * 
  * @param client Client instance  
  * @return Error message or NULL if no error
  */
@@ -133,6 +147,146 @@ const char* sgnl_client_get_last_error(sgnl_client_t *client);
  */
 bool sgnl_client_is_debug_enabled(sgnl_client_t *client);
 
+/**
+ * Remove cached decisions for a principal
+ * 
+ * The decision cache is enabled with the "cache" block of the config file.
+ * The principal's prefetched snapshot (see sgnl_client_snapshot_refresh) is
+ * dropped as well, whatever asset_id and action are.
+ * 
+ * @param client Client instance
+ * @param principal_id Principal whose decisions should be dropped
+ * @param asset_id Asset to drop (NULL = all assets)
+ * @param action Action to drop (NULL = all actions)
+ * @return SGNL_OK on success, SGNL_ERROR on invalid arguments
+ */
+sgnl_result_t sgnl_client_cache_invalidate(sgnl_client_t *client,
+                                           const char *principal_id,
+                                           const char *asset_id,
+                                           const char *action);
+
+/**
+ * Remove all cached decisions and prefetched snapshots
+ * 
+ * @param client Client instance
+ * @return SGNL_OK on success, SGNL_ERROR on invalid arguments
+ */
+sgnl_result_t sgnl_client_cache_flush(sgnl_client_t *client);
+
+/**
+ * Resolve the API host and complete a TLS handshake ahead of the first call
+ * 
+ * The resolved addresses stay in the client's DNS cache (http.dns) for
+ * later requests. Meant for long-lived clients such as sgnld; a short-lived
+ * PAM or sudo client gains nothing from it.
+ * 
+ * @param client Client instance
+ * @return SGNL_OK once connected, SGNL_TIMEOUT_ERROR or SGNL_NETWORK_ERROR
+ *         if the API could not be reached
+ */
+sgnl_result_t sgnl_client_warm_up(sgnl_client_t *client);
+
+/**
+ * Rebuild the prefetched entitlement snapshot of one principal
+ * 
+ * Searches SGNL for every asset the principal may use for the configured
+ * prefetch action and, once the search completes, swaps in the new set.
+ * Evaluations of that action whose asset is in a set refreshed within the
+ * last two prefetch intervals are then answered locally as Allow; anything
+ * else is evaluated by SGNL as usual. Enabled with the "prefetch" block of
+ * the config file; sgnld drives it from a background refresher.
+ * 
+ * @param client Client instance
+ * @param principal_id Principal to refresh
+ * @return SGNL_OK when the set was replaced, SGNL_ERROR if prefetch is
+ *         disabled, otherwise the search error (the previous set is kept
+ *         until it ages out)
+ */
+sgnl_result_t sgnl_client_snapshot_refresh(sgnl_client_t *client, const char *principal_id);
+
+/**
+ * Drop the prefetched snapshots of principals that are no longer active
+ * 
+ * @param client Client instance
+ * @param principal_ids Principals to keep
+ * @param count Number of entries in principal_ids
+ * @return SGNL_OK on success, SGNL_ERROR if prefetch is disabled
+ */
+sgnl_result_t sgnl_client_snapshot_retain(sgnl_client_t *client, const char **principal_ids, int count);
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+// Phases of an HTTP attempt to the SGNL API, as timed by libcurl. DNS,
+// connect and TLS are recorded only for attempts that opened a connection.
+typedef enum {
+    SGNL_PHASE_DNS = 0,             // Name resolution
+    SGNL_PHASE_CONNECT,             // TCP connect, after resolution
+    SGNL_PHASE_TLS,                 // TLS handshake, after connect
+    SGNL_PHASE_FIRST_BYTE,          // Request sent until the first response byte
+    SGNL_PHASE_TOTAL,               // Whole attempt
+    SGNL_PHASE_PARSE,               // Parsing the response body
+    SGNL_PHASE_COUNT
+} sgnl_phase_t;
+
+// Latency summary of one phase, in microseconds. Percentiles are accurate
+// to about 3%.
+typedef struct {
+    uint64_t count;
+    uint64_t sum_us;
+    uint64_t max_us;
+    uint64_t p50_us;
+    uint64_t p90_us;
+    uint64_t p99_us;
+    uint64_t p999_us;
+} sgnl_latency_stats_t;
+
+// Totals since the client was created
+typedef struct {
+    uint64_t cache_hits;            // Evaluations answered by the decision cache
+    uint64_t cache_misses;          // Decision cache lookups that found nothing
+    uint64_t snapshot_hits;         // Queries answered by the prefetched snapshot
+    uint64_t broker_hits;           // Calls answered by sgnld
+    uint64_t offline_hits;          // Queries answered by the offline store
+    uint64_t requests;              // HTTP attempts, hedges and retries included
+    uint64_t request_errors;        // Attempts without a 200 response
+    uint64_t retries;               // Attempts retried after a transient failure
+    uint64_t hedges;                // Hedged second attempts started
+    uint64_t connections;           // Connections opened
+    sgnl_latency_stats_t phases[SGNL_PHASE_COUNT];
+} sgnl_client_stats_t;
+
+/**
+ * Read the client's counters and latency percentiles
+ * 
+ * Statistics are always collected; recording never takes a lock, so
+ * reading them while evaluations run is cheap and does not slow those down.
+ * 
+ * @param client Client instance
+ * @param stats Output
+ * @return SGNL_OK on success, SGNL_ERROR on invalid arguments
+ */
+sgnl_result_t sgnl_client_get_stats(sgnl_client_t *client, sgnl_client_stats_t *stats);
+
+/**
+ * Write the client's statistics in the Prometheus text format
+ * 
+ * The file is replaced atomically, so it can be read by the node_exporter
+ * textfile collector at any time. Series are labelled with the API host.
+ * sgnld writes it periodically when metrics.textfile_path is set.
+ * 
+ * @param client Client instance
+ * @param path File to write (its directory must exist)
+ * @return SGNL_OK on success, SGNL_ERROR if the file could not be written
+ */
+sgnl_result_t sgnl_client_write_metrics(sgnl_client_t *client, const char *path);
+
+/**
+ * Name of a phase as used in metrics ("dns", "connect", ...)
+ */
+const char* sgnl_phase_to_string(sgnl_phase_t phase);
+
 
 
 // ============================================================================
@@ -170,6 +324,10 @@ sgnl_access_result_t* sgnl_evaluate_access(sgnl_client_t *client,
 /**
  * Batch access evaluation (multiple queries)
  * 
+ * Batches larger than batch.max_queries are split into that many queries
+ * per request, and up to batch.max_concurrency requests are sent at once.
+ * The batch still succeeds or fails as a whole.
+ * 
  * @param client SGNL client
  * @param principal_id User/principal ID
  * @param asset_ids Array of asset IDs
@@ -183,16 +341,248 @@ sgnl_access_result_t** sgnl_evaluate_access_batch(sgnl_client_t *client,
                                                   const char **actions,
                                                   int query_count);
 
+/**
+ * Check that every query of a batch is allowed
+ * 
+ * For callers that only act when all queries are allowed. Decisions are
+ * read as they stream in and no per-query results are built; the first
+ * non-Allow decision ends the response and cancels chunk requests still in
+ * flight.
+ * 
+ * @param client SGNL client
+ * @param principal_id User/principal ID
+ * @param asset_ids Array of asset IDs
+ * @param actions Array of actions (or NULL for all "execute")
+ * @param query_count Number of queries
+ * @param failed_index Set to the first query found not allowed, or -1 (may be NULL)
+ * @return SGNL_ALLOWED if every query is allowed, SGNL_DENIED on the first
+ *         Deny, or an error code
+ */
+sgnl_result_t sgnl_check_access_batch(sgnl_client_t *client,
+                                      const char *principal_id,
+                                      const char **asset_ids,
+                                      const char **actions,
+                                      int query_count,
+                                      int *failed_index);
+
+// ============================================================================
+// Query Sets
+// ============================================================================
+
+/**
+ * Create an empty query set
+ * 
+ * A query set collects (asset, action) queries for one principal. Strings
+ * are copied into the set; each distinct action is stored once, and a
+ * repeated (asset, action) pair is evaluated only once.
+ * 
+ * @return Query set or NULL on allocation failure
+ */
+sgnl_query_set_t* sgnl_query_set_create(void);
+
+void sgnl_query_set_free(sgnl_query_set_t *set);
+
+/**
+ * Add a query
+ * 
+ * @param set Query set
+ * @param asset_id Asset ID (may be NULL)
+ * @param action Action (NULL = "execute")
+ * @return Index of the query in the order added, or -1 on allocation failure
+ */
+int sgnl_query_set_add(sgnl_query_set_t *set, const char *asset_id, const char *action);
+
+/**
+ * Number of queries added, duplicates included
+ */
+int sgnl_query_set_count(const sgnl_query_set_t *set);
+
+/**
+ * Number of distinct (asset, action) pairs, i.e. queries actually evaluated
+ */
+int sgnl_query_set_unique_count(const sgnl_query_set_t *set);
+
+/**
+ * Position in the sgnl_evaluate_query_set results of the query at index
+ * 
+ * Duplicate queries share a result.
+ * 
+ * @return Result index, or -1 if index is out of range
+ */
+int sgnl_query_set_result_index(const sgnl_query_set_t *set, int index);
+
+/**
+ * Evaluate the distinct queries of a set as one batch
+ * 
+ * @param client SGNL client
+ * @param principal_id User/principal ID
+ * @param set Query set
+ * @return One result per distinct query (sgnl_query_set_unique_count, map
+ *         added queries with sgnl_query_set_result_index), or NULL on
+ *         failure. Free with sgnl_access_result_array_free.
+ */
+sgnl_access_result_t** sgnl_evaluate_query_set(sgnl_client_t *client,
+                                               const char *principal_id,
+                                               const sgnl_query_set_t *set);
+
+/**
+ * Check that every distinct query of a set is allowed
+ * 
+ * See sgnl_check_access_batch.
+ * 
+ * @return SGNL_ALLOWED if every query is allowed, SGNL_DENIED or an error code
+ */
+sgnl_result_t sgnl_check_query_set(sgnl_client_t *client,
+                                   const char *principal_id,
+                                   const sgnl_query_set_t *set);
+
+// ============================================================================
+// Compact Batch Results
+// ============================================================================
+
+/**
+ * Batch access evaluation returning compact results
+ * 
+ * Same evaluation as sgnl_evaluate_access_batch, but all results share one
+ * allocation: each costs a few bytes plus its strings instead of a full
+ * sgnl_access_result_t. Read them through the sgnl_result_set_* accessors.
+ * 
+ * @param client SGNL client
+ * @param principal_id User/principal ID
+ * @param asset_ids Array of asset IDs
+ * @param actions Array of actions (or NULL for all "execute")
+ * @param query_count Number of queries
+ * @return Result set (must be freed with sgnl_result_set_free), or NULL on failure
+ */
+sgnl_result_set_t* sgnl_evaluate_access_batch_compact(sgnl_client_t *client,
+                                                      const char *principal_id,
+                                                      const char **asset_ids,
+                                                      const char **actions,
+                                                      int query_count);
+
+/**
+ * Evaluate the distinct queries of a set, returning compact results
+ * 
+ * @return One result per distinct query (map added queries with
+ *         sgnl_query_set_result_index), or NULL on failure
+ */
+sgnl_result_set_t* sgnl_evaluate_query_set_compact(sgnl_client_t *client,
+                                                   const char *principal_id,
+                                                   const sgnl_query_set_t *set);
+
+void sgnl_result_set_free(sgnl_result_set_t *set);
+
+int sgnl_result_set_count(const sgnl_result_set_t *set);
+
+/**
+ * Outcome of the query at index
+ * 
+ * @return Result code, or SGNL_INVALID_REQUEST if index is out of range
+ */
+sgnl_result_t sgnl_result_set_result(const sgnl_result_set_t *set, int index);
+
+/**
+ * Accessors for the query at index
+ * 
+ * The strings belong to the set and stay valid until it is freed. Missing
+ * values and out of range indexes yield "". The decision is derived from
+ * the result: "Allow", "Deny" or "".
+ */
+const char* sgnl_result_set_decision(const sgnl_result_set_t *set, int index);
+const char* sgnl_result_set_reason(const sgnl_result_set_t *set, int index);
+const char* sgnl_result_set_asset_id(const sgnl_result_set_t *set, int index);
+const char* sgnl_result_set_action(const sgnl_result_set_t *set, int index);
+
+/**
+ * Values shared by every result of the set
+ */
+const char* sgnl_result_set_principal_id(const sgnl_result_set_t *set);
+const char* sgnl_result_set_request_id(const sgnl_result_set_t *set);
+int64_t sgnl_result_set_timestamp(const sgnl_result_set_t *set);
+
+/**
+ * Completion callback for sgnl_evaluate_access_async
+ * 
+ * Runs on the client's worker thread (or on the calling thread for a cached
+ * decision) and should return quickly; it must not destroy the client.
+ * 
+ * @param result Evaluation result, owned by the callback (free with sgnl_access_result_free)
+ * @param user_data Caller context passed to sgnl_evaluate_access_async
+ */
+typedef void (*sgnl_access_callback_t)(sgnl_access_result_t *result, void *user_data);
+
+/**
+ * Asynchronous access evaluation
+ * 
+ * Returns without waiting for the API. All asynchronous evaluations of a
+ * client are multiplexed by one internal worker thread, so any number can
+ * be in flight at once. They go straight to the API (not through sgnld) and
+ * follow the same retry policy as synchronous calls. Evaluations still
+ * pending when the client is destroyed complete with SGNL_ERROR.
+ * 
+ * @param client SGNL client
+ * @param principal_id User/principal ID
+ * @param asset_id Asset ID
+ * @param action Action to perform (NULL = "execute")
+ * @param callback Called exactly once with the result when SGNL_OK is returned
+ * @param user_data Passed through to callback
+ * @return SGNL_OK if the evaluation was accepted, otherwise the error that
+ *         prevented it (callback is not called)
+ */
+sgnl_result_t sgnl_evaluate_access_async(sgnl_client_t *client,
+                                         const char *principal_id,
+                                         const char *asset_id,
+                                         const char *action,
+                                         sgnl_access_callback_t callback,
+                                         void *user_data);
+
 // ============================================================================
 // Asset Search
 // ============================================================================
 
+// Search page sizes sent as pageSize
+#define SGNL_SEARCH_DEFAULT_PAGE_SIZE 50
+#define SGNL_SEARCH_MAX_PAGE_SIZE     1000
+
+/**
+ * Callback invoked for each allowed asset as search pages arrive
+ * 
+ * @param asset_id Asset ID (only valid for the duration of the call)
+ * @param user_data Caller context passed to sgnl_search_assets_foreach
+ * @return true to continue, false to stop the search
+ */
+typedef bool (*sgnl_asset_callback_t)(const char *asset_id, void *user_data);
+
+/**
+ * Search for assets the principal can access, following all pages
+ * 
+ * Each page is requested only after the previous one has been handed to
+ * the callback, so memory stays bounded by one page.
+ * 
+ * @param client SGNL client
+ * @param principal_id User/principal ID
+ * @param action Action to search for (NULL = "list")
+ * @param page_size Assets per page (0 = default: 50)
+ * @param callback Called once per allowed asset
+ * @param user_data Passed through to callback
+ * @return SGNL_OK when all pages were read or the callback stopped early,
+ *         otherwise the error that ended the search
+ */
+sgnl_result_t sgnl_search_assets_foreach(sgnl_client_t *client,
+                                         const char *principal_id,
+                                         const char *action,
+                                         int page_size,
+                                         sgnl_asset_callback_t callback,
+                                         void *user_data);
+
 /**
  * Search for assets the principal can access
  * 
+ * Collects every page; prefer sgnl_search_assets_foreach for large results.
+ * 
  * @param client SGNL client
  * @param principal_id User/principal ID
- * @param action Action to search for (NULL = "execute")
+ * @param action Action to search for (NULL = "list")
  * @param asset_count Output: number of assets found
  * @return Array of asset IDs (must be freed with sgnl_asset_ids_free)
  */
@@ -204,12 +594,16 @@ char** sgnl_search_assets(sgnl_client_t *client,
 /**
  * Detailed asset search with pagination
  * 
+ * Fetches a single page. Pass the returned next_page_token back in to read
+ * the following page while has_more_pages is set.
+ * 
  * @param client SGNL client
  * @param principal_id User/principal ID
- * @param action Action to search for (NULL = "execute")
+ * @param action Action to search for (NULL = "list")
  * @param page_token Pagination token (NULL = first page)
  * @param page_size Page size (0 = default: 50)
- * @return Search result (must be freed with sgnl_search_result_free)
+ * @return Search result (must be freed with sgnl_search_result_free),
+ *         NULL on invalid arguments or allocation failure
  */
 sgnl_search_result_t* sgnl_search_assets_detailed(sgnl_client_t *client,
                                                   const char *principal_id,
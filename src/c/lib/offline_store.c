@@ -0,0 +1,523 @@
+/*
+ * SGNL Offline Decision Store Implementation
+ *
+ * The file is a fixed header followed by a table of fixed-size slots that is
+ * mapped shared, so every process on the host (PAM, sudo, sgnld) sees the
+ * same decisions. A slot is addressed by the HMAC of its key and probed
+ * linearly over a short window; when the window is full the oldest entry is
+ * replaced. Access is serialized with flock() across processes and a mutex
+ * across threads. The file only ever grows, so a mapping held by another
+ * process never points past the end of it.
+ */
+
+#include "offline_store.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OFFLINE_MAGIC "SGNLOFL1"
+#define OFFLINE_VERSION 1
+
+// Slots examined for one key before the oldest is replaced
+#define OFFLINE_PROBE_WINDOW 8
+
+// An Allow is rewritten at most this often, so hot decisions do not dirty
+// the mapping on every evaluation
+#define OFFLINE_REFRESH_SECONDS 60
+
+// Tolerated clock skew for entries recorded "in the future"
+#define OFFLINE_CLOCK_SKEW_SECONDS 300
+
+#define OFFLINE_MAX_CAPACITY 1000000
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity;
+    uint8_t key_check[32];          // HMAC of a fixed label; detects a different key
+    uint8_t reserved[16];
+} offline_header_t;
+
+typedef struct {
+    uint8_t id[32];                 // HMAC(principal\0asset\0action); all zero when free
+    int64_t stored_at;              // Wall-clock seconds when the Allow was recorded
+    uint8_t tag[32];                // HMAC(id || stored_at)
+} offline_entry_t;
+
+struct sgnl_offline_store {
+    int fd;
+    void *map;
+    size_t map_size;
+    offline_entry_t *entries;
+    uint32_t capacity;
+    int grace_period_seconds;
+    uint8_t key[32];
+    pthread_mutex_t lock;           // Serializes threads; flock() serializes processes
+};
+
+// ============================================================================
+// SHA-256 / HMAC-SHA256 (FIPS 180-4, RFC 2104)
+// ============================================================================
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    size_t block_len;
+} sha256_ctx_t;
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_transform(sha256_ctx_t *ctx, const uint8_t *block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+    uint32_t e = ctx->state[4], f = ctx->state[5], g = ctx->state[6], h = ctx->state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + sha256_k[i] + w[i];
+        uint32_t s0 = ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+}
+
+static void sha256_init(sha256_ctx_t *ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+static void sha256_update(sha256_ctx_t *ctx, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    ctx->length += len;
+    while (len > 0) {
+        size_t take = 64 - ctx->block_len;
+        if (take > len) {
+            take = len;
+        }
+        memcpy(ctx->block + ctx->block_len, p, take);
+        ctx->block_len += take;
+        p += take;
+        len -= take;
+        if (ctx->block_len == 64) {
+            sha256_transform(ctx, ctx->block);
+            ctx->block_len = 0;
+        }
+    }
+}
+
+static void sha256_final(sha256_ctx_t *ctx, uint8_t digest[32]) {
+    uint64_t bits = ctx->length * 8;
+    uint8_t pad = 0x80;
+    sha256_update(ctx, &pad, 1);
+    pad = 0;
+    while (ctx->block_len != 56) {
+        sha256_update(ctx, &pad, 1);
+    }
+    uint8_t length_be[8];
+    for (int i = 0; i < 8; i++) {
+        length_be[i] = (uint8_t)(bits >> (56 - i * 8));
+    }
+    sha256_update(ctx, length_be, 8);
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+typedef struct {
+    sha256_ctx_t inner;
+    uint8_t outer_pad[64];
+} hmac_ctx_t;
+
+static void hmac_init(hmac_ctx_t *ctx, const void *key, size_t key_len) {
+    uint8_t block[64];
+    memset(block, 0, sizeof(block));
+    if (key_len > sizeof(block)) {
+        sha256_ctx_t key_hash;
+        sha256_init(&key_hash);
+        sha256_update(&key_hash, key, key_len);
+        sha256_final(&key_hash, block);
+    } else {
+        memcpy(block, key, key_len);
+    }
+
+    uint8_t inner_pad[64];
+    for (int i = 0; i < 64; i++) {
+        inner_pad[i] = block[i] ^ 0x36;
+        ctx->outer_pad[i] = block[i] ^ 0x5c;
+    }
+    sha256_init(&ctx->inner);
+    sha256_update(&ctx->inner, inner_pad, sizeof(inner_pad));
+}
+
+static void hmac_update(hmac_ctx_t *ctx, const void *data, size_t len) {
+    sha256_update(&ctx->inner, data, len);
+}
+
+static void hmac_final(hmac_ctx_t *ctx, uint8_t mac[32]) {
+    uint8_t inner_digest[32];
+    sha256_final(&ctx->inner, inner_digest);
+
+    sha256_ctx_t outer;
+    sha256_init(&outer);
+    sha256_update(&outer, ctx->outer_pad, sizeof(ctx->outer_pad));
+    sha256_update(&outer, inner_digest, sizeof(inner_digest));
+    sha256_final(&outer, mac);
+}
+
+// ============================================================================
+// Entries
+// ============================================================================
+
+static void entry_id(const sgnl_offline_store_t *store, const char *principal_id,
+                     const char *asset_id, const char *action, uint8_t id[32]) {
+    const char *parts[3] = {principal_id, asset_id ? asset_id : "", action ? action : "execute"};
+    hmac_ctx_t hmac;
+    hmac_init(&hmac, store->key, sizeof(store->key));
+    for (int i = 0; i < 3; i++) {
+        hmac_update(&hmac, parts[i], strlen(parts[i]) + 1);
+    }
+    hmac_final(&hmac, id);
+}
+
+static void entry_tag(const sgnl_offline_store_t *store, const uint8_t id[32], int64_t stored_at,
+                      uint8_t tag[32]) {
+    uint8_t stored_at_le[8];
+    for (int i = 0; i < 8; i++) {
+        stored_at_le[i] = (uint8_t)((uint64_t)stored_at >> (i * 8));
+    }
+    hmac_ctx_t hmac;
+    hmac_init(&hmac, store->key, sizeof(store->key));
+    hmac_update(&hmac, id, 32);
+    hmac_update(&hmac, stored_at_le, sizeof(stored_at_le));
+    hmac_final(&hmac, tag);
+}
+
+static bool digest_equal(const uint8_t *a, const uint8_t *b) {
+    uint8_t diff = 0;
+    for (int i = 0; i < 32; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+static bool entry_is_free(const offline_entry_t *entry) {
+    static const uint8_t zero[32];
+    return memcmp(entry->id, zero, sizeof(zero)) == 0;
+}
+
+static bool entry_authentic(const sgnl_offline_store_t *store, const offline_entry_t *entry) {
+    uint8_t tag[32];
+    entry_tag(store, entry->id, entry->stored_at, tag);
+    return digest_equal(tag, entry->tag);
+}
+
+static bool entry_live(const sgnl_offline_store_t *store, const offline_entry_t *entry, int64_t now) {
+    return entry->stored_at <= now + OFFLINE_CLOCK_SKEW_SECONDS &&
+           now - entry->stored_at <= store->grace_period_seconds;
+}
+
+static uint32_t entry_home(const sgnl_offline_store_t *store, const uint8_t id[32]) {
+    uint64_t h = 0;
+    for (int i = 0; i < 8; i++) {
+        h = (h << 8) | id[i];
+    }
+    return (uint32_t)(h % store->capacity);
+}
+
+// Find the slot holding id within its probe window, or -1
+static long entry_find(const sgnl_offline_store_t *store, const uint8_t id[32]) {
+    uint32_t slot = entry_home(store, id);
+    for (int i = 0; i < OFFLINE_PROBE_WINDOW; i++) {
+        if (memcmp(store->entries[slot].id, id, 32) == 0) {
+            return (long)slot;
+        }
+        slot = (slot + 1) % store->capacity;
+    }
+    return -1;
+}
+
+// Slot to write a new entry for id: a free, forged or expired slot if the
+// window has one, otherwise the oldest entry
+static uint32_t entry_victim(const sgnl_offline_store_t *store, const uint8_t id[32], int64_t now) {
+    uint32_t slot = entry_home(store, id);
+    uint32_t oldest = slot;
+    for (int i = 0; i < OFFLINE_PROBE_WINDOW; i++) {
+        const offline_entry_t *entry = &store->entries[slot];
+        if (entry_is_free(entry) || !entry_live(store, entry, now) || !entry_authentic(store, entry)) {
+            return slot;
+        }
+        if (entry->stored_at < store->entries[oldest].stored_at) {
+            oldest = slot;
+        }
+        slot = (slot + 1) % store->capacity;
+    }
+    return oldest;
+}
+
+// ============================================================================
+// File
+// ============================================================================
+
+static void derive_key(const char *secret, uint8_t key[32]) {
+    static const char label[] = "sgnl-offline-store-v1";
+    hmac_ctx_t hmac;
+    hmac_init(&hmac, secret, strlen(secret));
+    hmac_update(&hmac, label, sizeof(label));
+    hmac_final(&hmac, key);
+}
+
+static void key_check(const uint8_t key[32], uint8_t check[32]) {
+    static const char label[] = "key-check";
+    hmac_ctx_t hmac;
+    hmac_init(&hmac, key, 32);
+    hmac_update(&hmac, label, sizeof(label));
+    hmac_final(&hmac, check);
+}
+
+static size_t store_file_size(uint32_t capacity) {
+    return sizeof(offline_header_t) + (size_t)capacity * sizeof(offline_entry_t);
+}
+
+// Create the parent directory of path if it does not exist yet
+static void ensure_parent_directory(const char *path) {
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+    if (!slash || slash == path || (size_t)(slash - path) >= sizeof(dir)) {
+        return;
+    }
+    memcpy(dir, path, (size_t)(slash - path));
+    dir[slash - path] = '\0';
+
+    // EEXIST is the common case; any real problem surfaces when opening the file
+    (void)mkdir(dir, 0700);
+}
+
+// Called with an exclusive flock held. Adopts a valid existing table or
+// lays out a new one of max_entries slots.
+static bool store_map(sgnl_offline_store_t *store, size_t max_entries) {
+    struct stat st;
+    if (fstat(store->fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid()) {
+        return false;
+    }
+
+    uint8_t expected_check[32];
+    key_check(store->key, expected_check);
+
+    offline_header_t header;
+    bool valid = st.st_size >= (off_t)sizeof(header) &&
+                 pread(store->fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+                 memcmp(header.magic, OFFLINE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == OFFLINE_VERSION &&
+                 header.capacity > 0 && header.capacity <= OFFLINE_MAX_CAPACITY &&
+                 st.st_size >= (off_t)store_file_size(header.capacity) &&
+                 digest_equal(header.key_check, expected_check);
+
+    uint32_t capacity = valid ? header.capacity : (uint32_t)max_entries;
+    size_t size = store_file_size(capacity);
+    if (!valid && st.st_size < (off_t)size && ftruncate(store->fd, (off_t)size) != 0) {
+        return false;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, store->fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    store->map = map;
+    store->map_size = size;
+    store->capacity = capacity;
+    store->entries = (offline_entry_t *)((char *)map + sizeof(offline_header_t));
+
+    if (!valid) {
+        memset(map, 0, size);
+        offline_header_t *fresh = (offline_header_t *)map;
+        memcpy(fresh->magic, OFFLINE_MAGIC, sizeof(fresh->magic));
+        fresh->version = OFFLINE_VERSION;
+        fresh->capacity = capacity;
+        memcpy(fresh->key_check, expected_check, sizeof(expected_check));
+    }
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+sgnl_offline_store_t* sgnl_offline_store_open(const char *path,
+                                              size_t max_entries,
+                                              int grace_period_seconds,
+                                              const char *secret) {
+    if (!path || !*path || !secret || !*secret || max_entries == 0 ||
+        max_entries > OFFLINE_MAX_CAPACITY || grace_period_seconds <= 0) {
+        return NULL;
+    }
+
+    sgnl_offline_store_t *store = calloc(1, sizeof(sgnl_offline_store_t));
+    if (!store) {
+        return NULL;
+    }
+    store->grace_period_seconds = grace_period_seconds;
+    derive_key(secret, store->key);
+
+    ensure_parent_directory(path);
+    store->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (store->fd < 0) {
+        memset(store->key, 0, sizeof(store->key));
+        free(store);
+        return NULL;
+    }
+
+    bool mapped = false;
+    if (flock(store->fd, LOCK_EX) == 0) {
+        mapped = store_map(store, max_entries);
+        flock(store->fd, LOCK_UN);
+    }
+    if (!mapped) {
+        close(store->fd);
+        memset(store->key, 0, sizeof(store->key));
+        free(store);
+        return NULL;
+    }
+
+    pthread_mutex_init(&store->lock, NULL);
+    return store;
+}
+
+void sgnl_offline_store_close(sgnl_offline_store_t *store) {
+    if (!store) {
+        return;
+    }
+    munmap(store->map, store->map_size);
+    close(store->fd);
+    pthread_mutex_destroy(&store->lock);
+    memset(store->key, 0, sizeof(store->key));
+    free(store);
+}
+
+bool sgnl_offline_store_lookup(sgnl_offline_store_t *store,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               int64_t *age_seconds) {
+    if (!store || !principal_id) {
+        return false;
+    }
+
+    uint8_t id[32];
+    entry_id(store, principal_id, asset_id, action, id);
+
+    // Copy the entry out so it is verified as one consistent snapshot
+    offline_entry_t entry;
+    bool found = false;
+    pthread_mutex_lock(&store->lock);
+    if (flock(store->fd, LOCK_SH) == 0) {
+        long slot = entry_find(store, id);
+        if (slot >= 0) {
+            entry = store->entries[slot];
+            found = true;
+        }
+        flock(store->fd, LOCK_UN);
+    }
+    pthread_mutex_unlock(&store->lock);
+
+    int64_t now = (int64_t)time(NULL);
+    if (!found || !entry_authentic(store, &entry) || !entry_live(store, &entry, now)) {
+        return false;
+    }
+
+    if (age_seconds) {
+        *age_seconds = now > entry.stored_at ? now - entry.stored_at : 0;
+    }
+    return true;
+}
+
+void sgnl_offline_store_record(sgnl_offline_store_t *store,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               sgnl_result_t result) {
+    if (!store || !principal_id || (result != SGNL_ALLOWED && result != SGNL_DENIED)) {
+        return;
+    }
+
+    uint8_t id[32];
+    entry_id(store, principal_id, asset_id, action, id);
+    int64_t now = (int64_t)time(NULL);
+
+    // Computed outside the locks; only the write happens under them
+    offline_entry_t fresh;
+    memcpy(fresh.id, id, sizeof(fresh.id));
+    fresh.stored_at = now;
+    entry_tag(store, id, now, fresh.tag);
+
+    pthread_mutex_lock(&store->lock);
+    if (flock(store->fd, LOCK_EX) == 0) {
+        long slot = entry_find(store, id);
+        if (result == SGNL_DENIED) {
+            if (slot >= 0) {
+                memset(&store->entries[slot], 0, sizeof(offline_entry_t));
+            }
+        } else if (slot >= 0) {
+            offline_entry_t *entry = &store->entries[slot];
+            if (now - entry->stored_at >= OFFLINE_REFRESH_SECONDS || entry->stored_at > now ||
+                !entry_authentic(store, entry)) {
+                *entry = fresh;
+            }
+        } else {
+            store->entries[entry_victim(store, id, now)] = fresh;
+        }
+        flock(store->fd, LOCK_UN);
+    }
+    pthread_mutex_unlock(&store->lock);
+}
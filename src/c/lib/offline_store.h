@@ -0,0 +1,66 @@
+/*
+ * SGNL Offline Decision Store
+ *
+ * Persistent, memory-mapped record of recent Allow decisions keyed by
+ * (principal, asset, action). While the SGNL API is unreachable, an Allow
+ * recorded within the grace period can be served instead of failing closed.
+ *
+ * Entries carry an HMAC-SHA256 tag under a key derived from the client's API
+ * token, so a store written by anyone without the token (or under a rotated
+ * token) is never trusted. Denials are not stored: a Deny removes the entry.
+ * Internal to libsgnl; enabled through the "offline_mode" config block.
+ */
+
+#ifndef SGNL_OFFLINE_STORE_H
+#define SGNL_OFFLINE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "libsgnl.h"
+
+typedef struct sgnl_offline_store sgnl_offline_store_t;
+
+/**
+ * Open (creating if needed) an offline store
+ *
+ * The file is created mode 0600 and must be a regular file owned by the
+ * calling user. A file that is corrupt, was written under another key or has
+ * a different version is reinitialized empty.
+ *
+ * @param path Store file; its parent directory is created (0700) if missing
+ * @param max_entries Number of slots when the store is created
+ * @param grace_period_seconds How long after it was recorded an Allow may be served
+ * @param secret Key material (the API token); only a derived key is kept
+ * @return Store or NULL if it cannot be opened or mapped
+ */
+sgnl_offline_store_t* sgnl_offline_store_open(const char *path,
+                                              size_t max_entries,
+                                              int grace_period_seconds,
+                                              const char *secret);
+
+void sgnl_offline_store_close(sgnl_offline_store_t *store);
+
+/**
+ * Look for an Allow recorded within the grace period
+ *
+ * @param age_seconds Optional output: seconds since the decision was recorded
+ * @return true if an authentic, unexpired Allow is present
+ */
+bool sgnl_offline_store_lookup(sgnl_offline_store_t *store,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               int64_t *age_seconds);
+
+/**
+ * Record a fresh decision: SGNL_ALLOWED stores (or refreshes) the entry,
+ * SGNL_DENIED removes it, anything else is ignored. NULL store is a no-op.
+ */
+void sgnl_offline_store_record(sgnl_offline_store_t *store,
+                               const char *principal_id,
+                               const char *asset_id,
+                               const char *action,
+                               sgnl_result_t result);
+
+#endif /* SGNL_OFFLINE_STORE_H */
@@ -0,0 +1,253 @@
+/*
+ * SGNL Query Set Implementation
+ *
+ * Asset IDs live in one string arena and are referenced by offset, so a set
+ * of thousands of glob-expanded paths costs a handful of allocations.
+ * Actions are few (typically "sudo" and "sudo:<command>") and are interned
+ * in a small array searched linearly. Distinct queries are found through an
+ * open-addressed table keyed on (asset, action).
+ */
+
+#include "query_set.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QUERY_SET_INITIAL_SLOTS 64
+#define QUERY_SET_INITIAL_ARENA 1024
+
+typedef struct {
+    uint32_t asset;                 // Arena offset + 1; 0 for a NULL asset
+    uint32_t action;                // Index into actions
+    uint32_t hash;
+} unique_query_t;
+
+struct sgnl_query_set {
+    char *arena;                    // asset\0asset\0...
+    size_t arena_len;
+    size_t arena_cap;
+
+    char **actions;                 // Interned action strings
+    int action_count;
+    int action_cap;
+
+    unique_query_t *unique;         // Distinct queries in first-added order
+    int unique_count;
+    int unique_cap;
+
+    uint32_t *slots;                // Index into unique + 1; 0 marks a free slot
+    size_t slot_count;              // Power of two, at least twice unique_count
+
+    int *query_map;                 // Added query -> index into unique
+    int query_count;
+    int query_cap;
+};
+
+// FNV-1a over the asset followed by the action index
+static uint32_t hash_query(const char *asset_id, uint32_t action) {
+    uint32_t hash = 2166136261u;
+    if (asset_id) {
+        for (const unsigned char *p = (const unsigned char *)asset_id; *p; p++) {
+            hash ^= *p;
+            hash *= 16777619u;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        hash ^= (action >> (i * 8)) & 0xff;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool grow_array(void **array, int *cap, size_t element_size, int initial) {
+    int new_cap = *cap ? *cap * 2 : initial;
+    void *grown = realloc(*array, (size_t)new_cap * element_size);
+    if (!grown) {
+        return false;
+    }
+    *array = grown;
+    *cap = new_cap;
+    return true;
+}
+
+static const char* unique_asset(const sgnl_query_set_t *set, const unique_query_t *query) {
+    return query->asset ? set->arena + query->asset - 1 : NULL;
+}
+
+// Index of an interned action, interning it if new; -1 on allocation failure
+static int intern_action(sgnl_query_set_t *set, const char *action) {
+    for (int i = 0; i < set->action_count; i++) {
+        if (strcmp(set->actions[i], action) == 0) {
+            return i;
+        }
+    }
+
+    if (set->action_count == set->action_cap &&
+        !grow_array((void **)&set->actions, &set->action_cap, sizeof(char *), 4)) {
+        return -1;
+    }
+    char *copy = strdup(action);
+    if (!copy) {
+        return -1;
+    }
+    set->actions[set->action_count] = copy;
+    return set->action_count++;
+}
+
+// Slot holding the query, or the free slot where it would go
+static size_t probe(const sgnl_query_set_t *set, const char *asset_id, uint32_t action, uint32_t hash) {
+    size_t mask = set->slot_count - 1;
+    size_t slot = hash & mask;
+    while (set->slots[slot] != 0) {
+        const unique_query_t *query = &set->unique[set->slots[slot] - 1];
+        if (query->hash == hash && query->action == action) {
+            const char *asset = unique_asset(set, query);
+            if (asset == asset_id || (asset && asset_id && strcmp(asset, asset_id) == 0)) {
+                break;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool grow_slots(sgnl_query_set_t *set) {
+    size_t new_count = set->slot_count * 2;
+    uint32_t *slots = calloc(new_count, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+    for (int i = 0; i < set->unique_count; i++) {
+        size_t slot = set->unique[i].hash & (new_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (new_count - 1);
+        }
+        slots[slot] = (uint32_t)i + 1;
+    }
+    free(set->slots);
+    set->slots = slots;
+    set->slot_count = new_count;
+    return true;
+}
+
+// Copy an asset ID into the arena; returns its offset + 1, or 0 on failure
+static uint32_t arena_add(sgnl_query_set_t *set, const char *asset_id) {
+    size_t len = strlen(asset_id) + 1;
+    if (set->arena_len + len >= UINT32_MAX) {
+        return 0;
+    }
+    if (set->arena_len + len > set->arena_cap) {
+        size_t new_cap = set->arena_cap;
+        while (new_cap < set->arena_len + len) {
+            new_cap *= 2;
+        }
+        char *arena = realloc(set->arena, new_cap);
+        if (!arena) {
+            return 0;
+        }
+        set->arena = arena;
+        set->arena_cap = new_cap;
+    }
+    memcpy(set->arena + set->arena_len, asset_id, len);
+    uint32_t offset = (uint32_t)set->arena_len + 1;
+    set->arena_len += len;
+    return offset;
+}
+
+sgnl_query_set_t* sgnl_query_set_create(void) {
+    sgnl_query_set_t *set = calloc(1, sizeof(sgnl_query_set_t));
+    if (!set) {
+        return NULL;
+    }
+    set->slot_count = QUERY_SET_INITIAL_SLOTS;
+    set->slots = calloc(set->slot_count, sizeof(uint32_t));
+    set->arena_cap = QUERY_SET_INITIAL_ARENA;
+    set->arena = malloc(set->arena_cap);
+    if (!set->slots || !set->arena) {
+        sgnl_query_set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void sgnl_query_set_free(sgnl_query_set_t *set) {
+    if (!set) {
+        return;
+    }
+    for (int i = 0; i < set->action_count; i++) {
+        free(set->actions[i]);
+    }
+    free(set->actions);
+    free(set->arena);
+    free(set->unique);
+    free(set->slots);
+    free(set->query_map);
+    free(set);
+}
+
+int sgnl_query_set_add(sgnl_query_set_t *set, const char *asset_id, const char *action) {
+    if (!set) {
+        return -1;
+    }
+    if (set->query_count == set->query_cap &&
+        !grow_array((void **)&set->query_map, &set->query_cap, sizeof(int), 16)) {
+        return -1;
+    }
+
+    int action_index = intern_action(set, action ? action : "execute");
+    if (action_index < 0) {
+        return -1;
+    }
+    uint32_t hash = hash_query(asset_id, (uint32_t)action_index);
+    size_t slot = probe(set, asset_id, (uint32_t)action_index, hash);
+
+    if (set->slots[slot] == 0) {
+        if (set->unique_count == set->unique_cap &&
+            !grow_array((void **)&set->unique, &set->unique_cap, sizeof(unique_query_t), 16)) {
+            return -1;
+        }
+        uint32_t asset = 0;
+        if (asset_id && (asset = arena_add(set, asset_id)) == 0) {
+            return -1;
+        }
+
+        // Keep the table at most half full so probe runs stay short
+        if ((size_t)(set->unique_count + 1) * 2 > set->slot_count) {
+            if (!grow_slots(set)) {
+                return -1;
+            }
+            slot = probe(set, asset_id, (uint32_t)action_index, hash);
+        }
+
+        unique_query_t *query = &set->unique[set->unique_count];
+        query->asset = asset;
+        query->action = (uint32_t)action_index;
+        query->hash = hash;
+        set->slots[slot] = (uint32_t)++set->unique_count;
+    }
+
+    set->query_map[set->query_count] = (int)set->slots[slot] - 1;
+    return set->query_count++;
+}
+
+int sgnl_query_set_count(const sgnl_query_set_t *set) {
+    return set ? set->query_count : 0;
+}
+
+int sgnl_query_set_unique_count(const sgnl_query_set_t *set) {
+    return set ? set->unique_count : 0;
+}
+
+int sgnl_query_set_result_index(const sgnl_query_set_t *set, int index) {
+    if (!set || index < 0 || index >= set->query_count) {
+        return -1;
+    }
+    return set->query_map[index];
+}
+
+void sgnl_query_set_unique_queries(const sgnl_query_set_t *set, const char **asset_ids, const char **actions) {
+    for (int i = 0; set && i < set->unique_count; i++) {
+        asset_ids[i] = unique_asset(set, &set->unique[i]);
+        actions[i] = set->actions[set->unique[i].action];
+    }
+}
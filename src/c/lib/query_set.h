@@ -0,0 +1,24 @@
+/*
+ * SGNL Query Set
+ *
+ * Builder behind the public sgnl_query_set_* API (see libsgnl.h): interns
+ * action strings, folds duplicate (asset, action) pairs and remembers which
+ * distinct query each added query maps to. Internal to libsgnl.
+ */
+
+#ifndef SGNL_QUERY_SET_H
+#define SGNL_QUERY_SET_H
+
+#include "libsgnl.h"
+
+/**
+ * Fill parallel arrays with the distinct queries, in first-added order
+ *
+ * The pointers stay valid until the set is modified or freed.
+ *
+ * @param asset_ids Array of sgnl_query_set_unique_count entries
+ * @param actions Array of sgnl_query_set_unique_count entries
+ */
+void sgnl_query_set_unique_queries(const sgnl_query_set_t *set, const char **asset_ids, const char **actions);
+
+#endif /* SGNL_QUERY_SET_H */
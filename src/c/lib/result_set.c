@@ -0,0 +1,222 @@
+/*
+ * SGNL Result Set Implementation
+ *
+ * Every string of a set (principal, request ID, assets, actions, reasons)
+ * lives in one arena and results refer to it by offset, so a result costs
+ * 16 bytes plus whatever text it actually carries. Offset 0 is the empty
+ * string. Consecutive queries usually share an action, and decisions often
+ * share a reason, so a string equal to the previous one is stored once.
+ */
+
+#include "result_set.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RESULT_SET_REASON_RESERVE 256
+
+typedef struct {
+    uint32_t asset;                 // Arena offsets
+    uint32_t action;
+    uint32_t reason;
+    int8_t result;                  // sgnl_result_t
+    bool filled;
+} compact_result_t;
+
+struct sgnl_result_set {
+    char *arena;                    // \0principal\0request\0asset\0action\0...
+    size_t arena_len;
+    size_t arena_cap;
+    uint32_t principal_id;
+    uint32_t request_id;
+    uint32_t last_reason;           // Most recently stored reason
+    int64_t timestamp;
+    compact_result_t *results;
+    int count;
+    pthread_mutex_t lock;           // Guards the arena while results are filled
+};
+
+// Copy a string into the arena; returns its offset, or 0 on failure
+static uint32_t arena_add(sgnl_result_set_t *set, const char *text) {
+    size_t len = strlen(text) + 1;
+    if (set->arena_len + len >= UINT32_MAX) {
+        return 0;
+    }
+    if (set->arena_len + len > set->arena_cap) {
+        size_t new_cap = set->arena_cap;
+        while (new_cap < set->arena_len + len) {
+            new_cap *= 2;
+        }
+        char *arena = realloc(set->arena, new_cap);
+        if (!arena) {
+            return 0;
+        }
+        set->arena = arena;
+        set->arena_cap = new_cap;
+    }
+    memcpy(set->arena + set->arena_len, text, len);
+    uint32_t offset = (uint32_t)set->arena_len;
+    set->arena_len += len;
+    return offset;
+}
+
+// Offset of text, reusing previous when it holds the same string
+static bool arena_intern(sgnl_result_set_t *set, const char *text, uint32_t previous, uint32_t *offset) {
+    if (!text || !text[0]) {
+        *offset = 0;
+        return true;
+    }
+    if (previous && strcmp(set->arena + previous, text) == 0) {
+        *offset = previous;
+        return true;
+    }
+    *offset = arena_add(set, text);
+    return *offset != 0;
+}
+
+sgnl_result_set_t* sgnl_result_set_create(const char *principal_id, const char *request_id,
+                                          const char **asset_ids, const char **actions, int count) {
+    if (!principal_id || !request_id || !asset_ids || count <= 0) {
+        return NULL;
+    }
+
+    sgnl_result_set_t *set = calloc(1, sizeof(sgnl_result_set_t));
+    if (!set) {
+        return NULL;
+    }
+
+    // Size the arena for the queries up front; only reasons grow it later
+    size_t needed = 1 + strlen(principal_id) + 1 + strlen(request_id) + 1 + RESULT_SET_REASON_RESERVE;
+    for (int i = 0; i < count; i++) {
+        needed += (asset_ids[i] ? strlen(asset_ids[i]) + 1 : 0);
+        if (actions && (i == 0 || strcmp(actions[i], actions[i - 1]) != 0)) {
+            needed += strlen(actions[i]) + 1;
+        }
+    }
+    set->arena_cap = needed;
+    set->arena = malloc(set->arena_cap);
+    set->results = calloc(count, sizeof(compact_result_t));
+    if (!set->arena || !set->results) {
+        free(set->arena);
+        free(set->results);
+        free(set);
+        return NULL;
+    }
+    set->arena[0] = '\0';
+    set->arena_len = 1;
+    set->count = count;
+    set->timestamp = time(NULL);
+    pthread_mutex_init(&set->lock, NULL);
+
+    bool ok = arena_intern(set, principal_id, 0, &set->principal_id) &&
+              arena_intern(set, request_id, 0, &set->request_id);
+    uint32_t action = 0;
+    for (int i = 0; ok && i < count; i++) {
+        compact_result_t *result = &set->results[i];
+        result->result = SGNL_ERROR;
+        ok = arena_intern(set, asset_ids[i], 0, &result->asset) &&
+             arena_intern(set, actions ? actions[i] : "execute", action, &action);
+        result->action = action;
+    }
+    if (!ok) {
+        sgnl_result_set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+void sgnl_result_set_free(sgnl_result_set_t *set) {
+    if (!set) {
+        return;
+    }
+    pthread_mutex_destroy(&set->lock);
+    free(set->arena);
+    free(set->results);
+    free(set);
+}
+
+bool sgnl_result_set_fill(sgnl_result_set_t *set, int index, sgnl_result_t result, const char *reason) {
+    if (!set || index < 0 || index >= set->count) {
+        return false;
+    }
+
+    pthread_mutex_lock(&set->lock);
+    uint32_t offset;
+    bool ok = arena_intern(set, reason, set->last_reason, &offset);
+    if (ok) {
+        if (offset) {
+            set->last_reason = offset;
+        }
+        set->results[index].reason = offset;
+        set->results[index].result = (int8_t)result;
+        set->results[index].filled = true;
+    }
+    pthread_mutex_unlock(&set->lock);
+    return ok;
+}
+
+bool sgnl_result_set_filled(const sgnl_result_set_t *set, int index) {
+    return set && index >= 0 && index < set->count && set->results[index].filled;
+}
+
+void sgnl_result_set_clear(sgnl_result_set_t *set, int first, int count) {
+    for (int i = first; set && i < first + count && i < set->count; i++) {
+        set->results[i].result = SGNL_ERROR;
+        set->results[i].reason = 0;
+        set->results[i].filled = false;
+    }
+}
+
+int sgnl_result_set_count(const sgnl_result_set_t *set) {
+    return set ? set->count : 0;
+}
+
+sgnl_result_t sgnl_result_set_result(const sgnl_result_set_t *set, int index) {
+    if (!set || index < 0 || index >= set->count) {
+        return SGNL_INVALID_REQUEST;
+    }
+    return (sgnl_result_t)set->results[index].result;
+}
+
+const char* sgnl_result_set_decision(const sgnl_result_set_t *set, int index) {
+    switch (sgnl_result_set_result(set, index)) {
+        case SGNL_ALLOWED: return "Allow";
+        case SGNL_DENIED:  return "Deny";
+        default:           return "";
+    }
+}
+
+const char* sgnl_result_set_reason(const sgnl_result_set_t *set, int index) {
+    if (!set || index < 0 || index >= set->count) {
+        return "";
+    }
+    return set->arena + set->results[index].reason;
+}
+
+const char* sgnl_result_set_asset_id(const sgnl_result_set_t *set, int index) {
+    if (!set || index < 0 || index >= set->count) {
+        return "";
+    }
+    return set->arena + set->results[index].asset;
+}
+
+const char* sgnl_result_set_action(const sgnl_result_set_t *set, int index) {
+    if (!set || index < 0 || index >= set->count) {
+        return "";
+    }
+    return set->arena + set->results[index].action;
+}
+
+const char* sgnl_result_set_principal_id(const sgnl_result_set_t *set) {
+    return set ? set->arena + set->principal_id : "";
+}
+
+const char* sgnl_result_set_request_id(const sgnl_result_set_t *set) {
+    return set ? set->arena + set->request_id : "";
+}
+
+int64_t sgnl_result_set_timestamp(const sgnl_result_set_t *set) {
+    return set ? set->timestamp : 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * SGNL Result Set
+ *
+ * Builder behind the public sgnl_result_set_* API (see libsgnl.h). Batch
+ * evaluation creates a set holding the queries, then fills in each
+ * decision as it is parsed. Internal to libsgnl.
+ */
+
+#ifndef SGNL_RESULT_SET_H
+#define SGNL_RESULT_SET_H
+
+#include <stdbool.h>
+#include "libsgnl.h"
+
+/**
+ * Create a set of count unfilled results for the given queries
+ *
+ * @param asset_ids Array of count asset IDs (entries may be NULL)
+ * @param actions Array of count actions (or NULL for all "execute")
+ * @return Set or NULL on allocation failure
+ */
+sgnl_result_set_t* sgnl_result_set_create(const char *principal_id, const char *request_id,
+                                          const char **asset_ids, const char **actions, int count);
+
+/**
+ * Record the outcome of one query
+ *
+ * Safe to call from several threads for different indexes.
+ *
+ * @param reason Reason text (NULL = none)
+ * @return false on allocation failure (the result stays unfilled)
+ */
+bool sgnl_result_set_fill(sgnl_result_set_t *set, int index, sgnl_result_t result, const char *reason);
+
+bool sgnl_result_set_filled(const sgnl_result_set_t *set, int index);
+
+/**
+ * Mark count results starting at first as unfilled again
+ */
+void sgnl_result_set_clear(sgnl_result_set_t *set, int first, int count);
+
+#endif /* SGNL_RESULT_SET_H */
@@ -0,0 +1,368 @@
+/*
+ * SGNL Entitlement Snapshot Implementation
+ *
+ * Each principal's set is built off to the side by the refresher and
+ * swapped in whole under a write lock, so readers (every evaluation) only
+ * ever take the read lock and never see a half-filled set. Principals are
+ * few (active users on one host), so they are kept in a flat array.
+ */
+
+#include "snapshot.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ASSET_SET_INITIAL_SLOTS 64
+#define ASSET_SET_INITIAL_ARENA 1024
+
+struct sgnl_asset_set {
+    char *arena;                    // asset\0asset\0...
+    size_t arena_len;
+    size_t arena_cap;
+    uint32_t *slots;                // Arena offset + 1; 0 marks a free slot
+    uint32_t *hashes;               // Hash of the asset in the same slot
+    size_t slot_count;              // Power of two, at least twice count
+    size_t count;
+};
+
+typedef struct {
+    char *principal_id;
+    sgnl_asset_set_t *set;
+    int64_t refreshed_at;           // Monotonic seconds
+} snapshot_entry_t;
+
+struct sgnl_snapshot {
+    char action[64];
+    size_t max_principals;
+    int max_age_seconds;
+    snapshot_entry_t *entries;
+    size_t count;
+    pthread_rwlock_t lock;          // Guards entries and count
+};
+
+static int64_t monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec;
+}
+
+// FNV-1a
+static uint32_t hash_asset(const char *asset_id) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)asset_id; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ============================================================================
+// Asset set
+// ============================================================================
+
+// Slot holding asset_id, or the free slot where it would go
+static size_t asset_set_probe(const sgnl_asset_set_t *set, const char *asset_id, uint32_t hash) {
+    size_t mask = set->slot_count - 1;
+    size_t slot = hash & mask;
+    while (set->slots[slot] != 0) {
+        if (set->hashes[slot] == hash && strcmp(set->arena + set->slots[slot] - 1, asset_id) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool asset_set_grow_slots(sgnl_asset_set_t *set) {
+    size_t new_count = set->slot_count * 2;
+    uint32_t *slots = calloc(new_count, sizeof(uint32_t));
+    uint32_t *hashes = calloc(new_count, sizeof(uint32_t));
+    if (!slots || !hashes) {
+        free(slots);
+        free(hashes);
+        return false;
+    }
+
+    for (size_t i = 0; i < set->slot_count; i++) {
+        if (set->slots[i] == 0) {
+            continue;
+        }
+        size_t slot = set->hashes[i] & (new_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (new_count - 1);
+        }
+        slots[slot] = set->slots[i];
+        hashes[slot] = set->hashes[i];
+    }
+
+    free(set->slots);
+    free(set->hashes);
+    set->slots = slots;
+    set->hashes = hashes;
+    set->slot_count = new_count;
+    return true;
+}
+
+sgnl_asset_set_t* sgnl_asset_set_create(void) {
+    sgnl_asset_set_t *set = calloc(1, sizeof(sgnl_asset_set_t));
+    if (!set) {
+        return NULL;
+    }
+    set->slot_count = ASSET_SET_INITIAL_SLOTS;
+    set->slots = calloc(set->slot_count, sizeof(uint32_t));
+    set->hashes = calloc(set->slot_count, sizeof(uint32_t));
+    set->arena_cap = ASSET_SET_INITIAL_ARENA;
+    set->arena = malloc(set->arena_cap);
+    if (!set->slots || !set->hashes || !set->arena) {
+        sgnl_asset_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+void sgnl_asset_set_destroy(sgnl_asset_set_t *set) {
+    if (!set) {
+        return;
+    }
+    free(set->arena);
+    free(set->slots);
+    free(set->hashes);
+    free(set);
+}
+
+bool sgnl_asset_set_add(sgnl_asset_set_t *set, const char *asset_id) {
+    if (!set || !asset_id) {
+        return false;
+    }
+
+    uint32_t hash = hash_asset(asset_id);
+    size_t slot = asset_set_probe(set, asset_id, hash);
+    if (set->slots[slot] != 0) {
+        return true;
+    }
+
+    size_t len = strlen(asset_id) + 1;
+    if (set->arena_len + len >= UINT32_MAX) {
+        return false;
+    }
+    if (set->arena_len + len > set->arena_cap) {
+        size_t new_cap = set->arena_cap;
+        while (new_cap < set->arena_len + len) {
+            new_cap *= 2;
+        }
+        char *arena = realloc(set->arena, new_cap);
+        if (!arena) {
+            return false;
+        }
+        set->arena = arena;
+        set->arena_cap = new_cap;
+    }
+
+    // Keep the table at most half full so probe runs stay short
+    if ((set->count + 1) * 2 > set->slot_count) {
+        if (!asset_set_grow_slots(set)) {
+            return false;
+        }
+        slot = asset_set_probe(set, asset_id, hash);
+    }
+
+    memcpy(set->arena + set->arena_len, asset_id, len);
+    set->slots[slot] = (uint32_t)set->arena_len + 1;
+    set->hashes[slot] = hash;
+    set->arena_len += len;
+    set->count++;
+    return true;
+}
+
+bool sgnl_asset_set_contains(const sgnl_asset_set_t *set, const char *asset_id) {
+    if (!set || !asset_id) {
+        return false;
+    }
+    return set->slots[asset_set_probe(set, asset_id, hash_asset(asset_id))] != 0;
+}
+
+size_t sgnl_asset_set_count(const sgnl_asset_set_t *set) {
+    return set ? set->count : 0;
+}
+
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+sgnl_snapshot_t* sgnl_snapshot_create(const char *action, size_t max_principals, int max_age_seconds) {
+    if (!action || max_principals == 0 || max_age_seconds <= 0) {
+        return NULL;
+    }
+
+    sgnl_snapshot_t *snapshot = calloc(1, sizeof(sgnl_snapshot_t));
+    if (!snapshot) {
+        return NULL;
+    }
+    snapshot->entries = calloc(max_principals, sizeof(snapshot_entry_t));
+    if (!snapshot->entries) {
+        free(snapshot);
+        return NULL;
+    }
+
+    strncpy(snapshot->action, action, sizeof(snapshot->action) - 1);
+    snapshot->action[sizeof(snapshot->action) - 1] = '\0';
+    snapshot->max_principals = max_principals;
+    snapshot->max_age_seconds = max_age_seconds;
+    pthread_rwlock_init(&snapshot->lock, NULL);
+    return snapshot;
+}
+
+static void entry_clear(snapshot_entry_t *entry) {
+    free(entry->principal_id);
+    sgnl_asset_set_destroy(entry->set);
+    memset(entry, 0, sizeof(*entry));
+}
+
+void sgnl_snapshot_destroy(sgnl_snapshot_t *snapshot) {
+    if (!snapshot) {
+        return;
+    }
+    for (size_t i = 0; i < snapshot->count; i++) {
+        entry_clear(&snapshot->entries[i]);
+    }
+    free(snapshot->entries);
+    pthread_rwlock_destroy(&snapshot->lock);
+    free(snapshot);
+}
+
+const char* sgnl_snapshot_action(const sgnl_snapshot_t *snapshot) {
+    return snapshot ? snapshot->action : NULL;
+}
+
+// Called with the lock held
+static snapshot_entry_t* snapshot_find(sgnl_snapshot_t *snapshot, const char *principal_id) {
+    for (size_t i = 0; i < snapshot->count; i++) {
+        if (strcmp(snapshot->entries[i].principal_id, principal_id) == 0) {
+            return &snapshot->entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Called with the write lock held; moves the last entry into the hole
+static void snapshot_remove_at(sgnl_snapshot_t *snapshot, size_t index) {
+    entry_clear(&snapshot->entries[index]);
+    snapshot->count--;
+    if (index != snapshot->count) {
+        snapshot->entries[index] = snapshot->entries[snapshot->count];
+        memset(&snapshot->entries[snapshot->count], 0, sizeof(snapshot_entry_t));
+    }
+}
+
+bool sgnl_snapshot_replace(sgnl_snapshot_t *snapshot, const char *principal_id, sgnl_asset_set_t *set) {
+    if (!snapshot || !principal_id || !set) {
+        sgnl_asset_set_destroy(set);
+        return false;
+    }
+
+    char *principal_copy = strdup(principal_id);
+    if (!principal_copy) {
+        sgnl_asset_set_destroy(set);
+        return false;
+    }
+
+    sgnl_asset_set_t *old_set = NULL;
+    pthread_rwlock_wrlock(&snapshot->lock);
+    snapshot_entry_t *entry = snapshot_find(snapshot, principal_id);
+    if (entry) {
+        old_set = entry->set;
+        free(principal_copy);
+    } else {
+        // Full: the least recently refreshed principal makes room
+        if (snapshot->count == snapshot->max_principals) {
+            size_t stalest = 0;
+            for (size_t i = 1; i < snapshot->count; i++) {
+                if (snapshot->entries[i].refreshed_at < snapshot->entries[stalest].refreshed_at) {
+                    stalest = i;
+                }
+            }
+            snapshot_remove_at(snapshot, stalest);
+        }
+        entry = &snapshot->entries[snapshot->count++];
+        entry->principal_id = principal_copy;
+    }
+    entry->set = set;
+    entry->refreshed_at = monotonic_seconds();
+    pthread_rwlock_unlock(&snapshot->lock);
+
+    sgnl_asset_set_destroy(old_set);
+    return true;
+}
+
+bool sgnl_snapshot_contains(sgnl_snapshot_t *snapshot, const char *principal_id,
+                            const char *asset_id, const char *action) {
+    if (!snapshot || !principal_id || !asset_id || !action || strcmp(action, snapshot->action) != 0) {
+        return false;
+    }
+
+    bool found = false;
+    int64_t now = monotonic_seconds();
+    pthread_rwlock_rdlock(&snapshot->lock);
+    snapshot_entry_t *entry = snapshot_find(snapshot, principal_id);
+    if (entry && now - entry->refreshed_at <= snapshot->max_age_seconds) {
+        found = sgnl_asset_set_contains(entry->set, asset_id);
+    }
+    pthread_rwlock_unlock(&snapshot->lock);
+    return found;
+}
+
+size_t sgnl_snapshot_retain(sgnl_snapshot_t *snapshot, const char *const *principal_ids, size_t count) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    pthread_rwlock_wrlock(&snapshot->lock);
+    size_t i = 0;
+    while (i < snapshot->count) {
+        bool keep = false;
+        for (size_t j = 0; j < count && !keep; j++) {
+            keep = principal_ids[j] && strcmp(snapshot->entries[i].principal_id, principal_ids[j]) == 0;
+        }
+        if (keep) {
+            i++;
+        } else {
+            snapshot_remove_at(snapshot, i);
+            removed++;
+        }
+    }
+    pthread_rwlock_unlock(&snapshot->lock);
+    return removed;
+}
+
+size_t sgnl_snapshot_invalidate(sgnl_snapshot_t *snapshot, const char *principal_id) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    size_t removed = 0;
+    pthread_rwlock_wrlock(&snapshot->lock);
+    size_t i = 0;
+    while (i < snapshot->count) {
+        if (!principal_id || strcmp(snapshot->entries[i].principal_id, principal_id) == 0) {
+            snapshot_remove_at(snapshot, i);
+            removed++;
+        } else {
+            i++;
+        }
+    }
+    pthread_rwlock_unlock(&snapshot->lock);
+    return removed;
+}
+
+size_t sgnl_snapshot_principal_count(sgnl_snapshot_t *snapshot) {
+    if (!snapshot) {
+        return 0;
+    }
+    pthread_rwlock_rdlock(&snapshot->lock);
+    size_t count = snapshot->count;
+    pthread_rwlock_unlock(&snapshot->lock);
+    return count;
+}
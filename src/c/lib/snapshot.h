@@ -0,0 +1,89 @@
+/*
+ * SGNL Entitlement Snapshot
+ *
+ * Per-principal sets of the assets a principal may use for one action,
+ * filled from /access/v2/search by a background refresher (sgnld). A hit
+ * answers an evaluation locally as Allow; a miss means nothing and the
+ * evaluation goes to SGNL as usual. Sets older than the snapshot's maximum
+ * age are ignored, so a stalled refresher cannot keep stale grants alive.
+ * Internal to libsgnl; applications use the sgnl_client_snapshot_* API.
+ */
+
+#ifndef SGNL_SNAPSHOT_H
+#define SGNL_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct sgnl_asset_set sgnl_asset_set_t;
+typedef struct sgnl_snapshot sgnl_snapshot_t;
+
+/**
+ * Create an empty asset set
+ *
+ * Asset IDs are packed into one string arena indexed by an open-addressed
+ * table of offsets, so a set costs little more than its strings.
+ *
+ * @return Set or NULL on allocation failure
+ */
+sgnl_asset_set_t* sgnl_asset_set_create(void);
+
+void sgnl_asset_set_destroy(sgnl_asset_set_t *set);
+
+/**
+ * Add an asset ID (duplicates are ignored)
+ *
+ * @return false on allocation failure
+ */
+bool sgnl_asset_set_add(sgnl_asset_set_t *set, const char *asset_id);
+
+bool sgnl_asset_set_contains(const sgnl_asset_set_t *set, const char *asset_id);
+
+size_t sgnl_asset_set_count(const sgnl_asset_set_t *set);
+
+/**
+ * Create a snapshot
+ *
+ * @param action The only action the snapshot answers for
+ * @param max_principals Principals kept (least recently refreshed dropped first)
+ * @param max_age_seconds Age after which a principal's set is ignored
+ * @return Snapshot or NULL on allocation failure
+ */
+sgnl_snapshot_t* sgnl_snapshot_create(const char *action, size_t max_principals, int max_age_seconds);
+
+void sgnl_snapshot_destroy(sgnl_snapshot_t *snapshot);
+
+const char* sgnl_snapshot_action(const sgnl_snapshot_t *snapshot);
+
+/**
+ * Install a freshly built set for a principal, replacing the previous one
+ *
+ * Takes ownership of set, also on failure.
+ *
+ * @return false on allocation failure
+ */
+bool sgnl_snapshot_replace(sgnl_snapshot_t *snapshot, const char *principal_id, sgnl_asset_set_t *set);
+
+/**
+ * Whether a fresh set for principal_id contains asset_id for action
+ */
+bool sgnl_snapshot_contains(sgnl_snapshot_t *snapshot, const char *principal_id,
+                            const char *asset_id, const char *action);
+
+/**
+ * Drop every principal not in principal_ids
+ *
+ * @return Number of principals removed
+ */
+size_t sgnl_snapshot_retain(sgnl_snapshot_t *snapshot, const char *const *principal_ids, size_t count);
+
+/**
+ * Drop one principal's set, or every set when principal_id is NULL
+ *
+ * @return Number of principals removed
+ */
+size_t sgnl_snapshot_invalidate(sgnl_snapshot_t *snapshot, const char *principal_id);
+
+size_t sgnl_snapshot_principal_count(sgnl_snapshot_t *snapshot);
+
+#endif /* SGNL_SNAPSHOT_H */
@@ -0,0 +1,198 @@
+/*
+ * SGNL Client Statistics Implementation
+ */
+
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int histogram_index(uint64_t value) {
+    if (value < (1u << SGNL_HISTOGRAM_SUB_BITS)) {
+        return (int)value;
+    }
+    int magnitude = 63 - __builtin_clzll(value);
+    if (magnitude >= SGNL_HISTOGRAM_MAX_BITS) {
+        return SGNL_HISTOGRAM_BUCKETS - 1;
+    }
+    int shift = magnitude - SGNL_HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << SGNL_HISTOGRAM_SUB_BITS) + (int)(value >> shift) - (1 << SGNL_HISTOGRAM_SUB_BITS);
+}
+
+// Largest value counted in a bucket
+static uint64_t histogram_bucket_limit(int index) {
+    if (index < (1 << SGNL_HISTOGRAM_SUB_BITS)) {
+        return (uint64_t)index;
+    }
+    if (index == SGNL_HISTOGRAM_BUCKETS - 1) {
+        return UINT64_MAX;
+    }
+    int shift = (index >> SGNL_HISTOGRAM_SUB_BITS) - 1;
+    uint64_t sub = (uint64_t)(index & ((1 << SGNL_HISTOGRAM_SUB_BITS) - 1)) + (1u << SGNL_HISTOGRAM_SUB_BITS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void sgnl_histogram_record(sgnl_histogram_t *histogram, uint64_t value) {
+    __atomic_fetch_add(&histogram->buckets[histogram_index(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, value, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&histogram->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+uint64_t sgnl_histogram_percentile(const sgnl_histogram_t *histogram, double percentile) {
+    // Buckets are read once, so the rank is taken against what was read
+    uint64_t counts[SGNL_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < SGNL_HISTOGRAM_BUCKETS; i++) {
+        counts[i] = __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    if (percentile < 0) {
+        percentile = 0;
+    } else if (percentile > 100) {
+        percentile = 100;
+    }
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < SGNL_HISTOGRAM_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t limit = histogram_bucket_limit(i);
+            uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+            return limit < max ? limit : max;
+        }
+    }
+    return __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+}
+
+static uint64_t load(const uint64_t *counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+void sgnl_stats_snapshot(const sgnl_stats_t *stats, sgnl_client_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->cache_hits = load(&stats->cache_hits);
+    out->cache_misses = load(&stats->cache_misses);
+    out->snapshot_hits = load(&stats->snapshot_hits);
+    out->broker_hits = load(&stats->broker_hits);
+    out->offline_hits = load(&stats->offline_hits);
+    out->requests = load(&stats->requests);
+    out->request_errors = load(&stats->request_errors);
+    out->retries = load(&stats->retries);
+    out->hedges = load(&stats->hedges);
+    out->connections = load(&stats->connections);
+
+    for (int phase = 0; phase < SGNL_PHASE_COUNT; phase++) {
+        const sgnl_histogram_t *histogram = &stats->phases[phase];
+        sgnl_latency_stats_t *latency = &out->phases[phase];
+        latency->count = load(&histogram->count);
+        latency->sum_us = load(&histogram->sum);
+        latency->max_us = load(&histogram->max);
+        latency->p50_us = sgnl_histogram_percentile(histogram, 50);
+        latency->p90_us = sgnl_histogram_percentile(histogram, 90);
+        latency->p99_us = sgnl_histogram_percentile(histogram, 99);
+        latency->p999_us = sgnl_histogram_percentile(histogram, 99.9);
+    }
+}
+
+// ============================================================================
+// Prometheus
+// ============================================================================
+
+static void write_counter(FILE *out, const char *name, const char *help, const char *labels, uint64_t value) {
+    fprintf(out, "# HELP %s %s\n# TYPE %s counter\n%s{%s} %llu\n",
+            name, help, name, name, labels, (unsigned long long)value);
+}
+
+bool sgnl_stats_write_prometheus(const sgnl_client_stats_t *stats, const char *host, const char *path) {
+    if (!stats || !host || !path || !*path) {
+        return false;
+    }
+
+    // Label values escape backslash, quote and newline
+    char labels[512];
+    size_t used = (size_t)snprintf(labels, sizeof(labels), "host=\"");
+    for (const char *c = host; *c && used + 4 < sizeof(labels); c++) {
+        if (*c == '\\' || *c == '"') {
+            labels[used++] = '\\';
+            labels[used++] = *c;
+        } else if (*c == '\n') {
+            labels[used++] = '\\';
+            labels[used++] = 'n';
+        } else {
+            labels[used++] = *c;
+        }
+    }
+    labels[used++] = '"';
+    labels[used] = '\0';
+
+    char temp_path[4096];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path) >= (int)sizeof(temp_path)) {
+        return false;
+    }
+    int fd = mkstemp(temp_path);
+    if (fd < 0) {
+        return false;
+    }
+    FILE *out = fdopen(fd, "w");
+    if (!out) {
+        close(fd);
+        unlink(temp_path);
+        return false;
+    }
+
+    // Scrapers run unprivileged; nothing here is sensitive
+    (void)fchmod(fd, 0644);
+
+    write_counter(out, "sgnl_cache_hits_total", "Evaluations answered by the decision cache.", labels, stats->cache_hits);
+    write_counter(out, "sgnl_cache_misses_total", "Decision cache lookups that found nothing.", labels, stats->cache_misses);
+    write_counter(out, "sgnl_snapshot_hits_total", "Queries answered by the prefetched snapshot.", labels, stats->snapshot_hits);
+    write_counter(out, "sgnl_broker_hits_total", "Calls answered by sgnld.", labels, stats->broker_hits);
+    write_counter(out, "sgnl_offline_hits_total", "Queries answered by the offline store.", labels, stats->offline_hits);
+    write_counter(out, "sgnl_http_requests_total", "HTTP attempts to the SGNL API.", labels, stats->requests);
+    write_counter(out, "sgnl_http_request_errors_total", "HTTP attempts without a 200 response.", labels, stats->request_errors);
+    write_counter(out, "sgnl_http_retries_total", "HTTP attempts retried after a transient failure.", labels, stats->retries);
+    write_counter(out, "sgnl_http_hedges_total", "Hedged second attempts started.", labels, stats->hedges);
+    write_counter(out, "sgnl_http_connections_total", "Connections opened to the SGNL API.", labels, stats->connections);
+
+    static const char *quantiles[4] = {"0.5", "0.9", "0.99", "0.999"};
+    fprintf(out, "# HELP sgnl_request_phase_seconds Time spent in each phase of SGNL API requests.\n"
+                 "# TYPE sgnl_request_phase_seconds summary\n");
+    for (int phase = 0; phase < SGNL_PHASE_COUNT; phase++) {
+        const sgnl_latency_stats_t *latency = &stats->phases[phase];
+        const char *name = sgnl_phase_to_string((sgnl_phase_t)phase);
+        const uint64_t values_us[4] = {latency->p50_us, latency->p90_us, latency->p99_us, latency->p999_us};
+        for (int i = 0; i < 4; i++) {
+            fprintf(out, "sgnl_request_phase_seconds{%s,phase=\"%s\",quantile=\"%s\"} %.6f\n",
+                    labels, name, quantiles[i], (double)values_us[i] / 1e6);
+        }
+        fprintf(out, "sgnl_request_phase_seconds_sum{%s,phase=\"%s\"} %.6f\n",
+                labels, name, (double)latency->sum_us / 1e6);
+        fprintf(out, "sgnl_request_phase_seconds_count{%s,phase=\"%s\"} %llu\n",
+                labels, name, (unsigned long long)latency->count);
+    }
+
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(temp_path, path) != 0) {
+        unlink(temp_path);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+/*
+ * SGNL Client Statistics
+ *
+ * Counters and latency histograms behind sgnl_client_get_stats. Histograms
+ * are log-linear in the style of HdrHistogram: values below 32 are counted
+ * exactly and larger ones in 32 sub-buckets per power of two, so a reported
+ * percentile is within about 3% of the true value. Recording is lock-free
+ * (relaxed atomic increments), so request threads never wait on each other;
+ * a snapshot taken while requests complete may be off by those requests.
+ * Internal to libsgnl.
+ */
+
+#ifndef SGNL_STATS_H
+#define SGNL_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "libsgnl.h"
+
+// Exact below 2^5; values from 2^32 up share the top bucket
+#define SGNL_HISTOGRAM_SUB_BITS 5
+#define SGNL_HISTOGRAM_MAX_BITS 32
+#define SGNL_HISTOGRAM_BUCKETS ((SGNL_HISTOGRAM_MAX_BITS - SGNL_HISTOGRAM_SUB_BITS + 1) << SGNL_HISTOGRAM_SUB_BITS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[SGNL_HISTOGRAM_BUCKETS];
+} sgnl_histogram_t;
+
+// Counters mirror sgnl_client_stats_t; all fields are updated atomically
+typedef struct {
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    uint64_t snapshot_hits;
+    uint64_t broker_hits;
+    uint64_t offline_hits;
+    uint64_t requests;
+    uint64_t request_errors;
+    uint64_t retries;
+    uint64_t hedges;
+    uint64_t connections;
+    sgnl_histogram_t phases[SGNL_PHASE_COUNT];  // Microseconds
+} sgnl_stats_t;
+
+static inline void sgnl_stats_add(uint64_t *counter, uint64_t n) {
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+void sgnl_histogram_record(sgnl_histogram_t *histogram, uint64_t value);
+
+/**
+ * Smallest value that at least percentile% of the recorded values do not
+ * exceed, rounded up to its bucket's upper bound
+ *
+ * @param percentile 0 to 100
+ * @return The value, 0 when nothing has been recorded
+ */
+uint64_t sgnl_histogram_percentile(const sgnl_histogram_t *histogram, double percentile);
+
+/**
+ * Copy the current counters and summarize each histogram
+ */
+void sgnl_stats_snapshot(const sgnl_stats_t *stats, sgnl_client_stats_t *out);
+
+/**
+ * Write stats in the Prometheus text exposition format, replacing path
+ * atomically so a textfile collector never reads a partial file
+ *
+ * @param host Value of the "host" label: the SGNL API host
+ * @return true if the file was written
+ */
+bool sgnl_stats_write_prometheus(const sgnl_client_stats_t *stats, const char *host, const char *path);
+
+#endif /* SGNL_STATS_H */
@@ -0,0 +1,301 @@
+/*
+ * SGNL TLS Session Store Implementation
+ *
+ * The file is a small header followed by length-prefixed records, written
+ * to a temporary file and renamed over the old one, so concurrent sudo
+ * invocations never see a half-written store; the last writer wins. It is
+ * only trusted when owned by the caller and private to it, since session
+ * data holds the keys needed to decrypt resumed traffic.
+ */
+
+#include "tls_session_store.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TLS_SESSION_MAGIC "SGNLTLS1"
+#define TLS_SESSION_VERSION 1
+
+// Bounds on what libcurl hands out; anything larger is not a session
+#define TLS_SESSION_MAX_SHMAC 256
+#define TLS_SESSION_MAX_DATA (32 * 1024)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+} tls_session_header_t;
+
+typedef struct {
+    uint32_t shmac_len;
+    uint32_t data_len;
+    int64_t valid_until;
+} tls_session_record_t;
+
+typedef struct {
+    unsigned char *shmac;
+    size_t shmac_len;
+    unsigned char *data;
+    size_t data_len;
+    int64_t valid_until;
+} tls_session_t;
+
+struct sgnl_tls_session_store {
+    tls_session_t sessions[SGNL_TLS_SESSION_MAX];
+    size_t count;
+};
+
+static bool session_expired(int64_t valid_until, int64_t now) {
+    return valid_until != 0 && valid_until <= now;
+}
+
+static void session_clear(tls_session_t *session) {
+    if (session->data) {
+        memset(session->data, 0, session->data_len);
+    }
+    free(session->shmac);
+    free(session->data);
+    memset(session, 0, sizeof(*session));
+}
+
+sgnl_tls_session_store_t* sgnl_tls_session_store_create(void) {
+    return calloc(1, sizeof(sgnl_tls_session_store_t));
+}
+
+static void store_clear(sgnl_tls_session_store_t *store) {
+    for (size_t i = 0; i < store->count; i++) {
+        session_clear(&store->sessions[i]);
+    }
+    store->count = 0;
+}
+
+void sgnl_tls_session_store_free(sgnl_tls_session_store_t *store) {
+    if (!store) {
+        return;
+    }
+    store_clear(store);
+    free(store);
+}
+
+bool sgnl_tls_session_store_add(sgnl_tls_session_store_t *store,
+                                const unsigned char *shmac, size_t shmac_len,
+                                const unsigned char *data, size_t data_len,
+                                int64_t valid_until) {
+    if (!store || !shmac || !data || shmac_len == 0 || data_len == 0 ||
+        shmac_len > TLS_SESSION_MAX_SHMAC || data_len > TLS_SESSION_MAX_DATA ||
+        session_expired(valid_until, (int64_t)time(NULL))) {
+        return false;
+    }
+
+    tls_session_t session;
+    session.shmac = malloc(shmac_len);
+    session.data = malloc(data_len);
+    if (!session.shmac || !session.data) {
+        free(session.shmac);
+        free(session.data);
+        return false;
+    }
+    memcpy(session.shmac, shmac, shmac_len);
+    memcpy(session.data, data, data_len);
+    session.shmac_len = shmac_len;
+    session.data_len = data_len;
+    session.valid_until = valid_until;
+
+    // A newer ticket for the same peer replaces the old one
+    size_t slot = store->count;
+    for (size_t i = 0; i < store->count; i++) {
+        if (store->sessions[i].shmac_len == shmac_len && memcmp(store->sessions[i].shmac, shmac, shmac_len) == 0) {
+            slot = i;
+            break;
+        }
+    }
+
+    // Full: the session that expires first (unknown expiry counts as first) goes
+    if (slot == SGNL_TLS_SESSION_MAX) {
+        slot = 0;
+        for (size_t i = 1; i < store->count; i++) {
+            if (store->sessions[i].valid_until < store->sessions[slot].valid_until) {
+                slot = i;
+            }
+        }
+    }
+
+    if (slot < store->count) {
+        session_clear(&store->sessions[slot]);
+    } else {
+        store->count++;
+    }
+    store->sessions[slot] = session;
+    return true;
+}
+
+size_t sgnl_tls_session_store_count(const sgnl_tls_session_store_t *store) {
+    return store ? store->count : 0;
+}
+
+bool sgnl_tls_session_store_get(const sgnl_tls_session_store_t *store, size_t index,
+                                const unsigned char **shmac, size_t *shmac_len,
+                                const unsigned char **data, size_t *data_len) {
+    if (!store || index >= store->count) {
+        return false;
+    }
+    const tls_session_t *session = &store->sessions[index];
+    *shmac = session->shmac;
+    *shmac_len = session->shmac_len;
+    *data = session->data;
+    *data_len = session->data_len;
+    return true;
+}
+
+bool sgnl_tls_session_store_copy(sgnl_tls_session_store_t *dest, const sgnl_tls_session_store_t *src) {
+    if (!dest || !src || dest == src) {
+        return false;
+    }
+    store_clear(dest);
+    for (size_t i = 0; i < src->count; i++) {
+        const tls_session_t *session = &src->sessions[i];
+        sgnl_tls_session_store_add(dest, session->shmac, session->shmac_len,
+                                   session->data, session->data_len, session->valid_until);
+    }
+    return true;
+}
+
+// ============================================================================
+// File
+// ============================================================================
+
+// Create the parent directory of path if it does not exist yet
+static void ensure_parent_directory(const char *path) {
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+    if (!slash || slash == path || (size_t)(slash - path) >= sizeof(dir)) {
+        return;
+    }
+    memcpy(dir, path, (size_t)(slash - path));
+    dir[slash - path] = '\0';
+
+    // EEXIST is the common case; any real problem surfaces when writing the file
+    (void)mkdir(dir, 0700);
+}
+
+static bool read_all(int fd, void *buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, (char *)buffer + done, size - done);
+        if (n <= 0) {
+            return false;
+        }
+        done += (size_t)n;
+    }
+    return true;
+}
+
+static bool write_all(int fd, const void *buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write(fd, (const char *)buffer + done, size - done);
+        if (n <= 0) {
+            return false;
+        }
+        done += (size_t)n;
+    }
+    return true;
+}
+
+size_t sgnl_tls_session_store_load(sgnl_tls_session_store_t *store, const char *path) {
+    if (!store || !path || !*path) {
+        return 0;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    tls_session_header_t header;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 077) != 0 ||
+        !read_all(fd, &header, sizeof(header)) ||
+        memcmp(header.magic, TLS_SESSION_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TLS_SESSION_VERSION || header.count > SGNL_TLS_SESSION_MAX) {
+        close(fd);
+        return 0;
+    }
+
+    size_t added = 0;
+    unsigned char shmac[TLS_SESSION_MAX_SHMAC];
+    unsigned char *data = malloc(TLS_SESSION_MAX_DATA);
+    for (uint32_t i = 0; data && i < header.count; i++) {
+        tls_session_record_t record;
+        if (!read_all(fd, &record, sizeof(record)) ||
+            record.shmac_len == 0 || record.shmac_len > sizeof(shmac) ||
+            record.data_len == 0 || record.data_len > TLS_SESSION_MAX_DATA ||
+            !read_all(fd, shmac, record.shmac_len) || !read_all(fd, data, record.data_len)) {
+            break;
+        }
+        if (sgnl_tls_session_store_add(store, shmac, record.shmac_len, data, record.data_len, record.valid_until)) {
+            added++;
+        }
+    }
+
+    if (data) {
+        memset(data, 0, TLS_SESSION_MAX_DATA);
+        free(data);
+    }
+    close(fd);
+    return added;
+}
+
+bool sgnl_tls_session_store_save(const sgnl_tls_session_store_t *store, const char *path) {
+    if (!store || !path || !*path) {
+        return false;
+    }
+
+    char temp_path[4096];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path) >= (int)sizeof(temp_path)) {
+        return false;
+    }
+    ensure_parent_directory(path);
+    int fd = mkstemp(temp_path);
+    if (fd < 0) {
+        return false;
+    }
+
+    int64_t now = (int64_t)time(NULL);
+    tls_session_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TLS_SESSION_MAGIC, sizeof(header.magic));
+    header.version = TLS_SESSION_VERSION;
+    for (size_t i = 0; i < store->count; i++) {
+        header.count += !session_expired(store->sessions[i].valid_until, now);
+    }
+
+    bool ok = fchmod(fd, 0600) == 0 && write_all(fd, &header, sizeof(header));
+    for (size_t i = 0; ok && i < store->count; i++) {
+        const tls_session_t *session = &store->sessions[i];
+        if (session_expired(session->valid_until, now)) {
+            continue;
+        }
+        tls_session_record_t record = {
+            .shmac_len = (uint32_t)session->shmac_len,
+            .data_len = (uint32_t)session->data_len,
+            .valid_until = session->valid_until
+        };
+        ok = write_all(fd, &record, sizeof(record)) &&
+             write_all(fd, session->shmac, session->shmac_len) &&
+             write_all(fd, session->data, session->data_len);
+    }
+
+    if (close(fd) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(temp_path, path) != 0) {
+        unlink(temp_path);
+        return false;
+    }
+    return true;
+}
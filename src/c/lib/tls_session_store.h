@@ -0,0 +1,77 @@
+/*
+ * SGNL TLS Session Store
+ *
+ * Opaque TLS session tickets exported from libcurl, kept in memory and
+ * optionally persisted to a root-only file, so a short-lived process (a
+ * sudo or PAM invocation) can resume the previous process's session
+ * instead of paying for a full handshake. Entries are stored as libcurl
+ * hands them out: a salted hash of the session key and the session data.
+ * Internal to libsgnl; enabled through the "http.tls" config block.
+ */
+
+#ifndef SGNL_TLS_SESSION_STORE_H
+#define SGNL_TLS_SESSION_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Sessions kept per store; the API host needs one or two
+#define SGNL_TLS_SESSION_MAX 16
+
+typedef struct sgnl_tls_session_store sgnl_tls_session_store_t;
+
+sgnl_tls_session_store_t* sgnl_tls_session_store_create(void);
+
+void sgnl_tls_session_store_free(sgnl_tls_session_store_t *store);
+
+/**
+ * Add a copy of one session; when the store is full the session that
+ * expires first makes room
+ *
+ * @param valid_until Unix time the session expires (0 = unknown)
+ * @return false if the session is invalid, expired or cannot be copied
+ */
+bool sgnl_tls_session_store_add(sgnl_tls_session_store_t *store,
+                                const unsigned char *shmac, size_t shmac_len,
+                                const unsigned char *data, size_t data_len,
+                                int64_t valid_until);
+
+size_t sgnl_tls_session_store_count(const sgnl_tls_session_store_t *store);
+
+/**
+ * Borrow one session; the pointers stay valid until the store changes
+ *
+ * @return false if index is out of range
+ */
+bool sgnl_tls_session_store_get(const sgnl_tls_session_store_t *store, size_t index,
+                                const unsigned char **shmac, size_t *shmac_len,
+                                const unsigned char **data, size_t *data_len);
+
+/**
+ * Replace the contents of dest with copies of the sessions in src
+ */
+bool sgnl_tls_session_store_copy(sgnl_tls_session_store_t *dest, const sgnl_tls_session_store_t *src);
+
+/**
+ * Add the unexpired sessions saved in a file
+ *
+ * The file must be a regular file owned by the calling user and not
+ * accessible to group or others; anything else, or a file that is
+ * missing, truncated or of another version, adds nothing.
+ *
+ * @return Number of sessions added
+ */
+size_t sgnl_tls_session_store_load(sgnl_tls_session_store_t *store, const char *path);
+
+/**
+ * Write the unexpired sessions to a file, replacing it atomically
+ *
+ * The file is created mode 0600; its parent directory is created (0700)
+ * if missing.
+ *
+ * @return true if the file was written
+ */
+bool sgnl_tls_session_store_save(const sgnl_tls_session_store_t *store, const char *path);
+
+#endif /* SGNL_TLS_SESSION_STORE_H */
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <syslog.h>
+#include <pthread.h>
 
 // PAM includes
 #include <security/pam_appl.h>
@@ -20,8 +21,10 @@
 #include "../../lib/libsgnl.h"
 #include "../../common/logging.h"
 
-// Global SGNL client (initialized once, reused)
+// Global SGNL client (initialized once, reused). The client itself is safe
+// to share between threads; the lock only serializes its creation.
 static sgnl_client_t *sgnl_client = NULL;
+static pthread_mutex_t sgnl_client_lock = PTHREAD_MUTEX_INITIALIZER;
 
 // Logging compatibility macro
 #ifdef __APPLE__
@@ -32,8 +35,10 @@ static sgnl_client_t *sgnl_client = NULL;
 
 /**
  * Initialize SGNL client with PAM-specific configuration
+ * 
+ * Called with sgnl_client_lock held.
  */
-static int init_sgnl_client(pam_handle_t *pamh) {
+static int create_sgnl_client(pam_handle_t *pamh) {
     if (sgnl_client != NULL) {
         return PAM_SUCCESS; // Already initialized
     }
@@ -47,17 +52,17 @@ static int init_sgnl_client(pam_handle_t *pamh) {
     sgnl_client_config_t pam_config = {
         .config_path = NULL,  // Use default config path
         .timeout_seconds = 0, // Use defaults
-        .retry_count = 2,
-        .retry_delay_ms = 1000,
+        .retry_count = 0,     // Use http.retry from config
+        .retry_delay_ms = 0,  // Use http.retry from config
         .enable_debug_logging = false,  // Will be overridden by config file
         .validate_ssl = true,
         .user_agent = "SGNL-PAM/1.0"
     };
     
     // Create client with PAM-specific configuration
-    sgnl_client = sgnl_client_create(&pam_config);
+    sgnl_client_t *client = sgnl_client_create(&pam_config);
     
-    if (sgnl_client == NULL) {
+    if (client == NULL) {
         SGNL_LOG_ERROR(&log_ctx, "Failed to initialize SGNL client");
         SGNL_LOG(pamh, LOG_ERR, "SGNL PAM: Failed to initialize client");
         return PAM_AUTHINFO_UNAVAIL;
@@ -66,20 +71,32 @@ static int init_sgnl_client(pam_handle_t *pamh) {
     SGNL_LOG_INFO(&log_ctx, "SGNL client created successfully for PAM module");
     
     // Validate configuration
-    if (sgnl_client_validate(sgnl_client) != SGNL_OK) {
-        const char *error = sgnl_client_get_last_error(sgnl_client);
+    if (sgnl_client_validate(client) != SGNL_OK) {
+        const char *error = sgnl_client_get_last_error(client);
         SGNL_LOG_ERROR(&log_ctx, "Configuration validation failed: %s", error);
         SGNL_LOG(pamh, LOG_ERR, "SGNL PAM: Invalid configuration: %s", error);
-        sgnl_client_destroy(sgnl_client);
-        sgnl_client = NULL;
+        sgnl_client_destroy(client);
         return PAM_AUTHINFO_UNAVAIL;
     }
     
+    // Publish only a fully validated client
+    sgnl_client = client;
+    
     SGNL_LOG_INFO(&log_ctx, "SGNL client initialized successfully");
     SGNL_LOG(pamh, LOG_INFO, "SGNL PAM: Client initialized successfully");
     return PAM_SUCCESS;
 }
 
+/**
+ * Get the shared SGNL client, creating it on first use
+ */
+static sgnl_client_t* get_sgnl_client(pam_handle_t *pamh) {
+    pthread_mutex_lock(&sgnl_client_lock);
+    sgnl_client_t *client = create_sgnl_client(pamh) == PAM_SUCCESS ? sgnl_client : NULL;
+    pthread_mutex_unlock(&sgnl_client_lock);
+    return client;
+}
+
 /**
  * Check SGNL access
  */
@@ -87,7 +104,8 @@ static int check_access(pam_handle_t *pamh, const char *username, const char *se
     sgnl_log_context_t log_ctx = SGNL_LOG_CONTEXT("pam");
     
     // Ensure client is initialized
-    if (init_sgnl_client(pamh) != PAM_SUCCESS) {
+    sgnl_client_t *client = get_sgnl_client(pamh);
+    if (client == NULL) {
         return PAM_AUTHINFO_UNAVAIL;
     }
     
@@ -96,7 +114,7 @@ static int check_access(pam_handle_t *pamh, const char *username, const char *se
              username, service);
     
     // Make SGNL API call
-    sgnl_result_t result = sgnl_check_access(sgnl_client, username, service, NULL);
+    sgnl_result_t result = sgnl_check_access(client, username, service, NULL);
     
     switch (result) {
         case SGNL_ALLOWED:
@@ -144,8 +162,16 @@ PAM_EXTERN int pam_sm_acct_mgmt(pam_handle_t *pamh, int flags, int argc, const c
     SGNL_LOG(pamh, LOG_INFO, "SGNL PAM: Processing account for [%s] service [%s] host [%s]", 
              username, service, host ? host : "local");
     
-    // Check access
-    return check_access(pamh, username, service);
+    // Check access; the audit record covers client setup as well as the decision
+    sgnl_request_tracker_t *tracker = sgnl_request_start(username, service, NULL);
+    int rc = check_access(pamh, username, service);
+    if (tracker && tracker->result[0] != '\0') {
+        sgnl_request_end(tracker, NULL);
+    } else {
+        sgnl_request_end(tracker, rc == PAM_SUCCESS ? "Access Allowed" :
+                                  rc == PAM_PERM_DENIED ? "Access Denied" : "Client Unavailable");
+    }
+    return rc;
 }
 
 /**
@@ -169,8 +195,10 @@ PAM_EXTERN int pam_sm_authenticate(pam_handle_t *pamh, int flags, int argc, cons
  */
 __attribute__((destructor))
 static void pam_module_cleanup(void) {
+    pthread_mutex_lock(&sgnl_client_lock);
     if (sgnl_client != NULL) {
         sgnl_client_destroy(sgnl_client);
         sgnl_client = NULL;
     }
+    pthread_mutex_unlock(&sgnl_client_lock);
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 // SGNL library and common config
 #include "../../lib/libsgnl.h"
 #include "../../common/config.h"
+#include "../../common/logging.h"
 
 // Define sudo_dso_public if not already defined
 #ifndef sudo_dso_public
@@ -46,6 +47,7 @@ static struct {
     char * const *user_info;
     sgnl_client_t *sgnl_client;
     sudo_plugin_settings_t config;  // Our settings struct
+    char username[256];             // Resolved by get_current_username
 } plugin_state = {0};
 
 static sudo_conv_t sudo_conv;
@@ -103,7 +105,6 @@ static bool load_sudo_settings(sudo_plugin_settings_t *settings) {
  * Get current username from plugin context
  */
 static const char* get_current_username(void) {
-    static char username_buffer[256];
     const char *username = "unknown";
     
     // Try to get from user_info first
@@ -125,33 +126,39 @@ static const char* get_current_username(void) {
         }
     }
     
-    strncpy(username_buffer, username, sizeof(username_buffer) - 1);
-    username_buffer[sizeof(username_buffer) - 1] = '\0';
-    return username_buffer;
+    strncpy(plugin_state.username, username, sizeof(plugin_state.username) - 1);
+    plugin_state.username[sizeof(plugin_state.username) - 1] = '\0';
+    return plugin_state.username;
 }
 
 /**
  * Show allowed commands for user
  */
+static bool print_allowed_command(const char *asset_id, void *user_data) {
+    int *shown = (int *)user_data;
+    if (*shown == 0) {
+        sudo_log(SUDO_CONV_INFO_MSG, "Allowed commands:\n");
+    }
+    sudo_log(SUDO_CONV_INFO_MSG, "  - %s\n", asset_id);
+    (*shown)++;
+    return true;
+}
+
 static void show_allowed_commands(const char *username) {
     if (!plugin_state.sgnl_client) {
         sudo_log(SUDO_CONV_INFO_MSG, "SGNL client not available\n");
         return;
     }
     
-    // Search for allowed assets
-    int asset_count = 0;
-    char **allowed_commands = sgnl_search_assets(plugin_state.sgnl_client, 
-                                               username, "sudo_list", &asset_count);
+    // Print each page as it arrives instead of collecting the full list
+    int shown = 0;
+    sgnl_result_t result = sgnl_search_assets_foreach(plugin_state.sgnl_client, username,
+                                                      "sudo_list", 0, print_allowed_command, &shown);
     
-    if (allowed_commands && asset_count > 0) {
-        sudo_log(SUDO_CONV_INFO_MSG, "Allowed commands:\n");
-        for (int i = 0; i < asset_count && allowed_commands[i]; i++) {
-            sudo_log(SUDO_CONV_INFO_MSG, "  - %s\n", allowed_commands[i]);
-        }
-        sgnl_asset_ids_free(allowed_commands, asset_count);
-    } else {
+    if (shown == 0) {
         sudo_log(SUDO_CONV_INFO_MSG, "No commands are currently allowed.\n");
+    } else if (result != SGNL_OK) {
+        sudo_log(SUDO_CONV_INFO_MSG, "(list incomplete: %s)\n", sgnl_result_to_string(result));
     }
 }
 
@@ -323,6 +330,10 @@ static sgnl_result_t check_sudo_access_single(sgnl_client_t *client,
 
 /**
  * Build batch access evaluation for sudo command and arguments
+ * 
+ * The command is checked with action "sudo" and every argument with
+ * "sudo:<command>". Repeated arguments are evaluated once, and large
+ * argument lists are split into concurrent requests by libsgnl.
  */
 static sgnl_result_t check_sudo_access_with_args(sgnl_client_t *client, 
                                                 const char *username, 
@@ -331,89 +342,36 @@ static sgnl_result_t check_sudo_access_with_args(sgnl_client_t *client,
         return SGNL_ERROR;
     }
     
-    // Count how many queries we need:
-    // 1. sudo access for the command itself
-    // 2. command-specific access for each argument (if any)
-    int query_count = 1; // Always at least 1 for the command itself
-    
-    // Add queries for arguments if they exist
-    for (int i = 1; i < argc; i++) {
-        if (argv[i] && strlen(argv[i]) > 0) {
-            query_count++;
-        }
-    }
-    
-    if (query_count == 1) {
-        // No arguments, just check the command
-        return sgnl_check_access(client, username, argv[0], "sudo");
-    }
-    
-    // Allocate arrays for batch evaluation
-    const char **asset_ids = calloc(query_count, sizeof(char*));
-    const char **actions = calloc(query_count, sizeof(char*));
-    char **action_strings = calloc(query_count, sizeof(char*)); // Track allocated strings
-    
-    if (!asset_ids || !actions || !action_strings) {
-        if (asset_ids) free(asset_ids);
-        if (actions) free(actions);
-        if (action_strings) free(action_strings);
+    sgnl_query_set_t *queries = sgnl_query_set_create();
+    if (!queries) {
         return SGNL_MEMORY_ERROR;
     }
     
-    // Build the queries
-    int query_idx = 0;
-    
     // First query: sudo access for the command
-    asset_ids[query_idx] = argv[0];
-    actions[query_idx] = "sudo";
-    query_idx++;
+    bool ok = sgnl_query_set_add(queries, argv[0], "sudo") >= 0;
     
     // Additional queries: command-specific access for each argument
-    for (int i = 1; i < argc && query_idx < query_count; i++) {
-        if (argv[i] && strlen(argv[i]) > 0) {
-            asset_ids[query_idx] = argv[i];
-            // Create action string with 'sudo:' prefix
-            char action_buffer[256];
-            snprintf(action_buffer, sizeof(action_buffer), "sudo:%s", argv[0]);
-            action_strings[query_idx] = strdup(action_buffer); // Track for cleanup
-            actions[query_idx] = action_strings[query_idx];
-            query_idx++;
-        }
-    }
-    
-    // Perform batch evaluation
-    sgnl_access_result_t **results = sgnl_evaluate_access_batch(client, username, 
-                                                              asset_ids, actions, query_count);
-    
-    // Clean up arrays
-    free(asset_ids);
-    free(actions);
-    
-    // Free allocated action strings
-    if (action_strings) {
-        for (int i = 0; i < query_count; i++) {
-            if (action_strings[i]) {
-                free(action_strings[i]);
-            }
+    char action_buffer[256];
+    snprintf(action_buffer, sizeof(action_buffer), "sudo:%s", argv[0]);
+    for (int i = 1; ok && i < argc; i++) {
+        if (argv[i] && argv[i][0] != '\0') {
+            ok = sgnl_query_set_add(queries, argv[i], action_buffer) >= 0;
         }
-        free(action_strings);
     }
-    
-    if (!results) {
-        return SGNL_ERROR;
+    if (!ok) {
+        sgnl_query_set_free(queries);
+        return SGNL_MEMORY_ERROR;
     }
     
-    // Check all results - ALL must be allowed for the overall request to succeed
-    sgnl_result_t overall_result = SGNL_ALLOWED;
-    for (int i = 0; i < query_count && results[i]; i++) {
-        if (results[i]->result != SGNL_ALLOWED) {
-            overall_result = results[i]->result;
-            break;
-        }
+    if (sgnl_query_set_count(queries) == 1) {
+        // No arguments, just check the command
+        sgnl_query_set_free(queries);
+        return sgnl_check_access(client, username, argv[0], "sudo");
     }
     
-    // Clean up results
-    sgnl_access_result_array_free(results, query_count);
+    // ALL queries must be allowed; evaluation stops at the first Deny
+    sgnl_result_t overall_result = sgnl_check_query_set(client, username, queries);
+    sgnl_query_set_free(queries);
     
     return overall_result;
 }
@@ -452,7 +410,8 @@ static int policy_open(unsigned int version, sudo_conv_t conversation,
         return SUDO_RC_ERROR;
     }
     
-    // Create SGNL client (libsgnl will load its own config using common config system)
+    // Create SGNL client (libsgnl reuses the config parsed by load_sudo_settings
+    // while the file is unchanged)
     plugin_state.sgnl_client = sgnl_client_create(NULL);  // NULL = use defaults
     
     if (!plugin_state.sgnl_client) {
@@ -516,7 +475,10 @@ static int policy_check(int argc, char * const argv[], char *env_add[],
         return SUDO_RC_ERROR;
     }
     
-    // Check access using either single or batch evaluation based on configuration
+    // Check access using either single or batch evaluation based on configuration.
+    // The tracker times the whole check; the asset and action of the audit
+    // record come from the evaluation libsgnl performs under it.
+    sgnl_request_tracker_t *tracker = sgnl_request_start(username, NULL, NULL);
     sgnl_result_t result;
     if (plugin_state.config.batch_evaluation) {
         result = check_sudo_access_with_args(plugin_state.sgnl_client, 
@@ -525,6 +487,7 @@ static int policy_check(int argc, char * const argv[], char *env_add[],
         result = check_sudo_access_single(plugin_state.sgnl_client, 
                                         username, argc, argv);
     }
+    sgnl_request_end(tracker, sgnl_result_to_string(result));
     
     if (result != SGNL_ALLOWED) {
         // Build a more descriptive error message
@@ -107,6 +107,7 @@ endef
 # Detect required libraries
 HAS_JSON_C := $(call check_pkg_config,json-c)
 HAS_LIBCURL := $(call check_pkg_config,libcurl)
+HAS_ZLIB := $(call check_pkg_config,zlib)
 
 # Set library flags based on availability
 ifeq ($(HAS_JSON_C),yes)
@@ -125,10 +126,18 @@ else
     CURL_LIBS = -lcurl
 endif
 
+ifeq ($(HAS_ZLIB),yes)
+    ZLIB_CFLAGS = $(call get_pkg_cflags,zlib)
+    ZLIB_LIBS = $(call get_pkg_libs,zlib)
+else
+    ZLIB_CFLAGS = 
+    ZLIB_LIBS = -lz
+endif
+
 # Combined platform settings
-PLATFORM_ALL_CFLAGS = $(PLATFORM_CFLAGS) $(PLATFORM_INCLUDES) $(JSON_CFLAGS) $(CURL_CFLAGS)
+PLATFORM_ALL_CFLAGS = $(PLATFORM_CFLAGS) $(PLATFORM_INCLUDES) $(JSON_CFLAGS) $(CURL_CFLAGS) $(ZLIB_CFLAGS)
 PLATFORM_ALL_LDFLAGS = $(PLATFORM_LDFLAGS) $(PLATFORM_LIBDIRS)
-PLATFORM_ALL_LIBS = $(JSON_LIBS) $(CURL_LIBS)
+PLATFORM_ALL_LIBS = $(JSON_LIBS) $(CURL_LIBS) $(ZLIB_LIBS) -lpthread
 
 # Debug info
 platform-info:
@@ -138,6 +147,7 @@ platform-info:
 	@echo "Sudo directory: $(SUDO_DIR)"
 	@echo "JSON-C available: $(HAS_JSON_C)"
 	@echo "libcurl available: $(HAS_LIBCURL)"
+	@echo "zlib available: $(HAS_ZLIB)"
 	@echo "Platform CFLAGS: $(PLATFORM_ALL_CFLAGS)"
 	@echo "Platform LDFLAGS: $(PLATFORM_ALL_LDFLAGS)"
 	@echo "Platform LIBS: $(PLATFORM_ALL_LIBS)"
@@ -66,6 +66,85 @@ static int test_config_defaults(void) {
     TEST_ASSERT(config->sudo.access_msg == true, "Default access message");
     TEST_ASSERT(strcmp(config->sudo.command_attribute, "id") == 0, "Default command attribute");
     
+    // Verify retry defaults
+    TEST_ASSERT(config->http.retry.max_retries == 2, "Default max retries");
+    TEST_ASSERT(config->http.retry.base_delay_ms == 100, "Default retry base delay");
+    TEST_ASSERT(config->http.retry.max_delay_ms == 2000, "Default retry max delay");
+    TEST_ASSERT(config->http.retry.budget_ms == 0, "Default retry budget follows timeout");
+    
+    // Verify millisecond timeouts are unset and fall back to the seconds values
+    TEST_ASSERT(config->http.timeout_ms == 0, "Default millisecond timeout unset");
+    TEST_ASSERT(config->http.connect_timeout_ms == 0, "Default millisecond connect timeout unset");
+    TEST_ASSERT(config->http.deadline_ms == 0, "Default deadline unset");
+    TEST_ASSERT(sgnl_config_get_timeout_ms(config) == config->http.timeout_seconds * 1000,
+                "Millisecond timeout follows seconds");
+    TEST_ASSERT(sgnl_config_get_connect_timeout_ms(config) == config->http.connect_timeout_seconds * 1000,
+                "Millisecond connect timeout follows seconds");
+    
+    // Verify batch splitting defaults
+    TEST_ASSERT(config->http.batch.max_queries == 100, "Default batch queries per request");
+    TEST_ASSERT(config->http.batch.max_concurrency == 4, "Default batch request concurrency");
+    
+    // Verify compression defaults
+    TEST_ASSERT(config->http.compression.response == true, "Default response decoding enabled");
+    TEST_ASSERT(config->http.compression.request == false, "Default request compression disabled");
+    TEST_ASSERT(config->http.compression.request_min_bytes == 4096, "Default request compression threshold");
+    
+    // Verify name resolution defaults
+    TEST_ASSERT(config->http.dns.cache_ttl_seconds == 60, "Default DNS cache lifetime");
+    TEST_ASSERT(config->http.dns.resolve_count == 0, "Default no static resolve entries");
+    TEST_ASSERT(strcmp(config->http.dns.ip_version, "any") == 0, "Default IP version");
+    TEST_ASSERT(config->http.dns.happy_eyeballs_timeout_ms == 0, "Default happy eyeballs timeout");
+    
+    // Verify TLS session defaults
+    TEST_ASSERT(config->http.tls.session_cache == true, "Default TLS session sharing enabled");
+    TEST_ASSERT(config->http.tls.persist_sessions == false, "Default TLS session persistence disabled");
+    TEST_ASSERT(strcmp(config->http.tls.session_file, SGNL_DEFAULT_TLS_SESSION_FILE) == 0, "Default TLS session file");
+    TEST_ASSERT(config->http.tls.early_data == false, "Default TLS early data disabled");
+    
+    // Verify hedging defaults
+    TEST_ASSERT(config->http.hedging.enabled == false, "Default hedging disabled");
+    TEST_ASSERT(config->http.hedging.percentile == 95, "Default hedging percentile");
+    TEST_ASSERT(config->http.hedging.initial_delay_ms == 250, "Default hedging initial delay");
+    TEST_ASSERT(config->http.hedging.min_delay_ms == 20, "Default hedging minimum delay");
+    
+    // Verify cache defaults
+    TEST_ASSERT(config->cache.enabled == false, "Default cache disabled");
+    TEST_ASSERT(config->cache.positive_ttl_seconds == 30, "Default cache positive TTL");
+    TEST_ASSERT(config->cache.negative_ttl_seconds == 5, "Default cache negative TTL");
+    
+    // Verify broker defaults
+    TEST_ASSERT(config->broker.enabled == false, "Default broker disabled");
+    TEST_ASSERT(strcmp(config->broker.socket_path, SGNL_DEFAULT_BROKER_SOCKET) == 0, "Default broker socket path");
+    TEST_ASSERT(config->broker.timeout_ms == 250, "Default broker timeout");
+    
+    // Verify offline store defaults
+    TEST_ASSERT(config->offline_mode.enabled == false, "Default offline mode disabled");
+    TEST_ASSERT(strcmp(config->offline_mode.store_path, SGNL_DEFAULT_OFFLINE_STORE) == 0, "Default offline store path");
+    TEST_ASSERT(config->offline_mode.grace_period_seconds == 14400, "Default offline grace period");
+    TEST_ASSERT(config->offline_mode.max_entries == 4096, "Default offline store size");
+    
+    // Verify log output defaults
+    TEST_ASSERT(strcmp(config->logging.destination, "stdout") == 0, "Default log destination");
+    TEST_ASSERT(strcmp(config->logging.format, "text") == 0, "Default log format");
+    TEST_ASSERT(config->logging.timestamp == false && config->logging.pid == false, "Default log prefixes off");
+    TEST_ASSERT(strcmp(config->logging.facility, "local0") == 0, "Default syslog facility");
+    TEST_ASSERT(config->logging.async == false, "Default synchronous logging");
+    TEST_ASSERT(config->logging.async_buffer_kb == 256, "Default async log buffer");
+    TEST_ASSERT(strcmp(config->logging.audit, "syslog") == 0, "Default audit destination");
+    
+    // Verify metrics defaults
+    TEST_ASSERT(config->metrics.textfile_path[0] == '\0', "Default metrics export disabled");
+    TEST_ASSERT(config->metrics.interval_seconds == 15, "Default metrics interval");
+    
+    // Verify prefetch defaults
+    TEST_ASSERT(config->prefetch.enabled == false, "Default prefetch disabled");
+    TEST_ASSERT(config->prefetch.interval_seconds == 300, "Default prefetch interval");
+    TEST_ASSERT(strcmp(config->prefetch.action, "sudo") == 0, "Default prefetch action");
+    TEST_ASSERT(config->prefetch.group[0] == '\0', "Default prefetch group empty");
+    TEST_ASSERT(config->prefetch.logged_in_users == true, "Default prefetch of logged-in users");
+    TEST_ASSERT(config->prefetch.max_principals == 256, "Default prefetch principal limit");
+    
     sgnl_config_destroy(config);
     return 0;
 }
@@ -98,10 +177,63 @@ static int test_config_loading(void) {
     TEST_ASSERT(config->http.timeout_seconds == 15, "HTTP timeout loaded");
     TEST_ASSERT(config->http.connect_timeout_seconds == 5, "HTTP connect timeout loaded");
     TEST_ASSERT(strcmp(config->http.user_agent, "SGNL-Test/1.0") == 0, "User agent loaded");
+    TEST_ASSERT(config->http.retry.max_retries == 3, "Max retries loaded");
+    TEST_ASSERT(config->http.retry.base_delay_ms == 20, "Retry base delay loaded");
+    TEST_ASSERT(config->http.retry.max_delay_ms == 200, "Retry max delay loaded");
+    TEST_ASSERT(config->http.retry.budget_ms == 1500, "Retry budget loaded");
+    TEST_ASSERT(sgnl_config_get_timeout_ms(config) == 1500, "Millisecond timeout loaded");
+    TEST_ASSERT(sgnl_config_get_connect_timeout_ms(config) == 750, "Millisecond connect timeout loaded");
+    TEST_ASSERT(sgnl_config_get_deadline_ms(config) == 2500, "Deadline loaded");
+    TEST_ASSERT(config->http.hedging.enabled == true, "Hedging enabled loaded");
+    TEST_ASSERT(sgnl_config_get_batch_max_queries(config) == 50, "Batch queries per request loaded");
+    TEST_ASSERT(sgnl_config_get_batch_max_concurrency(config) == 2, "Batch request concurrency loaded");
+    TEST_ASSERT(sgnl_config_get_compression_response(config) == false, "Response decoding setting loaded");
+    TEST_ASSERT(sgnl_config_get_compression_request(config) == true, "Request compression setting loaded");
+    TEST_ASSERT(sgnl_config_get_compression_request_min_bytes(config) == 1024, "Request compression threshold loaded");
+    TEST_ASSERT(sgnl_config_get_dns_cache_ttl(config) == 300, "DNS cache lifetime loaded");
+    TEST_ASSERT(sgnl_config_get_dns_resolve_count(config) == 2, "Static resolve entries loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_dns_resolve(config, 1), "v6.example.invalid:443:[2001:db8::1]") == 0,
+                "Static resolve entry loaded");
+    TEST_ASSERT(sgnl_config_get_dns_resolve(config, 2) == NULL, "Static resolve index out of range");
+    TEST_ASSERT(strcmp(sgnl_config_get_ip_version(config), "ipv4") == 0, "IP version loaded");
+    TEST_ASSERT(sgnl_config_get_happy_eyeballs_timeout_ms(config) == 100, "Happy eyeballs timeout loaded");
+    TEST_ASSERT(sgnl_config_get_tls_session_cache(config) == true, "TLS session sharing loaded");
+    TEST_ASSERT(sgnl_config_get_tls_persist_sessions(config) == true, "TLS session persistence loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_tls_session_file(config), "/tmp/sgnl-test-tls-sessions") == 0,
+                "TLS session file loaded");
+    TEST_ASSERT(sgnl_config_get_tls_early_data(config) == true, "TLS early data loaded");
+    TEST_ASSERT(config->http.hedging.percentile == 90, "Hedging percentile loaded");
+    TEST_ASSERT(config->http.hedging.initial_delay_ms == 150, "Hedging initial delay loaded");
+    TEST_ASSERT(config->http.hedging.min_delay_ms == 10, "Hedging minimum delay loaded");
     TEST_ASSERT(config->sudo.access_msg == true, "Sudo access message loaded");
     TEST_ASSERT(strcmp(config->sudo.command_attribute, "name") == 0, "Command attribute loaded");
     TEST_ASSERT(config->logging.debug_mode == true, "Debug mode loaded");
     TEST_ASSERT(strcmp(config->logging.log_level, "debug") == 0, "Log level loaded");
+    TEST_ASSERT(config->cache.enabled == true, "Cache enabled loaded");
+    TEST_ASSERT(config->cache.positive_ttl_seconds == 60, "Cache positive TTL loaded");
+    TEST_ASSERT(config->cache.negative_ttl_seconds == 10, "Cache negative TTL loaded");
+    TEST_ASSERT(config->cache.max_entries == 256, "Cache max entries loaded");
+    TEST_ASSERT(config->offline_mode.enabled == false, "Offline mode flag loaded");
+    TEST_ASSERT(strcmp(config->offline_mode.store_path, "/tmp/sgnl-test-offline.db") == 0, "Offline store path loaded");
+    TEST_ASSERT(config->offline_mode.grace_period_seconds == 600, "Offline grace period loaded");
+    TEST_ASSERT(config->offline_mode.max_entries == 64, "Offline store size loaded");
+    TEST_ASSERT(config->prefetch.interval_seconds == 120, "Prefetch interval loaded");
+    TEST_ASSERT(strcmp(config->prefetch.action, "login") == 0, "Prefetch action loaded");
+    TEST_ASSERT(strcmp(config->prefetch.group, "wheel") == 0, "Prefetch group loaded");
+    TEST_ASSERT(config->prefetch.logged_in_users == false, "Prefetch logged-in users flag loaded");
+    TEST_ASSERT(config->prefetch.max_principals == 32, "Prefetch principal limit loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_metrics_textfile_path(config), "/tmp/sgnl-test-metrics.prom") == 0,
+                "Metrics textfile path loaded");
+    TEST_ASSERT(sgnl_config_get_metrics_interval(config) == 30, "Metrics interval loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_log_level(config), "debug") == 0, "Log level accessor");
+    TEST_ASSERT(strcmp(sgnl_config_get_log_destination(config), "stdout") == 0, "Log destination loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_log_format(config), "text") == 0, "Log format loaded");
+    TEST_ASSERT(sgnl_config_get_log_timestamp(config) == true, "Log timestamp loaded");
+    TEST_ASSERT(sgnl_config_get_log_pid(config) == true, "Log PID loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_log_facility(config), "authpriv") == 0, "Syslog facility loaded");
+    TEST_ASSERT(sgnl_config_get_log_async(config) == false, "Async logging flag loaded");
+    TEST_ASSERT(sgnl_config_get_log_async_buffer_kb(config) == 64, "Async log buffer loaded");
+    TEST_ASSERT(strcmp(sgnl_config_get_log_audit(config), "stderr") == 0, "Audit destination loaded");
     
     sgnl_config_destroy(config);
     
@@ -141,6 +273,180 @@ static int test_config_validation(void) {
     result = sgnl_config_validate(config);
     TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Invalid connect timeout validation fails");
     
+    // Test invalid millisecond timeouts
+    config->http.connect_timeout_seconds = 5;
+    config->http.timeout_ms = -1;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Negative millisecond timeout validation fails");
+    
+    config->http.timeout_ms = 0;
+    config->http.deadline_ms = 300001;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Too long deadline validation fails");
+    config->http.deadline_ms = 0;
+    
+    // Test invalid retry settings
+    config->http.retry.max_retries = 11;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Too many retries validation fails");
+    
+    config->http.retry.max_retries = 2;
+    config->http.retry.max_delay_ms = config->http.retry.base_delay_ms - 1;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Retry max delay below base validation fails");
+    config->http.retry.max_delay_ms = 2000;
+    
+    // Test invalid batch splitting
+    config->http.batch.max_queries = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Zero batch queries per request validation fails");
+    
+    config->http.batch.max_queries = 100;
+    config->http.batch.max_concurrency = 17;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Too many concurrent batch requests validation fails");
+    config->http.batch.max_concurrency = 4;
+    
+    // Test invalid compression threshold
+    config->http.compression.request_min_bytes = -1;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Negative compression threshold validation fails");
+    config->http.compression.request_min_bytes = 4096;
+    
+    // Test invalid name resolution settings
+    strcpy(config->http.dns.ip_version, "ipv5");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Unknown IP version validation fails");
+    strcpy(config->http.dns.ip_version, "any");
+    
+    config->http.dns.resolve_count = 1;
+    strcpy(config->http.dns.resolve[0], "api.example.com:443");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Resolve entry without address validation fails");
+    strcpy(config->http.dns.resolve[0], "api.example.com:443:192.0.2.1");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_OK, "Resolve entry validation passes");
+    config->http.dns.resolve_count = 0;
+    
+    config->http.dns.cache_ttl_seconds = -2;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Invalid DNS cache lifetime validation fails");
+    config->http.dns.cache_ttl_seconds = 60;
+    
+    // Test invalid TLS session file
+    config->http.tls.persist_sessions = true;
+    strcpy(config->http.tls.session_file, "relative/sessions");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Relative TLS session file validation fails");
+    config->http.tls.persist_sessions = false;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_OK, "Unused TLS session file is not validated");
+    strcpy(config->http.tls.session_file, SGNL_DEFAULT_TLS_SESSION_FILE);
+    
+    // Test invalid log output settings
+    strcpy(config->logging.destination, "stderr");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Unknown log destination validation fails");
+    strcpy(config->logging.destination, "journald");
+    strcpy(config->logging.format, "xml");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Unknown log format validation fails");
+    strcpy(config->logging.format, "json");
+    strcpy(config->logging.facility, "local9");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Unknown syslog facility validation fails");
+    strcpy(config->logging.facility, "authpriv");
+    config->logging.async_buffer_kb = 4;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Tiny async log buffer validation fails");
+    config->logging.async_buffer_kb = 256;
+    strcpy(config->logging.audit, "file");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Unknown audit destination validation fails");
+    strcpy(config->logging.audit, "none");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_OK, "Log output validation passes");
+    strcpy(config->logging.audit, "syslog");
+    strcpy(config->logging.destination, "stdout");
+    strcpy(config->logging.format, "text");
+    
+    // Test invalid metrics settings
+    strcpy(config->metrics.textfile_path, "sgnl.prom");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Relative metrics path validation fails");
+    strcpy(config->metrics.textfile_path, "/var/lib/node_exporter/sgnl.prom");
+    config->metrics.interval_seconds = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Zero metrics interval validation fails");
+    config->metrics.interval_seconds = 15;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_OK, "Metrics settings validation passes");
+    config->metrics.textfile_path[0] = '\0';
+    
+    // Test invalid hedging settings
+    config->http.hedging.enabled = true;
+    config->http.hedging.percentile = 40;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Hedging percentile below 50 validation fails");
+    
+    config->http.hedging.percentile = 95;
+    config->http.hedging.min_delay_ms = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Zero hedging minimum delay validation fails");
+    config->http.hedging.min_delay_ms = 20;
+    config->http.hedging.enabled = false;
+    
+    // Test invalid cache settings
+    config->cache.enabled = true;
+    config->cache.max_entries = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Invalid cache size validation fails");
+    
+    // Test invalid broker settings
+    config->cache.enabled = false;
+    config->broker.enabled = true;
+    config->broker.timeout_ms = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Invalid broker timeout validation fails");
+    
+    config->broker.timeout_ms = 250;
+    config->broker.socket_path[0] = '\0';
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Empty broker socket path validation fails");
+    
+    // Test invalid offline store settings
+    strcpy(config->broker.socket_path, SGNL_DEFAULT_BROKER_SOCKET);
+    config->broker.enabled = false;
+    config->offline_mode.enabled = true;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_OK, "Default offline settings validate");
+    
+    config->offline_mode.grace_period_seconds = 0;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Zero offline grace period validation fails");
+    
+    config->offline_mode.grace_period_seconds = 604801;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Offline grace period over a week validation fails");
+    
+    config->offline_mode.grace_period_seconds = 3600;
+    strcpy(config->offline_mode.store_path, "offline.db");
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Relative offline store path validation fails");
+    
+    // Test invalid prefetch settings
+    strcpy(config->offline_mode.store_path, SGNL_DEFAULT_OFFLINE_STORE);
+    config->offline_mode.enabled = false;
+    config->prefetch.enabled = true;
+    config->prefetch.interval_seconds = 5;
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Too short prefetch interval validation fails");
+    
+    config->prefetch.interval_seconds = 300;
+    config->prefetch.action[0] = '\0';
+    result = sgnl_config_validate(config);
+    TEST_ASSERT(result == SGNL_CONFIG_INVALID_VALUE, "Empty prefetch action validation fails");
+    
     sgnl_config_destroy(config);
     return 0;
 }
@@ -244,6 +550,68 @@ static int test_non_strict_validation(void) {
     return 0;
 }
 
+// Write a minimal config with the given token
+static int write_token_config(const char *path, const char *token) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return -1;
+    }
+    fprintf(fp, "{\"tenant\": \"test\", \"api_url\": \"sgnlapis.cloud\", \"api_token\": \"%s\"}\n", token);
+    return fclose(fp);
+}
+
+// Test that repeated loads reuse the parse only while the file is unchanged
+static int test_config_load_cache(void) {
+    TEST_SECTION("Configuration Load Cache");
+    
+    char path[64];
+    char replacement[80];
+    snprintf(path, sizeof(path), "/tmp/sgnl-config-test-%d.json", (int)getpid());
+    snprintf(replacement, sizeof(replacement), "%s.new", path);
+    TEST_ASSERT(write_token_config(path, "token-one") == 0, "Temporary config written");
+    
+    sgnl_config_options_t options = SGNL_CONFIG_DEFAULT_OPTIONS;
+    options.config_path = path;
+    options.module_name = "test-module";
+    
+    sgnl_config_t *first = sgnl_config_create();
+    sgnl_config_t *second = sgnl_config_create();
+    TEST_ASSERT(first != NULL && second != NULL, "Configuration creation");
+    
+    TEST_ASSERT(sgnl_config_load(first, &options) == SGNL_CONFIG_OK, "First load succeeds");
+    options.module_name = "other-module";
+    TEST_ASSERT(sgnl_config_load(second, &options) == SGNL_CONFIG_OK, "Repeated load succeeds");
+    TEST_ASSERT(strcmp(sgnl_config_get_api_token(second), "token-one") == 0, "Repeated load sees the same values");
+    TEST_ASSERT(second->initialized, "Repeated load marks configuration initialized");
+    
+    // The cached copy, token included, is handed out once; later loads parse again
+    sgnl_config_t *third = sgnl_config_create();
+    TEST_ASSERT(third != NULL && sgnl_config_load(third, &options) == SGNL_CONFIG_OK, "Load after reuse succeeds");
+    TEST_ASSERT(strcmp(sgnl_config_get_api_token(third), "token-one") == 0, "Load after reuse reads the token");
+    sgnl_config_destroy(third);
+    
+    // Rewritten in place with a different size
+    TEST_ASSERT(write_token_config(path, "token-two-longer") == 0, "Config rewritten");
+    TEST_ASSERT(sgnl_config_load(second, &options) == SGNL_CONFIG_OK, "Load after rewrite succeeds");
+    TEST_ASSERT(strcmp(sgnl_config_get_api_token(second), "token-two-longer") == 0, "Rewritten file is parsed again");
+    
+    // Replaced by rename with the same size (new inode)
+    TEST_ASSERT(write_token_config(replacement, "token-3-longer!!") == 0, "Replacement config written");
+    TEST_ASSERT(rename(replacement, path) == 0, "Config replaced");
+    TEST_ASSERT(sgnl_config_load(second, &options) == SGNL_CONFIG_OK, "Load after replace succeeds");
+    TEST_ASSERT(strcmp(sgnl_config_get_api_token(second), "token-3-longer!!") == 0, "Replaced file is parsed again");
+    
+    // A removed file is reported even though it was cached
+    unlink(path);
+    TEST_ASSERT(sgnl_config_load(second, &options) == SGNL_CONFIG_FILE_NOT_FOUND, "Removed file is not served from cache");
+    
+    sgnl_config_cache_clear();
+    sgnl_config_destroy(first);
+    sgnl_config_destroy(second);
+    
+    return 0;
+}
+
 #ifdef SGNL_TEST_RUNNER
 int test_config_main(void)
 #else
@@ -259,6 +627,7 @@ static int test_config_main(void)
     failures += test_config_errors();
     failures += test_result_codes();
     failures += test_non_strict_validation();
+    failures += test_config_load_cache();
     printf("\n📊 Test Summary\n");
     printf("==============\n");
     if (failures == 0) {
@@ -5,11 +5,35 @@
  */
 
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <zlib.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
 #include "../lib/libsgnl.h"
+#include "../lib/decision_cache.h"
+#include "../lib/broker.h"
+#include "../lib/arena.h"
+#include "../lib/json_writer.h"
+#include "../lib/json_stream.h"
+#include "../lib/offline_store.h"
+#include "../lib/tls_session_store.h"
+#include "../lib/snapshot.h"
+#include "../lib/stats.h"
+#include "../lib/hedge.h"
+#include "../lib/compress.h"
 #include "../common/config.h"
 #include "../common/logging.h"
 
@@ -318,6 +342,1656 @@ static int test_batch_access_evaluation(void) {
     return 0;
 }
 
+// Test that one client can serve repeated requests on its persistent transport
+static int test_connection_reuse(void) {
+    TEST_SECTION("Connection Reuse");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .timeout_seconds = 30,
+        .retry_count = 0,
+        .retry_delay_ms = 0,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .user_agent = "SGNL-Test/1.0"
+    };
+    
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    // Both requests go through the same handle; a failed transfer must not
+    // leave it unusable for the next one
+    sgnl_result_t first = sgnl_check_access(client, "test-user", "asset1", "execute");
+    sgnl_result_t second = sgnl_check_access(client, "test-user", "asset2", "execute");
+    TEST_ASSERT(first == SGNL_NETWORK_ERROR || first == SGNL_ERROR, "First request on handle completes");
+    TEST_ASSERT(second == first, "Second request on reused handle behaves the same");
+    
+    // Warming up an unreachable API reports it and leaves the client usable
+    sgnl_result_t warm = sgnl_client_warm_up(client);
+    TEST_ASSERT(warm == SGNL_NETWORK_ERROR || warm == SGNL_TIMEOUT_ERROR, "Warm-up reports unreachable API");
+    TEST_ASSERT(sgnl_check_access(client, "test-user", "asset1", "execute") == first, "Requests unaffected by warm-up");
+    TEST_ASSERT(sgnl_client_warm_up(NULL) == SGNL_ERROR, "Warm-up rejects NULL client");
+    
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Test that switching principals on one client rebuilds the cached principal payload
+static int test_principal_switch(void) {
+    TEST_SECTION("Principal Switch");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .timeout_seconds = 30,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .user_agent = "SGNL-Test/1.0"
+    };
+    
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    char long_principal[400];
+    memset(long_principal, 'p', sizeof(long_principal) - 1);
+    long_principal[sizeof(long_principal) - 1] = '\0';
+    
+    const char *asset_ids[] = {"asset1", "asset2"};
+    sgnl_result_t first = sgnl_check_access(client, "alice", "asset1", "execute");
+    sgnl_result_t second = sgnl_check_access(client, "bob", "asset1", "execute");
+    sgnl_result_t third = sgnl_check_access(client, long_principal, "asset1", "execute");
+    sgnl_access_result_t **batch = sgnl_evaluate_access_batch(client, "alice", asset_ids, NULL, 2);
+    
+    TEST_ASSERT(first == SGNL_NETWORK_ERROR || first == SGNL_ERROR, "First principal request completes");
+    TEST_ASSERT(second == first, "Second principal behaves the same");
+    TEST_ASSERT(third == first, "Over-long principal behaves the same");
+    
+    if (batch) {
+        sgnl_access_result_array_free(batch, 2);
+    }
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Concurrent evaluations on one shared client
+#define CONCURRENT_THREADS 8
+#define CONCURRENT_REQUESTS 4
+
+typedef struct {
+    sgnl_client_t *client;
+    int index;
+    sgnl_result_t results[CONCURRENT_REQUESTS];
+    char request_ids[CONCURRENT_REQUESTS][64];
+    bool error_recorded;
+} concurrent_worker_t;
+
+static void* concurrent_worker(void *arg) {
+    concurrent_worker_t *worker = (concurrent_worker_t *)arg;
+    char principal[32];
+    snprintf(principal, sizeof(principal), "user-%d", worker->index);
+    
+    for (int i = 0; i < CONCURRENT_REQUESTS; i++) {
+        sgnl_access_result_t *result = sgnl_evaluate_access(worker->client, principal, "asset1", "execute");
+        worker->results[i] = result ? result->result : SGNL_MEMORY_ERROR;
+        if (result) {
+            snprintf(worker->request_ids[i], sizeof(worker->request_ids[i]), "%s", result->request_id);
+        }
+        sgnl_access_result_free(result);
+    }
+    
+    const char *error = sgnl_client_get_last_error(worker->client);
+    worker->error_recorded = error != NULL;
+    return NULL;
+}
+
+static int test_concurrent_evaluations(void) {
+    TEST_SECTION("Concurrent Evaluations");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .timeout_seconds = 30,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .user_agent = "SGNL-Test/1.0"
+    };
+    
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    concurrent_worker_t workers[CONCURRENT_THREADS];
+    pthread_t threads[CONCURRENT_THREADS];
+    int started = 0;
+    for (int i = 0; i < CONCURRENT_THREADS; i++) {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].client = client;
+        workers[i].index = i;
+        if (pthread_create(&threads[i], NULL, concurrent_worker, &workers[i]) == 0) {
+            started++;
+        }
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    TEST_ASSERT(started == CONCURRENT_THREADS, "All worker threads started");
+    
+    bool consistent = true;
+    bool unique = true;
+    for (int t = 0; t < CONCURRENT_THREADS; t++) {
+        for (int i = 0; i < CONCURRENT_REQUESTS; i++) {
+            if (workers[t].results[i] != workers[0].results[0] || workers[t].request_ids[i][0] == '\0') {
+                consistent = false;
+            }
+            for (int u = 0; u <= t; u++) {
+                for (int j = 0; j < CONCURRENT_REQUESTS; j++) {
+                    if ((u != t || j != i) && strcmp(workers[t].request_ids[i], workers[u].request_ids[j]) == 0) {
+                        unique = false;
+                    }
+                }
+            }
+        }
+        if (!workers[t].error_recorded) {
+            consistent = false;
+        }
+    }
+    TEST_ASSERT(workers[0].results[0] == SGNL_NETWORK_ERROR || workers[0].results[0] == SGNL_ERROR,
+                "Concurrent requests complete");
+    TEST_ASSERT(consistent, "Every thread sees the same outcome and its own error");
+    TEST_ASSERT(unique, "Concurrent request IDs are unique");
+    
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Async completion tracking shared with the worker thread
+#define ASYNC_REQUESTS 16
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    int completed;
+    int duplicates;
+    bool seen[ASYNC_REQUESTS];
+    sgnl_result_t results[ASYNC_REQUESTS];
+} async_tracker_t;
+
+typedef struct {
+    async_tracker_t *tracker;
+    int index;
+} async_slot_t;
+
+static void async_test_callback(sgnl_access_result_t *result, void *user_data) {
+    async_slot_t *slot = (async_slot_t *)user_data;
+    async_tracker_t *tracker = slot->tracker;
+    
+    pthread_mutex_lock(&tracker->lock);
+    if (tracker->seen[slot->index]) {
+        tracker->duplicates++;
+    }
+    tracker->seen[slot->index] = true;
+    tracker->results[slot->index] = result ? result->result : SGNL_MEMORY_ERROR;
+    tracker->completed++;
+    pthread_cond_signal(&tracker->done);
+    pthread_mutex_unlock(&tracker->lock);
+    
+    sgnl_access_result_free(result);
+}
+
+// Test asynchronous evaluation: every accepted request completes exactly once
+static int test_async_evaluation(void) {
+    TEST_SECTION("Asynchronous Evaluation");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .timeout_seconds = 30,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .user_agent = "SGNL-Test/1.0"
+    };
+    
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    async_tracker_t tracker = {0};
+    pthread_mutex_init(&tracker.lock, NULL);
+    pthread_cond_init(&tracker.done, NULL);
+    async_slot_t slots[ASYNC_REQUESTS];
+    
+    TEST_ASSERT(sgnl_evaluate_access_async(client, "test-user", "asset1", NULL, NULL, NULL) == SGNL_INVALID_REQUEST,
+                "NULL callback rejected");
+    TEST_ASSERT(sgnl_evaluate_access_async(NULL, "test-user", "asset1", NULL, async_test_callback, &slots[0]) == SGNL_INVALID_REQUEST,
+                "NULL client rejected");
+    
+    int accepted = 0;
+    for (int i = 0; i < ASYNC_REQUESTS; i++) {
+        slots[i].tracker = &tracker;
+        slots[i].index = i;
+        if (sgnl_evaluate_access_async(client, "test-user", i % 2 ? "asset1" : "asset2", "execute",
+                                       async_test_callback, &slots[i]) == SGNL_OK) {
+            accepted++;
+        }
+    }
+    TEST_ASSERT(accepted == ASYNC_REQUESTS, "All async evaluations accepted");
+    
+    // Wait (bounded) for the worker to finish them
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 60;
+    pthread_mutex_lock(&tracker.lock);
+    while (tracker.completed < accepted) {
+        if (pthread_cond_timedwait(&tracker.done, &tracker.lock, &deadline) != 0) {
+            break;
+        }
+    }
+    int completed = tracker.completed;
+    pthread_mutex_unlock(&tracker.lock);
+    
+    TEST_ASSERT(completed == accepted, "Every async evaluation completed");
+    TEST_ASSERT(tracker.duplicates == 0, "No async callback ran twice");
+    TEST_ASSERT(tracker.results[0] == SGNL_NETWORK_ERROR || tracker.results[0] == SGNL_ERROR,
+                "Async evaluation reports the transport failure");
+    
+    // Evaluations still pending at destroy complete during it
+    memset(&tracker.seen, 0, sizeof(tracker.seen));
+    tracker.completed = 0;
+    accepted = 0;
+    for (int i = 0; i < 4; i++) {
+        if (sgnl_evaluate_access_async(client, "test-user", "asset3", "execute",
+                                       async_test_callback, &slots[i]) == SGNL_OK) {
+            accepted++;
+        }
+    }
+    sgnl_client_destroy(client);
+    TEST_ASSERT(tracker.completed == accepted, "Pending async evaluations complete on destroy");
+    TEST_ASSERT(tracker.duplicates == 0, "No callback ran twice on destroy");
+    
+    pthread_cond_destroy(&tracker.done);
+    pthread_mutex_destroy(&tracker.lock);
+    
+    return 0;
+}
+
+// Test that retries of a failing endpoint stay within the retry budget
+static int test_retry_budget(void) {
+    TEST_SECTION("Retry Budget");
+    
+    // Far more retries and backoff than the 1500 ms budget in the test config allows
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .retry_count = 10,
+        .retry_delay_ms = 1000,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sgnl_result_t result = sgnl_check_access(client, "retry-user", "asset1", "execute");
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    
+    TEST_ASSERT(result == SGNL_NETWORK_ERROR || result == SGNL_ERROR, "Unreachable endpoint still fails");
+    TEST_ASSERT(elapsed_ms < 2500, "Retries bounded by budget");
+    
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Test the decision cache directly
+static int test_decision_cache(void) {
+    TEST_SECTION("Decision Cache");
+    
+    sgnl_decision_cache_t *cache = sgnl_decision_cache_create(2, 60, 0);
+    TEST_ASSERT(cache != NULL, "Cache creation");
+    
+    sgnl_result_t result = SGNL_ERROR;
+    char reason[64] = "";
+    TEST_ASSERT(!sgnl_decision_cache_lookup(cache, "alice", "host1", "sudo", &result, NULL, 0), "Empty cache misses");
+    
+    sgnl_decision_cache_store(cache, "alice", "host1", "sudo", SGNL_ALLOWED, "policy-7");
+    TEST_ASSERT(sgnl_decision_cache_lookup(cache, "alice", "host1", "sudo", &result, reason, sizeof(reason)), "Allow decision cached");
+    TEST_ASSERT(result == SGNL_ALLOWED, "Cached result is Allow");
+    TEST_ASSERT(strcmp(reason, "policy-7") == 0, "Cached reason returned");
+    
+    // Negative TTL of zero means Deny is never cached, errors never are
+    sgnl_decision_cache_store(cache, "alice", "host2", "sudo", SGNL_DENIED, NULL);
+    sgnl_decision_cache_store(cache, "alice", "host3", "sudo", SGNL_NETWORK_ERROR, NULL);
+    TEST_ASSERT(sgnl_decision_cache_count(cache) == 1, "Deny and errors not cached");
+    
+    // Bounded: third entry evicts the oldest
+    sgnl_decision_cache_store(cache, "bob", "host1", "sudo", SGNL_ALLOWED, NULL);
+    sgnl_decision_cache_store(cache, "bob", "host2", "sudo", SGNL_ALLOWED, NULL);
+    TEST_ASSERT(sgnl_decision_cache_count(cache) == 2, "Cache stays within bound");
+    TEST_ASSERT(!sgnl_decision_cache_lookup(cache, "alice", "host1", "sudo", &result, NULL, 0), "Oldest entry evicted");
+    
+    // Wildcard invalidation by principal
+    TEST_ASSERT(sgnl_decision_cache_invalidate(cache, "bob", NULL, NULL) == 2, "Principal invalidation removes all entries");
+    
+    sgnl_decision_cache_store(cache, "carol", NULL, "execute", SGNL_ALLOWED, NULL);
+    TEST_ASSERT(sgnl_decision_cache_lookup(cache, "carol", NULL, "execute", &result, NULL, 0), "NULL asset key cached");
+    sgnl_decision_cache_flush(cache);
+    TEST_ASSERT(sgnl_decision_cache_count(cache) == 0, "Flush empties cache");
+    
+    sgnl_decision_cache_destroy(cache);
+    
+    // Client-level API
+    TEST_ASSERT(sgnl_client_cache_flush(NULL) == SGNL_ERROR, "NULL client flush fails");
+    TEST_ASSERT(sgnl_client_cache_invalidate(NULL, "alice", NULL, NULL) == SGNL_ERROR, "NULL client invalidate fails");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with cache enabled");
+    TEST_ASSERT(sgnl_client_cache_invalidate(client, "alice", "host1", "sudo") == SGNL_OK, "Client invalidate succeeds");
+    TEST_ASSERT(sgnl_client_cache_invalidate(client, NULL, NULL, NULL) == SGNL_ERROR, "Invalidate requires principal");
+    TEST_ASSERT(sgnl_client_cache_flush(client) == SGNL_OK, "Client flush succeeds");
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Test the offline decision store and its use when the API is unreachable
+static int test_offline_store(void) {
+    TEST_SECTION("Offline Decision Store");
+    
+    char store_path[128];
+    snprintf(store_path, sizeof(store_path), "/tmp/sgnl-offline-test-%d.db", (int)getpid());
+    unlink(store_path);
+    
+    sgnl_offline_store_t *store = sgnl_offline_store_open(store_path, 64, 3600, "offline-token");
+    TEST_ASSERT(store != NULL, "Store creation");
+    struct stat st;
+    TEST_ASSERT(stat(store_path, &st) == 0 && (st.st_mode & 0777) == 0600, "Store file is private");
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host1", "sudo", NULL), "Empty store misses");
+    
+    sgnl_offline_store_record(store, "alice", "host1", "sudo", SGNL_ALLOWED);
+    sgnl_offline_store_record(store, "alice", "host2", "sudo", SGNL_ALLOWED);
+    sgnl_offline_store_record(store, "alice", "host3", "sudo", SGNL_NETWORK_ERROR);
+    int64_t age = -1;
+    TEST_ASSERT(sgnl_offline_store_lookup(store, "alice", "host1", "sudo", &age), "Allow decision stored");
+    TEST_ASSERT(age >= 0 && age < 5, "Stored decision age reported");
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host1", "login", NULL), "Key includes action");
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host3", "sudo", NULL), "Errors not stored");
+    
+    // A fresh Deny revokes the stored Allow
+    sgnl_offline_store_record(store, "alice", "host2", "sudo", SGNL_DENIED);
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host2", "sudo", NULL), "Deny removes stored Allow");
+    sgnl_offline_store_close(store);
+    
+    // Decisions persist across processes
+    store = sgnl_offline_store_open(store_path, 64, 3600, "offline-token");
+    TEST_ASSERT(store != NULL, "Store reopened");
+    TEST_ASSERT(sgnl_offline_store_lookup(store, "alice", "host1", "sudo", NULL), "Decision survives reopen");
+    sgnl_offline_store_close(store);
+    
+    // Tampering with an entry invalidates it
+    FILE *file = fopen(store_path, "r+b");
+    TEST_ASSERT(file != NULL, "Store file opened for tampering");
+    unsigned char *contents = malloc((size_t)st.st_size);
+    TEST_ASSERT(contents != NULL && fread(contents, 1, (size_t)st.st_size, file) == (size_t)st.st_size, "Store file read");
+    for (long i = 64; i < (long)st.st_size; i++) {
+        contents[i] ^= contents[i] ? 0x01 : 0x00;
+    }
+    rewind(file);
+    fwrite(contents, 1, (size_t)st.st_size, file);
+    fclose(file);
+    free(contents);
+    store = sgnl_offline_store_open(store_path, 64, 3600, "offline-token");
+    TEST_ASSERT(store != NULL, "Tampered store opened");
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host1", "sudo", NULL), "Tampered entry rejected");
+    sgnl_offline_store_record(store, "alice", "host1", "sudo", SGNL_ALLOWED);
+    sgnl_offline_store_close(store);
+    
+    // A store written under another token is never trusted
+    store = sgnl_offline_store_open(store_path, 64, 3600, "rotated-token");
+    TEST_ASSERT(store != NULL, "Store opened with another key");
+    TEST_ASSERT(!sgnl_offline_store_lookup(store, "alice", "host1", "sudo", NULL), "Other key's entries rejected");
+    sgnl_offline_store_close(store);
+    
+    // Client falls back to the store only while the API is unreachable
+    char config_path[128];
+    snprintf(config_path, sizeof(config_path), "/tmp/sgnl-offline-test-%d.json", (int)getpid());
+    file = fopen(config_path, "w");
+    TEST_ASSERT(file != NULL, "Offline config written");
+    fprintf(file,
+            "{\"api_url\": \"localhost:1\", \"api_token\": \"offline-token\", \"tenant\": \"sgnl-offline-test\",\n"
+            " \"http\": {\"timeout\": 2, \"connect_timeout\": 1, \"retry\": {\"max_retries\": 0}},\n"
+            " \"offline_mode\": {\"enabled\": true, \"store_path\": \"%s\", \"grace_period_seconds\": 3600}}\n",
+            store_path);
+    fclose(file);
+    
+    store = sgnl_offline_store_open(store_path, 64, 3600, "offline-token");
+    TEST_ASSERT(store != NULL, "Store opened with client key");
+    sgnl_offline_store_record(store, "bob", "host1", "sudo", SGNL_ALLOWED);
+    sgnl_offline_store_record(store, "bob", "host2", "sudo", SGNL_ALLOWED);
+    sgnl_offline_store_close(store);
+    
+    sgnl_client_config_t config = {
+        .config_path = config_path,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with offline mode");
+    
+    sgnl_access_result_t *result = sgnl_evaluate_access(client, "bob", "host1", "sudo");
+    TEST_ASSERT(result != NULL && result->result == SGNL_ALLOWED, "Stored Allow served while unreachable");
+    TEST_ASSERT(strncmp(result->reason, "Offline", 7) == 0, "Offline decision is labelled");
+    sgnl_access_result_free(result);
+    TEST_ASSERT(sgnl_check_access(client, "bob", "host9", "sudo") != SGNL_ALLOWED, "Unknown query still fails closed");
+    
+    const char *assets[2] = {"host1", "host2"};
+    const char *actions[2] = {"sudo", "sudo"};
+    sgnl_access_result_t **batch = sgnl_evaluate_access_batch(client, "bob", assets, actions, 2);
+    TEST_ASSERT(batch != NULL && batch[0]->result == SGNL_ALLOWED && batch[1]->result == SGNL_ALLOWED,
+                "Batch served from offline store");
+    sgnl_access_result_array_free(batch, 2);
+    
+    const char *mixed[2] = {"host1", "host9"};
+    batch = sgnl_evaluate_access_batch(client, "bob", mixed, actions, 2);
+    TEST_ASSERT(batch == NULL, "Batch with an unknown query fails closed");
+    
+    sgnl_client_destroy(client);
+    unlink(config_path);
+    unlink(store_path);
+    sgnl_config_cache_clear();
+    
+    return 0;
+}
+
+static int test_tls_session_store(void) {
+    TEST_SECTION("TLS Session Store");
+    
+    sgnl_tls_session_store_t *store = sgnl_tls_session_store_create();
+    TEST_ASSERT(store != NULL, "Store creation");
+    
+    int64_t later = (int64_t)time(NULL) + 3600;
+    unsigned char shmac[32];
+    unsigned char data[64];
+    memset(data, 0xab, sizeof(data));
+    for (int i = 0; i < SGNL_TLS_SESSION_MAX; i++) {
+        memset(shmac, i, sizeof(shmac));
+        TEST_ASSERT(sgnl_tls_session_store_add(store, shmac, sizeof(shmac), data, sizeof(data), later + i),
+                    "Session added");
+    }
+    TEST_ASSERT(sgnl_tls_session_store_count(store) == SGNL_TLS_SESSION_MAX, "Store filled");
+    TEST_ASSERT(!sgnl_tls_session_store_add(store, shmac, sizeof(shmac), data, sizeof(data), 1), "Expired session rejected");
+    TEST_ASSERT(!sgnl_tls_session_store_add(store, shmac, 0, data, sizeof(data), later), "Empty session rejected");
+    
+    // Same peer replaces its ticket; a new peer evicts the session expiring first
+    TEST_ASSERT(sgnl_tls_session_store_add(store, shmac, sizeof(shmac), data, 16, later + 50), "Ticket replaced");
+    TEST_ASSERT(sgnl_tls_session_store_count(store) == SGNL_TLS_SESSION_MAX, "Replacement keeps count");
+    memset(shmac, 0xff, sizeof(shmac));
+    TEST_ASSERT(sgnl_tls_session_store_add(store, shmac, sizeof(shmac), data, sizeof(data), later + 100), "Full store accepts");
+    const unsigned char *got_shmac;
+    const unsigned char *got_data;
+    size_t got_shmac_len;
+    size_t got_data_len;
+    bool first_evicted = true;
+    bool replaced_kept = false;
+    for (size_t i = 0; i < sgnl_tls_session_store_count(store); i++) {
+        TEST_ASSERT(sgnl_tls_session_store_get(store, i, &got_shmac, &got_shmac_len, &got_data, &got_data_len), "Session read");
+        first_evicted = first_evicted && got_shmac[0] != 0;
+        replaced_kept = replaced_kept || (got_shmac[0] == SGNL_TLS_SESSION_MAX - 1 && got_data_len == 16);
+    }
+    TEST_ASSERT(first_evicted && replaced_kept, "Earliest expiry evicted");
+    TEST_ASSERT(!sgnl_tls_session_store_get(store, SGNL_TLS_SESSION_MAX, &got_shmac, &got_shmac_len, &got_data, &got_data_len),
+                "Out of range index rejected");
+    
+    sgnl_tls_session_store_t *copy = sgnl_tls_session_store_create();
+    TEST_ASSERT(sgnl_tls_session_store_copy(copy, store) && sgnl_tls_session_store_count(copy) == SGNL_TLS_SESSION_MAX,
+                "Store copied");
+    sgnl_tls_session_store_free(copy);
+    
+    // Sessions survive a save and load through a private file
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/sgnl-tls-test-%d/sessions", (int)getpid());
+    TEST_ASSERT(sgnl_tls_session_store_save(store, path), "Sessions saved");
+    struct stat st;
+    TEST_ASSERT(stat(path, &st) == 0 && (st.st_mode & 0777) == 0600, "Session file is private");
+    sgnl_tls_session_store_t *loaded = sgnl_tls_session_store_create();
+    TEST_ASSERT(sgnl_tls_session_store_load(loaded, path) == SGNL_TLS_SESSION_MAX, "Sessions loaded");
+    TEST_ASSERT(sgnl_tls_session_store_get(loaded, 0, &got_shmac, &got_shmac_len, &got_data, &got_data_len) &&
+                got_shmac_len == sizeof(shmac) && got_data[0] == 0xab, "Loaded session intact");
+    sgnl_tls_session_store_free(loaded);
+    
+    // A file others can read is never trusted
+    chmod(path, 0644);
+    loaded = sgnl_tls_session_store_create();
+    TEST_ASSERT(sgnl_tls_session_store_load(loaded, path) == 0, "Readable session file ignored");
+    sgnl_tls_session_store_free(loaded);
+    TEST_ASSERT(sgnl_tls_session_store_load(NULL, path) == 0, "NULL store handled");
+    TEST_ASSERT(sgnl_tls_session_store_load(store, "/nonexistent/sessions") == 0, "Missing file handled");
+    
+    unlink(path);
+    *strrchr(path, '/') = '\0';
+    rmdir(path);
+    sgnl_tls_session_store_free(store);
+    
+    return 0;
+}
+
+static int64_t elapsed_ms_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)(now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+// Test latency histograms and the client statistics export
+static int test_client_stats(void) {
+    TEST_SECTION("Client Statistics");
+    
+    static sgnl_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    sgnl_histogram_t *histogram = &stats.phases[SGNL_PHASE_TOTAL];
+    TEST_ASSERT(sgnl_histogram_percentile(histogram, 50) == 0, "Empty histogram reports zero");
+    
+    // 1..10000us uniformly: percentiles within the histogram's 1/32 precision
+    for (uint64_t us = 1; us <= 10000; us++) {
+        sgnl_histogram_record(histogram, us);
+    }
+    uint64_t p50 = sgnl_histogram_percentile(histogram, 50);
+    uint64_t p99 = sgnl_histogram_percentile(histogram, 99);
+    TEST_ASSERT(p50 >= 5000 && p50 <= 5000 + 5000 / 32, "Median within bucket precision");
+    TEST_ASSERT(p99 >= 9900 && p99 <= 9900 + 9900 / 32, "p99 within bucket precision");
+    TEST_ASSERT(sgnl_histogram_percentile(histogram, 100) == 10000, "p100 capped at maximum");
+    sgnl_histogram_record(&stats.phases[SGNL_PHASE_DNS], 7);
+    TEST_ASSERT(sgnl_histogram_percentile(&stats.phases[SGNL_PHASE_DNS], 99.9) == 7, "Small values exact");
+    sgnl_histogram_record(&stats.phases[SGNL_PHASE_DNS], UINT64_MAX);
+    TEST_ASSERT(sgnl_histogram_percentile(&stats.phases[SGNL_PHASE_DNS], 100) == UINT64_MAX, "Huge values recorded");
+    
+    sgnl_stats_add(&stats.cache_hits, 3);
+    sgnl_client_stats_t snapshot;
+    sgnl_stats_snapshot(&stats, &snapshot);
+    TEST_ASSERT(snapshot.cache_hits == 3 && snapshot.requests == 0, "Counters copied");
+    TEST_ASSERT(snapshot.phases[SGNL_PHASE_TOTAL].count == 10000, "Phase count copied");
+    TEST_ASSERT(snapshot.phases[SGNL_PHASE_TOTAL].sum_us == 10000ull * 10001 / 2, "Phase sum copied");
+    TEST_ASSERT(snapshot.phases[SGNL_PHASE_TOTAL].p50_us == p50, "Phase percentiles summarized");
+    TEST_ASSERT(strcmp(sgnl_phase_to_string(SGNL_PHASE_FIRST_BYTE), "first_byte") == 0, "Phase names");
+    
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/sgnl-metrics-test-%d.prom", (int)getpid());
+    TEST_ASSERT(sgnl_stats_write_prometheus(&snapshot, "api\"x", path), "Metrics file written");
+    FILE *file = fopen(path, "r");
+    char text[65536];
+    size_t length = file ? fread(text, 1, sizeof(text) - 1, file) : 0;
+    text[length] = '\0';
+    if (file) {
+        fclose(file);
+    }
+    TEST_ASSERT(strstr(text, "sgnl_cache_hits_total{host=\"api\\\"x\"} 3\n") != NULL, "Counter exported with escaped host");
+    TEST_ASSERT(strstr(text, "sgnl_request_phase_seconds_count{host=\"api\\\"x\",phase=\"total\"} 10000\n") != NULL,
+                "Phase count exported");
+    TEST_ASSERT(strstr(text, "phase=\"total\",quantile=\"0.99\"}") != NULL, "Phase quantiles exported");
+    struct stat st;
+    TEST_ASSERT(stat(path, &st) == 0 && (st.st_mode & 0777) == 0644, "Metrics file readable by scrapers");
+    unlink(path);
+    
+    // Client-level API
+    sgnl_client_stats_t client_stats;
+    TEST_ASSERT(sgnl_client_get_stats(NULL, &client_stats) == SGNL_ERROR, "NULL client stats fails");
+    TEST_ASSERT(sgnl_client_write_metrics(NULL, path) == SGNL_ERROR, "NULL client metrics fails");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation for statistics");
+    TEST_ASSERT(sgnl_client_get_stats(client, &client_stats) == SGNL_OK, "Client stats read");
+    TEST_ASSERT(client_stats.requests == 0 && client_stats.phases[SGNL_PHASE_TOTAL].count == 0, "New client has no requests");
+    TEST_ASSERT(sgnl_client_write_metrics(client, path) == SGNL_OK && access(path, R_OK) == 0, "Client metrics written");
+    TEST_ASSERT(sgnl_client_write_metrics(client, "/nonexistent-dir/sgnl.prom") == SGNL_ERROR, "Unwritable path fails");
+    unlink(path);
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+// Test the query set builder and chunked batches
+static int test_query_set(void) {
+    TEST_SECTION("Query Set and Chunked Batches");
+    
+    sgnl_query_set_t *set = sgnl_query_set_create();
+    TEST_ASSERT(set != NULL, "Query set creation");
+    TEST_ASSERT(sgnl_query_set_add(set, "ls", "sudo") == 0, "First query index");
+    TEST_ASSERT(sgnl_query_set_add(set, "/tmp/a", "sudo:ls") == 1, "Second query index");
+    TEST_ASSERT(sgnl_query_set_add(set, "/tmp/a", "sudo:ls") == 2, "Duplicate query still indexed");
+    TEST_ASSERT(sgnl_query_set_add(set, "/tmp/a", "sudo") == 3, "Same asset, other action");
+    TEST_ASSERT(sgnl_query_set_add(set, NULL, NULL) == 4, "Query without asset");
+    TEST_ASSERT(sgnl_query_set_add(set, NULL, "execute") == 5, "Duplicate query without asset");
+    TEST_ASSERT(sgnl_query_set_count(set) == 6, "All queries counted");
+    TEST_ASSERT(sgnl_query_set_unique_count(set) == 4, "Duplicates folded");
+    TEST_ASSERT(sgnl_query_set_result_index(set, 2) == sgnl_query_set_result_index(set, 1), "Duplicates share a result");
+    TEST_ASSERT(sgnl_query_set_result_index(set, 3) == 2, "Distinct query keeps its own result");
+    TEST_ASSERT(sgnl_query_set_result_index(set, 5) == 3, "NULL action means execute");
+    TEST_ASSERT(sgnl_query_set_result_index(set, 6) == -1, "Out of range index rejected");
+    
+    // Enough distinct queries to grow the table and arena
+    char asset[64];
+    bool added = true;
+    for (int i = 0; i < 5000 && added; i++) {
+        snprintf(asset, sizeof(asset), "/var/log/app/archive-%05d.log.gz", i % 2500);
+        added = sgnl_query_set_add(set, asset, "sudo:rm") >= 0;
+    }
+    TEST_ASSERT(added && sgnl_query_set_unique_count(set) == 2504, "Large argument list folded");
+    snprintf(asset, sizeof(asset), "/var/log/app/archive-%05d.log.gz", 1234);
+    int first = sgnl_query_set_add(set, asset, "sudo:rm");
+    TEST_ASSERT(sgnl_query_set_result_index(set, first) == 4 + 1234, "Lookup after growth");
+    sgnl_query_set_free(set);
+    
+    // A batch over batch.max_queries is split into concurrent requests; the
+    // API is unreachable, so every chunk is answered from the offline store
+    char store_path[128];
+    snprintf(store_path, sizeof(store_path), "/tmp/sgnl-chunk-test-%d.db", (int)getpid());
+    unlink(store_path);
+    char config_path[128];
+    snprintf(config_path, sizeof(config_path), "/tmp/sgnl-chunk-test-%d.json", (int)getpid());
+    FILE *file = fopen(config_path, "w");
+    TEST_ASSERT(file != NULL, "Chunked batch config written");
+    fprintf(file,
+            "{\"api_url\": \"localhost:1\", \"api_token\": \"chunk-token\", \"tenant\": \"sgnl-chunk-test\",\n"
+            " \"http\": {\"timeout\": 2, \"connect_timeout\": 1, \"retry\": {\"max_retries\": 0},\n"
+            "          \"batch\": {\"max_queries\": 3, \"max_concurrency\": 3}},\n"
+            " \"offline_mode\": {\"enabled\": true, \"store_path\": \"%s\", \"grace_period_seconds\": 3600}}\n",
+            store_path);
+    fclose(file);
+    
+    const char *assets[10];
+    char names[10][16];
+    sgnl_offline_store_t *store = sgnl_offline_store_open(store_path, 64, 3600, "chunk-token");
+    TEST_ASSERT(store != NULL, "Chunk test store opened");
+    for (int i = 0; i < 10; i++) {
+        snprintf(names[i], sizeof(names[i]), "file-%d", i);
+        assets[i] = names[i];
+        sgnl_offline_store_record(store, "dave", names[i], "sudo:rm", SGNL_ALLOWED);
+    }
+    sgnl_offline_store_close(store);
+    
+    sgnl_client_config_t config = {
+        .config_path = config_path,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .bypass_broker = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with small batches");
+    
+    set = sgnl_query_set_create();
+    for (int i = 0; i < 20; i++) {
+        sgnl_query_set_add(set, assets[i % 10], "sudo:rm");
+    }
+    sgnl_access_result_t **results = sgnl_evaluate_query_set(client, "dave", set);
+    TEST_ASSERT(results != NULL, "Chunked batch evaluated");
+    bool in_order = results != NULL;
+    for (int i = 0; in_order && i < 10; i++) {
+        in_order = results[i] && results[i]->result == SGNL_ALLOWED && strcmp(results[i]->asset_id, assets[i]) == 0;
+    }
+    TEST_ASSERT(in_order, "Chunk results land in query order");
+    TEST_ASSERT(results && results[sgnl_query_set_result_index(set, 17)] == results[7], "Duplicate maps to original result");
+    sgnl_access_result_array_free(results, sgnl_query_set_unique_count(set));
+    
+    // The same batch as compact results
+    sgnl_result_set_t *compact = sgnl_evaluate_query_set_compact(client, "dave", set);
+    TEST_ASSERT(compact != NULL && sgnl_result_set_count(compact) == 10, "Compact batch evaluated");
+    in_order = compact != NULL;
+    for (int i = 0; in_order && i < 10; i++) {
+        in_order = sgnl_result_set_result(compact, i) == SGNL_ALLOWED &&
+                   strcmp(sgnl_result_set_asset_id(compact, i), assets[i]) == 0 &&
+                   strcmp(sgnl_result_set_action(compact, i), "sudo:rm") == 0 &&
+                   strcmp(sgnl_result_set_decision(compact, i), "Allow") == 0 &&
+                   strncmp(sgnl_result_set_reason(compact, i), "Offline:", 8) == 0;
+    }
+    TEST_ASSERT(in_order, "Compact results land in query order");
+    TEST_ASSERT(strcmp(sgnl_result_set_principal_id(compact), "dave") == 0, "Compact principal shared");
+    TEST_ASSERT(sgnl_result_set_request_id(compact)[0] != '\0', "Compact request ID set");
+    TEST_ASSERT(sgnl_result_set_result(compact, 10) == SGNL_INVALID_REQUEST, "Compact index out of range rejected");
+    TEST_ASSERT(strcmp(sgnl_result_set_reason(compact, -1), "") == 0, "Compact out of range string empty");
+    sgnl_result_set_free(compact);
+    
+    // One unanswerable query fails the whole batch, whichever chunk it is in
+    sgnl_query_set_add(set, "file-unknown", "sudo:rm");
+    results = sgnl_evaluate_query_set(client, "dave", set);
+    TEST_ASSERT(results == NULL, "Chunked batch fails as a whole");
+    TEST_ASSERT(sgnl_evaluate_query_set_compact(client, "dave", set) == NULL, "Compact batch fails as a whole");
+    TEST_ASSERT(sgnl_check_query_set(client, "dave", set) != SGNL_ALLOWED, "Check with unanswerable query not allowed");
+    sgnl_query_set_free(set);
+    
+    // All-must-allow checks return only the aggregate outcome
+    int failed_index = 0;
+    sgnl_result_t outcome = sgnl_check_access_batch(client, "dave", assets, NULL, 10, &failed_index);
+    TEST_ASSERT(outcome == SGNL_NETWORK_ERROR || outcome == SGNL_ERROR, "Check with unrecorded action fails");
+    TEST_ASSERT(failed_index == -1, "Network failure not tied to a query");
+    const char *actions[10];
+    for (int i = 0; i < 10; i++) {
+        actions[i] = "sudo:rm";
+    }
+    TEST_ASSERT(sgnl_check_access_batch(client, "dave", assets, actions, 10, &failed_index) == SGNL_ALLOWED,
+                "Chunked check allowed from offline store");
+    TEST_ASSERT(failed_index == -1, "No failed query when allowed");
+    TEST_ASSERT(sgnl_check_access_batch(client, "dave", assets, actions, 0, NULL) == SGNL_INVALID_REQUEST,
+                "Empty check rejected");
+    
+    sgnl_client_destroy(client);
+    unlink(config_path);
+    unlink(store_path);
+    sgnl_config_cache_clear();
+    
+    return 0;
+}
+
+// Test millisecond timeouts and the end-to-end deadline against a server
+// that accepts connections but never answers
+static int test_deadline(void) {
+    TEST_SECTION("Millisecond Timeouts and Deadline");
+    
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    TEST_ASSERT(listener >= 0 && bind(listener, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+                listen(listener, 8) == 0 && getsockname(listener, (struct sockaddr *)&addr, &addr_len) == 0,
+                "Silent server listening");
+    
+    // The tenant is prepended to api_url, so "127" + "0.0.1" is loopback
+    char config_path[128];
+    snprintf(config_path, sizeof(config_path), "/tmp/sgnl-deadline-test-%d.json", (int)getpid());
+    FILE *file = fopen(config_path, "w");
+    TEST_ASSERT(file != NULL, "Deadline config written");
+    fprintf(file,
+            "{\"api_url\": \"0.0.1:%d\", \"api_token\": \"deadline-token\", \"tenant\": \"127\",\n"
+            " \"http\": {\"timeout\": 10, \"connect_timeout\": 5, \"deadline_ms\": 300,\n"
+            "          \"retry\": {\"max_retries\": 3, \"budget_ms\": 5000}}}\n",
+            ntohs(addr.sin_port));
+    fclose(file);
+    
+    sgnl_client_config_t config = {
+        .config_path = config_path,
+        .enable_debug_logging = false,
+        .validate_ssl = true,
+        .bypass_broker = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with deadline");
+    
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sgnl_access_result_t *result = sgnl_evaluate_access(client, "carol", "host1", "sudo");
+    int64_t elapsed = elapsed_ms_since(&start);
+    TEST_ASSERT(result != NULL && result->result == SGNL_TIMEOUT_ERROR, "Silent server reported as timeout");
+    TEST_ASSERT(elapsed >= 250 && elapsed < 1500, "Configured deadline bounds the evaluation");
+    sgnl_access_result_free(result);
+    sgnl_client_destroy(client);
+    
+    // A caller's millisecond settings take precedence over the config file
+    config.deadline_ms = 5000;
+    config.timeout_ms = 100;
+    client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with caller timeout");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    result = sgnl_evaluate_access(client, "carol", "host1", "sudo");
+    elapsed = elapsed_ms_since(&start);
+    TEST_ASSERT(result != NULL && result->result == SGNL_TIMEOUT_ERROR, "Attempt timeout reported as timeout");
+    TEST_ASSERT(elapsed >= 80 && elapsed < 1000, "Millisecond attempt timeout applied");
+    sgnl_access_result_free(result);
+    sgnl_client_destroy(client);
+    
+    close(listener);
+    unlink(config_path);
+    sgnl_config_cache_clear();
+    
+    return 0;
+}
+
+// gunzip a buffer with zlib, independently of the library's encoder
+static size_t test_gunzip(const char *data, size_t length, char *out, size_t capacity) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 16) != Z_OK) {
+        return 0;
+    }
+    zs.next_in = (Bytef *)data;
+    zs.avail_in = (uInt)length;
+    zs.next_out = (Bytef *)out;
+    zs.avail_out = (uInt)capacity;
+    int status = inflate(&zs, Z_FINISH);
+    size_t total = zs.total_out;
+    inflateEnd(&zs);
+    return status == Z_STREAM_END ? total : 0;
+}
+
+// Test gzip encoding of request bodies
+static int test_request_compression(void) {
+    TEST_SECTION("Request Compression");
+    
+    char body[4096];
+    size_t length = 0;
+    length += (size_t)snprintf(body, sizeof(body), "{\"principal\":{\"id\":\"alice\"},\"queries\":[");
+    for (int i = 0; i < 40; i++) {
+        length += (size_t)snprintf(body + length, sizeof(body) - length, "%s{\"assetId\":\"host%d\",\"action\":\"sudo\"}",
+                                   i ? "," : "", i);
+    }
+    length += (size_t)snprintf(body + length, sizeof(body) - length, "]}");
+    
+    char storage[256];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, storage, sizeof(storage));
+    
+    // Below min_bytes the body goes out as is
+    const char *encoded = NULL;
+    TEST_ASSERT(sgnl_gzip_encode(&arena, body, length, length + 1, -1, &encoded) == 0 && encoded == NULL,
+                "Short body not encoded");
+    TEST_ASSERT(sgnl_gzip_encode(&arena, body, 0, 0, -1, &encoded) == 0, "Empty body not encoded");
+    
+    // Larger bodies gzip and round-trip through zlib
+    size_t encoded_length = sgnl_gzip_encode(&arena, body, length, length, -1, &encoded);
+    TEST_ASSERT(encoded_length > 0 && encoded_length < length / 4, "Repetitive body compressed");
+    TEST_ASSERT(encoded != NULL && (unsigned char)encoded[0] == 0x1f && (unsigned char)encoded[1] == 0x8b,
+                "gzip header written");
+    char decoded[4096];
+    size_t decoded_length = encoded ? test_gunzip(encoded, encoded_length, decoded, sizeof(decoded)) : 0;
+    TEST_ASSERT(decoded_length == length && memcmp(decoded, body, length) == 0, "Encoding round-trips through zlib");
+    
+    // A failed or useless deflate leaves the plain body
+    encoded = NULL;
+    TEST_ASSERT(sgnl_gzip_encode(&arena, body, length, 0, 42, &encoded) == 0 && encoded == NULL,
+                "Failed deflate falls back to plain body");
+    unsigned char noise[2048];
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < sizeof(noise); i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        noise[i] = (unsigned char)state;
+    }
+    TEST_ASSERT(sgnl_gzip_encode(&arena, (const char *)noise, sizeof(noise), 0, -1, &encoded) == 0 && encoded == NULL,
+                "Incompressible body sent as is");
+    sgnl_arena_release(&arena);
+    
+    return 0;
+}
+
+#define TLS_SERVER_MAX_REQUESTS 4
+
+// One-shot HTTPS endpoint for the evaluations API: each connection carries
+// one request, answered with an Allow for every assetId in its body
+typedef struct {
+    int listener;
+    SSL_CTX *ctx;
+    int requests;
+    int served;
+    char headers[TLS_SERVER_MAX_REQUESTS][2048];
+    char bodies[TLS_SERVER_MAX_REQUESTS][8192];     // Decoded when sent gzip
+    size_t body_lengths[TLS_SERVER_MAX_REQUESTS];
+    bool body_gzip[TLS_SERVER_MAX_REQUESTS];
+    bool response_gzip[TLS_SERVER_MAX_REQUESTS];
+} tls_server_t;
+
+// Self-signed certificate for the test server, generated in memory
+static SSL_CTX* tls_server_context(void) {
+    SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+    EVP_PKEY *key = EVP_EC_gen("P-256");
+    X509 *cert = X509_new();
+    bool ok = ctx && key && cert;
+    if (ok) {
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME *name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *)"127.0.0.1", -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0 && SSL_CTX_use_certificate(ctx, cert) == 1 &&
+             SSL_CTX_use_PrivateKey(ctx, key) == 1;
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    if (!ok) {
+        SSL_CTX_free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+static size_t test_gzip(const char *data, size_t length, char *out, size_t capacity) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    zs.next_in = (Bytef *)data;
+    zs.avail_in = (uInt)length;
+    zs.next_out = (Bytef *)out;
+    zs.avail_out = (uInt)capacity;
+    int status = deflate(&zs, Z_FINISH);
+    size_t total = zs.total_out;
+    deflateEnd(&zs);
+    return status == Z_STREAM_END ? total : 0;
+}
+
+// Whether a request header is present and its value mentions token
+static bool header_has(const char *headers, const char *name, const char *token) {
+    char line[256];
+    snprintf(line, sizeof(line), "\r\n%s:", name);
+    const char *value = strcasestr(headers, line);
+    if (!value) {
+        return false;
+    }
+    value += strlen(line);
+    const char *end = strstr(value, "\r\n");
+    snprintf(line, sizeof(line), "%.*s", end ? (int)(end - value) : (int)strlen(value), value);
+    return strcasestr(line, token) != NULL;
+}
+
+static void tls_server_serve(tls_server_t *server, SSL *ssl, int n) {
+    char request[16384];
+    size_t length = 0;
+    char *end = NULL;
+    size_t content_length = 0;
+    bool continued = false;
+    for (;;) {
+        if (end && length >= (size_t)(end + 4 - request) + content_length) {
+            break;
+        }
+        int got = SSL_read(ssl, request + length, (int)(sizeof(request) - 1 - length));
+        if (got <= 0) {
+            return;
+        }
+        length += (size_t)got;
+        request[length] = '\0';
+        if (!end && (end = strstr(request, "\r\n\r\n")) != NULL) {
+            *end = '\0';
+            const char *header = strcasestr(request, "\r\ncontent-length:");
+            content_length = header ? strtoul(header + 17, NULL, 10) : 0;
+            size_t header_length = (size_t)(end - request);
+            if (header_length >= sizeof(server->headers[n])) {
+                header_length = sizeof(server->headers[n]) - 1;
+            }
+            memcpy(server->headers[n], request, header_length);
+            server->headers[n][header_length] = '\0';
+            if (header_has(request, "expect", "100-continue") && !continued) {
+                SSL_write(ssl, "HTTP/1.1 100 Continue\r\n\r\n", 25);
+                continued = true;
+            }
+        }
+    }
+    
+    const char *raw = end + 4;
+    server->body_gzip[n] = header_has(server->headers[n], "content-encoding", "gzip");
+    if (server->body_gzip[n]) {
+        server->body_lengths[n] = test_gunzip(raw, content_length, server->bodies[n], sizeof(server->bodies[n]) - 1);
+    } else {
+        server->body_lengths[n] = content_length < sizeof(server->bodies[n]) ? content_length : 0;
+        memcpy(server->bodies[n], raw, server->body_lengths[n]);
+    }
+    server->bodies[n][server->body_lengths[n]] = '\0';
+    
+    char json[8192];
+    size_t json_length = (size_t)snprintf(json, sizeof(json), "{\"decisions\":[");
+    const char *asset = server->bodies[n];
+    int count = 0;
+    while ((asset = strstr(asset, "\"assetId\":\"")) != NULL && json_length < sizeof(json) - 128) {
+        asset += 11;
+        int asset_length = (int)(strchr(asset, '"') - asset);
+        json_length += (size_t)snprintf(json + json_length, sizeof(json) - json_length,
+                                        "%s{\"decision\":\"Allow\",\"assetId\":\"%.*s\"}",
+                                        count++ ? "," : "", asset_length, asset);
+    }
+    json_length += (size_t)snprintf(json + json_length, sizeof(json) - json_length, "]}");
+    
+    char encoded[8192];
+    const char *payload = json;
+    size_t payload_length = json_length;
+    server->response_gzip[n] = header_has(server->headers[n], "accept-encoding", "gzip");
+    if (server->response_gzip[n]) {
+        payload_length = test_gzip(json, json_length, encoded, sizeof(encoded));
+        payload = encoded;
+    }
+    char head[256];
+    int head_length = snprintf(head, sizeof(head),
+                               "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                               "%sConnection: close\r\n\r\n",
+                               payload_length, server->response_gzip[n] ? "Content-Encoding: gzip\r\n" : "");
+    SSL_write(ssl, head, head_length);
+    SSL_write(ssl, payload, (int)payload_length);
+}
+
+static void* tls_server_thread(void *arg) {
+    tls_server_t *server = (tls_server_t *)arg;
+    while (server->served < server->requests) {
+        struct pollfd pfd = {.fd = server->listener, .events = POLLIN};
+        if (poll(&pfd, 1, 5000) <= 0) {
+            break;
+        }
+        int fd = accept(server->listener, NULL, NULL);
+        if (fd < 0) {
+            break;
+        }
+        SSL *ssl = SSL_new(server->ctx);
+        SSL_set_fd(ssl, fd);
+        if (SSL_accept(ssl) == 1) {
+            tls_server_serve(server, ssl, server->served++);
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+        close(fd);
+    }
+    return NULL;
+}
+
+// Listen on an ephemeral loopback port, reported in addr
+static bool tls_server_listen(tls_server_t *server, struct sockaddr_in *addr) {
+    memset(server, 0, sizeof(*server));
+    server->ctx = tls_server_context();
+    server->listener = socket(AF_INET, SOCK_STREAM, 0);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(*addr);
+    return server->ctx != NULL && server->listener >= 0 &&
+           bind(server->listener, (struct sockaddr *)addr, sizeof(*addr)) == 0 &&
+           listen(server->listener, 8) == 0 &&
+           getsockname(server->listener, (struct sockaddr *)addr, &addr_len) == 0;
+}
+
+// Run one call against the test server, which answers `requests` connections
+static void tls_server_run(tls_server_t *server, int requests, pthread_t *thread) {
+    server->requests = requests;
+    server->served = 0;
+    memset(server->headers, 0, sizeof(server->headers));
+    memset(server->bodies, 0, sizeof(server->bodies));
+    memset(server->body_gzip, 0, sizeof(server->body_gzip));
+    memset(server->response_gzip, 0, sizeof(server->response_gzip));
+    pthread_create(thread, NULL, tls_server_thread, server);
+}
+
+// Test Accept-Encoding and gzip request bodies against a local HTTPS server
+static int test_http_compression(void) {
+    TEST_SECTION("HTTP Compression");
+    
+    static tls_server_t server;
+    struct sockaddr_in addr;
+    TEST_ASSERT(tls_server_listen(&server, &addr), "HTTPS server listening");
+    
+    char config_path[128];
+    snprintf(config_path, sizeof(config_path), "/tmp/sgnl-compression-test-%d.json", (int)getpid());
+    FILE *file = fopen(config_path, "w");
+    TEST_ASSERT(file != NULL, "Compression config written");
+    fprintf(file,
+            "{\"api_url\": \"0.0.1:%d\", \"api_token\": \"compression-token\", \"tenant\": \"127\",\n"
+            " \"http\": {\"timeout\": 10, \"retry\": {\"max_retries\": 0},\n"
+            "          \"compression\": {\"response\": true, \"request\": true, \"request_min_bytes\": 512}}}\n",
+            ntohs(addr.sin_port));
+    fclose(file);
+    
+    sgnl_client_config_t config = {
+        .config_path = config_path,
+        .enable_debug_logging = false,
+        .validate_ssl = false,
+        .bypass_broker = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation with compression");
+    
+    // A short body goes out as JSON; the gzip response is decoded by libcurl
+    pthread_t thread;
+    tls_server_run(&server, 1, &thread);
+    sgnl_result_t result = sgnl_check_access(client, "carol", "host1", "sudo");
+    pthread_join(thread, NULL);
+    TEST_ASSERT(result == SGNL_ALLOWED, "Evaluation answered through HTTPS server");
+    TEST_ASSERT(server.response_gzip[0],
+                "Accept-Encoding offers gzip");
+    TEST_ASSERT(!server.body_gzip[0] && strstr(server.bodies[0], "\"assetId\":\"host1\"") != NULL,
+                "Short body sent uncompressed");
+    
+    // A batch body above request_min_bytes is sent gzip-encoded
+    const char *assets[32];
+    char names[32][16];
+    for (int i = 0; i < 32; i++) {
+        snprintf(names[i], sizeof(names[i]), "batch-host-%d", i);
+        assets[i] = names[i];
+    }
+    tls_server_run(&server, 1, &thread);
+    result = sgnl_check_access_batch(client, "carol", assets, NULL, 32, NULL);
+    pthread_join(thread, NULL);
+    TEST_ASSERT(result == SGNL_ALLOWED, "Compressed batch allowed");
+    TEST_ASSERT(server.body_gzip[0], "Content-Encoding: gzip on large body");
+    TEST_ASSERT(server.body_lengths[0] > 512 && strstr(server.bodies[0], "\"assetId\":\"batch-host-31\"") != NULL,
+                "Compressed body decodes to the full request");
+    sgnl_client_destroy(client);
+    sgnl_config_cache_clear();
+    
+    // Both directions off: no Accept-Encoding and a plain body
+    file = fopen(config_path, "w");
+    fprintf(file,
+            "{\"api_url\": \"0.0.1:%d\", \"api_token\": \"compression-token\", \"tenant\": \"127\",\n"
+            " \"http\": {\"timeout\": 10, \"retry\": {\"max_retries\": 0},\n"
+            "          \"compression\": {\"response\": false, \"request\": false, \"request_min_bytes\": 0}}}\n",
+            ntohs(addr.sin_port));
+    fclose(file);
+    client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation without compression");
+    tls_server_run(&server, 1, &thread);
+    result = sgnl_check_access_batch(client, "carol", assets, NULL, 32, NULL);
+    pthread_join(thread, NULL);
+    TEST_ASSERT(result == SGNL_ALLOWED, "Uncompressed batch allowed");
+    TEST_ASSERT(server.headers[0][0] != '\0' && !header_has(server.headers[0], "accept-encoding", ""),
+                "No Accept-Encoding when response compression is off");
+    TEST_ASSERT(!server.body_gzip[0] && strstr(server.bodies[0], "\"assetId\":\"batch-host-31\"") != NULL,
+                "Body sent as JSON when request compression is off");
+    sgnl_client_destroy(client);
+    
+    close(server.listener);
+    SSL_CTX_free(server.ctx);
+    unlink(config_path);
+    sgnl_config_cache_clear();
+    
+    return 0;
+}
+
+// Run one evaluation with stderr redirected into output
+static sgnl_result_t check_access_capturing_stderr(sgnl_client_t *client, tls_server_t *server,
+                                                   const char *principal_id, char *output, size_t size) {
+    fflush(stderr);
+    FILE *capture = tmpfile();
+    int saved = dup(STDERR_FILENO);
+    dup2(fileno(capture), STDERR_FILENO);
+    
+    pthread_t thread;
+    tls_server_run(server, 1, &thread);
+    sgnl_result_t result = sgnl_check_access(client, principal_id, "host1", "sudo");
+    pthread_join(thread, NULL);
+    sgnl_log_flush();
+    
+    fflush(stderr);
+    dup2(saved, STDERR_FILENO);
+    close(saved);
+    rewind(capture);
+    size_t length = fread(output, 1, size - 1, capture);
+    output[length] = '\0';
+    fclose(capture);
+    return result;
+}
+
+// Test that a decision served through sgnld is audited once, by its caller
+static int test_broker_audit(void) {
+    TEST_SECTION("Broker Audit Records");
+    
+    static tls_server_t server;
+    struct sockaddr_in addr;
+    TEST_ASSERT(tls_server_listen(&server, &addr), "HTTPS server listening");
+    
+    char config_path[128];
+    snprintf(config_path, sizeof(config_path), "/tmp/sgnl-audit-test-%d.json", (int)getpid());
+    FILE *file = fopen(config_path, "w");
+    TEST_ASSERT(file != NULL, "Audit config written");
+    fprintf(file,
+            "{\"api_url\": \"0.0.1:%d\", \"api_token\": \"audit-token\", \"tenant\": \"127\",\n"
+            " \"http\": {\"timeout\": 10, \"retry\": {\"max_retries\": 0}},\n"
+            " \"log_level\": \"error\", \"logging\": {\"audit\": \"stderr\"}}\n",
+            ntohs(addr.sin_port));
+    fclose(file);
+    
+    // The broker's own client leaves the record to the process that asked it
+    sgnl_client_config_t config = {
+        .config_path = config_path,
+        .enable_debug_logging = false,
+        .validate_ssl = false,
+        .bypass_broker = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Broker client creation");
+    char output[4096];
+    sgnl_result_t result = check_access_capturing_stderr(client, &server, "audit-broker", output, sizeof(output));
+    TEST_ASSERT(result == SGNL_ALLOWED, "Broker client evaluation allowed");
+    TEST_ASSERT(strstr(output, "audit-broker") == NULL, "Broker client writes no audit record");
+    sgnl_client_destroy(client);
+    sgnl_config_cache_clear();
+    
+    // Any other client audits its decisions
+    config.bypass_broker = false;
+    client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    result = check_access_capturing_stderr(client, &server, "audit-caller", output, sizeof(output));
+    TEST_ASSERT(result == SGNL_ALLOWED, "Client evaluation allowed");
+    const char *record = strstr(output, "principal=audit-caller");
+    TEST_ASSERT(record != NULL && strstr(record, "source=network") != NULL, "Client writes the audit record");
+    TEST_ASSERT(record != NULL && strstr(record + 1, "principal=audit-caller") == NULL, "One record per decision");
+    sgnl_client_destroy(client);
+    
+    close(server.listener);
+    SSL_CTX_free(server.ctx);
+    unlink(config_path);
+    sgnl_config_cache_clear();
+    
+    return 0;
+}
+
+// Test the prefetched entitlement snapshot
+static int test_entitlement_snapshot(void) {
+    TEST_SECTION("Entitlement Snapshot");
+    
+    sgnl_asset_set_t *set = sgnl_asset_set_create();
+    TEST_ASSERT(set != NULL, "Asset set creation");
+    char asset[32];
+    bool added = true;
+    for (int i = 0; i < 1000; i++) {
+        snprintf(asset, sizeof(asset), "host-%d", i);
+        added = added && sgnl_asset_set_add(set, asset);
+    }
+    TEST_ASSERT(added && sgnl_asset_set_add(set, "host-7"), "Assets added across growth");
+    TEST_ASSERT(sgnl_asset_set_count(set) == 1000, "Duplicates ignored");
+    TEST_ASSERT(sgnl_asset_set_contains(set, "host-0") && sgnl_asset_set_contains(set, "host-999"), "Added assets found");
+    TEST_ASSERT(!sgnl_asset_set_contains(set, "host-1000") && !sgnl_asset_set_contains(set, "host-"), "Missing assets not found");
+    
+    sgnl_snapshot_t *snapshot = sgnl_snapshot_create("sudo", 2, 60);
+    TEST_ASSERT(snapshot != NULL, "Snapshot creation");
+    TEST_ASSERT(sgnl_snapshot_replace(snapshot, "alice", set), "Set installed for principal");
+    TEST_ASSERT(sgnl_snapshot_contains(snapshot, "alice", "host-42", "sudo"), "Snapshot hit");
+    TEST_ASSERT(!sgnl_snapshot_contains(snapshot, "alice", "host-42", "login"), "Other actions not answered");
+    TEST_ASSERT(!sgnl_snapshot_contains(snapshot, "bob", "host-42", "sudo"), "Other principals not answered");
+    
+    // Replacing swaps in the new set whole
+    set = sgnl_asset_set_create();
+    TEST_ASSERT(set != NULL && sgnl_asset_set_add(set, "db-1"), "Replacement set built");
+    TEST_ASSERT(sgnl_snapshot_replace(snapshot, "alice", set), "Set replaced");
+    TEST_ASSERT(sgnl_snapshot_contains(snapshot, "alice", "db-1", "sudo"), "New grant visible");
+    TEST_ASSERT(!sgnl_snapshot_contains(snapshot, "alice", "host-42", "sudo"), "Revoked grant gone");
+    
+    // Bounded: a third principal evicts the least recently refreshed
+    sgnl_snapshot_replace(snapshot, "bob", sgnl_asset_set_create());
+    sgnl_snapshot_replace(snapshot, "carol", sgnl_asset_set_create());
+    TEST_ASSERT(sgnl_snapshot_principal_count(snapshot) == 2, "Principal count bounded");
+    
+    const char *active[1] = {"carol"};
+    TEST_ASSERT(sgnl_snapshot_retain(snapshot, active, 1) == 1, "Inactive principal dropped");
+    TEST_ASSERT(sgnl_snapshot_invalidate(snapshot, NULL) == 1, "Invalidate drops every set");
+    sgnl_snapshot_destroy(snapshot);
+    
+    // Prefetch is off in the test config
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    TEST_ASSERT(sgnl_client_snapshot_refresh(client, "alice") == SGNL_ERROR, "Refresh fails without prefetch");
+    TEST_ASSERT(sgnl_client_snapshot_retain(client, NULL, 0) == SGNL_ERROR, "Retain fails without prefetch");
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
+typedef struct {
+    int count;
+    int stop_after;
+    char assets[4][32];
+    char decisions[4][16];
+    char reasons[4][64];
+} stream_capture_t;
+
+static bool capture_decision(const sgnl_json_decision_t *decision, int index, void *user_data) {
+    stream_capture_t *capture = (stream_capture_t *)user_data;
+    if (index < 4) {
+        snprintf(capture->assets[index], sizeof(capture->assets[index]), "%s", decision->asset_id ? decision->asset_id : "(null)");
+        snprintf(capture->decisions[index], sizeof(capture->decisions[index]), "%s", decision->decision ? decision->decision : "(null)");
+        snprintf(capture->reasons[index], sizeof(capture->reasons[index]), "%s", decision->reason ? decision->reason : "(null)");
+    }
+    capture->count++;
+    return capture->stop_after == 0 || capture->count < capture->stop_after;
+}
+
+// Test the streaming response parser
+static int test_json_stream(void) {
+    TEST_SECTION("Streaming Response Parser");
+    
+    const char *response =
+        "{\"requestId\": \"r-1\", \"decisions\": ["
+        "{\"decision\": \"Allow\", \"assetId\": \"host\\u00e9\\\"1\", \"attributes\": {\"decision\": \"Deny\", \"n\": [1, -2.5e3, true, null]}},"
+        "{\"action\": \"sudo\", \"assetId\": \"host2\", \"decision\": \"Deny\", \"reason\": \"not in group\"},"
+        "{\"assetId\": \"host3\"}"
+        "], \"nextPageToken\": \"page-2\"}";
+    
+    stream_capture_t capture = {0};
+    sgnl_json_stream_t *stream = sgnl_json_stream_create(capture_decision, &capture);
+    TEST_ASSERT(stream != NULL, "Parser creation");
+    
+    // One byte at a time exercises every state at a chunk boundary
+    bool fed = true;
+    for (size_t i = 0; response[i] && fed; i++) {
+        fed = sgnl_json_stream_feed(stream, &response[i], 1) == SGNL_JSON_STREAM_OK;
+    }
+    TEST_ASSERT(fed, "Byte-wise feed accepted");
+    TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_OK, "Complete document");
+    TEST_ASSERT(capture.count == 3 && sgnl_json_stream_decision_count(stream) == 3, "Three decisions reported");
+    TEST_ASSERT(strcmp(capture.assets[0], "host\xc3\xa9\"1") == 0, "Escapes decoded");
+    TEST_ASSERT(strcmp(capture.decisions[0], "Allow") == 0, "Nested fields do not override decision");
+    TEST_ASSERT(strcmp(capture.reasons[1], "not in group") == 0, "Reason captured");
+    TEST_ASSERT(strcmp(capture.decisions[2], "(null)") == 0, "Missing decision reported as NULL");
+    TEST_ASSERT(sgnl_json_stream_has_decisions(stream), "Decisions array seen");
+    TEST_ASSERT(sgnl_json_stream_next_page_token(stream) != NULL &&
+                strcmp(sgnl_json_stream_next_page_token(stream), "page-2") == 0, "Page token captured");
+    TEST_ASSERT(!sgnl_json_stream_has_error(stream), "No API error");
+    
+    // API error object
+    sgnl_json_stream_reset(stream);
+    const char *error_response = "{\"error\": {\"code\": 7, \"message\": \"tenant suspended\"}}";
+    sgnl_json_stream_feed(stream, error_response, strlen(error_response));
+    TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_OK, "Error document parsed");
+    TEST_ASSERT(sgnl_json_stream_has_error(stream), "API error detected");
+    TEST_ASSERT(strcmp(sgnl_json_stream_error_message(stream), "tenant suspended") == 0, "Error message captured");
+    TEST_ASSERT(!sgnl_json_stream_has_decisions(stream), "No decisions in error document");
+    
+    // Malformed and truncated input
+    const char *malformed[] = {"{\"decisions\": [}", "{\"a\": tru}", "{\"a\": 01}", "{} {}", "<html>"};
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        sgnl_json_stream_reset(stream);
+        sgnl_json_stream_feed(stream, malformed[i], strlen(malformed[i]));
+        TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_ERROR, "Malformed document rejected");
+    }
+    sgnl_json_stream_reset(stream);
+    const char *truncated = "{\"decisions\": [{\"decision\": \"Allow\"}";
+    TEST_ASSERT(sgnl_json_stream_feed(stream, truncated, strlen(truncated)) == SGNL_JSON_STREAM_OK, "Partial document accepted so far");
+    TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_ERROR, "Truncated document rejected");
+    
+    sgnl_json_stream_destroy(stream);
+    
+    // Consumer can stop early
+    stream_capture_t stopper = {.stop_after = 1};
+    stream = sgnl_json_stream_create(capture_decision, &stopper);
+    TEST_ASSERT(sgnl_json_stream_feed(stream, response, strlen(response)) == SGNL_JSON_STREAM_STOPPED, "Callback stops parsing");
+    TEST_ASSERT(stopper.count == 1, "No decisions after stop");
+    sgnl_json_stream_destroy(stream);
+    
+    return 0;
+}
+
+// Test the hedge delay and the race between hedged legs
+static int test_request_hedging(void) {
+    TEST_SECTION("Request Hedging");
+    
+    // Too few samples: the configured initial delay, never below the floor
+    sgnl_latency_window_t window;
+    memset(&window, 0, sizeof(window));
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 95, 50, 10) == 50, "No samples uses initial delay");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 95, 5, 10) == 10, "Initial delay raised to floor");
+    for (int i = 0; i < SGNL_HEDGE_MIN_SAMPLES - 1; i++) {
+        sgnl_latency_window_record(&window, 1000);
+    }
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 95, 50, 10) == 50, "Initial delay until enough samples");
+    
+    // 1..100ms recorded out of order: percentiles over the sorted window
+    memset(&window, 0, sizeof(window));
+    for (int i = 0; i < 100; i++) {
+        sgnl_latency_window_record(&window, (i * 37) % 100 + 1);
+    }
+    TEST_ASSERT(window.count == 100, "Samples counted");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 95, 50, 10) == 96, "p95 of recent latencies");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 50, 500, 10) == 51, "p50 replaces initial delay");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 100, 50, 10) == 100, "p100 is the slowest sample");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 95, 50, 200) == 200, "Percentile raised to floor");
+    
+    // Only the most recent samples count
+    memset(&window, 0, sizeof(window));
+    for (int i = 0; i < SGNL_HEDGE_LATENCY_SAMPLES; i++) {
+        sgnl_latency_window_record(&window, 1000);
+    }
+    for (int i = 0; i < SGNL_HEDGE_LATENCY_SAMPLES; i++) {
+        sgnl_latency_window_record(&window, 20);
+    }
+    TEST_ASSERT(window.count == SGNL_HEDGE_LATENCY_SAMPLES, "Window capped");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 99, 50, 10) == 20, "Old latencies aged out");
+    sgnl_latency_window_record(&window, -5);
+    sgnl_latency_window_record(&window, INT64_MAX);
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 0, 50, 0) == 0, "Negative latency clamped");
+    TEST_ASSERT(sgnl_hedge_delay_ms(&window, 100, 50, 0) == INT32_MAX, "Huge latency clamped");
+    
+    // Unhedged: the primary's outcome, whatever it is, ends the race
+    sgnl_hedge_race_t race;
+    sgnl_hedge_race_init(&race);
+    TEST_ASSERT(sgnl_hedge_race_finish(&race, 0, false) && race.winner == 0, "Lone failure reported");
+    sgnl_hedge_race_init(&race);
+    TEST_ASSERT(sgnl_hedge_race_finish(&race, 0, true) && race.winner == 0, "Primary answers first");
+    TEST_ASSERT(!sgnl_hedge_race_finish(&race, 1, true) && race.winner == 0, "Race decided once");
+    
+    // Hedged: a failed leg falls back to the one still running
+    sgnl_hedge_race_init(&race);
+    race.started = 2;
+    TEST_ASSERT(!sgnl_hedge_race_finish(&race, 0, false) && race.winner < 0, "Primary failure waits for hedge");
+    TEST_ASSERT(sgnl_hedge_race_finish(&race, 1, true) && race.winner == 1, "Hedge answers");
+    sgnl_hedge_race_init(&race);
+    race.started = 2;
+    TEST_ASSERT(!sgnl_hedge_race_finish(&race, 1, false) && race.winner < 0, "Hedge failure waits for primary");
+    TEST_ASSERT(sgnl_hedge_race_finish(&race, 0, true) && race.winner == 0, "Primary answers");
+    sgnl_hedge_race_init(&race);
+    race.started = 2;
+    sgnl_hedge_race_finish(&race, 0, false);
+    TEST_ASSERT(sgnl_hedge_race_finish(&race, 1, false) && race.winner == 1, "Last failure reported when both fail");
+    
+    // The winner's buffered body reaches the parser; a partial feed is discarded
+    const char *bodies[2] = {
+        "{\"decisions\": [{\"assetId\": \"slow\", \"decision\": \"Deny\"}]}",
+        "{\"decisions\": [{\"assetId\": \"fast\", \"decision\": \"Allow\"}]}"
+    };
+    sgnl_hedge_race_init(&race);
+    race.started = 2;
+    sgnl_hedge_race_finish(&race, 1, true);
+    stream_capture_t capture = {0};
+    sgnl_json_stream_t *stream = sgnl_json_stream_create(capture_decision, &capture);
+    TEST_ASSERT(stream != NULL, "Parser creation");
+    sgnl_json_stream_feed(stream, "{\"decisions\": [{\"assetId\": \"stale", 33);
+    TEST_ASSERT(sgnl_hedge_replay(stream, bodies[race.winner], strlen(bodies[race.winner])) == SGNL_JSON_STREAM_OK,
+                "Winning body replayed");
+    TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_OK, "Replayed body complete");
+    TEST_ASSERT(capture.count == 1 && strcmp(capture.assets[0], "fast") == 0 &&
+                strcmp(capture.decisions[0], "Allow") == 0, "Winner's decision parsed");
+    sgnl_json_stream_destroy(stream);
+    
+    return 0;
+}
+
+// Test the request arena and the JSON writer that fills it
+static int test_json_writer(void) {
+    TEST_SECTION("Request Arena and JSON Writer");
+    
+    char storage[64];
+    sgnl_arena_t arena;
+    sgnl_arena_init(&arena, storage, sizeof(storage));
+    
+    sgnl_json_writer_t writer;
+    sgnl_json_writer_init(&writer, &arena, 16);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "decisions");
+    sgnl_json_writer_begin_array(&writer);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "decision");
+    sgnl_json_writer_string(&writer, "Allow");
+    sgnl_json_writer_key(&writer, "assetId");
+    sgnl_json_writer_string(&writer, "a\"b\\c\n\x01");
+    sgnl_json_writer_end_object(&writer);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "assetId");
+    sgnl_json_writer_string(&writer, "second");
+    sgnl_json_writer_end_object(&writer);
+    sgnl_json_writer_end_array(&writer);
+    sgnl_json_writer_key(&writer, "n");
+    sgnl_json_writer_int(&writer, -5);
+    sgnl_json_writer_key(&writer, "z");
+    sgnl_json_writer_string(&writer, NULL);
+    sgnl_json_writer_key(&writer, "raw");
+    sgnl_json_writer_raw(&writer, "{\"k\":[]}");
+    sgnl_json_writer_end_object(&writer);
+    
+    const char *json = sgnl_json_writer_finish(&writer);
+    const char *expected =
+        "{\"decisions\":[{\"decision\":\"Allow\",\"assetId\":\"a\\\"b\\\\c\\n\\u0001\"},"
+        "{\"assetId\":\"second\"}],\"n\":-5,\"z\":null,\"raw\":{\"k\":[]}}";
+    TEST_ASSERT(json != NULL, "Writer produces a document");
+    TEST_ASSERT(strcmp(json, expected) == 0, "Commas, escapes, null and raw values");
+    
+    // The escaped document reads back through the streaming parser
+    stream_capture_t capture = {0};
+    sgnl_json_stream_t *stream = sgnl_json_stream_create_in(&arena, capture_decision, &capture);
+    TEST_ASSERT(stream != NULL, "Parser created in the arena");
+    TEST_ASSERT(sgnl_json_stream_feed(stream, json, strlen(json)) == SGNL_JSON_STREAM_OK, "Written document parses");
+    TEST_ASSERT(sgnl_json_stream_finish(stream) == SGNL_JSON_STREAM_OK, "Written document complete");
+    TEST_ASSERT(capture.count == 2, "Both decisions read back");
+    TEST_ASSERT(strcmp(capture.assets[0], "a\"b\\c\n\x01") == 0, "Escaped asset round-trips");
+    sgnl_json_stream_destroy(stream);
+    sgnl_arena_release(&arena);
+    
+    // Unbalanced documents are refused
+    sgnl_json_writer_init(&writer, &arena, 0);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "open");
+    sgnl_json_writer_begin_array(&writer);
+    TEST_ASSERT(sgnl_json_writer_finish(&writer) == NULL, "Unbalanced document rejected");
+    sgnl_arena_release(&arena);
+    
+    // Allocations past the inline storage spill into aligned heap blocks
+    bool aligned = true;
+    for (int i = 0; i < 100; i++) {
+        void *p = sgnl_arena_alloc(&arena, 1 + (size_t)i * 3);
+        aligned = aligned && p != NULL && ((uintptr_t)p % 16) == 0;
+    }
+    TEST_ASSERT(aligned, "Arena allocations are aligned");
+    char *big = sgnl_arena_alloc(&arena, 20000);
+    TEST_ASSERT(big != NULL, "Oversized allocation served");
+    memset(big, 'x', 20000);
+    TEST_ASSERT(arena.blocks != NULL, "Heap blocks in use after overflow");
+    sgnl_arena_release(&arena);
+    TEST_ASSERT(arena.blocks == NULL && arena.used == 0, "Release returns to inline storage");
+    
+    char *copy = sgnl_arena_strdup(&arena, "reused");
+    TEST_ASSERT(copy >= storage && copy < storage + sizeof(storage) && strcmp(copy, "reused") == 0, "Arena reusable after release");
+    TEST_ASSERT(sgnl_arena_extend(&arena, copy, 7, 32), "Top allocation extends in place");
+    sgnl_arena_release(&arena);
+    
+    // A heap buffer grows once and is then reused in place
+    sgnl_json_buffer_t buffer = {0};
+    sgnl_json_writer_init_buffer(&writer, &buffer, 0);
+    sgnl_json_writer_begin_array(&writer);
+    for (int i = 0; i < 1000; i++) {
+        sgnl_json_writer_string(&writer, "quote\"d");
+    }
+    sgnl_json_writer_end_array(&writer);
+    json = sgnl_json_writer_finish(&writer);
+    TEST_ASSERT(json != NULL && strncmp(json, "[\"quote\\\"d\",", 12) == 0, "Buffer writer escapes");
+    size_t grown = buffer.capacity;
+    char *data = buffer.data;
+    TEST_ASSERT(grown > 10000, "Buffer grew to fit the document");
+    
+    sgnl_json_writer_init_buffer(&writer, &buffer, 0);
+    sgnl_json_writer_begin_object(&writer);
+    sgnl_json_writer_key(&writer, "k");
+    sgnl_json_writer_int(&writer, 1);
+    sgnl_json_writer_end_object(&writer);
+    json = sgnl_json_writer_finish(&writer);
+    TEST_ASSERT(json == data && strcmp(json, "{\"k\":1}") == 0, "Buffer reused for the next document");
+    TEST_ASSERT(buffer.capacity == grown, "Buffer keeps its capacity");
+    sgnl_json_buffer_free(&buffer);
+    TEST_ASSERT(buffer.data == NULL && buffer.capacity == 0, "Buffer freed");
+    
+    return 0;
+}
+
+// Test the broker protocol against an in-process fake sgnld
+static int test_broker_protocol(void) {
+    TEST_SECTION("Decision Broker Protocol");
+    
+    sgnl_access_result_t allow = {.result = SGNL_ALLOWED};
+    sgnl_access_result_t deny = {.result = SGNL_DENIED};
+    strcpy(deny.reason, "outside change window");
+    
+    const char *assets[] = {"host1", NULL};
+    const char *actions[] = {"sudo", "login"};
+    sgnl_access_result_t storage[2];
+    sgnl_access_result_t *results[2] = {&storage[0], &storage[1]};
+    memset(storage, 0, sizeof(storage));
+    
+    // No broker listening: caller must fall back
+    TEST_ASSERT(!sgnl_broker_evaluate("/nonexistent/sgnld.sock", 100, "alice", assets, actions, 2, results),
+                "Missing broker reports fallback");
+    
+    // A socket in a directory others can write to is never asked
+    char socket_path[108];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/sgnl-test-%d.sock", (int)getpid());
+    unlink(socket_path);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+    TEST_ASSERT(listen_fd >= 0 && bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+                listen(listen_fd, 1) == 0, "Socket in /tmp listening");
+    TEST_ASSERT(!sgnl_broker_evaluate(socket_path, 100, "alice", assets, actions, 2, results),
+                "Broker in world-writable directory refused");
+    close(listen_fd);
+    unlink(socket_path);
+    
+    char socket_dir[] = "/tmp/sgnl-test-XXXXXX";
+    TEST_ASSERT(mkdtemp(socket_dir) != NULL, "Private socket directory created");
+    snprintf(socket_path, sizeof(socket_path), "%s/sgnld.sock", socket_dir);
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+    TEST_ASSERT(listen_fd >= 0 && bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+                listen(listen_fd, 1) == 0, "Test broker socket listening");
+    
+    // Only a broker run by root is trusted
+    if (geteuid() != 0) {
+        TEST_ASSERT(!sgnl_broker_evaluate(socket_path, 100, "alice", assets, actions, 2, results),
+                    "Broker not run by root refused");
+        close(listen_fd);
+        unlink(socket_path);
+        rmdir(socket_dir);
+        return 0;
+    }
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Fake broker: decode one request and answer Allow, Deny
+        int fd = accept(listen_fd, NULL, NULL);
+        sgnl_broker_request_t req;
+        int status = 1;
+        if (fd >= 0 && sgnl_broker_read_request(fd, &req)) {
+            bool decoded = req.count == 2 && strcmp(req.principal_id, "alice") == 0 &&
+                           strcmp(req.asset_ids[0], "host1") == 0 && req.asset_ids[1] == NULL &&
+                           strcmp(req.actions[1], "login") == 0;
+            sgnl_access_result_t *answers[2] = {&allow, &deny};
+            if (decoded && sgnl_broker_write_response(fd, SGNL_OK, answers, 2)) {
+                status = 0;
+            }
+            sgnl_broker_request_free(&req);
+        }
+        _exit(status);
+    }
+    
+    bool answered = sgnl_broker_evaluate(socket_path, 2000, "alice", assets, actions, 2, results);
+    int child_status = -1;
+    waitpid(pid, &child_status, 0);
+    close(listen_fd);
+    unlink(socket_path);
+    rmdir(socket_dir);
+    
+    TEST_ASSERT(answered, "Broker answered");
+    TEST_ASSERT(WIFEXITED(child_status) && WEXITSTATUS(child_status) == 0, "Broker decoded request");
+    TEST_ASSERT(storage[0].result == SGNL_ALLOWED && strcmp(storage[0].decision, "Allow") == 0, "First result is Allow");
+    TEST_ASSERT(storage[1].result == SGNL_DENIED && strcmp(storage[1].decision, "Deny") == 0, "Second result is Deny");
+    TEST_ASSERT(strcmp(storage[1].reason, "outside change window") == 0, "Deny reason carried");
+    
+    return 0;
+}
+
 // Test asset search
 static int test_asset_search(void) {
     TEST_SECTION("Asset Search");
@@ -394,6 +2068,47 @@ static int test_detailed_asset_search(void) {
     return 0;
 }
 
+static bool count_asset(const char *asset_id, void *user_data) {
+    (void)asset_id;
+    (*(int *)user_data)++;
+    return true;
+}
+
+// Test paginated asset iteration
+static int test_asset_search_foreach(void) {
+    TEST_SECTION("Asset Search Iteration");
+    
+    int seen = 0;
+    TEST_ASSERT(sgnl_search_assets_foreach(NULL, "test-user", NULL, 0, count_asset, &seen) == SGNL_INVALID_REQUEST,
+                "NULL client iteration rejected");
+    
+    sgnl_client_config_t config = {
+        .config_path = test_config_file,
+        .enable_debug_logging = false,
+        .validate_ssl = true
+    };
+    sgnl_client_t *client = sgnl_client_create(&config);
+    TEST_ASSERT(client != NULL, "Client creation");
+    
+    TEST_ASSERT(sgnl_search_assets_foreach(client, "test-user", NULL, 0, NULL, NULL) == SGNL_INVALID_REQUEST,
+                "Iteration requires a callback");
+    
+    // Network is unavailable in tests: the first page fails and nothing is delivered
+    sgnl_result_t result = sgnl_search_assets_foreach(client, "test-user", "sudo_list", 10, count_asset, &seen);
+    TEST_ASSERT(result != SGNL_OK, "Iteration reports page failure");
+    TEST_ASSERT(seen == 0, "No assets delivered on failure");
+    
+    sgnl_search_result_t *page = sgnl_search_assets_detailed(client, "test-user", NULL, "opaque-token", 0);
+    TEST_ASSERT(page != NULL, "Continuation page result created");
+    TEST_ASSERT(!page->has_more_pages && page->next_page_token == NULL, "Failed page has no continuation");
+    TEST_ASSERT(strcmp(page->action, "list") == 0, "Default search action applied");
+    sgnl_search_result_free(page);
+    
+    sgnl_client_destroy(client);
+    
+    return 0;
+}
+
 // Test memory management
 static int test_memory_management(void) {
     TEST_SECTION("Memory Management");
@@ -601,8 +2316,28 @@ static int test_libsgnl_main(void)
     failures += test_simple_access_check();
     failures += test_detailed_access_evaluation();
     failures += test_batch_access_evaluation();
+    failures += test_connection_reuse();
+    failures += test_principal_switch();
+    failures += test_concurrent_evaluations();
+    failures += test_async_evaluation();
+    failures += test_retry_budget();
+    failures += test_decision_cache();
+    failures += test_offline_store();
+    failures += test_tls_session_store();
+    failures += test_client_stats();
+    failures += test_entitlement_snapshot();
+    failures += test_query_set();
+    failures += test_deadline();
+    failures += test_request_compression();
+    failures += test_http_compression();
+    failures += test_broker_audit();
+    failures += test_broker_protocol();
+    failures += test_json_stream();
+    failures += test_request_hedging();
+    failures += test_json_writer();
     failures += test_asset_search();
     failures += test_detailed_asset_search();
+    failures += test_asset_search_foreach();
     failures += test_memory_management();
     failures += test_client_config_loading();
     failures += test_error_message_handling();